@@ -0,0 +1,93 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#include "common/include/big_five_macros.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/signal_set.hpp>
+
+#include <sys/types.h>
+
+namespace mmotd::server {
+
+// Both variants are rendered up front so a request never has to wait on the template writer
+struct RenderedOutput {
+    std::string color;
+    std::string plain;
+    // The width of the terminal the output was fitted to (0 when it is unknown), nullopt when the output does not
+    //  depend on the width.  Such an output is only served to the clients with a terminal as wide, the others
+    //  render the output themselves.
+    std::optional<std::size_t> columns;
+};
+
+// What a client asks the daemon for, it is sent as "mmotd/2 color=<0|1> columns=<width>\n" where the width of the
+//  client's terminal is 0 when it is unknown
+struct MotdRequest {
+    bool color_output = false;
+    std::size_t columns = 0;
+};
+
+std::string FormatMotdRequest(const MotdRequest &request);
+// Returns nullopt when the request is malformed
+std::optional<MotdRequest> ParseMotdRequest(std::string_view request);
+
+using RefreshFunction = std::function<RenderedOutput()>;
+
+// Returns 'daemon.socket_path' or, by default, $XDG_RUNTIME_DIR/mmotd.sock
+std::filesystem::path GetSocketPath();
+
+//
+// The resident daemon (`mmotd --daemon`).  The informations are refreshed on a background thread
+//  every 'daemon.refresh_interval' seconds while the io_context thread serves the last rendered output
+//  to each client which connects to the unix domain socket.  The output contains information about
+//  the user running the daemon (name, last login, etc.) so only clients running as that user are served.
+//
+class MotdServer {
+public:
+    MotdServer(std::filesystem::path socket_path, RefreshFunction refresh);
+    // Only serves the clients running as `user_id` rather than as the effective user of the daemon
+    MotdServer(std::filesystem::path socket_path, RefreshFunction refresh, uid_t user_id);
+    NO_CONSTRUCTOR_DELETE_COPY_MOVE_OPERATORS_DEFAULT_DESTRUCTOR(MotdServer);
+
+    // Blocks until the daemon receives SIGINT or SIGTERM (or until Stop is called)
+    bool Run();
+    // Can be called from any thread
+    void Stop();
+
+private:
+    using Socket = boost::asio::local::stream_protocol::socket;
+
+    bool RemoveStaleSocket();
+    bool Listen();
+    void Accept();
+    void Serve(Socket socket);
+    void Refresh();
+    void RefreshLoop();
+
+    std::filesystem::path socket_path_;
+    RefreshFunction refresh_;
+    uid_t user_id_;
+    boost::asio::io_context io_context_;
+    boost::asio::local::stream_protocol::acceptor acceptor_;
+    boost::asio::signal_set signals_;
+    std::mutex output_mutex_;
+    std::shared_ptr<const RenderedOutput> output_;
+    std::mutex refresh_mutex_;
+    std::condition_variable refresh_condition_;
+    bool stopped_ = false;
+};
+
+// Returns the output rendered by a running daemon or nullopt when no daemon answers in time
+std::optional<std::string> RequestMotdFromServer(const std::filesystem::path &socket_path, const MotdRequest &request);
+
+} // namespace mmotd::server
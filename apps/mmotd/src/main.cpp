@@ -1,25 +1,31 @@
 // vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
 #include "apps/mmotd/include/main.h"
+#include "apps/mmotd/include/mmotd_server.h"
 
 #include "common/assertion/include/assertion.h"
 #include "common/assertion/include/throw.h"
 #include "common/include/algorithm.h"
 #include "common/include/cli_options_parser.h"
+#include "common/include/compiled_template.h"
 #include "common/include/config_options.h"
 #include "common/include/global_state.h"
 #include "common/include/logging.h"
-#include "common/include/output_template.h"
 #include "common/include/output_template_writer.h"
 #include "common/include/special_files.h"
 #include "lib/include/computer_information.h"
+#include "lib/include/http_request.h"
 
+#include <chrono>
 #include <clocale>
+#include <cstddef>
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
 #include <iterator>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <utility>
 
 #include <backward.hpp>
 #include <boost/exception/exception.hpp>
@@ -34,31 +40,116 @@ using mmotd::core::ConfigOptions;
 
 namespace {
 
-void PrintMmotd() {
+unique_ptr<mmotd::output_template::CompiledTemplate> LoadOutputTemplate() {
     using namespace mmotd::output_template;
-    using namespace mmotd::output_template_writer;
     using mmotd::core::special_files::ExpandEnvironmentVariables;
 
     auto template_filename = ConfigOptions::Instance().GetString("core.template_path"sv, ""sv);
     LOG_INFO("template file name: '{}'", (empty(template_filename) ? "<builtin template>"s : template_filename));
-    auto output_template = unique_ptr<OutputTemplate>{};
+    auto output_template = unique_ptr<CompiledTemplate>{};
     if (!empty(template_filename)) {
-        output_template = MakeOutputTemplate(ExpandEnvironmentVariables(template_filename));
+        output_template = MakeCompiledTemplate(ExpandEnvironmentVariables(template_filename));
     } else {
-        output_template = MakeOutputTemplateFromDefault();
+        output_template = MakeCompiledTemplateFromDefault();
     }
 
     if (!output_template) {
         LOG_FATAL("unable to create output template from '{}'",
                   !empty(template_filename) ? template_filename : "<internal output template>");
+    }
+    return output_template;
+}
+
+string RenderMmotd(const mmotd::output_template::CompiledTemplate &output_template,
+                   const mmotd::information::InformationsView &informations,
+                   bool color_output) {
+    using namespace mmotd::output_template_writer;
+    auto writer = OutputTemplateWriter(output_template, informations);
+    writer.SetColorOutput(color_output);
+    return fmt::format(FMT_STRING("{}\n"), writer);
+}
+
+void PrintMmotd() {
+    auto output_template = LoadOutputTemplate();
+    if (!output_template) {
         return;
     }
 
     auto &computer_information = mmotd::information::ComputerInformation::Instance();
-    auto informations = computer_information.GetAllInformations();
+    computer_information.SetRequiredInformationIds(output_template->GetReferencedInformationIds());
+    const auto &informations = computer_information.GetAllInformations();
 
-    auto writer = OutputTemplateWriter(output_template->GetColumns(), output_template->GetColumnItems(), informations);
-    fmt::print(FMT_STRING("{}\n"), writer);
+    auto color_output = ConfigOptions::Instance().GetBoolean("core.output_color"sv, true);
+    fmt::print(FMT_STRING("{}"), RenderMmotd(*output_template, informations, color_output));
+    // stdout is otherwise flushed after the static destructors, one of which finishes the http revalidations
+    fflush(stdout);
+}
+
+bool RunDaemon() {
+    using namespace mmotd::server;
+    auto output_template = LoadOutputTemplate();
+    if (!output_template) {
+        return false;
+    }
+    auto required_information_ids = output_template->GetReferencedInformationIds();
+    mmotd::information::ComputerInformation::Instance().SetRequiredInformationIds(std::move(required_information_ids));
+    auto refresh = [&output_template]() {
+        auto &computer_information = mmotd::information::ComputerInformation::Instance();
+        computer_information.RefreshInformation();
+        const auto &informations = computer_information.GetAllInformations();
+        // both variants are rendered for the clients, the configuration is left as it is
+        auto output = RenderedOutput{};
+        output.color = RenderMmotd(*output_template, informations, true);
+        output.plain = RenderMmotd(*output_template, informations, false);
+        if (ConfigOptions::Instance().GetBoolean("fortune.fit_terminal_width"sv, false)) {
+            // the fortune was fitted to the terminal of the daemon, usually there is none and it is unconstrained
+            output.columns = mmotd::core::special_files::GetTerminalWidth().value_or(size_t{0});
+        }
+        return output;
+    };
+    auto server = MotdServer{GetSocketPath(), refresh};
+    return server.Run();
+}
+
+bool PrintMmotdFromDaemon() {
+    auto request = mmotd::server::MotdRequest{};
+    request.color_output = ConfigOptions::Instance().GetBoolean("core.output_color"sv, true);
+    request.columns = mmotd::core::special_files::GetTerminalWidth().value_or(size_t{0});
+    auto output_holder = mmotd::server::RequestMotdFromServer(mmotd::server::GetSocketPath(), request);
+    if (!output_holder) {
+        return false;
+    }
+    fmt::print(FMT_STRING("{}"), *output_holder);
+    return true;
+}
+
+void PrintHttpTimings() {
+    using mmotd::networking::HttpRequest;
+    auto to_ms = [](chrono::microseconds duration) { return chrono::duration<double, milli>(duration).count(); };
+    auto timings = HttpRequest::GetTimings();
+    fmt::print(stderr, FMT_STRING("http timings (ms from the start of each request), {} requests\n"), size(timings));
+    fmt::print(stderr,
+               FMT_STRING("{:>6} {:>9} {:>9} {:>9} {:>10} {:>9} {:>9}  {}\n"),
+               "status",
+               "dns",
+               "connect",
+               "tls",
+               "first byte",
+               "total",
+               "bytes",
+               "url");
+    for (const auto &timing : timings) {
+        fmt::print(stderr,
+                   FMT_STRING("{:>6} {:>9.1f} {:>9.1f} {:>9.1f} {:>10.1f} {:>9.1f} {:>9}  {}\n"),
+                   timing.status_code,
+                   to_ms(timing.name_lookup),
+                   to_ms(timing.connect),
+                   to_ms(timing.tls_handshake),
+                   to_ms(timing.first_byte),
+                   to_ms(timing.total),
+                   timing.bytes,
+                   timing.url);
+    }
 }
 
 void UpdateLoggingDetails() {
@@ -90,7 +181,15 @@ int main_impl(int argc, char **argv) {
 
     UpdateLoggingDetails();
 
-    PrintMmotd();
+    if (ConfigOptions::Instance().GetBoolean("core.daemon"sv, false)) {
+        return RunDaemon() ? EXIT_SUCCESS : EXIT_FAILURE;
+    } else if (ConfigOptions::Instance().GetBoolean("core.timings"sv, false)) {
+        // the requests are timed in this process, so the daemon's pre-rendered output is not used
+        PrintMmotd();
+        PrintHttpTimings();
+    } else if (!PrintMmotdFromDaemon()) {
+        PrintMmotd();
+    }
     return EXIT_SUCCESS;
 }
 
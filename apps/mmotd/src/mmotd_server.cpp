@@ -0,0 +1,340 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "apps/mmotd/include/mmotd_server.h"
+
+#include "common/include/config_options.h"
+#include "common/include/logging.h"
+#include "common/include/posix_error.h"
+#include "common/include/special_files.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/write.hpp>
+#include <fmt/format.h>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+using namespace std;
+using fmt::format;
+namespace fs = std::filesystem;
+using boost::asio::local::stream_protocol;
+
+namespace {
+
+constexpr auto SOCKET_FILENAME = string_view{"mmotd.sock"};
+constexpr auto PROTOCOL_VERSION = string_view{"mmotd/2"};
+constexpr auto COLOR_FIELD = string_view{"color="};
+constexpr auto COLUMNS_FIELD = string_view{"columns="};
+constexpr auto MAX_REQUEST_SIZE = size_t{64};
+constexpr auto DEFAULT_REFRESH_INTERVAL = int64_t{60};
+// a login must never wait long on an unresponsive daemon, mmotd renders the output itself instead
+constexpr auto CLIENT_TIMEOUT = chrono::milliseconds{250};
+
+optional<uid_t> GetPeerUserId(int socket_fd) {
+#if defined(__linux__)
+    auto credentials = ucred{};
+    auto length = static_cast<socklen_t>(sizeof(credentials));
+    if (getsockopt(socket_fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0) {
+        LOG_ERROR("unable to query the peer credentials, {}", mmotd::error::posix_error::to_string());
+        return nullopt;
+    }
+    return credentials.uid;
+#elif defined(__APPLE__)
+    auto user_id = uid_t{};
+    auto group_id = gid_t{};
+    if (getpeereid(socket_fd, &user_id, &group_id) != 0) {
+        LOG_ERROR("unable to query the peer credentials, {}", mmotd::error::posix_error::to_string());
+        return nullopt;
+    }
+    return user_id;
+#else
+    return nullopt;
+#endif
+}
+
+struct Session {
+    explicit Session(stream_protocol::socket client_socket) : socket(std::move(client_socket)) {}
+
+    stream_protocol::socket socket;
+    string request;
+    shared_ptr<const mmotd::server::RenderedOutput> output;
+};
+
+} // namespace
+
+namespace mmotd::server {
+
+fs::path GetSocketPath() {
+    using mmotd::core::ConfigOptions;
+    using namespace mmotd::core::special_files;
+    auto socket_path = ConfigOptions::Instance().GetString("daemon.socket_path"sv, ""sv);
+    if (!empty(socket_path)) {
+        return fs::path{ExpandEnvironmentVariables(socket_path)};
+    }
+    auto runtime_dir = GetEnvironmentValue("XDG_RUNTIME_DIR");
+    if (!empty(runtime_dir)) {
+        return fs::path{runtime_dir} / SOCKET_FILENAME;
+    }
+    auto cache_dir = GetCacheDirectory();
+    return empty(cache_dir) ? fs::path{} : cache_dir / SOCKET_FILENAME;
+}
+
+string FormatMotdRequest(const MotdRequest &request) {
+    return format(FMT_STRING("{} {}{} {}{}\n"),
+                  PROTOCOL_VERSION,
+                  COLOR_FIELD,
+                  request.color_output ? 1 : 0,
+                  COLUMNS_FIELD,
+                  request.columns);
+}
+
+optional<MotdRequest> ParseMotdRequest(string_view request) {
+    // "mmotd/2 color=<0|1> columns=<width>\n", the fields are taken off the front one at a time
+    auto take_field = [&request](string_view name, char delimiter) -> optional<string_view> {
+        if (!request.starts_with(name)) {
+            return nullopt;
+        }
+        request.remove_prefix(size(name));
+        auto end = request.find(delimiter);
+        if (end == string_view::npos) {
+            return nullopt;
+        }
+        auto value = request.substr(0, end);
+        request.remove_prefix(end + 1);
+        return make_optional(value);
+    };
+    auto version = take_field(PROTOCOL_VERSION, ' ');
+    auto color = take_field(COLOR_FIELD, ' ');
+    auto columns = take_field(COLUMNS_FIELD, '\n');
+    if (!version || !empty(*version) || !color || (*color != "0" && *color != "1") || !columns || !empty(request)) {
+        return nullopt;
+    }
+    auto motd_request = MotdRequest{};
+    motd_request.color_output = *color == "1";
+    auto [ptr, ec] = from_chars(data(*columns), data(*columns) + size(*columns), motd_request.columns);
+    if (empty(*columns) || ec != errc{} || ptr != data(*columns) + size(*columns)) {
+        return nullopt;
+    }
+    return make_optional(motd_request);
+}
+
+MotdServer::MotdServer(fs::path socket_path, RefreshFunction refresh) :
+    MotdServer(std::move(socket_path), std::move(refresh), geteuid()) {}
+
+MotdServer::MotdServer(fs::path socket_path, RefreshFunction refresh, uid_t user_id) :
+    socket_path_(std::move(socket_path)),
+    refresh_(std::move(refresh)),
+    user_id_(user_id),
+    io_context_(),
+    acceptor_(io_context_),
+    signals_(io_context_, SIGINT, SIGTERM) {}
+
+bool MotdServer::Run() {
+    if (empty(socket_path_)) {
+        LOG_FATAL("unable to determine the path of the daemon socket");
+        return false;
+    } else if (!RemoveStaleSocket()) {
+        return false;
+    }
+
+    // render before listening so the first client is never served an empty response
+    Refresh();
+    if (!Listen()) {
+        return false;
+    }
+    signals_.async_wait([this](const boost::system::error_code &ec, int signal_number) {
+        if (!ec) {
+            LOG_INFO("received signal {}, stopping the daemon", signal_number);
+            Stop();
+        }
+    });
+    Accept();
+
+    auto refresh_thread = std::thread([this]() { RefreshLoop(); });
+    LOG_INFO("daemon listening on {}", socket_path_.string());
+    io_context_.run();
+
+    Stop();
+    refresh_thread.join();
+    auto ec = error_code{};
+    fs::remove(socket_path_, ec);
+    return true;
+}
+
+bool MotdServer::RemoveStaleSocket() {
+    auto ec = error_code{};
+    if (!fs::exists(socket_path_, ec)) {
+        return true;
+    } else if (!fs::is_socket(socket_path_, ec)) {
+        LOG_FATAL("{} exists and is not a socket", socket_path_.string());
+        return false;
+    }
+    auto probe = stream_protocol::socket{io_context_};
+    auto connect_ec = boost::system::error_code{};
+    probe.connect(stream_protocol::endpoint{socket_path_.string()}, connect_ec);
+    if (!connect_ec) {
+        LOG_FATAL("another daemon is already listening on {}", socket_path_.string());
+        return false;
+    }
+    LOG_INFO("removing stale socket {}", socket_path_.string());
+    return fs::remove(socket_path_, ec) && !ec;
+}
+
+bool MotdServer::Listen() {
+    auto ec = boost::system::error_code{};
+    acceptor_.open(stream_protocol{}, ec);
+    if (!ec) {
+        acceptor_.bind(stream_protocol::endpoint{socket_path_.string()}, ec);
+    }
+    if (!ec) {
+        acceptor_.listen(boost::asio::socket_base::max_listen_connections, ec);
+    }
+    if (ec) {
+        LOG_FATAL("unable to listen on {}, {}", socket_path_.string(), ec.message());
+        return false;
+    }
+    if (chmod(socket_path_.c_str(), S_IRUSR | S_IWUSR) != 0) {
+        LOG_WARNING("unable to restrict access to {}, {}",
+                    socket_path_.string(),
+                    mmotd::error::posix_error::to_string());
+    }
+    return true;
+}
+
+void MotdServer::Accept() {
+    acceptor_.async_accept([this](const boost::system::error_code &ec, Socket socket) {
+        if (ec == boost::asio::error::operation_aborted) {
+            return;
+        } else if (ec) {
+            LOG_ERROR("unable to accept a connection, {}", ec.message());
+        } else {
+            Serve(std::move(socket));
+        }
+        Accept();
+    });
+}
+
+void MotdServer::Serve(Socket socket) {
+    auto peer_user_id = GetPeerUserId(socket.native_handle());
+    if (!peer_user_id || *peer_user_id != user_id_) {
+        LOG_WARNING("refusing connection from user id {}", peer_user_id ? to_string(*peer_user_id) : "<unknown>");
+        return;
+    }
+    auto session = make_shared<Session>(std::move(socket));
+    {
+        auto lock = lock_guard<mutex>{output_mutex_};
+        session->output = output_;
+    }
+    boost::asio::async_read_until(
+        session->socket,
+        boost::asio::dynamic_buffer(session->request, MAX_REQUEST_SIZE),
+        '\n',
+        [session](const boost::system::error_code &ec, size_t) {
+            if (ec) {
+                LOG_ERROR("unable to read the request, {}", ec.message());
+                return;
+            }
+            auto request = ParseMotdRequest(session->request);
+            if (!request) {
+                LOG_ERROR("invalid request: '{}'", session->request);
+                return;
+            }
+            const auto &output = *session->output;
+            if (output.columns && *output.columns != request->columns) {
+                // the client renders the output itself rather than print one which fits another terminal
+                LOG_VERBOSE("the output fits {} columns, the client has {}", *output.columns, request->columns);
+                return;
+            }
+            const auto &response = request->color_output ? output.color : output.plain;
+            boost::asio::async_write(session->socket,
+                                     boost::asio::buffer(response),
+                                     [session](const boost::system::error_code &write_ec, size_t) {
+                                         if (write_ec) {
+                                             LOG_ERROR("unable to write the response, {}", write_ec.message());
+                                         }
+                                     });
+        });
+}
+
+void MotdServer::Refresh() {
+    auto output = make_shared<const RenderedOutput>(refresh_());
+    auto lock = lock_guard<mutex>{output_mutex_};
+    output_ = std::move(output);
+}
+
+void MotdServer::RefreshLoop() {
+    using mmotd::core::ConfigOptions;
+    auto interval = ConfigOptions::Instance().GetInteger("daemon.refresh_interval"sv, DEFAULT_REFRESH_INTERVAL);
+    auto refresh_interval = chrono::seconds{std::max(interval, int64_t{1})};
+    auto lock = unique_lock<mutex>{refresh_mutex_};
+    while (!refresh_condition_.wait_for(lock, refresh_interval, [this]() { return stopped_; })) {
+        lock.unlock();
+        Refresh();
+        lock.lock();
+    }
+}
+
+void MotdServer::Stop() {
+    {
+        auto lock = lock_guard<mutex>{refresh_mutex_};
+        stopped_ = true;
+    }
+    refresh_condition_.notify_all();
+    io_context_.stop();
+}
+
+optional<string> RequestMotdFromServer(const fs::path &socket_path, const MotdRequest &motd_request) {
+    auto ec = error_code{};
+    if (empty(socket_path) || !fs::is_socket(socket_path, ec)) {
+        return nullopt;
+    }
+    auto io_context = boost::asio::io_context{};
+    auto socket = stream_protocol::socket{io_context};
+    auto request = FormatMotdRequest(motd_request);
+    auto response = string{};
+    auto succeeded = false;
+    auto on_read = [&](const boost::system::error_code &read_ec, size_t) {
+        succeeded = read_ec == boost::asio::error::eof && !empty(response);
+    };
+    auto on_write = [&](const boost::system::error_code &write_ec, size_t) {
+        if (write_ec) {
+            LOG_VERBOSE("unable to send the request to the daemon, {}", write_ec.message());
+            return;
+        }
+        boost::asio::async_read(socket, boost::asio::dynamic_buffer(response), on_read);
+    };
+    auto on_connect = [&](const boost::system::error_code &connect_ec) {
+        if (connect_ec) {
+            LOG_VERBOSE("unable to connect to the daemon, {}", connect_ec.message());
+            return;
+        }
+        boost::asio::async_write(socket, boost::asio::buffer(request), on_write);
+    };
+    socket.async_connect(stream_protocol::endpoint{socket_path.string()}, on_connect);
+    io_context.run_for(CLIENT_TIMEOUT);
+    if (!succeeded) {
+        LOG_VERBOSE("the daemon did not respond, rendering the output locally");
+        return nullopt;
+    }
+    return make_optional(std::move(response));
+}
+
+} // namespace mmotd::server
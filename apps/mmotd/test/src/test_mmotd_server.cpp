@@ -0,0 +1,143 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "apps/mmotd/include/mmotd_server.h"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <catch2/catch.hpp>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+using boost::asio::local::stream_protocol;
+
+namespace {
+
+mmotd::server::RenderedOutput MakeOutput() {
+    auto output = mmotd::server::RenderedOutput{};
+    output.color = "\x1b[1mmmotd\x1b[0m\n";
+    output.plain = "mmotd\n";
+    return output;
+}
+
+// Runs the daemon on a socket of its own until it is destroyed
+class TestServer {
+public:
+    explicit TestServer(mmotd::server::RenderedOutput output, uid_t user_id = geteuid()) :
+        socket_path_(fs::temp_directory_path() / ("mmotd_test_" + to_string(getpid()) + ".sock")),
+        server_(socket_path_, [output]() { return output; }, user_id),
+        thread_([this]() { server_.Run(); }) {
+        auto deadline = chrono::steady_clock::now() + chrono::seconds{5};
+        auto ec = error_code{};
+        while (!fs::is_socket(socket_path_, ec) && chrono::steady_clock::now() < deadline) {
+            this_thread::sleep_for(chrono::milliseconds{10});
+        }
+    }
+
+    ~TestServer() {
+        server_.Stop();
+        thread_.join();
+    }
+
+    TestServer(const TestServer &other) = delete;
+    TestServer(TestServer &&other) = delete;
+    TestServer &operator=(const TestServer &other) = delete;
+    TestServer &operator=(TestServer &&other) = delete;
+
+    const fs::path &GetSocketPath() const noexcept { return socket_path_; }
+
+private:
+    fs::path socket_path_;
+    mmotd::server::MotdServer server_;
+    std::thread thread_;
+};
+
+mmotd::server::MotdRequest MakeRequest(bool color_output, size_t columns) {
+    auto request = mmotd::server::MotdRequest{};
+    request.color_output = color_output;
+    request.columns = columns;
+    return request;
+}
+
+// Sends `request` as it is and returns whatever the daemon answers before it closes the connection
+string SendRawRequest(const fs::path &socket_path, string_view request) {
+    auto io_context = boost::asio::io_context{};
+    auto socket = stream_protocol::socket{io_context};
+    socket.connect(stream_protocol::endpoint{socket_path.string()});
+    // the daemon can close the connection before it has read all of a malformed request
+    auto ec = boost::system::error_code{};
+    boost::asio::write(socket, boost::asio::buffer(request), ec);
+    auto response = string{};
+    boost::asio::read(socket, boost::asio::dynamic_buffer(response), ec);
+    return response;
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("MotdRequest is formatted and parsed", "[MotdServer]") {
+    using namespace mmotd::server;
+    CATCH_CHECK(FormatMotdRequest(MakeRequest(true, 80)) == "mmotd/2 color=1 columns=80\n");
+    auto request = ParseMotdRequest(FormatMotdRequest(MakeRequest(false, 132)));
+    CATCH_REQUIRE(request);
+    CATCH_CHECK(!request->color_output);
+    CATCH_CHECK(request->columns == 132);
+
+    // the first version of the protocol did not send the width of the terminal
+    CATCH_CHECK(!ParseMotdRequest("mmotd/1 color=1\n"));
+    CATCH_CHECK(!ParseMotdRequest("mmotd/1 color=1 columns=80\n"));
+    CATCH_CHECK(!ParseMotdRequest("mmotd/2 color=1 columns=80"));
+    CATCH_CHECK(!ParseMotdRequest("mmotd/2 color=2 columns=80\n"));
+    CATCH_CHECK(!ParseMotdRequest("mmotd/2 color=1 columns=\n"));
+    CATCH_CHECK(!ParseMotdRequest("mmotd/2 color=1 columns=-80\n"));
+    CATCH_CHECK(!ParseMotdRequest("mmotd/2 color=1 columns=80 rows=24\n"));
+}
+
+CATCH_TEST_CASE("MotdServer serves the rendered output over its socket", "[MotdServer]") {
+    using namespace mmotd::server;
+    auto server = TestServer{MakeOutput()};
+    CATCH_CHECK(RequestMotdFromServer(server.GetSocketPath(), MakeRequest(true, 80)) == MakeOutput().color);
+    CATCH_CHECK(RequestMotdFromServer(server.GetSocketPath(), MakeRequest(false, 0)) == MakeOutput().plain);
+}
+
+CATCH_TEST_CASE("MotdServer only serves an output fitted to the terminal to a terminal as wide", "[MotdServer]") {
+    using namespace mmotd::server;
+    auto output = MakeOutput();
+    output.columns = 80;
+    auto server = TestServer{output};
+    CATCH_CHECK(RequestMotdFromServer(server.GetSocketPath(), MakeRequest(false, 80)) == output.plain);
+    // the client renders the output itself
+    CATCH_CHECK(!RequestMotdFromServer(server.GetSocketPath(), MakeRequest(false, 132)));
+    CATCH_CHECK(!RequestMotdFromServer(server.GetSocketPath(), MakeRequest(false, 0)));
+}
+
+CATCH_TEST_CASE("MotdServer refuses a client running as another user", "[MotdServer]") {
+    using namespace mmotd::server;
+    // the daemon serves another user so this process is the other user
+    auto server = TestServer{MakeOutput(), geteuid() + 1};
+    CATCH_CHECK(!RequestMotdFromServer(server.GetSocketPath(), MakeRequest(true, 80)));
+}
+
+CATCH_TEST_CASE("MotdServer closes the connection of a malformed request", "[MotdServer]") {
+    auto server = TestServer{MakeOutput()};
+    CATCH_CHECK(SendRawRequest(server.GetSocketPath(), "mmotd/1 color=1\n").empty());
+    CATCH_CHECK(SendRawRequest(server.GetSocketPath(), "GET / HTTP/1.1\r\n\r\n").empty());
+    // a request without a newline which is longer than any valid request
+    CATCH_CHECK(SendRawRequest(server.GetSocketPath(), string(128, 'x')).empty());
+    // and the daemon is still serving
+    CATCH_CHECK(SendRawRequest(server.GetSocketPath(), "mmotd/2 color=0 columns=0\n") == MakeOutput().plain);
+}
+
+} // namespace mmotd::test
@@ -0,0 +1,78 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/assertion/include/assertion.h"
+#include "common/assertion/include/throw.h"
+#include "common/include/logging.h"
+#include "lib/include/geoip_database.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include <boost/exception/diagnostic_information.hpp>
+#include <boost/exception_ptr.hpp>
+#include <fmt/format.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+// Converts a csv file of ip address ranges into the memory mapped database read by 'location.geoip_database'
+int main_impl(int argc, char **argv) {
+    auto program_name = argv != nullptr && *argv != nullptr ? string_view(*argv) : string_view{};
+    auto initilized = mmotd::logging::InitializeLogging(program_name);
+    CHECKS(initilized, "unable to initialize logging");
+
+    if (argc != 3) {
+        fmt::print(stderr, FMT_STRING("usage: {} <ranges.csv> <geoip.db>\n"), program_name);
+        fmt::print(stderr,
+                   FMT_STRING("  the csv columns are: "
+                              "first_ip,last_ip,country,region,city,postal_code,timezone,latitude,longitude\n"));
+        return EXIT_FAILURE;
+    }
+    auto input_path = fs::path{argv[1]};
+    auto output_path = fs::path{argv[2]};
+    auto input = ifstream(input_path);
+    if (!input.is_open()) {
+        fmt::print(stderr, FMT_STRING("unable to open {}\n"), input_path.string());
+        return EXIT_FAILURE;
+    }
+    auto ranges = mmotd::networking::ParseGeoIpCsv(input);
+    if (!mmotd::networking::GeoIpDatabase::Write(output_path, ranges)) {
+        fmt::print(stderr, FMT_STRING("unable to write {}\n"), output_path.string());
+        return EXIT_FAILURE;
+    }
+    auto database = mmotd::networking::GeoIpDatabase::Open(output_path);
+    if (!database) {
+        fmt::print(stderr, FMT_STRING("unable to open {} after writing it\n"), output_path.string());
+        return EXIT_FAILURE;
+    }
+    fmt::print(FMT_STRING("wrote {} of {} ranges to {}\n"),
+               database->GetRangeCount(),
+               size(ranges),
+               output_path.string());
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    auto retval = EXIT_SUCCESS;
+    auto exception_message = string{};
+
+    try {
+        retval = main_impl(argc, argv);
+    } catch (boost::exception &ex) {
+        exception_message = mmotd::assertion::GetBoostExceptionMessage(ex);
+    } catch (const std::exception &ex) {
+        exception_message = mmotd::assertion::GetStdExceptionMessage(ex);
+    } catch (...) { exception_message = mmotd::assertion::GetUnknownExceptionMessage(); }
+
+    if (!empty(exception_message)) {
+        fmt::print(stderr, FMT_STRING("{}\n"), exception_message);
+        retval = EXIT_FAILURE;
+    }
+    return retval;
+}
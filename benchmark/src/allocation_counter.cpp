@@ -0,0 +1,54 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "benchmark/src/allocation_counter.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local auto allocation_count = mmotd::benchmark::AllocationCount{};
+
+void *CountedAllocate(std::size_t size) {
+    ++allocation_count.allocations;
+    allocation_count.bytes += size;
+    // malloc(0) may return nullptr, operator new has to return a unique pointer
+    if (auto *memory = std::malloc(size == 0 ? 1 : size); memory != nullptr) {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+} // namespace
+
+namespace mmotd::benchmark {
+
+AllocationCount GetAllocationCount() noexcept {
+    return allocation_count;
+}
+
+} // namespace mmotd::benchmark
+
+void *operator new(std::size_t size) {
+    return CountedAllocate(size);
+}
+
+void *operator new[](std::size_t size) {
+    return CountedAllocate(size);
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
@@ -0,0 +1,26 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace mmotd::benchmark {
+
+// The global operator new is replaced in this executable so the allocations made by each thread can be counted
+struct AllocationCount {
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+};
+
+AllocationCount GetAllocationCount() noexcept;
+
+// Counts the allocations made by the calling thread while `function` runs
+template<typename Function>
+AllocationCount CountAllocations(Function &&function) {
+    auto before = GetAllocationCount();
+    std::forward<Function>(function)();
+    auto after = GetAllocationCount();
+    return AllocationCount{after.allocations - before.allocations, after.bytes - before.bytes};
+}
+
+} // namespace mmotd::benchmark
@@ -0,0 +1,56 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#if defined(__linux__)
+#include "benchmark/src/allocation_counter.h"
+#include "common/include/line_parser.h"
+#include "lib/include/platform/hardware_information.h"
+
+#include <string>
+
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+
+using namespace std;
+
+namespace {
+
+mmotd::platform::HardwareDetails GetNativeCpuDetails() {
+    auto details = mmotd::platform::HardwareDetails{};
+    if (auto cpuinfo = mmotd::core::ReadVirtualFile("/proc/cpuinfo"); cpuinfo) {
+        mmotd::platform::GetCpuInfoDetails(details, *cpuinfo, "/sys/devices/system/cpu");
+    }
+    return details;
+}
+
+mmotd::platform::HardwareDetails GetLscpuDetails() {
+    auto details = mmotd::platform::HardwareDetails{};
+    mmotd::platform::GetLscpuCpuDetails(details);
+    return details;
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("cpu details", "[HardwareInformation][benchmark]") {
+    using mmotd::benchmark::CountAllocations;
+    auto native_details = GetNativeCpuDetails();
+    auto lscpu_details = GetLscpuDetails();
+    fmt::print(FMT_STRING("/proc/cpuinfo: '{}', {} threads, {} cores, {} sockets\n"),
+               native_details.cpu_name,
+               native_details.cpu_core_count,
+               native_details.cpu_physical_core_count,
+               native_details.cpu_socket_count);
+    fmt::print(FMT_STRING("lscpu:         '{}', {} threads\n"), lscpu_details.cpu_name, lscpu_details.cpu_core_count);
+    CATCH_CHECK(native_details.cpu_core_count == lscpu_details.cpu_core_count);
+
+    auto native_allocations = CountAllocations([]() { GetNativeCpuDetails(); });
+    fmt::print(FMT_STRING("/proc/cpuinfo: {} allocations, {} bytes\n"),
+               native_allocations.allocations,
+               native_allocations.bytes);
+
+    CATCH_BENCHMARK("cpu details: /proc/cpuinfo and sysfs") { return GetNativeCpuDetails(); };
+    CATCH_BENCHMARK("cpu details: lscpu --json") { return GetLscpuDetails(); };
+}
+
+} // namespace mmotd::test
+#endif
@@ -0,0 +1,77 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#if defined(__linux__)
+#include "lib/include/fortune_file.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+
+#include <unistd.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+// About the size of the fortune files of a distribution, which fortune.all_files draws from
+constexpr auto FILE_COUNT = size_t{50};
+constexpr auto FORTUNES_PER_FILE = size_t{1000};
+
+// Text fortune files where every third fortune is too tall for the constraints
+vector<fs::path> WriteFortuneFiles(const fs::path &directory) {
+    auto text_paths = vector<fs::path>{};
+    for (auto i = size_t{0}; i != FILE_COUNT; ++i) {
+        auto text_path = directory / fmt::format(FMT_STRING("fortunes{:02}"), i);
+        auto output = ofstream(text_path, ios_base::out | ios_base::binary | ios_base::trunc);
+        for (auto j = size_t{0}; j != FORTUNES_PER_FILE; ++j) {
+            output << fmt::format(FMT_STRING("fortune {} of file {}\n"), j, i);
+            if (j % 3 == 0) {
+                output << "which goes on\nfor a few\nmore lines\n";
+            }
+            output << "%\n";
+        }
+        text_paths.push_back(text_path);
+    }
+    return text_paths;
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("eligible fortunes", "[fortune][benchmark]") {
+    using mmotd::fortune::EligibleFortunes;
+    using mmotd::fortune::FortuneConstraints;
+    auto directory = fs::temp_directory_path() / ("mmotd_benchmark_fortune_" + to_string(getpid()));
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    auto text_paths = WriteFortuneFiles(directory);
+    auto index_path = directory / "eligible.elg";
+    auto constraints = FortuneConstraints{2, 0};
+
+    auto eligible_fortunes = EligibleFortunes::Open(text_paths, constraints, index_path);
+    CATCH_REQUIRE(eligible_fortunes);
+    CATCH_CHECK(eligible_fortunes->GetCount() == FILE_COUNT * (FORTUNES_PER_FILE - (FORTUNES_PER_FILE + 2) / 3));
+
+    // the metrics of every fortune are read, what every login did before the table was saved
+    CATCH_BENCHMARK("eligible fortunes: build the table and draw") {
+        return EligibleFortunes::Open(text_paths, constraints, fs::path{})->GetFortune(FORTUNES_PER_FILE);
+    };
+    // only the size and modification time of each file are checked and the file of the fortune is read
+    CATCH_BENCHMARK("eligible fortunes: open the saved table and draw") {
+        return EligibleFortunes::Open(text_paths, constraints, index_path)->GetFortune(FORTUNES_PER_FILE);
+    };
+
+    auto ec = error_code{};
+    fs::remove_all(directory, ec);
+}
+
+} // namespace mmotd::test
+#endif
@@ -0,0 +1,93 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/information.h"
+#include "common/include/information_decls.h"
+#include "common/include/information_definitions.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using namespace std;
+using namespace mmotd::information;
+
+namespace {
+
+// The chain of compares from_information_id_string used before the perfect hash
+InformationId LegacyFromInformationIdString(const string &id_str) {
+    // clang-format off
+#define INFO_DEF(cat, id_descriptor, name, fmttr, id)                                                                      \
+    if (id_str == BOOST_PP_STRINGIZE(BOOST_PP_CAT(ID_, BOOST_PP_CAT(cat, BOOST_PP_CAT(_, id_descriptor))))) {              \
+        return BOOST_PP_CAT(InformationId::ID_, BOOST_PP_CAT(cat, BOOST_PP_CAT(_, id_descriptor)));                        \
+    }
+#define CATEGORY_INFO_DEF(name, description, value)
+#include "common/include/information_defs.h"
+    // clang-format on
+    return InformationId::ID_INVALID_INVALID_INFORMATION;
+}
+
+// The linear search GetInformationDefinition used before the perfect hash
+optional<Information> LegacyGetInformationDefinition(InformationId id) {
+    const auto &informations = GetInformationList();
+    auto i = find_if(begin(informations), end(informations), [id](const auto &information) {
+        return information.GetId() == id;
+    });
+    return i == end(informations) ? nullopt : optional<Information>{*i};
+}
+
+// Every id of a template, in the order they are rendered, plus a few which are not ids at all
+vector<string> GetIdStrs() {
+    auto id_strs = vector<string>{};
+    for (const auto &definition : INFORMATION_DEFINITIONS) {
+        id_strs.emplace_back(definition.plain_id_str);
+    }
+    id_strs.emplace_back("ID_NOT_AN_INFORMATION");
+    id_strs.emplace_back("ID_WEATHER_WEATHERS");
+    return id_strs;
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("information id lookup", "[Informations][benchmark]") {
+    const auto id_strs = GetIdStrs();
+    for (const auto &id_str : id_strs) {
+        CATCH_CHECK(from_information_id_string(id_str) == LegacyFromInformationIdString(id_str));
+    }
+
+    CATCH_BENCHMARK("string to id: sequential compares") {
+        auto found = size_t{0};
+        for (const auto &id_str : id_strs) {
+            found += LegacyFromInformationIdString(id_str) != InformationId::ID_INVALID_INVALID_INFORMATION;
+        }
+        return found;
+    };
+    CATCH_BENCHMARK("string to id: perfect hash") {
+        auto found = size_t{0};
+        for (const auto &id_str : id_strs) {
+            found += FindInformationId(id_str).has_value();
+        }
+        return found;
+    };
+    CATCH_BENCHMARK("id to definition: linear search") {
+        auto found = size_t{0};
+        for (auto id : INFORMATION_IDS) {
+            found += LegacyGetInformationDefinition(id).has_value();
+        }
+        return found;
+    };
+    CATCH_BENCHMARK("id to definition: perfect hash") {
+        auto found = size_t{0};
+        for (auto id : INFORMATION_IDS) {
+            found += FindInformationDefinition(id) != nullptr;
+        }
+        return found;
+    };
+}
+
+} // namespace mmotd::test
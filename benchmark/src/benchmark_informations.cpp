@@ -0,0 +1,123 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "benchmark/src/allocation_counter.h"
+#include "common/include/information.h"
+#include "common/include/information_decls.h"
+#include "common/include/informations.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+
+using namespace std;
+using namespace mmotd::information;
+
+namespace {
+
+// The store used before the informations were addressed by their dense index
+using MappedInformations = unordered_map<InformationId, vector<Information>>;
+
+constexpr auto REPEATED_INFORMATION_COUNT = size_t{3};
+
+// The category is kept in the high 32 bits of the id, see MakeInformationId
+CategoryId GetCategory(InformationId id) {
+    return static_cast<CategoryId>(static_cast<size_t>(id) & 0xFFFFFFFF00000000);
+}
+
+// One store per category, the way each provider finds the informations of its own category
+template<typename Store, typename Add>
+vector<Store> CollectInformations(Add add) {
+    auto stores = vector<Store>{};
+    auto category = CategoryId::ID_INVALID;
+    for (auto information : GetInformationList()) {
+        if (empty(stores) || GetCategory(information.GetId()) != category) {
+            category = GetCategory(information.GetId());
+            stores.emplace_back();
+        }
+        information.SetValue(fmt::format(FMT_STRING("a value long enough to not fit in {}"), information.GetName()));
+        // the network interfaces are repeated once for every interface
+        auto count = category == CategoryId::ID_NETWORK_INFO ? REPEATED_INFORMATION_COUNT : size_t{1};
+        for (auto i = size_t{0}; i != count; ++i) {
+            add(stores.back(), information);
+        }
+    }
+    return stores;
+}
+
+vector<MappedInformations> CollectMappedInformations() {
+    return CollectInformations<MappedInformations>([](auto &informations, const auto &information) {
+        informations[information.GetId()].push_back(information);
+    });
+}
+
+vector<Informations> CollectIndexedInformations() {
+    return CollectInformations<Informations>([](auto &informations, const auto &information) {
+        informations.push_back(information);
+    });
+}
+
+// Merges the stores by value, then hands them to the output the way PrintMmotd and OutputTemplateWriter did
+size_t RenderMappedInformations(const vector<MappedInformations> &stores) {
+    auto merged = MappedInformations{};
+    for (const auto &informations : stores) {
+        for (auto [id, infos] : informations) {
+            if (!merged.contains(id)) {
+                merged.emplace(id, move(infos));
+            } else {
+                auto &existing_infos = merged.at(id);
+                copy(begin(infos), end(infos), back_inserter(existing_infos));
+            }
+        }
+    }
+    auto printed = merged;
+    auto written = printed;
+    return size(written);
+}
+
+size_t RenderIndexedInformations(const vector<Informations> &stores) {
+    auto merged = InformationsView{};
+    for (const auto &informations : stores) {
+        merged.Merge(informations);
+    }
+    const auto &printed = merged;
+    auto written = InformationsView{printed};
+    return size(written);
+}
+
+void PrintAllocations(string_view name, const mmotd::benchmark::AllocationCount &count) {
+    fmt::print(FMT_STRING("{:<40} {:>6} allocations {:>9} bytes\n"), name, count.allocations, count.bytes);
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("informations store allocations", "[Informations][benchmark]") {
+    using mmotd::benchmark::CountAllocations;
+    auto mapped_stores = vector<MappedInformations>{};
+    auto indexed_stores = vector<Informations>{};
+    auto mapped_collect = CountAllocations([&mapped_stores]() { mapped_stores = CollectMappedInformations(); });
+    auto indexed_collect = CountAllocations([&indexed_stores]() { indexed_stores = CollectIndexedInformations(); });
+    auto mapped_render = CountAllocations([&mapped_stores]() { RenderMappedInformations(mapped_stores); });
+    auto indexed_render = CountAllocations([&indexed_stores]() { RenderIndexedInformations(indexed_stores); });
+
+    PrintAllocations("collect: unordered_map<id, vector>", mapped_collect);
+    PrintAllocations("collect: Informations", indexed_collect);
+    PrintAllocations("merge and render: unordered_map<id, vector>", mapped_render);
+    PrintAllocations("merge and render: InformationsView", indexed_render);
+    CATCH_CHECK(indexed_render.allocations == 0);
+    CATCH_CHECK(indexed_collect.allocations < mapped_collect.allocations);
+
+    CATCH_BENCHMARK("collect: unordered_map<id, vector>") { return CollectMappedInformations(); };
+    CATCH_BENCHMARK("collect: Informations") { return CollectIndexedInformations(); };
+    CATCH_BENCHMARK("merge and render: unordered_map<id, vector>") { return RenderMappedInformations(mapped_stores); };
+    CATCH_BENCHMARK("merge and render: InformationsView") { return RenderIndexedInformations(indexed_stores); };
+}
+
+} // namespace mmotd::test
@@ -0,0 +1,93 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#if !defined(_WIN32)
+#include "lib/include/external_network.h"
+#include "lib/include/information_provider.h"
+#include "lib/include/weather_info.h"
+#include "lib/test/src/local_http_server.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+
+using namespace std;
+
+namespace {
+
+constexpr auto LOOKUP_COUNT = size_t{100};
+
+// Times the whole provider path, the request, the parsing and the creation of the informations
+void PrintLatencies(string_view name, mmotd::information::InformationProvider &provider) {
+    auto latencies = vector<chrono::microseconds>{};
+    latencies.reserve(LOOKUP_COUNT);
+    auto found = size_t{0};
+    for (auto i = size_t{0}; i != LOOKUP_COUNT; ++i) {
+        auto start = chrono::steady_clock::now();
+        provider.LookupInformation();
+        latencies.push_back(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start));
+        found += !empty(provider.GetInformations());
+    }
+    sort(begin(latencies), end(latencies));
+    auto percentile = [&latencies](size_t p) {
+        return static_cast<double>(latencies[(size(latencies) - 1) * p / 100].count()) / 1000.0;
+    };
+    fmt::print(FMT_STRING("{:<40} p50 {:>8.2f}ms  p99 {:>8.2f}ms  {:>3}/{} found informations\n"),
+               name,
+               percentile(50),
+               percentile(99),
+               found,
+               LOOKUP_COUNT);
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("web service providers", "[network_providers][benchmark]") {
+    using namespace mmotd::information;
+    auto response = LocalHttpResponse{};
+    auto server = LocalHttpServer{[&response](string_view) { return response; }};
+    UseLocalEndpoint(server);
+    auto external_network = ExternalNetwork{};
+    auto weather_info = WeatherInfo{};
+
+    response.body = IPINFO_RESPONSE;
+    PrintLatencies("external network", external_network);
+    CATCH_BENCHMARK("web service providers: external network") {
+        external_network.LookupInformation();
+        return size(external_network.GetInformations());
+    };
+
+    response.body = WTTR_RESPONSE;
+    PrintLatencies("weather", weather_info);
+    CATCH_BENCHMARK("web service providers: weather") {
+        weather_info.LookupInformation();
+        return size(weather_info.GetInformations());
+    };
+
+    response.latency = chrono::milliseconds{20};
+    PrintLatencies("weather, 20ms latency", weather_info);
+
+    response.latency = chrono::milliseconds{0};
+    response.chunk_size = 8;
+    response.chunk_delay = chrono::milliseconds{2};
+    PrintLatencies("weather, slow body (8 bytes every 2ms)", weather_info);
+
+    response.chunk_size = 0;
+    response.chunk_delay = chrono::milliseconds{0};
+    response.body = HTML_ERROR_PAGE;
+    PrintLatencies("weather, html error page", weather_info);
+
+    response.status_code = 503;
+    response.body.clear();
+    PrintLatencies("weather, 503 service unavailable", weather_info);
+    CATCH_CHECK(empty(weather_info.GetInformations()));
+}
+
+} // namespace mmotd::test
+#endif
@@ -0,0 +1,77 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#if !defined(_WIN32)
+#include "benchmark/src/allocation_counter.h"
+#include "common/include/system_command.h"
+
+#include <filesystem>
+#include <future>
+#include <string>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/process.hpp>
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr auto ECHO_PATH = "/bin/echo";
+
+// The boost::process runner which mmotd::system::command::Run replaced, kept here as the baseline
+string RunBoostProcess(const fs::path &exe_path, const vector<string> &args) {
+    namespace bp = boost::process;
+    namespace io = boost::asio;
+    auto exit_code = std::future<int>{};
+    auto data = std::future<std::string>{};
+    auto error = std::future<std::string>{};
+    auto io_service = io::io_service{};
+    auto child_process = bp::child(exe_path.string(),
+                                   bp::args(args),
+                                   bp::std_in.close(),
+                                   bp::std_out > data,
+                                   bp::std_err > error,
+                                   bp::on_exit = exit_code,
+                                   io_service);
+    io_service.run();
+    exit_code.get();
+    error.get();
+    return data.get();
+}
+
+string RunPosixSpawn(const fs::path &exe_path, const vector<string> &args) {
+    return mmotd::system::command::Execute(mmotd::system::command::Command{exe_path, args}).output;
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("system command", "[system_command][benchmark]") {
+    using mmotd::benchmark::CountAllocations;
+    auto args = vector<string>{"hello"};
+    CATCH_CHECK(RunPosixSpawn(ECHO_PATH, args) == "hello\n");
+    CATCH_CHECK(RunBoostProcess(ECHO_PATH, args) == "hello\n");
+
+    auto spawn_allocations = CountAllocations([&args]() { RunPosixSpawn(ECHO_PATH, args); });
+    auto boost_allocations = CountAllocations([&args]() { RunBoostProcess(ECHO_PATH, args); });
+    fmt::print(FMT_STRING("posix_spawn:    {} allocations, {} bytes\n"),
+               spawn_allocations.allocations,
+               spawn_allocations.bytes);
+    fmt::print(FMT_STRING("boost::process: {} allocations, {} bytes\n"),
+               boost_allocations.allocations,
+               boost_allocations.bytes);
+
+    CATCH_BENCHMARK("system command: posix_spawn") { return RunPosixSpawn(ECHO_PATH, args); };
+    CATCH_BENCHMARK("system command: boost::process") { return RunBoostProcess(ECHO_PATH, args); };
+
+    auto commands = vector<mmotd::system::command::Command>(4, mmotd::system::command::Command{ECHO_PATH, args});
+    CATCH_BENCHMARK("system command: 4 commands with ExecuteAll") {
+        return mmotd::system::command::ExecuteAll(commands);
+    };
+}
+
+} // namespace mmotd::test
+#endif
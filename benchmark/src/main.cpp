@@ -0,0 +1,20 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#define CATCH_CONFIG_RUNNER
+#include "common/assertion/include/assertion.h"
+#include "common/include/logging.h"
+
+#include <clocale>
+#include <string_view>
+
+#include <catch2/catch.hpp>
+
+using std::string_view;
+
+int main(int argc, char *argv[]) {
+    setlocale(LC_ALL, "en_US.UTF-8");
+    auto program_name = argv != nullptr && *argv != nullptr ? string_view(*argv) : string_view{};
+    auto initilized = mmotd::logging::InitializeLogging(program_name);
+    CHECKS(initilized, "unable to initialize logging");
+
+    return Catch::Session().run(argc, argv);
+}
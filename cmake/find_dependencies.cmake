@@ -20,7 +20,7 @@ endif ()
 find_package(Threads REQUIRED)
 find_package(ZLIB 1.2.11 REQUIRED)
 find_package(Boost 1.71.0 REQUIRED)
-find_package(CURL 7.63.0 REQUIRED)
+find_package(CURL 7.68.0 REQUIRED)
 
 Include(FetchContent)
 
@@ -272,7 +272,7 @@ macro (setup_target_properties MMOTD_TARTET_NAME PROJECT_ROOT_INCLUDE_PATH)
         PRIVATE ${scope_guard_SOURCE_DIR}
         PRIVATE ${toml11_SOURCE_DIR}
         PRIVATE ${utfcpp_SOURCE_DIR}/source
-        PRIVATE $<$<AND:$<STREQUAL:"${target_type}","executable">,$<STREQUAL:"${MMOTD_TARGET_NAME}","mmotd_test">>:${catch2_SOURCE_DIR}/single_include>
+        PRIVATE $<$<AND:$<STREQUAL:"${target_type}","executable">,$<OR:$<STREQUAL:"${MMOTD_TARGET_NAME}","mmotd_test">,$<STREQUAL:"${MMOTD_TARGET_NAME}","mmotd_benchmark">>>:${catch2_SOURCE_DIR}/single_include>
         )
 
     if (target_type STREQUAL "executable")
@@ -311,7 +311,7 @@ macro (setup_target_properties MMOTD_TARTET_NAME PROJECT_ROOT_INCLUDE_PATH)
             PRIVATE $<$<PLATFORM_ID:Darwin>:${FWCoreFoundation}>
             PRIVATE $<$<PLATFORM_ID:Darwin>:${FWSecurity}>
             PRIVATE $<$<PLATFORM_ID:Darwin>:${FWIOKit}>
-            PRIVATE $<$<STREQUAL:"${MMOTD_TARGET_NAME}","mmotd_test">:Catch2::Catch2>
+            PRIVATE $<$<OR:$<STREQUAL:"${MMOTD_TARGET_NAME}","mmotd_test">,$<STREQUAL:"${MMOTD_TARGET_NAME}","mmotd_benchmark">>:Catch2::Catch2>
             PRIVATE Threads::Threads
             PRIVATE ${CMAKE_DL_LIBS}
             )
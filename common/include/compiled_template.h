@@ -0,0 +1,130 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#include "common/include/information_decls.h"
+#include "common/include/template_column_items.h"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/color.h>
+
+namespace mmotd::output_template {
+
+class OutputTemplate;
+struct TemplateRecords;
+
+// Either literal text or a %ID_...% slot, whose text is the token itself so a slot without an information is left
+//  as it was written.  A slot with an unknown id never resolves.
+struct TemplateSegment {
+    std::string_view text;
+    mmotd::information::InformationId id = mmotd::information::InformationId::ID_INVALID_INVALID_INFORMATION;
+    bool is_slot = false;
+};
+
+using CompiledString = std::span<const TemplateSegment>;
+
+// The color of a %color:...% specification embedded in a name or value
+struct TemplateColor {
+    std::string_view name;
+    fmt::text_style style;
+};
+
+inline constexpr auto DEFAULT_NAME_COLOR =
+    std::array{fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_cyan)};
+inline constexpr auto DEFAULT_VALUE_COLOR =
+    std::array{fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_white)};
+
+// A TemplateItemSettings with its strings split into segments, the same defaults apply
+struct CompiledItem {
+    int indent_size = DEFAULT_INDENT_SIZE;
+    int column = ENTIRE_LINE;
+    int prepend_newlines = 0;
+    int append_newlines = 1;
+    bool is_repeatable = false;
+    bool is_optional = false;
+    std::span<const CompiledString> name = {};
+    std::span<const fmt::text_style> name_color = DEFAULT_NAME_COLOR;
+    std::span<const CompiledString> value = {};
+    std::span<const fmt::text_style> value_color = DEFAULT_VALUE_COLOR;
+};
+
+// Everything the writer needs from a template, as spans which point either into static tables (the builtin template)
+//  or into the storage of a CompiledTemplate
+struct CompiledTemplateView {
+    std::span<const int> columns;
+    bool collapse_column_rows = true;
+    std::string_view table_type;
+    std::span<const CompiledItem> items;
+    std::span<const TemplateColor> colors;
+};
+
+//
+// An output template which has been parsed, validated and split up once: the colors are text styles, every %ID_...%
+//  token is a slot holding its id and every %color:...% specification has its text style.  Rendering does no JSON
+//  parsing, regex matching or color string parsing.
+//
+// A template file is compiled the first time it is used and cached in $XDG_CACHE_HOME/mmotd/template, keyed by the
+//  path, size and modification time of the file and the mmotd version (the ids are only valid for one version).
+//  The builtin template is compiled by the compiler, it is a table of constants.
+//
+// Cache layout (native byte order):
+//  TemplateCacheHeader | int32 columns | TemplateStyleRecord styles | TemplateSegmentRecord segments |
+//  TemplateRange strings | TemplateItemRecord items | TemplateColorRecord colors | text pool
+//
+class CompiledTemplate {
+public:
+    ~CompiledTemplate() = default;
+    CompiledTemplate(const CompiledTemplate &other) = delete;
+    CompiledTemplate &operator=(const CompiledTemplate &other) = delete;
+    // The spans point into heap storage which moves along with it
+    CompiledTemplate(CompiledTemplate &&other) noexcept = default;
+    CompiledTemplate &operator=(CompiledTemplate &&other) noexcept = default;
+
+    static CompiledTemplate Compile(const OutputTemplate &output_template);
+    static CompiledTemplate GetDefault() noexcept;
+
+    // The compiled template from the cache, compiling the template file and caching it when the cache is stale
+    static std::optional<CompiledTemplate> Load(const std::filesystem::path &template_path);
+    static std::filesystem::path GetCachePath(const std::filesystem::path &template_path);
+
+    static std::optional<CompiledTemplate> Read(const std::filesystem::path &cache_path,
+                                                const std::filesystem::path &template_path);
+    bool Write(const std::filesystem::path &cache_path, const std::filesystem::path &template_path) const;
+
+    const CompiledTemplateView &GetView() const noexcept { return view_; }
+    std::vector<int> GetColumns() const;
+
+    // The items as the strings they were compiled from
+    TemplateColumnItems GetColumnItems() const;
+
+    mmotd::information::InformationIds GetReferencedInformationIds() const;
+
+    std::optional<fmt::text_style> FindColor(std::string_view name) const noexcept;
+
+private:
+    explicit CompiledTemplate(CompiledTemplateView view) noexcept : view_(view) {}
+
+    // Builds the storage and the view from the records, false when a range of the records is out of bounds
+    bool Assemble(const TemplateRecords &records);
+
+    CompiledTemplateView view_;
+    std::unique_ptr<char[]> text_pool_;
+    std::vector<int> columns_;
+    std::vector<fmt::text_style> styles_;
+    std::vector<TemplateSegment> segments_;
+    std::vector<CompiledString> strings_;
+    std::vector<CompiledItem> items_;
+    std::vector<TemplateColor> colors_;
+};
+
+std::unique_ptr<CompiledTemplate> MakeCompiledTemplate(std::string file_name);
+std::unique_ptr<CompiledTemplate> MakeCompiledTemplateFromDefault();
+
+} // namespace mmotd::output_template
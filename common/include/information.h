@@ -3,59 +3,65 @@
 #include "common/include/big_five_macros.h"
 #include "common/include/information_decls.h"
 
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
 
 #include <fmt/format.h>
 
 namespace mmotd::information {
 
-enum class CategoryId : size_t;
-enum class InformationId : size_t;
+// The raw value found by a provider, a time point is displayed in the local time zone
+using InformationValue =
+    std::variant<std::string, std::int64_t, std::uint64_t, double, std::chrono::system_clock::time_point>;
 
+// A single value found by a provider.  The id, name and format are not copied into every information, they are
+//  read from its entry in the static INFORMATION_DEFINITIONS table so the information only owns its value.
 class Information {
 public:
     DEFAULT_CONSTRUCTORS_COPY_MOVE_OPERATORS_DESTRUCTOR(Information);
 
-    Information(CategoryId category,
-                InformationId information_id,
-                std::string id_str,
-                std::string name,
-                std::string format_str);
+    explicit Information(const InformationDefinition &definition) noexcept : definition_(&definition) {}
 
     // enum value: InformationId::ID_LOCATION_INFO_TIMEZONE
-    InformationId GetId() const noexcept { return information_id_; }
+    InformationId GetId() const noexcept { return definition_->id; }
     // string: "InformationId::ID_LOCATION_INFO_TIMEZONE"
-    std::string GetIdStr() const noexcept { return id_str_; }
+    std::string_view GetIdStr() const noexcept { return definition_->id_str; }
     // string: "ID_LOCATION_INFO_TIMEZONE"
-    std::string GetPlainIdStr() const noexcept { return id_str_no_namespace_; }
+    std::string_view GetPlainIdStr() const noexcept { return definition_->plain_id_str; }
     // string: "timezone"
-    std::string GetName() const noexcept { return name_; }
+    std::string_view GetName() const noexcept { return definition_->name; }
     // string: "{}" in most all cases -- some floats are formatted as "{:.1f}"
-    std::string GetFormat() const noexcept { return format_str_; }
-    // string: "America/Denver" -- value after looked up via API call and formatted
-    std::string GetValue() const noexcept { return value_; }
+    std::string_view GetFormat() const noexcept { return definition_->format_str; }
+    // string: "America/Denver" -- the raw value formatted with the format of the definition
+    std::string GetValue() const;
+    const InformationValue &GetRawValue() const noexcept { return value_; }
 
-    void SetName(const std::string &new_name) { name_ = new_name; }
-
-    void SetValue(std::string new_value) { value_ = new_value; }
-
-    template<typename... Args>
-    void SetValueArgs(Args &&...args) {
-        SetValueImpl(std::string_view(format_str_), fmt::format_arg_store<fmt::format_context, Args...>(args...));
+    // The value is kept as it is and only formatted when the output asks for it
+    template<typename T>
+    void SetValue(T new_value) {
+        static_assert(!std::is_same_v<T, bool>, "a bool needs to be turned into the text which is displayed");
+        if constexpr (std::is_floating_point_v<T>) {
+            value_ = static_cast<double>(new_value);
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            value_ = static_cast<std::int64_t>(new_value);
+        } else if constexpr (std::is_integral_v<T>) {
+            value_ = static_cast<std::uint64_t>(new_value);
+        } else if constexpr (std::is_same_v<T, std::chrono::system_clock::time_point>) {
+            value_ = new_value;
+        } else {
+            value_ = std::string{std::move(new_value)};
+        }
     }
 
 private:
-    void SetValueImpl(fmt::string_view format, fmt::format_args args) { value_ = fmt::vformat(format, args); }
-
-    CategoryId category_ = CategoryId::ID_INVALID;
-    InformationId information_id_ = InformationId::ID_INVALID_INVALID_INFORMATION;
-    std::string id_str_;
-    std::string id_str_no_namespace_;
-    std::string name_;
-    std::string format_str_;
-    std::string value_;
+    const InformationDefinition *definition_ = &INVALID_INFORMATION_DEFINITION;
+    InformationValue value_;
 };
 
 } // namespace mmotd::information
@@ -1,9 +1,15 @@
 // vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
 #pragma once
+#include "common/include/perfect_hash.h"
+
+#include <array>
 #include <cstdlib>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -54,12 +60,118 @@ enum class InformationId : std::size_t {
 };
 // clang-format on
 
+// clang-format off
+// Dense index of every information, in the order of information_defs.h, used to address the informations by array
+enum class InformationIndex : std::size_t {
+#define INFO_DEF(cat, id_descriptor, name, fmttr, id)                                                                  \
+    BOOST_PP_CAT(ID_, BOOST_PP_CAT(cat, BOOST_PP_CAT(_, id_descriptor))),
+#define CATEGORY_INFO_DEF(name, description, value)
+#include "common/include/information_defs.h"
+    INFORMATION_COUNT
+};
+// clang-format on
+
+inline constexpr std::size_t INFORMATION_COUNT = static_cast<std::size_t>(InformationIndex::INFORMATION_COUNT);
+
+// clang-format off
+inline constexpr std::array<InformationId, INFORMATION_COUNT> INFORMATION_IDS = {
+#define INFO_DEF(cat, id_descriptor, name, fmttr, id)                                                                  \
+    BOOST_PP_CAT(InformationId::ID_, BOOST_PP_CAT(cat, BOOST_PP_CAT(_, id_descriptor))),
+#define CATEGORY_INFO_DEF(name, description, value)
+#include "common/include/information_defs.h"
+};
+// clang-format on
+
+// The static metadata of an information, every Information points at one entry of INFORMATION_DEFINITIONS
+struct InformationDefinition {
+    CategoryId category;
+    // enum value: InformationId::ID_LOCATION_INFO_TIMEZONE
+    InformationId id;
+    // string: "InformationId::ID_LOCATION_INFO_TIMEZONE"
+    std::string_view id_str;
+    // string: "ID_LOCATION_INFO_TIMEZONE"
+    std::string_view plain_id_str;
+    // string: "timezone"
+    std::string_view name;
+    // string: "{}" in most all cases -- some floats are formatted as "{:.1f}"
+    std::string_view format_str;
+};
+
+inline constexpr auto INVALID_INFORMATION_DEFINITION =
+    InformationDefinition{CategoryId::ID_INVALID,
+                          InformationId::ID_INVALID_INVALID_INFORMATION,
+                          "InformationId::ID_INVALID_INVALID_INFORMATION",
+                          "ID_INVALID_INVALID_INFORMATION",
+                          "",
+                          "{}"};
+
+// clang-format off
+// Addressed by the dense index of the id, see ToInformationIndex
+inline constexpr std::array<InformationDefinition, INFORMATION_COUNT> INFORMATION_DEFINITIONS = {
+#define INFO_DEF(cat, id_descriptor, name, fmttr, id)                                                                  \
+    InformationDefinition{BOOST_PP_CAT(CategoryId::ID_, cat),                                                          \
+                          BOOST_PP_CAT(InformationId::ID_, BOOST_PP_CAT(cat, BOOST_PP_CAT(_, id_descriptor))),         \
+                          BOOST_PP_STRINGIZE(BOOST_PP_CAT(InformationId::ID_,                                          \
+                                                          BOOST_PP_CAT(cat, BOOST_PP_CAT(_, id_descriptor)))),         \
+                          BOOST_PP_STRINGIZE(BOOST_PP_CAT(ID_, BOOST_PP_CAT(cat, BOOST_PP_CAT(_, id_descriptor)))),    \
+                          name,                                                                                        \
+                          fmttr},
+#define CATEGORY_INFO_DEF(name, description, value)
+#include "common/include/information_defs.h"
+};
+// clang-format on
+
+namespace detail {
+
+// Enough slots that a seed without collisions is found after a handful of tries
+inline constexpr std::size_t INFORMATION_HASH_SLOT_COUNT = 1024;
+
+constexpr std::array<std::string_view, INFORMATION_COUNT> GetPlainIdStrs() noexcept {
+    auto plain_id_strs = std::array<std::string_view, INFORMATION_COUNT>{};
+    for (auto index = std::size_t{0}; index != INFORMATION_COUNT; ++index) {
+        plain_id_strs[index] = INFORMATION_DEFINITIONS[index].plain_id_str;
+    }
+    return plain_id_strs;
+}
+
+inline constexpr auto INFORMATION_ID_HASH =
+    mmotd::algorithms::PerfectHash<InformationId, mmotd::algorithms::IntegerHasher, INFORMATION_COUNT,
+                                   INFORMATION_HASH_SLOT_COUNT>{INFORMATION_IDS};
+
+inline constexpr auto PLAIN_ID_STR_HASH =
+    mmotd::algorithms::PerfectHash<std::string_view, mmotd::algorithms::StringHasher, INFORMATION_COUNT,
+                                   INFORMATION_HASH_SLOT_COUNT>{GetPlainIdStrs()};
+
+} // namespace detail
+
+// Returns the dense index of the id, nullopt for ID_INVALID_INVALID_INFORMATION (or any value not in the enum)
+constexpr std::optional<std::size_t> ToInformationIndex(InformationId id) noexcept {
+    auto index = detail::INFORMATION_ID_HASH.Find(id);
+    return index && INFORMATION_IDS[*index] == id ? index : std::nullopt;
+}
+
+// Returns nullptr when the id is not in information_defs.h
+constexpr const InformationDefinition *FindInformationDefinition(InformationId id) noexcept {
+    auto index = ToInformationIndex(id);
+    return index ? &INFORMATION_DEFINITIONS[*index] : nullptr;
+}
+
+// Finds the id of a plain id string ("ID_LOCATION_INFO_TIMEZONE"), nullopt when there is no such id
+constexpr std::optional<InformationId> FindInformationId(std::string_view plain_id_str) noexcept {
+    auto index = detail::PLAIN_ID_STR_HASH.Find(plain_id_str);
+    if (!index || INFORMATION_DEFINITIONS[*index].plain_id_str != plain_id_str) {
+        return std::nullopt;
+    }
+    return INFORMATION_IDS[*index];
+}
+
 class Information;
-using Informations = std::unordered_map<InformationId, std::vector<Information>>;
+class Informations;
+using InformationIds = std::unordered_set<InformationId>;
 const Informations &GetInformations();
 const std::vector<Information> &GetInformationList();
 
-InformationId from_information_id_string(std::string id_str);
+InformationId from_information_id_string(std::string_view id_str);
 std::string to_string(InformationId id);
 
 using CategoryIds = std::vector<std::pair<CategoryId, std::string>>;
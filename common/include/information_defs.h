@@ -80,6 +80,8 @@ INFO_DEF(WEATHER, WEATHER, "weather", "{}", 15001)
 INFO_DEF(WEATHER, LOCATION, "weather location", "{}", 15002)
 INFO_DEF(WEATHER, SUNRISE, "sunrise", "{}", 15003)
 INFO_DEF(WEATHER, SUNSET, "sunset", "{}", 15004)
+INFO_DEF(WEATHER, CIVIL_DAWN, "civil dawn", "{}", 15005)
+INFO_DEF(WEATHER, CIVIL_DUSK, "civil dusk", "{}", 15006)
 
 INFO_DEF(PACKAGE_MANAGEMENT, UPDATE_DETAILS, "", "{}", 16001)
 INFO_DEF(PACKAGE_MANAGEMENT, REBOOT_REQUIRED, "", "{}", 16002)
@@ -94,6 +96,8 @@ INFO_DEF(HARDWARE, MONITOR_NAME, "monitor", "{}", 17007)
 INFO_DEF(HARDWARE, MONITOR_RESOLUTION, "resolution", "{}", 17008)
 INFO_DEF(HARDWARE, CPU_TEMPERATURE, "cpu temperature", "{}", 17009)
 INFO_DEF(HARDWARE, GPU_TEMPERATURE, "gpu temperature", "{}", 17010)
+INFO_DEF(HARDWARE, CPU_PHYSICAL_CORE_COUNT, "cpu physical core count", "{}", 17011)
+INFO_DEF(HARDWARE, CPU_SOCKET_COUNT, "cpu socket count", "{}", 17012)
 
 #undef INFO_DEF
 #undef CATEGORY_INFO_DEF
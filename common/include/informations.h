@@ -0,0 +1,137 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#include "common/include/information.h"
+#include "common/include/information_decls.h"
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include <boost/container/small_vector.hpp>
+
+namespace mmotd::information {
+
+// Every information with the same id, most ids only ever have a single information so it is stored inline
+using InformationEntries = boost::container::small_vector<Information, 1>;
+
+namespace detail {
+
+// Walks the non-empty entries of an informations store in the order of information_defs.h
+template<typename Store>
+class InformationsIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<InformationId, const InformationEntries &>;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type;
+    using pointer = void;
+
+    InformationsIterator() = default;
+    InformationsIterator(const Store *store, std::size_t index) : store_(store), index_(index) { SkipEmpty(); }
+
+    value_type operator*() const { return value_type{INFORMATION_IDS[index_], *store_->GetEntries(index_)}; }
+
+    InformationsIterator &operator++() {
+        ++index_;
+        SkipEmpty();
+        return *this;
+    }
+
+    InformationsIterator operator++(int) {
+        auto previous = *this;
+        ++(*this);
+        return previous;
+    }
+
+    bool operator==(const InformationsIterator &other) const noexcept { return index_ == other.index_; }
+
+private:
+    void SkipEmpty() {
+        while (index_ < INFORMATION_COUNT && store_->GetEntries(index_) == nullptr) {
+            ++index_;
+        }
+    }
+
+    const Store *store_ = nullptr;
+    std::size_t index_ = INFORMATION_COUNT;
+};
+
+} // namespace detail
+
+// The informations found by the providers, addressed by the dense index of their id.  The entries are allocated in
+//  one block the first time an information is added, an empty store does not allocate at all.
+class Informations {
+public:
+    using const_iterator = detail::InformationsIterator<Informations>;
+
+    Informations() = default;
+    ~Informations() = default;
+    Informations(const Informations &other);
+    Informations &operator=(const Informations &other);
+    // The moved from store is left empty, rather than with a size but without any entries
+    Informations(Informations &&other) noexcept;
+    Informations &operator=(Informations &&other) noexcept;
+
+    // The number of ids which have at least one information
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    bool contains(InformationId id) const noexcept;
+
+    // Returns an empty list when there is no information with this id
+    const InformationEntries &at(InformationId id) const noexcept;
+
+    // The information is appended to the ones which already have the same id
+    void push_back(Information information);
+
+    // Keeps the block of entries so the store can be filled again without allocating it
+    void clear() noexcept;
+
+    const_iterator begin() const { return const_iterator{this, 0}; }
+    const_iterator end() const { return const_iterator{}; }
+
+    // nullptr when there is no information at this index
+    const InformationEntries *GetEntries(std::size_t index) const noexcept;
+
+private:
+    using Entries = std::array<InformationEntries, INFORMATION_COUNT>;
+
+    std::unique_ptr<Entries> entries_;
+    std::size_t size_ = 0;
+};
+
+// A non-owning view of informations which are stored elsewhere, used to hand the informations of every provider to
+//  the output without copying them.  It is only valid while the viewed informations are left unchanged.
+class InformationsView {
+public:
+    using const_iterator = detail::InformationsIterator<InformationsView>;
+
+    InformationsView() = default;
+    // Implicit so anything taking a view can be given the informations themselves
+    InformationsView(const Informations &informations);
+
+    // Adds the entries of `informations` which are not already in the view
+    void Merge(const Informations &informations);
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    bool contains(InformationId id) const noexcept;
+
+    // Returns an empty list when there is no information with this id
+    const InformationEntries &at(InformationId id) const noexcept;
+
+    void clear() noexcept;
+
+    const_iterator begin() const { return const_iterator{this, 0}; }
+    const_iterator end() const { return const_iterator{}; }
+
+    // nullptr when there is no information at this index
+    const InformationEntries *GetEntries(std::size_t index) const noexcept { return entries_[index]; }
+
+private:
+    std::array<const InformationEntries *, INFORMATION_COUNT> entries_ = {};
+    std::size_t size_ = 0;
+};
+
+} // namespace mmotd::information
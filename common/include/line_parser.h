@@ -0,0 +1,48 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace mmotd::core {
+
+// Reads an entire file in one go.  Made for the files in /proc and /sys which report a size of zero, so they can
+//  neither be memory mapped nor sized up front.
+std::optional<std::string> ReadVirtualFile(const std::filesystem::path &file_path);
+
+// Reads a small file such as "/sys/devices/system/cpu/online" into `buffer` without allocating, anything which
+//  does not fit in the buffer is dropped.  The returned view points into `buffer`.
+std::optional<std::string_view> ReadVirtualFile(const std::filesystem::path &file_path, std::span<char> buffer);
+
+// Removes the spaces, tabs, carriage returns and newlines around `str`
+std::string_view TrimBlanks(std::string_view str) noexcept;
+
+// Splits a line such as "model name\t: Intel(R) Core(TM)" at the first separator and trims both parts.  Returns
+//  nullopt when there is no separator.
+std::optional<std::pair<std::string_view, std::string_view>> SplitNameValue(std::string_view line,
+                                                                            char separator = ':') noexcept;
+
+// Calls `function` with each line of `buffer`, without its newline, until it returns false (when it returns bool).
+//  The lines are views into `buffer` so nothing is allocated.
+template<typename Function>
+void ForEachLine(std::string_view buffer, Function &&function) {
+    while (!buffer.empty()) {
+        auto newline = buffer.find('\n');
+        auto line = buffer.substr(0, newline);
+        buffer.remove_prefix(newline == std::string_view::npos ? buffer.size() : newline + 1);
+        if constexpr (std::is_same_v<std::invoke_result_t<Function, std::string_view>, bool>) {
+            if (!function(line)) {
+                return;
+            }
+        } else {
+            function(line);
+        }
+    }
+}
+
+} // namespace mmotd::core
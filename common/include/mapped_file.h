@@ -0,0 +1,88 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mmotd::core {
+
+//
+// A read-only memory mapping of an entire file.  The mapping is released when the object
+//  is destroyed.  A zero length file is a valid mapping with no data.
+//
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile &other) = delete;
+    MappedFile &operator=(const MappedFile &other) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    static std::optional<MappedFile> Open(const std::filesystem::path &file_path);
+
+    const char *data() const noexcept { return static_cast<const char *>(address_); }
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    std::string_view view() const noexcept { return std::string_view{data(), size_}; }
+
+private:
+    MappedFile(void *address, std::size_t size) noexcept;
+
+    void Release() noexcept;
+
+    void *address_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// A record copied out of a mapping, a mapping makes no promise about the alignment of the records in it
+template<typename T>
+T ReadRecord(const char *source) noexcept {
+    static_assert(std::is_trivially_copyable_v<T>, "only a trivially copyable record can be read as it is");
+    auto record = T{};
+    std::memcpy(&record, source, sizeof(T));
+    return record;
+}
+
+// The bytes of a record as it is written to a file and mapped back by `MappedFile`
+template<typename T>
+std::string_view AsBytes(const T &record) noexcept {
+    static_assert(std::is_trivially_copyable_v<T>, "only a trivially copyable record can be written as it is");
+    return std::string_view{reinterpret_cast<const char *>(&record), sizeof(T)};
+}
+
+template<typename T>
+std::string_view AsBytes(std::span<const T> records) noexcept {
+    static_assert(std::is_trivially_copyable_v<T>, "only a trivially copyable record can be written as it is");
+    return std::string_view{reinterpret_cast<const char *>(std::data(records)), std::size(records) * sizeof(T)};
+}
+
+template<typename T>
+std::string_view AsBytes(const std::vector<T> &records) noexcept {
+    return AsBytes(std::span<const T>{records});
+}
+
+//
+// Writes `parts` one after the other to a temporary file next to `file_path` and renames it over `file_path`, so
+//  a concurrent login never maps a partial file.  The temporary file is removed when anything fails.
+//
+bool WriteFileAtomically(const std::filesystem::path &file_path, std::span<const std::string_view> parts);
+
+// FNV-1a, unlike std::hash it is the same in every build so it can name the file a key is cached in
+std::uint64_t HashCacheKey(std::string_view key) noexcept;
+
+// The modification time in ticks of the file clock, which is what a cache records to notice its source changed
+std::optional<std::int64_t> GetModificationTime(const std::filesystem::path &file_path);
+
+// The size and the modification time of a file, both have to match for a cache of it to be current
+std::optional<std::pair<std::uint64_t, std::int64_t>>
+GetSizeAndModificationTime(const std::filesystem::path &file_path);
+
+} // namespace mmotd::core
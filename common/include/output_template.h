@@ -1,6 +1,7 @@
 // vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
 #pragma once
 #include "common/include/big_five_macros.h"
+#include "common/include/information_decls.h"
 #include "common/include/template_column_items.h"
 
 #include <filesystem>
@@ -32,6 +33,9 @@ public:
     // Get the output settings
     const OutputSettings &GetOutputSettings() const;
 
+    // Get every information id referenced by a %ID_...% token in the column items
+    mmotd::information::InformationIds GetReferencedInformationIds() const;
+
     // Serialization to/from JSON
     void from_json(const nlohmann::json &root);
     void to_json(nlohmann::json &root) const;
@@ -1,6 +1,8 @@
 // vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
 #pragma once
+#include "common/include/compiled_template.h"
 #include "common/include/information.h"
+#include "common/include/informations.h"
 #include "common/include/template_column_items.h"
 
 #include <iosfwd>
@@ -16,14 +18,23 @@ class OutputTemplateWriter {
     friend std::ostream &operator<<(std::ostream &os, const OutputTemplateWriter &writer);
 
 public:
+    // The informations are viewed rather than copied, they have to outlive the writer
     OutputTemplateWriter(std::vector<int> column_indexes,
                          mmotd::output_template::TemplateColumnItems items,
-                         mmotd::information::Informations informations);
+                         mmotd::information::InformationsView informations);
+    // The compiled template is viewed as well, its slots are filled in without searching the strings
+    OutputTemplateWriter(const mmotd::output_template::CompiledTemplate &compiled_template,
+                         mmotd::information::InformationsView informations);
+
+    // Whether the output has color, 'core.output_color' unless it is set
+    void SetColorOutput(bool color_output) noexcept { color_output_ = color_output; }
 
 private:
     std::vector<int> column_indexes_;
     mmotd::output_template::TemplateColumnItems items_;
-    mmotd::information::Informations informations_;
+    const mmotd::output_template::CompiledTemplate *compiled_template_ = nullptr;
+    mmotd::information::InformationsView informations_;
+    bool color_output_ = true;
 };
 
 std::string to_string(const OutputTemplateWriter &output);
@@ -0,0 +1,84 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace mmotd::algorithms {
+
+// FNV-1a, with the seed folded into the offset basis
+struct StringHasher {
+    constexpr std::uint64_t operator()(std::string_view str, std::uint64_t seed) const noexcept {
+        auto hash = std::uint64_t{14695981039346656037ull} ^ seed;
+        for (auto ch : str) {
+            hash ^= static_cast<std::uint8_t>(ch);
+            hash *= std::uint64_t{1099511628211ull};
+        }
+        return hash;
+    }
+};
+
+// The splitmix64 finalizer, works for any integer or enum which fits in 64 bits
+struct IntegerHasher {
+    template<typename T>
+    constexpr std::uint64_t operator()(T value, std::uint64_t seed) const noexcept {
+        auto hash = static_cast<std::uint64_t>(value) + seed * std::uint64_t{0x9E3779B97F4A7C15ull};
+        hash = (hash ^ (hash >> 30)) * std::uint64_t{0xBF58476D1CE4E5B9ull};
+        hash = (hash ^ (hash >> 27)) * std::uint64_t{0x94D049BB133111EBull};
+        return hash ^ (hash >> 31);
+    }
+};
+
+// A hash table built at compile time which maps every one of a fixed set of keys to its own slot.  The seed is
+//  searched for until no two keys collide, so a lookup is a single hash and one compare of the key.  The slots
+//  hold the position of the key in the array it was built from.
+template<typename Key, typename Hasher, std::size_t KEY_COUNT, std::size_t SLOT_COUNT>
+class PerfectHash {
+public:
+    static_assert(KEY_COUNT < std::numeric_limits<std::uint8_t>::max(), "slots only hold 8 bit key positions");
+    static_assert(SLOT_COUNT != 0 && (SLOT_COUNT & (SLOT_COUNT - 1)) == 0, "the slot count must be a power of two");
+
+    consteval explicit PerfectHash(const std::array<Key, KEY_COUNT> &keys) {
+        for (seed_ = 0; seed_ != MAX_SEED; ++seed_) {
+            if (TryBuild(keys)) {
+                return;
+            }
+        }
+        throw std::logic_error("no perfect hash found, increase the slot count");
+    }
+
+    // The position of the only key which can be equal to `key`, the caller compares the two keys
+    constexpr std::optional<std::size_t> Find(const Key &key) const noexcept {
+        auto position = slots_[GetSlot(key)];
+        return position == EMPTY_SLOT ? std::nullopt : std::optional<std::size_t>{position};
+    }
+
+private:
+    static constexpr auto EMPTY_SLOT = std::numeric_limits<std::uint8_t>::max();
+    static constexpr auto MAX_SEED = std::uint64_t{4096};
+
+    constexpr std::size_t GetSlot(const Key &key) const noexcept {
+        return static_cast<std::size_t>(Hasher{}(key, seed_) & (SLOT_COUNT - 1));
+    }
+
+    constexpr bool TryBuild(const std::array<Key, KEY_COUNT> &keys) {
+        slots_.fill(EMPTY_SLOT);
+        for (auto position = std::size_t{0}; position != KEY_COUNT; ++position) {
+            auto &slot = slots_[GetSlot(keys[position])];
+            if (slot != EMPTY_SLOT) {
+                return false;
+            }
+            slot = static_cast<std::uint8_t>(position);
+        }
+        return true;
+    }
+
+    std::uint64_t seed_ = 0;
+    std::array<std::uint8_t, SLOT_COUNT> slots_ = {};
+};
+
+} // namespace mmotd::algorithms
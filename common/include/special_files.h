@@ -1,6 +1,8 @@
 // vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
 #pragma once
+#include <cstddef>
 #include <filesystem>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -12,6 +14,8 @@ std::string GetEnvironmentValue(std::string variable_name);
 std::string ExpandEnvironmentVariables(std::string input);
 
 bool IsStdoutTty();
+// The columns of the terminal on stdout or else $COLUMNS, nullopt when neither is known
+std::optional<std::size_t> GetTerminalWidth();
 
 constexpr std::string_view CONFIG_FILENAME = "mmotd_config.toml";
 constexpr std::string_view TEMPLATE_FILENAME = "mmotd_template.json";
@@ -23,6 +27,10 @@ std::filesystem::path FindFileInDefaultLocations(std::string_view file_name);
 std::filesystem::path FindFileInDefaultLocations(std::string file_name);
 std::filesystem::path FindFileInDefaultLocations(std::filesystem::path file_path);
 
+// Returns $XDG_CACHE_HOME/mmotd (or $HOME/.cache/mmotd), creating it when needed.  An empty path is
+//  returned when no cache directory can be used.
+std::filesystem::path GetCacheDirectory();
+
 inline std::filesystem::path FindConfigInDefaultLocations() {
     return FindFileInDefaultLocations(CONFIG_FILENAME);
 }
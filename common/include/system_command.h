@@ -1,5 +1,7 @@
 // vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
 #pragma once
+#include <chrono>
+#include <cstddef>
 #include <filesystem>
 #include <functional>
 #include <optional>
@@ -8,6 +10,37 @@
 
 namespace mmotd::system::command {
 
+// A command which runs longer than this is asked to stop (SIGTERM) and killed (SIGKILL) shortly afterwards
+inline constexpr auto DEFAULT_COMMAND_TIMEOUT = std::chrono::milliseconds{5000};
+// The most output kept from stdout and from stderr, anything more is read and dropped
+inline constexpr auto DEFAULT_OUTPUT_LIMIT = std::size_t{1024 * 1024};
+
+struct Command {
+    std::filesystem::path exe_path;
+    std::vector<std::string> args;
+    std::chrono::milliseconds timeout = DEFAULT_COMMAND_TIMEOUT;
+    std::size_t output_limit = DEFAULT_OUTPUT_LIMIT;
+};
+
+struct CommandResult {
+    // nullopt when the command could not be started or did not exit on its own (i.e. it was killed)
+    std::optional<int> exit_code;
+    std::string output;
+    std::string error;
+    bool timed_out = false;
+    bool truncated = false;
+
+    bool succeeded() const noexcept { return exit_code && *exit_code == 0; }
+};
+
+// Runs the command with posix_spawn, stdin is /dev/null and stdout and stderr are captured through pipes
+CommandResult Execute(const Command &command);
+
+// Starts all of the commands before waiting on any of them, so the total time is that of the slowest command.  The
+//  results are in the order of the commands.
+std::vector<CommandResult> ExecuteAll(const std::vector<Command> &commands);
+
+// The stdout of the command when it exits with 0 and writes something, otherwise the failure is logged
 std::optional<std::string> Run(const std::filesystem::path &exe_path, const std::vector<std::string> &args);
 
 template<class Converter>
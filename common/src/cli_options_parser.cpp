@@ -48,6 +48,9 @@ public:
     filesystem::path GetTemplatePath() const { return template_path_; }
     filesystem::path GetOutputConfigPath() const { return output_config_path_; }
     filesystem::path GetOutputTemplatePath() const { return output_template_path_; }
+    filesystem::path GetSocketPath() const { return socket_path_; }
+    bool IsDaemon() const { return daemon_; }
+    bool IsTimings() const { return timings_; }
 
     bool SetConfigPath(const vector<string> &paths) { return AssignFirst(paths, config_path_, true, false); }
     bool SetTemplatePath(const vector<string> &paths) { return AssignFirst(paths, template_path_, true, false); }
@@ -57,6 +60,9 @@ public:
     bool SetOutputTemplatePath(const vector<string> &paths) {
         return AssignFirst(paths, output_template_path_, false, true);
     }
+    bool SetSocketPath(const vector<string> &paths) { return AssignFirst(paths, socket_path_, false, false); }
+    void SetDaemon() { daemon_ = true; }
+    void SetTimings() { timings_ = true; }
 
 private:
     bool AssignFirst(const vector<string> &values,
@@ -68,6 +74,9 @@ private:
     filesystem::path template_path_;
     filesystem::path output_config_path_;
     filesystem::path output_template_path_;
+    filesystem::path socket_path_;
+    bool daemon_ = false;
+    bool timings_ = false;
 };
 
 bool CliOptions::AssignFirst(const vector<string> &values,
@@ -167,6 +176,20 @@ void CliOptionsParser::AddConfigOptions() const {
     }
     const auto template_path_str = ConfigOptions::Instance().GetString("core.template_path", string{});
     LOG_VERBOSE("post-parsing config template file: '{}'", template_path_str);
+
+    if (auto socket_path = options_->GetSocketPath(); !empty(socket_path)) {
+        LOG_VERBOSE("overriding value for socket_path in config file with: '{}'", socket_path.string());
+        ConfigOptions::Instance().Override("socket_path"s, socket_path.string(), "daemon"s);
+    }
+    if (options_->IsDaemon()) {
+        ConfigOptions::Instance().Override("daemon"s, true, "core"s);
+    }
+    if (options_->IsTimings()) {
+        // a response from the http cache or the snapshot cache would leave nothing to time
+        ConfigOptions::Instance().Override("timings"s, true, "core"s);
+        ConfigOptions::Instance().Override("enabled"s, false, "http_cache"s);
+        ConfigOptions::Instance().Override("enabled"s, false, "cache"s);
+    }
 }
 
 void CliOptionsParser::AddOptionsToSubCommand(CLI::App &app) {
@@ -231,6 +254,33 @@ void CliOptionsParser::AddOptionDeclarations(CLI::App &app) {
         ->envname("MMOTD_TEMPLATE_PATH")
         ->configurable(false);
 
+    app.add_flag_callback(
+           "-d, --daemon",
+           [this]() { options_->SetDaemon(); },
+           mmotd::algorithms::split_sentence(
+               "Run as a resident daemon which serves the pre-rendered output to other instances of mmotd.", 70ull))
+        ->configurable(false);
+
+    app.add_flag_callback(
+           "--timings",
+           [this]() { options_->SetTimings(); },
+           mmotd::algorithms::split_sentence(
+               "Print how long each phase (dns, connect, tls, first byte) of every web service request took. The "
+               "http cache and the snapshot cache are bypassed.",
+               70ull))
+        ->configurable(false);
+
+    app.add_option(
+           "-s, --socket",
+           [this](auto &&paths) { return options_->SetSocketPath(forward<decltype(paths)>(paths)); },
+           mmotd::algorithms::split_sentence(
+               "Path of the unix domain socket used to communicate with the daemon. Default is "
+               "'$XDG_RUNTIME_DIR/mmotd.sock'.",
+               70ull))
+        ->required(false)
+        ->envname("MMOTD_SOCKET_PATH")
+        ->configurable(false);
+
     AddOptionsToSubCommand(app);
 }
 
@@ -0,0 +1,757 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/compiled_template.h"
+#include "common/include/logging.h"
+#include "common/include/mapped_file.h"
+#include "common/include/output_template.h"
+#include "common/include/special_files.h"
+#include "common/include/version.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fmt/color.h>
+#include <fmt/format.h>
+
+namespace fs = std::filesystem;
+using fmt::format;
+using mmotd::information::InformationId;
+using namespace std;
+
+namespace {
+
+using mmotd::output_template::CompiledItem;
+using mmotd::output_template::CompiledString;
+using mmotd::output_template::CompiledTemplateView;
+using mmotd::output_template::ENTIRE_LINE;
+using mmotd::output_template::TemplateColor;
+using mmotd::output_template::TemplateSegment;
+
+// Calls `add_segment` with each literal text and %ID_...% slot of `text`, the slots are the matches of the regex
+//  %(ID_[_A-Z]+)% which the writer used to search for.  It is constexpr so the builtin template is split up by the
+//  compiler.
+template<typename AddSegment>
+constexpr void ForEachTemplateSegment(string_view text, AddSegment add_segment) {
+    constexpr auto SLOT_PREFIX = string_view{"%ID_"};
+    auto literal_start = size_t{0};
+    auto pos = text.find(SLOT_PREFIX);
+    while (pos != string_view::npos) {
+        auto slot_end = pos + size(SLOT_PREFIX);
+        while (slot_end != size(text) && (text[slot_end] == '_' || (text[slot_end] >= 'A' && text[slot_end] <= 'Z'))) {
+            ++slot_end;
+        }
+        if (slot_end == pos + size(SLOT_PREFIX) || slot_end == size(text) || text[slot_end] != '%') {
+            pos = text.find(SLOT_PREFIX, pos + 1);
+            continue;
+        }
+        if (pos != literal_start) {
+            add_segment(TemplateSegment{text.substr(literal_start, pos - literal_start)});
+        }
+        auto token = text.substr(pos, slot_end + 1 - pos);
+        auto id = mmotd::information::FindInformationId(token.substr(1, size(token) - 2));
+        add_segment(TemplateSegment{token, id.value_or(InformationId::ID_INVALID_INVALID_INFORMATION), true});
+        literal_start = slot_end + 1;
+        pos = text.find(SLOT_PREFIX, literal_start);
+    }
+    if (literal_start != size(text)) {
+        add_segment(TemplateSegment{text.substr(literal_start)});
+    }
+}
+
+constexpr size_t CountTemplateSegments(string_view text) {
+    auto count = size_t{0};
+    ForEachTemplateSegment(text, [&count](const TemplateSegment &) { ++count; });
+    return count;
+}
+
+// A string literal as a template argument, so the segments of each builtin string are a constant of their own
+template<size_t N>
+struct TemplateText {
+    consteval TemplateText(const char (&text)[N]) { copy_n(text, N, begin(chars)); }
+    constexpr string_view view() const noexcept { return string_view{data(chars), N - 1}; }
+
+    array<char, N> chars = {};
+};
+
+template<TemplateText TEXT>
+consteval auto TokenizeTemplateText() {
+    auto segments = array<TemplateSegment, CountTemplateSegments(TEXT.view())>{};
+    auto index = size_t{0};
+    ForEachTemplateSegment(TEXT.view(), [&segments, &index](const TemplateSegment &segment) {
+        segments[index++] = segment;
+    });
+    return segments;
+}
+
+template<TemplateText TEXT>
+inline constexpr auto TEMPLATE_SEGMENTS = TokenizeTemplateText<TEXT>();
+
+template<TemplateText... TEXTS>
+inline constexpr auto TEMPLATE_STRINGS =
+    array<CompiledString, sizeof...(TEXTS)>{CompiledString{TEMPLATE_SEGMENTS<TEXTS>}...};
+
+constexpr fmt::text_style Bold(fmt::terminal_color color) {
+    return fmt::emphasis::bold | fmt::fg(color);
+}
+
+inline constexpr auto BOLD_BRIGHT_GREEN = array{Bold(fmt::terminal_color::bright_green)};
+inline constexpr auto BOLD_BRIGHT_YELLOW = array{Bold(fmt::terminal_color::bright_yellow)};
+inline constexpr auto BOLD_BRIGHT_RED = array{Bold(fmt::terminal_color::bright_red)};
+inline constexpr auto BOLD_BRIGHT_CYAN_2 = array{Bold(fmt::terminal_color::bright_cyan),
+                                                 Bold(fmt::terminal_color::bright_cyan)};
+inline constexpr auto BOLD_BRIGHT_WHITE_2 = array{Bold(fmt::terminal_color::bright_white),
+                                                  Bold(fmt::terminal_color::bright_white)};
+inline constexpr auto BOLD_BRIGHT_CYAN_3 = array{Bold(fmt::terminal_color::bright_cyan),
+                                                 Bold(fmt::terminal_color::bright_cyan),
+                                                 Bold(fmt::terminal_color::bright_cyan)};
+inline constexpr auto LAST_LOGIN_VALUE_COLOR = array{Bold(fmt::terminal_color::bright_white),
+                                                     Bold(fmt::terminal_color::bright_green),
+                                                     Bold(fmt::terminal_color::bright_green)};
+
+// clang-format off
+// The builtin template, the items of OutputTemplate::GetDefaultColumnItems are made from it
+inline constexpr auto DEFAULT_ITEMS = array{
+    CompiledItem{
+        .indent_size = 0,
+        .append_newlines = 2,
+        .value = TEMPLATE_STRINGS<"%ID_GENERAL_GREETING%, %ID_GENERAL_USER_NAME%! %ID_GENERAL_LOCAL_TIME_EMOJI% Welcome to %ID_SYSTEM_INFORMATION_PLATFORM_NAME% %ID_SYSTEM_INFORMATION_PLATFORM_VERSION% (%ID_SYSTEM_INFORMATION_KERNEL_TYPE% %ID_SYSTEM_INFORMATION_KERNEL_RELEASE% %ID_SYSTEM_INFORMATION_ARCHITECTURE%)">,
+        .value_color = BOLD_BRIGHT_GREEN},
+    CompiledItem{
+        .append_newlines = 2,
+        .value = TEMPLATE_STRINGS<"System information as of %ID_GENERAL_LOCAL_DATE_TIME%">,
+        .value_color = BOLD_BRIGHT_YELLOW},
+    CompiledItem{
+        .name = TEMPLATE_STRINGS<"%ID_WEATHER_LOCATION%:">,
+        .value = TEMPLATE_STRINGS<"%ID_WEATHER_WEATHER%, %color:bold_bright_green%Sunrise:%color:bold_bright_white% %ID_WEATHER_SUNRISE%, %color:bold_bright_green%Sunset:%color:bold_bright_white% %ID_WEATHER_SUNSET%">},
+    CompiledItem{
+        .name = TEMPLATE_STRINGS<"Last Login:", "", "">,
+        .name_color = BOLD_BRIGHT_CYAN_3,
+        .value = TEMPLATE_STRINGS<"%ID_LAST_LOGIN_LOGIN_SUMMARY%",
+                                  "Log in: %color:bold_bright_white%%ID_LAST_LOGIN_LOGIN_TIME%",
+                                  "Log out: %color:bold_bright_white%%ID_LAST_LOGIN_LOGOUT_TIME%">,
+        .value_color = LAST_LOGIN_VALUE_COLOR},
+    CompiledItem{.name = TEMPLATE_STRINGS<"Up Time:">, .value = TEMPLATE_STRINGS<"%ID_BOOT_TIME_UP_TIME%">},
+    CompiledItem{
+        .append_newlines = 2,
+        .name = TEMPLATE_STRINGS<"Boot Time:">,
+        .value = TEMPLATE_STRINGS<"%ID_BOOT_TIME_BOOT_TIME%">},
+    // Hardware specific
+    CompiledItem{.name = TEMPLATE_STRINGS<"Type:">, .value = TEMPLATE_STRINGS<"%ID_HARDWARE_MACHINE_TYPE%">},
+    CompiledItem{.name = TEMPLATE_STRINGS<"Model:">, .value = TEMPLATE_STRINGS<"%ID_HARDWARE_MACHINE_MODEL%">},
+    CompiledItem{.name = TEMPLATE_STRINGS<"CPU:">, .value = TEMPLATE_STRINGS<"%ID_HARDWARE_CPU_NAME%">},
+    CompiledItem{
+        .name = TEMPLATE_STRINGS<"CPU Cores:">,
+        .value = TEMPLATE_STRINGS<"%ID_HARDWARE_CPU_CORE_COUNT% (%ID_HARDWARE_CPU_BYTE_ORDER%)">},
+    CompiledItem{
+        .name = TEMPLATE_STRINGS<"CPU Temperature:">,
+        .value = TEMPLATE_STRINGS<"%ID_HARDWARE_CPU_TEMPERATURE%">},
+    CompiledItem{.name = TEMPLATE_STRINGS<"GPU:">, .value = TEMPLATE_STRINGS<"%ID_HARDWARE_GPU_MODEL_NAME%">},
+    CompiledItem{
+        .name = TEMPLATE_STRINGS<"GPU Temperature:">,
+        .value = TEMPLATE_STRINGS<"%ID_HARDWARE_GPU_TEMPERATURE%">},
+    CompiledItem{.name = TEMPLATE_STRINGS<"Monitor:">, .value = TEMPLATE_STRINGS<"%ID_HARDWARE_MONITOR_NAME%">},
+    CompiledItem{
+        .append_newlines = 2,
+        .name = TEMPLATE_STRINGS<"Resolution:">,
+        .value = TEMPLATE_STRINGS<"%ID_HARDWARE_MONITOR_RESOLUTION%">},
+    // The rest of the information
+    CompiledItem{
+        .name = TEMPLATE_STRINGS<"Computer Name:">,
+        .value = TEMPLATE_STRINGS<"%ID_SYSTEM_INFORMATION_COMPUTER_NAME%">},
+    CompiledItem{.name = TEMPLATE_STRINGS<"Hostname:">, .value = TEMPLATE_STRINGS<"%ID_SYSTEM_INFORMATION_HOST_NAME%">},
+    CompiledItem{
+        .name = TEMPLATE_STRINGS<"Public IP:">,
+        .value = TEMPLATE_STRINGS<"%ID_EXTERNAL_NETWORK_INFO_EXTERNAL_IP%">},
+    CompiledItem{
+        .name = TEMPLATE_STRINGS<"System Load:">,
+        .value = TEMPLATE_STRINGS<"%ID_LOAD_AVERAGE_LOAD_AVERAGE%">},
+    CompiledItem{.name = TEMPLATE_STRINGS<"Processes:">, .value = TEMPLATE_STRINGS<"%ID_PROCESSES_PROCESS_COUNT%">},
+    CompiledItem{
+        .name = TEMPLATE_STRINGS<"Users Logged In:">,
+        .value = TEMPLATE_STRINGS<"%ID_LOGGED_IN_USER_LOGGED_IN%">},
+    CompiledItem{.name = TEMPLATE_STRINGS<"Usage of /:">, .value = TEMPLATE_STRINGS<"%ID_FILE_SYSTEM_SUMMARY%">},
+    CompiledItem{.name = TEMPLATE_STRINGS<"Memory Usage:">, .value = TEMPLATE_STRINGS<"%ID_MEMORY_USAGE_SUMMARY%">},
+    CompiledItem{.name = TEMPLATE_STRINGS<"Swap Usage:">, .value = TEMPLATE_STRINGS<"%ID_SWAP_USAGE_SUMMARY%">},
+    CompiledItem{
+        .is_repeatable = true,
+        .is_optional = true,
+        .name = TEMPLATE_STRINGS<"IP %ID_NETWORK_INFO_INTERFACE_NAME%:", "Mac %ID_NETWORK_INFO_INTERFACE_NAME%:">,
+        .name_color = BOLD_BRIGHT_CYAN_2,
+        .value = TEMPLATE_STRINGS<"%ID_NETWORK_INFO_IP%", "%ID_NETWORK_INFO_MAC%">,
+        .value_color = BOLD_BRIGHT_WHITE_2},
+    // Whether the package manager is annoying us with updates
+    CompiledItem{
+        .indent_size = 0,
+        .prepend_newlines = 1,
+        .append_newlines = 1,
+        .is_optional = true,
+        .value = TEMPLATE_STRINGS<"%ID_PACKAGE_MANAGEMENT_UPDATE_DETAILS%">,
+        .value_color = BOLD_BRIGHT_YELLOW},
+    // Use the fortune databases to print a random "software engineering" quote
+    CompiledItem{
+        .indent_size = 0,
+        .prepend_newlines = 1,
+        .append_newlines = 1,
+        .is_optional = true,
+        .value = TEMPLATE_STRINGS<"%ID_FORTUNE_FORTUNE%">,
+        .value_color = BOLD_BRIGHT_GREEN},
+    // Notify the user whether the package manager has a reboot required
+    CompiledItem{
+        .indent_size = 0,
+        .prepend_newlines = 1,
+        .append_newlines = 1,
+        .is_optional = true,
+        .value = TEMPLATE_STRINGS<"%ID_PACKAGE_MANAGEMENT_REBOOT_REQUIRED%">,
+        .value_color = BOLD_BRIGHT_RED},
+};
+// clang-format on
+
+inline constexpr auto DEFAULT_COLUMNS = array{ENTIRE_LINE};
+// The colors of the %color:...% specifications in DEFAULT_ITEMS
+inline constexpr auto DEFAULT_COLORS =
+    array{TemplateColor{"bold_bright_green", Bold(fmt::terminal_color::bright_green)},
+          TemplateColor{"bold_bright_white", Bold(fmt::terminal_color::bright_white)}};
+inline constexpr auto DEFAULT_TEMPLATE =
+    CompiledTemplateView{DEFAULT_COLUMNS, true, "PLAIN_STYLE", DEFAULT_ITEMS, DEFAULT_COLORS};
+
+// Calls `add_color` with the name of each color in the %color:name[:name]% specifications of `text`
+template<typename AddColor>
+void ForEachColorName(string_view text, AddColor add_color) {
+    constexpr auto COLOR_PREFIX = string_view{"%color:"};
+    for (auto pos = text.find(COLOR_PREFIX); pos != string_view::npos; pos = text.find(COLOR_PREFIX, pos)) {
+        pos += size(COLOR_PREFIX);
+        auto end = text.find('%', pos);
+        if (end == string_view::npos) {
+            break;
+        }
+        auto specs = text.substr(pos, end - pos);
+        while (!empty(specs)) {
+            auto colon = specs.find(':');
+            if (auto name = specs.substr(0, colon); !empty(name)) {
+                add_color(name);
+            }
+            specs = colon == string_view::npos ? string_view{} : specs.substr(colon + 1);
+        }
+        pos = end + 1;
+    }
+}
+
+constexpr auto TEMPLATE_CACHE_DIRECTORY = string_view{"template"};
+constexpr auto TEMPLATE_CACHE_MAGIC = array<char, 8>{'m', 'm', 'o', 't', 'd', 't', 'p', 'l'};
+constexpr auto TEMPLATE_CACHE_VERSION = uint32_t{1};
+
+// A range of records or of the text pool
+struct TemplateRange {
+    uint32_t first;
+    uint32_t count;
+};
+
+struct TemplateCacheHeader {
+    array<char, 8> magic;
+    uint32_t version;
+    uint32_t collapse_column_rows;
+    uint32_t column_count;
+    uint32_t style_count;
+    uint32_t segment_count;
+    uint32_t string_count;
+    uint32_t item_count;
+    uint32_t color_count;
+    int64_t template_mtime;
+    uint64_t template_size;
+    TemplateRange template_path;
+    TemplateRange mmotd_version;
+    TemplateRange table_type;
+    uint64_t pool_size;
+};
+
+constexpr auto STYLE_HAS_FOREGROUND = uint16_t{0x01};
+constexpr auto STYLE_FOREGROUND_IS_RGB = uint16_t{0x02};
+constexpr auto STYLE_HAS_BACKGROUND = uint16_t{0x04};
+constexpr auto STYLE_BACKGROUND_IS_RGB = uint16_t{0x08};
+
+struct TemplateStyleRecord {
+    uint32_t foreground;
+    uint32_t background;
+    uint16_t emphasis;
+    uint16_t flags;
+    uint32_t reserved;
+};
+
+struct TemplateSegmentRecord {
+    TemplateRange text;
+    uint64_t id;
+    uint32_t is_slot;
+    uint32_t reserved;
+};
+
+struct TemplateItemRecord {
+    int32_t indent_size;
+    int32_t column;
+    int32_t prepend_newlines;
+    int32_t append_newlines;
+    uint32_t is_repeatable;
+    uint32_t is_optional;
+    TemplateRange name;
+    TemplateRange name_color;
+    TemplateRange value;
+    TemplateRange value_color;
+};
+
+struct TemplateColorRecord {
+    TemplateRange name;
+    uint32_t style;
+    uint32_t reserved;
+};
+
+TemplateStyleRecord ToStyleRecord(const fmt::text_style &style) {
+    auto record = TemplateStyleRecord{};
+    record.emphasis = style.has_emphasis() ? static_cast<uint16_t>(style.get_emphasis()) : uint16_t{0};
+    if (style.has_foreground()) {
+        auto foreground = style.get_foreground();
+        record.flags |= STYLE_HAS_FOREGROUND | (foreground.is_rgb ? STYLE_FOREGROUND_IS_RGB : uint16_t{0});
+        record.foreground = foreground.is_rgb ? foreground.value.rgb_color : foreground.value.term_color;
+    }
+    if (style.has_background()) {
+        auto background = style.get_background();
+        record.flags |= STYLE_HAS_BACKGROUND | (background.is_rgb ? STYLE_BACKGROUND_IS_RGB : uint16_t{0});
+        record.background = background.is_rgb ? background.value.rgb_color : background.value.term_color;
+    }
+    return record;
+}
+
+fmt::text_style FromStyleRecord(const TemplateStyleRecord &record) {
+    auto style = fmt::text_style{static_cast<fmt::emphasis>(record.emphasis)};
+    if ((record.flags & STYLE_HAS_FOREGROUND) != 0) {
+        style |= (record.flags & STYLE_FOREGROUND_IS_RGB) != 0 ?
+                     fmt::fg(fmt::rgb(record.foreground)) :
+                     fmt::fg(static_cast<fmt::terminal_color>(record.foreground));
+    }
+    if ((record.flags & STYLE_HAS_BACKGROUND) != 0) {
+        style |= (record.flags & STYLE_BACKGROUND_IS_RGB) != 0 ?
+                     fmt::bg(fmt::rgb(record.background)) :
+                     fmt::bg(static_cast<fmt::terminal_color>(record.background));
+    }
+    return style;
+}
+
+} // namespace
+
+namespace mmotd::output_template {
+
+// The records of a compiled template, both the cache file and a template compiled from json are made of them
+struct TemplateRecords {
+    bool collapse_column_rows = true;
+    TemplateRange table_type = {};
+    vector<int32_t> columns;
+    vector<TemplateStyleRecord> styles;
+    vector<TemplateSegmentRecord> segments;
+    vector<TemplateRange> strings;
+    vector<TemplateItemRecord> items;
+    vector<TemplateColorRecord> colors;
+    string pool;
+
+    TemplateRange AddText(string_view text) {
+        auto range = TemplateRange{static_cast<uint32_t>(size(pool)), static_cast<uint32_t>(size(text))};
+        pool.append(text);
+        return range;
+    }
+
+    TemplateRange AddStyles(span<const fmt::text_style> text_styles) {
+        auto range = TemplateRange{static_cast<uint32_t>(size(styles)), static_cast<uint32_t>(size(text_styles))};
+        transform(begin(text_styles), end(text_styles), back_inserter(styles), ToStyleRecord);
+        return range;
+    }
+
+    TemplateRange AddStrings(span<const CompiledString> compiled_strings) {
+        auto range = TemplateRange{static_cast<uint32_t>(size(strings)), static_cast<uint32_t>(size(compiled_strings))};
+        for (const auto &compiled_string : compiled_strings) {
+            strings.push_back(TemplateRange{static_cast<uint32_t>(size(segments)),
+                                            static_cast<uint32_t>(size(compiled_string))});
+            for (const auto &segment : compiled_string) {
+                segments.push_back(TemplateSegmentRecord{AddText(segment.text),
+                                                         static_cast<uint64_t>(segment.id),
+                                                         segment.is_slot ? uint32_t{1} : uint32_t{0},
+                                                         0});
+            }
+        }
+        return range;
+    }
+
+    void AddItem(const CompiledItem &item) {
+        auto record = TemplateItemRecord{};
+        record.indent_size = item.indent_size;
+        record.column = item.column;
+        record.prepend_newlines = item.prepend_newlines;
+        record.append_newlines = item.append_newlines;
+        record.is_repeatable = item.is_repeatable ? 1 : 0;
+        record.is_optional = item.is_optional ? 1 : 0;
+        record.name = AddStrings(item.name);
+        record.name_color = AddStyles(item.name_color);
+        record.value = AddStrings(item.value);
+        record.value_color = AddStyles(item.value_color);
+        items.push_back(record);
+    }
+
+    void AddColor(string_view name, const fmt::text_style &style) {
+        auto found = any_of(begin(colors), end(colors), [this, name](const auto &color) {
+            return string_view{pool}.substr(color.name.first, color.name.count) == name;
+        });
+        if (!found) {
+            auto style_index = static_cast<uint32_t>(size(styles));
+            styles.push_back(ToStyleRecord(style));
+            colors.push_back(TemplateColorRecord{AddText(name), style_index, 0});
+        }
+    }
+
+    static TemplateRecords FromView(const CompiledTemplateView &view) {
+        auto records = TemplateRecords{};
+        records.collapse_column_rows = view.collapse_column_rows;
+        records.table_type = records.AddText(view.table_type);
+        records.columns.assign(begin(view.columns), end(view.columns));
+        for_each(begin(view.items), end(view.items), [&records](const auto &item) { records.AddItem(item); });
+        for (const auto &color : view.colors) {
+            records.AddColor(color.name, color.style);
+        }
+        return records;
+    }
+};
+
+} // namespace mmotd::output_template
+
+namespace {
+
+using mmotd::output_template::TemplateRecords;
+
+template<typename T>
+void ReadRecords(string_view &buffer, size_t count, vector<T> &records) {
+    records.resize(count);
+    for (auto &record : records) {
+        record = mmotd::core::ReadRecord<T>(data(buffer));
+        buffer.remove_prefix(sizeof(T));
+    }
+}
+
+bool IsValidRange(TemplateRange range, size_t size) {
+    return size_t{range.first} + range.count <= size;
+}
+
+string GetTemplateKeyPath(const fs::path &template_path) {
+    auto ec = error_code{};
+    auto absolute_path = fs::absolute(template_path, ec);
+    return ec ? template_path.lexically_normal().string() : absolute_path.lexically_normal().string();
+}
+
+} // namespace
+
+namespace mmotd::output_template {
+
+CompiledTemplate CompiledTemplate::GetDefault() noexcept {
+    return CompiledTemplate{DEFAULT_TEMPLATE};
+}
+
+CompiledTemplate CompiledTemplate::Compile(const OutputTemplate &output_template) {
+    auto records = TemplateRecords{};
+    const auto &output_settings = output_template.GetOutputSettings();
+    records.collapse_column_rows = output_settings.collapse_column_rows;
+    records.table_type = records.AddText(output_settings.table_type);
+    const auto &columns = output_template.GetColumns();
+    records.columns.assign(begin(columns), end(columns));
+
+    auto compile_strings = [&records](const vector<string> &strs) {
+        auto segments = vector<vector<TemplateSegment>>{};
+        for (const auto &str : strs) {
+            auto &string_segments = segments.emplace_back();
+            ForEachTemplateSegment(str, [&string_segments](const auto &segment) {
+                string_segments.push_back(segment);
+            });
+            ForEachColorName(str, [&records](string_view name) {
+                records.AddColor(name, color::from_color_string(name));
+            });
+        }
+        auto compiled_strings = vector<CompiledString>{begin(segments), end(segments)};
+        return records.AddStrings(compiled_strings);
+    };
+    for (const auto &column_item : output_template.GetColumnItems()) {
+        auto record = TemplateItemRecord{};
+        record.indent_size = column_item.indent_size;
+        record.column = column_item.column;
+        record.prepend_newlines = column_item.prepend_newlines;
+        record.append_newlines = column_item.append_newlines;
+        record.is_repeatable = column_item.is_repeatable ? 1 : 0;
+        record.is_optional = column_item.is_optional ? 1 : 0;
+        record.name = compile_strings(column_item.name);
+        record.name_color = records.AddStyles(column_item.name_color);
+        record.value = compile_strings(column_item.value);
+        record.value_color = records.AddStyles(column_item.value_color);
+        records.items.push_back(record);
+    }
+
+    auto compiled_template = CompiledTemplate{CompiledTemplateView{}};
+    compiled_template.Assemble(records);
+    return compiled_template;
+}
+
+bool CompiledTemplate::Assemble(const TemplateRecords &records) {
+    const auto pool_size = size(records.pool);
+    text_pool_ = make_unique<char[]>(max(pool_size, size_t{1}));
+    copy(begin(records.pool), end(records.pool), text_pool_.get());
+    auto get_text = [this, pool_size](TemplateRange range) -> optional<string_view> {
+        if (!IsValidRange(range, pool_size)) {
+            return nullopt;
+        }
+        return string_view{text_pool_.get() + range.first, range.count};
+    };
+
+    columns_.assign(begin(records.columns), end(records.columns));
+    styles_.clear();
+    transform(begin(records.styles), end(records.styles), back_inserter(styles_), FromStyleRecord);
+    segments_.clear();
+    for (const auto &record : records.segments) {
+        auto text = get_text(record.text);
+        if (!text) {
+            return false;
+        }
+        segments_.push_back(TemplateSegment{*text, static_cast<InformationId>(record.id), record.is_slot != 0});
+    }
+    strings_.clear();
+    for (const auto &range : records.strings) {
+        if (!IsValidRange(range, size(segments_))) {
+            return false;
+        }
+        strings_.push_back(CompiledString{data(segments_) + range.first, range.count});
+    }
+    items_.clear();
+    for (const auto &record : records.items) {
+        if (!IsValidRange(record.name, size(strings_)) || !IsValidRange(record.value, size(strings_)) ||
+            !IsValidRange(record.name_color, size(styles_)) || !IsValidRange(record.value_color, size(styles_))) {
+            return false;
+        }
+        auto item = CompiledItem{};
+        item.indent_size = record.indent_size;
+        item.column = record.column;
+        item.prepend_newlines = record.prepend_newlines;
+        item.append_newlines = record.append_newlines;
+        item.is_repeatable = record.is_repeatable != 0;
+        item.is_optional = record.is_optional != 0;
+        item.name = span{data(strings_) + record.name.first, record.name.count};
+        item.name_color = span{data(styles_) + record.name_color.first, record.name_color.count};
+        item.value = span{data(strings_) + record.value.first, record.value.count};
+        item.value_color = span{data(styles_) + record.value_color.first, record.value_color.count};
+        items_.push_back(item);
+    }
+    colors_.clear();
+    for (const auto &record : records.colors) {
+        auto name = get_text(record.name);
+        if (!name || record.style >= size(styles_)) {
+            return false;
+        }
+        colors_.push_back(TemplateColor{*name, styles_[record.style]});
+    }
+    auto table_type = get_text(records.table_type);
+    if (!table_type) {
+        return false;
+    }
+    view_ = CompiledTemplateView{columns_, records.collapse_column_rows, *table_type, items_, colors_};
+    return true;
+}
+
+optional<CompiledTemplate> CompiledTemplate::Load(const fs::path &template_path) {
+    auto cache_path = GetCachePath(template_path);
+    if (!empty(cache_path)) {
+        if (auto compiled_template = Read(cache_path, template_path); compiled_template) {
+            LOG_DEBUG("read the compiled template of {} from {}", template_path.string(), cache_path.string());
+            return compiled_template;
+        }
+    }
+    auto output_template = OutputTemplate::ParseOutputTemplate(template_path.string());
+    if (!output_template) {
+        return nullopt;
+    }
+    auto compiled_template = Compile(*output_template);
+    if (!empty(cache_path) && !compiled_template.Write(cache_path, template_path)) {
+        LOG_WARNING("unable to cache the compiled template of {}", template_path.string());
+    }
+    return make_optional(std::move(compiled_template));
+}
+
+fs::path CompiledTemplate::GetCachePath(const fs::path &template_path) {
+    auto cache_dir = mmotd::core::special_files::GetCacheDirectory();
+    if (empty(cache_dir)) {
+        return fs::path{};
+    }
+    auto template_directory = cache_dir / TEMPLATE_CACHE_DIRECTORY;
+    auto ec = error_code{};
+    fs::create_directories(template_directory, ec);
+    if (ec) {
+        LOG_ERROR("unable to create template cache directory {}, {}", template_directory.string(), ec.message());
+        return fs::path{};
+    }
+    auto key_hash = mmotd::core::HashCacheKey(GetTemplateKeyPath(template_path));
+    return template_directory / format(FMT_STRING("{:016x}.bin"), key_hash);
+}
+
+optional<CompiledTemplate> CompiledTemplate::Read(const fs::path &cache_path, const fs::path &template_path) {
+    auto mapped_file = mmotd::core::MappedFile::Open(cache_path);
+    if (!mapped_file) {
+        return nullopt;
+    }
+    auto buffer = mapped_file->view();
+    if (size(buffer) < sizeof(TemplateCacheHeader)) {
+        return nullopt;
+    }
+    auto header = mmotd::core::ReadRecord<TemplateCacheHeader>(data(buffer));
+    buffer.remove_prefix(sizeof(header));
+    auto records_size = size_t{header.column_count} * sizeof(int32_t) +
+                        size_t{header.style_count} * sizeof(TemplateStyleRecord) +
+                        size_t{header.segment_count} * sizeof(TemplateSegmentRecord) +
+                        size_t{header.string_count} * sizeof(TemplateRange) +
+                        size_t{header.item_count} * sizeof(TemplateItemRecord) +
+                        size_t{header.color_count} * sizeof(TemplateColorRecord);
+    if (header.magic != TEMPLATE_CACHE_MAGIC || header.version != TEMPLATE_CACHE_VERSION ||
+        records_size + header.pool_size != size(buffer)) {
+        LOG_WARNING("discarding invalid template cache {}", cache_path.string());
+        return nullopt;
+    }
+    auto records = TemplateRecords{};
+    records.collapse_column_rows = header.collapse_column_rows != 0;
+    records.table_type = header.table_type;
+    ReadRecords(buffer, header.column_count, records.columns);
+    ReadRecords(buffer, header.style_count, records.styles);
+    ReadRecords(buffer, header.segment_count, records.segments);
+    ReadRecords(buffer, header.string_count, records.strings);
+    ReadRecords(buffer, header.item_count, records.items);
+    ReadRecords(buffer, header.color_count, records.colors);
+    records.pool = string{buffer};
+
+    // the ids of the slots are only valid for the version which wrote the cache
+    auto get_text = [&records](TemplateRange range) {
+        return IsValidRange(range, size(records.pool)) ? string_view{records.pool}.substr(range.first, range.count) :
+                                                         string_view{};
+    };
+    auto size_and_mtime = mmotd::core::GetSizeAndModificationTime(template_path);
+    if (!size_and_mtime || size_and_mtime->first != header.template_size ||
+        size_and_mtime->second != header.template_mtime ||
+        get_text(header.template_path) != GetTemplateKeyPath(template_path) ||
+        get_text(header.mmotd_version) != mmotd::version::Version::Instance().to_string()) {
+        LOG_DEBUG("template cache {} does not match {}", cache_path.string(), template_path.string());
+        return nullopt;
+    }
+    auto compiled_template = CompiledTemplate{CompiledTemplateView{}};
+    if (!compiled_template.Assemble(records)) {
+        LOG_WARNING("discarding invalid template cache {}", cache_path.string());
+        return nullopt;
+    }
+    return make_optional(std::move(compiled_template));
+}
+
+bool CompiledTemplate::Write(const fs::path &cache_path, const fs::path &template_path) const {
+    auto size_and_mtime = mmotd::core::GetSizeAndModificationTime(template_path);
+    if (!size_and_mtime) {
+        return false;
+    }
+    auto records = TemplateRecords::FromView(view_);
+
+    auto header = TemplateCacheHeader{};
+    header.magic = TEMPLATE_CACHE_MAGIC;
+    header.version = TEMPLATE_CACHE_VERSION;
+    header.collapse_column_rows = records.collapse_column_rows ? 1 : 0;
+    header.column_count = static_cast<uint32_t>(size(records.columns));
+    header.style_count = static_cast<uint32_t>(size(records.styles));
+    header.segment_count = static_cast<uint32_t>(size(records.segments));
+    header.string_count = static_cast<uint32_t>(size(records.strings));
+    header.item_count = static_cast<uint32_t>(size(records.items));
+    header.color_count = static_cast<uint32_t>(size(records.colors));
+    header.template_size = size_and_mtime->first;
+    header.template_mtime = size_and_mtime->second;
+    header.template_path = records.AddText(GetTemplateKeyPath(template_path));
+    header.mmotd_version = records.AddText(mmotd::version::Version::Instance().to_string());
+    header.table_type = records.table_type;
+    header.pool_size = size(records.pool);
+
+    auto parts = array{mmotd::core::AsBytes(header),
+                       mmotd::core::AsBytes(records.columns),
+                       mmotd::core::AsBytes(records.styles),
+                       mmotd::core::AsBytes(records.segments),
+                       mmotd::core::AsBytes(records.strings),
+                       mmotd::core::AsBytes(records.items),
+                       mmotd::core::AsBytes(records.colors),
+                       string_view{records.pool}};
+    return mmotd::core::WriteFileAtomically(cache_path, parts);
+}
+
+vector<int> CompiledTemplate::GetColumns() const {
+    return vector<int>{begin(view_.columns), end(view_.columns)};
+}
+
+TemplateColumnItems CompiledTemplate::GetColumnItems() const {
+    auto to_strings = [](span<const CompiledString> compiled_strings) {
+        auto strs = vector<string>{};
+        for (const auto &compiled_string : compiled_strings) {
+            auto &str = strs.emplace_back();
+            for_each(begin(compiled_string), end(compiled_string), [&str](const auto &segment) {
+                str += segment.text;
+            });
+        }
+        return strs;
+    };
+    auto items = TemplateColumnItems{};
+    for (const auto &compiled_item : view_.items) {
+        auto &item = items.emplace_back();
+        item.indent_size = compiled_item.indent_size;
+        item.column = compiled_item.column;
+        item.prepend_newlines = compiled_item.prepend_newlines;
+        item.append_newlines = compiled_item.append_newlines;
+        item.is_repeatable = compiled_item.is_repeatable;
+        item.is_optional = compiled_item.is_optional;
+        item.name = to_strings(compiled_item.name);
+        item.name_color.assign(begin(compiled_item.name_color), end(compiled_item.name_color));
+        item.value = to_strings(compiled_item.value);
+        item.value_color.assign(begin(compiled_item.value_color), end(compiled_item.value_color));
+    }
+    return items;
+}
+
+mmotd::information::InformationIds CompiledTemplate::GetReferencedInformationIds() const {
+    auto information_ids = mmotd::information::InformationIds{};
+    auto add_referenced_ids = [&information_ids](span<const CompiledString> compiled_strings) {
+        for (const auto &compiled_string : compiled_strings) {
+            for (const auto &segment : compiled_string) {
+                if (segment.is_slot && segment.id != InformationId::ID_INVALID_INVALID_INFORMATION) {
+                    information_ids.insert(segment.id);
+                }
+            }
+        }
+    };
+    for (const auto &item : view_.items) {
+        add_referenced_ids(item.name);
+        add_referenced_ids(item.value);
+    }
+    return information_ids;
+}
+
+optional<fmt::text_style> CompiledTemplate::FindColor(string_view name) const noexcept {
+    auto i = find_if(begin(view_.colors), end(view_.colors), [name](const auto &color) { return color.name == name; });
+    return i == end(view_.colors) ? nullopt : make_optional(i->style);
+}
+
+unique_ptr<CompiledTemplate> MakeCompiledTemplate(string file_name) {
+    auto compiled_template_holder = CompiledTemplate::Load(fs::path{file_name});
+    if (compiled_template_holder) {
+        return make_unique<CompiledTemplate>(std::move(*compiled_template_holder));
+    }
+    return nullptr;
+}
+
+unique_ptr<CompiledTemplate> MakeCompiledTemplateFromDefault() {
+    return make_unique<CompiledTemplate>(CompiledTemplate::GetDefault());
+}
+
+} // namespace mmotd::output_template
@@ -42,6 +42,75 @@ output_color=true
 #  specified on the command line or with the following variable:
 # template_path="$HOME/.config/mmotd/mmotd_template.json"
 
+# The number of milliseconds the providers have to look up their information.  When the budget
+#  expires the output is written with the information which is ready and the late providers are
+#  cancelled.  A value of 0 waits for every provider.
+latency_budget_ms=1500
+
+[cache]
+# The informations found by each provider are saved in a snapshot, $XDG_CACHE_HOME/mmotd/snapshot.bin,
+#  (or $HOME/.cache/mmotd/snapshot.bin) so that only the providers which have expired are looked up again.
+enabled=true
+
+[cache.ttl]
+# The number of seconds each provider's snapshot is valid:
+#  0 means the provider is looked up every time and -1 means the snapshot is valid until the next reboot
+#  (or until /etc/os-release changes).
+#  A provider which is not listed keeps its built-in default: -1 for hardware and system_information, 3600 for
+#  external_network and package_management, 1800 for weather, and 0 (never cached) for every other provider.
+hardware=-1
+system_information=-1
+external_network=3600
+package_management=3600
+weather=1800
+load_average=0
+
+[http_cache]
+# The responses of the web services are saved in $XDG_CACHE_HOME/mmotd/http (or $HOME/.cache/mmotd/http) and
+#  reused while they are fresh, as told by their Cache-Control header.  A stale response is revalidated with its
+#  ETag, and unless the server asked for 'must-revalidate' it is used right away while that happens in the
+#  background, for at most 'http_cache.max_stale' seconds past its freshness.
+enabled=true
+max_stale=86400
+
+[http_cache.min_ttl]
+# The minimum number of seconds a response from each host is fresh, whatever its Cache-Control says.
+#  The '.' in the host name is written as '_'.
+wttr_in=1800
+ipinfo_io=3600
+
+[network]
+# The number of milliseconds a request to a web service has to connect, and to finish.
+connect_timeout_ms=1500
+timeout_ms=5000
+# A host whose request fails (it cannot be reached, times out or answers with a server error) is skipped for
+#  'network.backoff_seconds', doubling with each consecutive failure up to 'network.max_backoff_seconds'.  The
+#  health of each host is kept in $XDG_CACHE_HOME/mmotd/http.  Requests are also skipped while there is no
+#  default route.  A back-off of 0 never skips a host.
+backoff_seconds=30
+max_backoff_seconds=3600
+# The web services which are used to find the external ip address (and location) and the weather.
+external_ip_endpoint="https://ipinfo.io"
+weather_endpoint="https://wttr.in"
+# How the external ip address is found:
+#  "https" asks 'network.external_ip_endpoint', which also finds the location.
+#  "dns" sends one udp query for 'network.dns_name' to 'network.dns_server', an "ip[:port]", and only asks the
+#  https service when the query fails.  It is faster, the location is found in 'location.geoip_database'.
+external_ip_resolver="https"
+dns_server="208.67.222.222:53"
+dns_name="myip.opendns.com"
+dns_timeout_ms=300
+dns_attempts=2
+
+[daemon]
+# `mmotd --daemon` keeps the informations and the template resident, refreshes them every
+#  'daemon.refresh_interval' seconds and serves the rendered output to mmotd over a unix domain socket.
+#  When the daemon is not running mmotd renders the output itself, as it does with 'fortune.fit_terminal_width'
+#  when the terminal is not as wide as the one the daemon fitted the fortune to.
+# The default location of the socket is:
+# socket_path="$XDG_RUNTIME_DIR/mmotd.sock"
+refresh_interval=60
+
 [fortune]
 # fortune: the facility to print a random, hopefully interesting, adage
 #  the 'fortune.db_directory' can specify a directory which contains the
@@ -58,6 +127,18 @@ output_color=true
 #  db_directory="/usr/share/games/fortunes"
 # The default value for 'fortune.file_name' variable is:
 #  file_name="softwareengineering"
+#
+# With 'fortune.all_files' the fortune is drawn from every fortune file (which has a .dat database) in the
+#  'fortune.db_directory' instead of only 'fortune.file_name', like `fortune -a`.  The number of fortunes in each
+#  file is kept in $XDG_CACHE_HOME/mmotd/fortune and is updated when the directory changes.
+all_files=false
+
+# A fortune longer than 'fortune.max_lines' lines or wider than 'fortune.max_width' columns is never drawn, zero is
+#  no limit.  With 'fortune.fit_terminal_width' the width is also limited to the width of the terminal.  The lines
+#  and width of every fortune are kept in an index next to the fortune file (or in $XDG_CACHE_HOME/mmotd/fortune).
+max_lines=0
+max_width=0
+fit_terminal_width=false
 
 [location]
 # This is the same value that is the last couple of segments of the file linked to /etc/localtime
@@ -69,6 +150,15 @@ city="Albuquerque"
 state="NM"
 country="USA"
 
+# The coordinates (in degrees, north and east are positive) which sunrise, sunset and civil twilight are computed
+#  for, without asking the weather service.  Without them the gps location of the external ip address is used.
+latitude=35.0844
+longitude=-106.6504
+
+# A geoip database built with `mmotd_geoip ranges.csv geoip.db`, used to find the location of the external ip
+#  address when 'network.external_ip_resolver' is "dns".  An empty value does not look up the location.
+geoip_database=""
+
 [logging]
 # Which log level (and higher) to output:
 #  trace, debug, info, warn, err, critical, off
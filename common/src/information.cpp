@@ -1,36 +1,90 @@
 // vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
-#include "common/include/algorithm.h"
+#include "common/include/chrono_io.h"
 #include "common/include/information.h"
-#include "common/include/logging.h"
+#include "common/include/information_decls.h"
 
+#include <array>
+#include <chrono>
 #include <string>
 #include <string_view>
-#include <utility>
+#include <type_traits>
+#include <variant>
 
+#include <fmt/compile.h>
 #include <fmt/format.h>
-#include <fmt/ostream.h>
 
-using fmt::format;
 using namespace std;
 
-static constexpr auto INFORMATION_ID_PREFIX = string_view{"InformationId::"};
+namespace {
+
+using mmotd::information::INFORMATION_COUNT;
+using mmotd::information::InformationValue;
+
+using ValueFormatter = string (*)(const InformationValue &);
+
+constexpr auto TIME_POINT_FORMAT = "%a, %d-%h-%Y %I:%M%p %Z";
+
+// The presentation type of the replacement field in the format ("{:.02f}" is 'f'), '\0' when there is none
+constexpr char GetPresentationType(string_view format) {
+    auto spec_end = format.rfind('}');
+    if (spec_end == string_view::npos || spec_end == 0 || format.find(':') == string_view::npos) {
+        return '\0';
+    }
+    auto type = format[spec_end - 1];
+    return (type >= 'a' && type <= 'z') || (type >= 'A' && type <= 'Z') || type == '%' ? type : '\0';
+}
+
+// Whether a number of type T can be formatted with the presentation type, i.e. "{:.02f}" is only for floating point
+template<typename T>
+constexpr bool IsPresentationTypeOf(char type) {
+    if (type == '\0') {
+        return true;
+    } else if constexpr (is_floating_point_v<T>) {
+        return string_view{"aAeEfFgG%"}.find(type) != string_view::npos;
+    } else {
+        return string_view{"bBcdoxX"}.find(type) != string_view::npos;
+    }
+}
+
+// The format was parsed when it was compiled, so only the arguments are formatted here.  Strings are used as they
+//  are and a number whose type does not match the format falls back to "{}".
+template<typename CompiledFormat>
+string FormatValue(const InformationValue &value, CompiledFormat format) {
+    constexpr auto format_view = static_cast<fmt::string_view>(CompiledFormat{});
+    constexpr auto presentation_type = GetPresentationType(string_view{format_view.data(), format_view.size()});
+    return visit(
+        [format](const auto &raw_value) -> string {
+            using T = decay_t<decltype(raw_value)>;
+            if constexpr (is_same_v<T, string>) {
+                return raw_value;
+            } else if constexpr (is_same_v<T, chrono::system_clock::time_point>) {
+                return mmotd::chrono::io::to_string(raw_value, TIME_POINT_FORMAT);
+            } else if constexpr (IsPresentationTypeOf<T>(presentation_type)) {
+                return fmt::format(format, raw_value);
+            } else {
+                return fmt::format(FMT_COMPILE("{}"), raw_value);
+            }
+        },
+        value);
+}
+
+// clang-format off
+// One formatter for each information, in the order of the dense index, with its format compiled in
+constexpr auto VALUE_FORMATTERS = array<ValueFormatter, INFORMATION_COUNT>{
+#define INFO_DEF(cat, id_descriptor, name, fmttr, id)                                                                  \
+    [](const InformationValue &value) { return FormatValue(value, FMT_COMPILE(fmttr)); },
+#define CATEGORY_INFO_DEF(name, description, value)
+#include "common/include/information_defs.h"
+};
+// clang-format on
+
+} // namespace
 
 namespace mmotd::information {
 
-Information::Information(CategoryId category,
-                         InformationId information_id,
-                         string id_str,
-                         string name,
-                         string format_str) :
-    category_(category),
-    information_id_(information_id),
-    id_str_(std::move(id_str)),
-    id_str_no_namespace_(
-        id_str_.substr(id_str_.starts_with(INFORMATION_ID_PREFIX) ? INFORMATION_ID_PREFIX.size() : 0ull)),
-    name_(std::move(name)),
-    format_str_(std::move(format_str)),
-    value_() {
-    mmotd::algorithms::unused(category_);
+string Information::GetValue() const {
+    auto index = ToInformationIndex(GetId());
+    return index ? VALUE_FORMATTERS[*index](value_) : FormatValue(value_, FMT_COMPILE("{}"));
 }
 
 } // namespace mmotd::information
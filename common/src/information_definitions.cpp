@@ -5,11 +5,7 @@
 #include "common/include/information_definitions.h"
 #include "common/include/logging.h"
 
-#include <algorithm>
-#include <cstdlib>
-#include <iterator>
 #include <string>
-#include <utility>
 
 #include <fmt/format.h>
 #include <fmt/ostream.h>
@@ -19,23 +15,17 @@ using namespace std;
 
 namespace mmotd::information {
 
-InformationDefinitions::InformationDefinitions(CategoryIds categories, vector<Information> informations) :
-    categories_(std::move(categories)),
-    informations_(std::move(informations)) {}
-
 const InformationDefinitions &InformationDefinitions::Instance() {
-    static const auto information_definitions = InformationDefinitions{GetCategoryIds(), GetInformationList()};
+    static const auto information_definitions = InformationDefinitions{};
     return information_definitions;
 }
 
 Information InformationDefinitions::GetInformationDefinition(InformationId id) const {
-    auto i = find_if(begin(informations_), end(informations_), [id](const auto &information) {
-        return information.GetId() == id;
-    });
-    if (i == end(informations_)) {
+    const auto *definition = FindInformationDefinition(id);
+    if (definition == nullptr) {
         THROW_RUNTIME_ERROR("unable to find information id '{}'", to_string(id));
     }
-    return *i;
+    return Information{*definition};
 }
 
 } // namespace mmotd::information
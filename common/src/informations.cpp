@@ -0,0 +1,112 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/informations.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+using namespace std;
+
+namespace mmotd::information {
+
+namespace {
+
+const InformationEntries &GetEmptyEntries() {
+    static const auto empty_entries = InformationEntries{};
+    return empty_entries;
+}
+
+} // namespace
+
+Informations::Informations(const Informations &other) :
+    entries_(other.entries_ ? make_unique<Entries>(*other.entries_) : nullptr), size_(other.size_) {}
+
+Informations &Informations::operator=(const Informations &other) {
+    if (this != &other) {
+        entries_ = other.entries_ ? make_unique<Entries>(*other.entries_) : nullptr;
+        size_ = other.size_;
+    }
+    return *this;
+}
+
+Informations::Informations(Informations &&other) noexcept :
+    entries_(std::move(other.entries_)), size_(std::exchange(other.size_, 0)) {}
+
+Informations &Informations::operator=(Informations &&other) noexcept {
+    if (this != &other) {
+        entries_ = std::move(other.entries_);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+bool Informations::contains(InformationId id) const noexcept {
+    auto index = ToInformationIndex(id);
+    return index && GetEntries(*index) != nullptr;
+}
+
+const InformationEntries &Informations::at(InformationId id) const noexcept {
+    auto index = ToInformationIndex(id);
+    const auto *entries = index ? GetEntries(*index) : nullptr;
+    return entries != nullptr ? *entries : GetEmptyEntries();
+}
+
+void Informations::push_back(Information information) {
+    auto index = ToInformationIndex(information.GetId());
+    if (!index) {
+        return;
+    }
+    if (!entries_) {
+        entries_ = make_unique<Entries>();
+    }
+    auto &entries = (*entries_)[*index];
+    if (std::empty(entries)) {
+        ++size_;
+    }
+    entries.push_back(std::move(information));
+}
+
+void Informations::clear() noexcept {
+    if (entries_) {
+        for_each(std::begin(*entries_), std::end(*entries_), [](auto &entries) { entries.clear(); });
+    }
+    size_ = 0;
+}
+
+const InformationEntries *Informations::GetEntries(size_t index) const noexcept {
+    if (!entries_ || std::empty((*entries_)[index])) {
+        return nullptr;
+    }
+    return &(*entries_)[index];
+}
+
+InformationsView::InformationsView(const Informations &informations) {
+    Merge(informations);
+}
+
+void InformationsView::Merge(const Informations &informations) {
+    for (auto index = size_t{0}; index != INFORMATION_COUNT; ++index) {
+        if (const auto *entries = informations.GetEntries(index); entries != nullptr && entries_[index] == nullptr) {
+            entries_[index] = entries;
+            ++size_;
+        }
+    }
+}
+
+bool InformationsView::contains(InformationId id) const noexcept {
+    auto index = ToInformationIndex(id);
+    return index && entries_[*index] != nullptr;
+}
+
+const InformationEntries &InformationsView::at(InformationId id) const noexcept {
+    auto index = ToInformationIndex(id);
+    const auto *entries = index ? entries_[*index] : nullptr;
+    return entries != nullptr ? *entries : GetEmptyEntries();
+}
+
+void InformationsView::clear() noexcept {
+    entries_.fill(nullptr);
+    size_ = 0;
+}
+
+} // namespace mmotd::information
@@ -0,0 +1,111 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/line_parser.h"
+#include "common/include/logging.h"
+#include "common/include/posix_error.h"
+
+#include <cerrno>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using namespace std;
+
+namespace {
+
+// Large enough for /proc/cpuinfo of a typical desktop in a single read
+constexpr auto INITIAL_READ_SIZE = size_t{16 * 1024};
+constexpr auto BLANKS = string_view{" \t\r\n"};
+
+// Reads until the end of the file or until the buffer is full, returns the number of bytes read
+optional<size_t> ReadAll(int fd, const fs::path &file_path, char *buffer, size_t buffer_size) {
+    auto buffer_used = size_t{0};
+    while (buffer_used != buffer_size) {
+        auto bytes_read = read(fd, buffer + buffer_used, buffer_size - buffer_used);
+        if (bytes_read == -1 && errno == EINTR) {
+            continue;
+        } else if (bytes_read == -1) {
+            LOG_ERROR("unable to read {}, {}", file_path.string(), mmotd::error::posix_error::to_string());
+            return nullopt;
+        } else if (bytes_read == 0) {
+            break;
+        }
+        buffer_used += static_cast<size_t>(bytes_read);
+    }
+    return make_optional(buffer_used);
+}
+
+int OpenForReading(const fs::path &file_path) {
+    auto fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        LOG_VERBOSE("unable to open {} for reading, {}", file_path.string(), mmotd::error::posix_error::to_string());
+    }
+    return fd;
+}
+
+} // namespace
+
+namespace mmotd::core {
+
+optional<string> ReadVirtualFile(const fs::path &file_path) {
+    auto fd = OpenForReading(file_path);
+    if (fd == -1) {
+        return nullopt;
+    }
+
+    // the file size is unknown so the buffer grows until a read comes back short
+    auto contents = string(INITIAL_READ_SIZE, '\0');
+    auto contents_size = size_t{0};
+    for (;;) {
+        auto bytes_read = ReadAll(fd, file_path, data(contents) + contents_size, size(contents) - contents_size);
+        if (!bytes_read) {
+            close(fd);
+            return nullopt;
+        }
+        contents_size += *bytes_read;
+        if (contents_size != size(contents)) {
+            break;
+        }
+        contents.resize(size(contents) * 2);
+    }
+    close(fd);
+    contents.resize(contents_size);
+    return make_optional(std::move(contents));
+}
+
+optional<string_view> ReadVirtualFile(const fs::path &file_path, span<char> buffer) {
+    auto fd = OpenForReading(file_path);
+    if (fd == -1) {
+        return nullopt;
+    }
+    auto bytes_read = ReadAll(fd, file_path, data(buffer), size(buffer));
+    close(fd);
+    return bytes_read ? make_optional(string_view{data(buffer), *bytes_read}) : nullopt;
+}
+
+string_view TrimBlanks(string_view str) noexcept {
+    auto first = str.find_first_not_of(BLANKS);
+    if (first == string_view::npos) {
+        return string_view{};
+    }
+    auto last = str.find_last_not_of(BLANKS);
+    return str.substr(first, last - first + 1);
+}
+
+optional<pair<string_view, string_view>> SplitNameValue(string_view line, char separator) noexcept {
+    auto separator_index = line.find(separator);
+    if (separator_index == string_view::npos) {
+        return nullopt;
+    }
+    return make_pair(TrimBlanks(line.substr(0, separator_index)), TrimBlanks(line.substr(separator_index + 1)));
+}
+
+} // namespace mmotd::core
@@ -0,0 +1,152 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/logging.h"
+#include "common/include/mapped_file.h"
+#include "common/include/posix_error.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using namespace std;
+using fmt::format;
+
+namespace mmotd::core {
+
+MappedFile::MappedFile(void *address, size_t size) noexcept : address_(address), size_(size) {}
+
+MappedFile::~MappedFile() {
+    Release();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept :
+    address_(std::exchange(other.address_, nullptr)),
+    size_(std::exchange(other.size_, size_t{0})) {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        Release();
+        address_ = std::exchange(other.address_, nullptr);
+        size_ = std::exchange(other.size_, size_t{0});
+    }
+    return *this;
+}
+
+void MappedFile::Release() noexcept {
+    if (address_ != nullptr) {
+        munmap(address_, size_);
+        address_ = nullptr;
+        size_ = 0;
+    }
+}
+
+optional<MappedFile> MappedFile::Open(const fs::path &file_path) {
+    auto fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        LOG_VERBOSE("unable to open {} for mapping, {}", file_path.string(), mmotd::error::posix_error::to_string());
+        return nullopt;
+    }
+
+    struct stat file_stat = {};
+    if (fstat(fd, &file_stat) != 0) {
+        LOG_ERROR("unable to stat {} for mapping, {}", file_path.string(), mmotd::error::posix_error::to_string());
+        close(fd);
+        return nullopt;
+    }
+
+    auto file_size = static_cast<size_t>(file_stat.st_size);
+    if (file_size == 0) {
+        close(fd);
+        return optional<MappedFile>{MappedFile{}};
+    }
+
+    auto *address = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping holds its own reference to the file, the descriptor is no longer needed
+    close(fd);
+    if (address == MAP_FAILED) {
+        LOG_ERROR("unable to map {} ({} bytes), {}",
+                  file_path.string(),
+                  file_size,
+                  mmotd::error::posix_error::to_string());
+        return nullopt;
+    }
+    return optional<MappedFile>{MappedFile{address, file_size}};
+}
+
+bool WriteFileAtomically(const fs::path &file_path, span<const string_view> parts) {
+    auto temp_path = file_path;
+    temp_path += format(FMT_STRING(".{}.tmp"), getpid());
+    auto ec = error_code{};
+    {
+        auto output = ofstream(temp_path, ios_base::out | ios_base::binary | ios_base::trunc);
+        if (!output.is_open()) {
+            LOG_VERBOSE("unable to open {} for writing", temp_path.string());
+            return false;
+        }
+        for (auto part : parts) {
+            output.write(data(part), static_cast<streamsize>(size(part)));
+        }
+        output.close();
+        if (!output) {
+            LOG_ERROR("unable to write {}", temp_path.string());
+            fs::remove(temp_path, ec);
+            return false;
+        }
+    }
+    fs::rename(temp_path, file_path, ec);
+    if (ec) {
+        LOG_ERROR("unable to rename {} to {}, {}", temp_path.string(), file_path.string(), ec.message());
+        fs::remove(temp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+uint64_t HashCacheKey(string_view key) noexcept {
+    auto hash = uint64_t{14695981039346656037ull};
+    for (auto c : key) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= uint64_t{1099511628211ull};
+    }
+    return hash;
+}
+
+optional<int64_t> GetModificationTime(const fs::path &file_path) {
+    auto ec = error_code{};
+    auto write_time = fs::last_write_time(file_path, ec);
+    if (ec) {
+        LOG_VERBOSE("unable to get the modification time of {}, {}", file_path.string(), ec.message());
+        return nullopt;
+    }
+    return static_cast<int64_t>(write_time.time_since_epoch().count());
+}
+
+optional<pair<uint64_t, int64_t>> GetSizeAndModificationTime(const fs::path &file_path) {
+    auto ec = error_code{};
+    auto file_size = fs::file_size(file_path, ec);
+    if (ec) {
+        LOG_VERBOSE("unable to get the size of {}, {}", file_path.string(), ec.message());
+        return nullopt;
+    }
+    auto write_time = GetModificationTime(file_path);
+    if (!write_time) {
+        return nullopt;
+    }
+    return make_pair(static_cast<uint64_t>(file_size), *write_time);
+}
+
+} // namespace mmotd::core
@@ -1,11 +1,13 @@
 // vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
 #include "common/assertion/include/assertion.h"
 #include "common/include/algorithm.h"
+#include "common/include/compiled_template.h"
 #include "common/include/logging.h"
 #include "common/include/output_template.h"
 
 #include <filesystem>
 #include <fstream>
+#include <regex>
 #include <string>
 #include <system_error>
 
@@ -64,6 +66,27 @@ const mmotd::output_template::OutputSettings &OutputTemplate::GetOutputSettings(
     return template_config_.output_settings;
 }
 
+mmotd::information::InformationIds OutputTemplate::GetReferencedInformationIds() const {
+    using mmotd::information::InformationId;
+    const auto pattern = regex(R"(%(ID_[_A-Z]+)%)");
+    auto information_ids = mmotd::information::InformationIds{};
+    auto add_referenced_ids = [&pattern, &information_ids](const vector<string> &strs) {
+        for (const auto &str : strs) {
+            for (auto i = sregex_iterator(begin(str), end(str), pattern); i != sregex_iterator{}; ++i) {
+                auto id = mmotd::information::from_information_id_string((*i)[1].str());
+                if (id != InformationId::ID_INVALID_INVALID_INFORMATION) {
+                    information_ids.insert(id);
+                }
+            }
+        }
+    };
+    for (const auto &item : column_items_) {
+        add_referenced_ids(item.name);
+        add_referenced_ids(item.value);
+    }
+    return information_ids;
+}
+
 void OutputTemplate::from_json(const json &root) {
     PRECONDITIONS(root.contains("config") && root.at("config").is_object(),
                   "json does not contain {} or it is not an {}",
@@ -99,214 +122,7 @@ void OutputTemplate::to_json(json &root) const {
 }
 
 TemplateColumnItems OutputTemplate::GetDefaultColumnItems() {
-    auto items = TemplateColumnItems{};
-    {
-        auto item = TemplateColumnItem{};
-        item.indent_size = 0;
-        item.value = {
-            "%ID_GENERAL_GREETING%, %ID_GENERAL_USER_NAME%! %ID_GENERAL_LOCAL_TIME_EMOJI% Welcome to %ID_SYSTEM_INFORMATION_PLATFORM_NAME% %ID_SYSTEM_INFORMATION_PLATFORM_VERSION% (%ID_SYSTEM_INFORMATION_KERNEL_TYPE% %ID_SYSTEM_INFORMATION_KERNEL_RELEASE% %ID_SYSTEM_INFORMATION_ARCHITECTURE%)"};
-        item.value_color = {fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_green)};
-        item.append_newlines = 2;
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.value = {"System information as of %ID_GENERAL_LOCAL_DATE_TIME%"};
-        item.value_color = {fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_yellow)};
-        item.append_newlines = 2;
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"%ID_WEATHER_LOCATION%:"};
-        item.value = {
-            "%ID_WEATHER_WEATHER%, %color:bold_bright_green%Sunrise:%color:bold_bright_white% %ID_WEATHER_SUNRISE%, %color:bold_bright_green%Sunset:%color:bold_bright_white% %ID_WEATHER_SUNSET%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"Last Login:", "", ""};
-        item.name_color = {fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_cyan),
-                           fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_cyan),
-                           fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_cyan)};
-        item.value = {"%ID_LAST_LOGIN_LOGIN_SUMMARY%",
-                      "Log in: %color:bold_bright_white%%ID_LAST_LOGIN_LOGIN_TIME%",
-                      "Log out: %color:bold_bright_white%%ID_LAST_LOGIN_LOGOUT_TIME%"};
-        item.value_color = {fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_white),
-                            fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_green),
-                            fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_green)};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"Up Time:"};
-        item.value = {"%ID_BOOT_TIME_UP_TIME%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.append_newlines = 2;
-        item.name = {"Boot Time:"};
-        item.value = {"%ID_BOOT_TIME_BOOT_TIME%"};
-        items.emplace_back(item);
-    }
-    // Hardware specific
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"Type:"};
-        item.value = {"%ID_HARDWARE_MACHINE_TYPE%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"Model:"};
-        item.value = {"%ID_HARDWARE_MACHINE_MODEL%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"CPU:"};
-        item.value = {"%ID_HARDWARE_CPU_NAME%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"CPU Cores:"};
-        item.value = {"%ID_HARDWARE_CPU_CORE_COUNT% (%ID_HARDWARE_CPU_BYTE_ORDER%)"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"CPU Temperature:"};
-        item.value = {"%ID_HARDWARE_CPU_TEMPERATURE%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"GPU:"};
-        item.value = {"%ID_HARDWARE_GPU_MODEL_NAME%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"GPU Temperature:"};
-        item.value = {"%ID_HARDWARE_GPU_TEMPERATURE%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"Monitor:"};
-        item.value = {"%ID_HARDWARE_MONITOR_NAME%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"Resolution:"};
-        item.value = {"%ID_HARDWARE_MONITOR_RESOLUTION%"};
-        item.append_newlines = 2;
-        items.emplace_back(item);
-    }
-    // The rest of the information
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"Computer Name:"};
-        item.value = {"%ID_SYSTEM_INFORMATION_COMPUTER_NAME%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"Hostname:"};
-        item.value = {"%ID_SYSTEM_INFORMATION_HOST_NAME%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"Public IP:"};
-        item.value = {"%ID_EXTERNAL_NETWORK_INFO_EXTERNAL_IP%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"System Load:"};
-        item.value = {"%ID_LOAD_AVERAGE_LOAD_AVERAGE%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"Processes:"};
-        item.value = {"%ID_PROCESSES_PROCESS_COUNT%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"Users Logged In:"};
-        item.value = {"%ID_LOGGED_IN_USER_LOGGED_IN%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"Usage of /:"};
-        item.value = {"%ID_FILE_SYSTEM_SUMMARY%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"Memory Usage:"};
-        item.value = {"%ID_MEMORY_USAGE_SUMMARY%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.name = {"Swap Usage:"};
-        item.value = {"%ID_SWAP_USAGE_SUMMARY%"};
-        items.emplace_back(item);
-    }
-    {
-        auto item = TemplateColumnItem{};
-        item.is_repeatable = true;
-        item.is_optional = true;
-        item.name = {"IP %ID_NETWORK_INFO_INTERFACE_NAME%:", "Mac %ID_NETWORK_INFO_INTERFACE_NAME%:"};
-        item.name_color = {fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_cyan),
-                           fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_cyan)};
-        item.value = {"%ID_NETWORK_INFO_IP%", "%ID_NETWORK_INFO_MAC%"};
-        item.value_color = {fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_white),
-                            fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_white)};
-        items.emplace_back(item);
-    }
-    // Whether the package manager is annoying us with updates
-    {
-        auto item = TemplateColumnItem{};
-        item.indent_size = 0;
-        item.is_optional = true;
-        item.value_color = {fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_yellow)};
-        item.value = {"%ID_PACKAGE_MANAGEMENT_UPDATE_DETAILS%"};
-        item.append_newlines = 1;
-        item.prepend_newlines = 1;
-        items.emplace_back(item);
-    }
-    // Use the fortune databases to print a random "software engineering" quote
-    {
-        auto item = TemplateColumnItem{};
-        item.indent_size = 0;
-        item.is_optional = true;
-        item.value_color = {fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_green)};
-        item.value = {"%ID_FORTUNE_FORTUNE%"};
-        item.append_newlines = 1;
-        item.prepend_newlines = 1;
-        items.emplace_back(item);
-    }
-    // Notify the user whether the package manager has a reboot required
-    {
-        auto item = TemplateColumnItem{};
-        item.indent_size = 0;
-        item.is_optional = true;
-        item.value_color = {fmt::emphasis::bold | fmt::fg(fmt::terminal_color::bright_red)};
-        item.value = {"%ID_PACKAGE_MANAGEMENT_REBOOT_REQUIRED%"};
-        item.append_newlines = 1;
-        item.prepend_newlines = 1;
-        items.emplace_back(item);
-    }
-    return items;
+    return CompiledTemplate::GetDefault().GetColumnItems();
 }
 
 void from_json(const json &root, OutputTemplate &output_template) {
@@ -5,6 +5,7 @@
 #include "common/include/algorithm.h"
 #include "common/include/config_options.h"
 #include "common/include/information.h"
+#include "common/include/informations.h"
 #include "common/include/logging.h"
 #include "common/include/output_template.h"
 #include "common/include/string_utils.h"
@@ -16,6 +17,7 @@
 #include <optional>
 #include <ostream>
 #include <regex>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -31,7 +33,10 @@ using namespace std::string_literals;
 using mmotd::core::ConfigOptions;
 using mmotd::information::Information;
 using mmotd::information::InformationId;
-using mmotd::information::Informations;
+using mmotd::information::InformationsView;
+using mmotd::output_template::CompiledItem;
+using mmotd::output_template::CompiledString;
+using mmotd::output_template::CompiledTemplate;
 using mmotd::output_template::OutputTemplate;
 using mmotd::output_template::TemplateColumnItem;
 using mmotd::output_template::TemplateColumnItems;
@@ -63,7 +68,7 @@ struct ColorSpecificationData {
 
 using ColorSpecifications = std::vector<ColorSpecificationData>;
 
-bool StrsReferencesIdNotFound(const vector<string> &strs, const Informations &informations) {
+bool StrsReferencesIdNotFound(const vector<string> &strs, const InformationsView &informations) {
     const auto pattern = regex(R"(%(ID_[_A-Z]+)%)");
     auto i = find_if(begin(strs), end(strs), [&pattern, &informations](auto &str) {
         auto match = smatch{};
@@ -76,7 +81,7 @@ bool StrsReferencesIdNotFound(const vector<string> &strs, const Informations &in
     return i != end(strs);
 }
 
-size_t GetInformationReferenceCount(const vector<string> &strs, const Informations &informations) {
+size_t GetInformationReferenceCount(const vector<string> &strs, const InformationsView &informations) {
     const auto pattern = regex(R"(%(ID_[_A-Z]+)%)");
     for (const auto &str : strs) {
         auto match = smatch{};
@@ -91,17 +96,17 @@ size_t GetInformationReferenceCount(const vector<string> &strs, const Informatio
     return size_t{0};
 }
 
-bool ItemReferencesIdNotFound(const TemplateColumnItem &item, const Informations &informations) {
+bool ItemReferencesIdNotFound(const TemplateColumnItem &item, const InformationsView &informations) {
     return StrsReferencesIdNotFound(item.name, informations) || StrsReferencesIdNotFound(item.value, informations);
 }
 
-size_t GetInformationReferenceCount(const TemplateColumnItem &item, const Informations &informations) {
+size_t GetInformationReferenceCount(const TemplateColumnItem &item, const InformationsView &informations) {
     auto name_count = GetInformationReferenceCount(item.name, informations);
     auto value_count = GetInformationReferenceCount(item.value, informations);
     return std::max(name_count, value_count);
 }
 
-auto DuplicateRepeatableItems(TemplateColumnItems items, const Informations &informations) -> TemplateColumnItems {
+auto DuplicateRepeatableItems(TemplateColumnItems items, const InformationsView &informations) -> TemplateColumnItems {
     auto result = TemplateColumnItems{};
     for (const auto &item : items) {
         if (item.is_repeatable) {
@@ -117,7 +122,7 @@ auto DuplicateRepeatableItems(TemplateColumnItems items, const Informations &inf
     return result;
 }
 
-auto RemoveOptionalItems(TemplateColumnItems items, const Informations &informations) -> TemplateColumnItems {
+auto RemoveOptionalItems(TemplateColumnItems items, const InformationsView &informations) -> TemplateColumnItems {
     auto result = TemplateColumnItems{};
     for (const auto &item : items) {
         if (item.is_optional && ItemReferencesIdNotFound(item, informations)) {
@@ -128,11 +133,70 @@ auto RemoveOptionalItems(TemplateColumnItems items, const Informations &informat
     return result;
 }
 
+// The first slot of each string decides, as the first %ID_...% match did for the strings of a TemplateColumnItem
+const InformationId *FindFirstSlotId(const CompiledString &str) {
+    auto i = find_if(begin(str), end(str), [](const auto &segment) { return segment.is_slot; });
+    return i == end(str) ? nullptr : &i->id;
+}
+
+bool StrsReferencesIdNotFound(span<const CompiledString> strs, const InformationsView &informations) {
+    return any_of(begin(strs), end(strs), [&informations](const auto &str) {
+        const auto *id = FindFirstSlotId(str);
+        return id != nullptr && *id != InformationId::ID_INVALID_INVALID_INFORMATION && !informations.contains(*id);
+    });
+}
+
+size_t GetInformationReferenceCount(span<const CompiledString> strs, const InformationsView &informations) {
+    for (const auto &str : strs) {
+        const auto *id = FindFirstSlotId(str);
+        if (id != nullptr && *id != InformationId::ID_INVALID_INVALID_INFORMATION && informations.contains(*id)) {
+            return std::size(informations.at(*id));
+        }
+    }
+    return size_t{0};
+}
+
+// Each slot is replaced by entry `index` of its information, a slot without one is left as it was written
+vector<string> ResolveSlots(span<const CompiledString> strs, size_t index, const InformationsView &informations) {
+    auto result = vector<string>{};
+    result.reserve(std::size(strs));
+    for (const auto &str : strs) {
+        auto &resolved_str = result.emplace_back();
+        for (const auto &segment : str) {
+            const auto &entries = informations.at(segment.id);
+            if (segment.is_slot && index < std::size(entries)) {
+                resolved_str += entries[index].GetValue();
+            } else {
+                resolved_str += segment.text;
+            }
+        }
+    }
+    return result;
+}
+
+TemplateColumnItem ResolveCompiledItem(const CompiledItem &compiled_item,
+                                       size_t index,
+                                       const InformationsView &informations) {
+    auto item = TemplateColumnItem{};
+    item.indent_size = compiled_item.indent_size;
+    item.repeatable_index = static_cast<int>(index);
+    item.column = compiled_item.column;
+    item.prepend_newlines = compiled_item.prepend_newlines;
+    item.append_newlines = compiled_item.append_newlines;
+    item.is_repeatable = compiled_item.is_repeatable;
+    item.is_optional = compiled_item.is_optional;
+    item.name = ResolveSlots(compiled_item.name, index, informations);
+    item.name_color.assign(begin(compiled_item.name_color), end(compiled_item.name_color));
+    item.value = ResolveSlots(compiled_item.value, index, informations);
+    item.value_color.assign(begin(compiled_item.value_color), end(compiled_item.value_color));
+    return item;
+}
+
 } // namespace
 
 namespace mmotd::output_template_writer {
 
-auto ReplaceInformationIds(TemplateColumnItems items, const Informations &informations) -> TemplateColumnItems {
+auto ReplaceInformationIds(TemplateColumnItems items, const InformationsView &informations) -> TemplateColumnItems {
     items = DuplicateRepeatableItems(items, informations);
     items = RemoveOptionalItems(items, informations);
     for (const auto &[id, multiple_infos] : informations) {
@@ -158,6 +222,27 @@ auto ReplaceInformationIds(TemplateColumnItems items, const Informations &inform
     return items;
 }
 
+// The same items as ReplaceInformationIds produces for the strings the template was compiled from
+auto ReplaceInformationIds(const CompiledTemplate &compiled_template, const InformationsView &informations)
+    -> TemplateColumnItems {
+    auto items = TemplateColumnItems{};
+    for (const auto &compiled_item : compiled_template.GetView().items) {
+        auto count = size_t{1};
+        if (compiled_item.is_repeatable) {
+            count = max(GetInformationReferenceCount(compiled_item.name, informations),
+                        GetInformationReferenceCount(compiled_item.value, informations));
+        }
+        if (compiled_item.is_optional && (StrsReferencesIdNotFound(compiled_item.name, informations) ||
+                                          StrsReferencesIdNotFound(compiled_item.value, informations))) {
+            continue;
+        }
+        for (auto i = size_t{0}; i < count; ++i) {
+            items.push_back(ResolveCompiledItem(compiled_item, i, informations));
+        }
+    }
+    return items;
+}
+
 // Input -> GOOD: %color:bold_bright_green%
 //           BAD: %color:bold_bright_green
 //                                        ^ missing closing '%'
@@ -214,11 +299,13 @@ auto FindColorSpecifications(string_view input) -> ColorSpecifications {
     return color_specs;
 }
 
-auto ReplaceColorSpecifications(const ColorSpecifications &color_specs, bool test) -> string {
+auto ReplaceColorSpecifications(const ColorSpecifications &color_specs,
+                                bool test,
+                                bool color_output,
+                                const CompiledTemplate *compiled_template = nullptr) -> string {
     if (empty(color_specs)) {
         return string{};
     }
-    static const auto color_output = ConfigOptions::Instance().GetBoolean("core.output_color"sv, true);
     auto output = string(color_specs.front().prefix);
     for (const auto &color_spec_data : color_specs) {
         const auto &colors = color_spec_data.color_specification.specs;
@@ -234,8 +321,10 @@ auto ReplaceColorSpecifications(const ColorSpecifications &color_specs, bool tes
                 continue;
             }
             const auto &input_text = color_spec_data.color_specification.text;
-            for_each(begin(colors), end(colors), [&output, input_text](const auto &color) {
-                auto text_style = mmotd::output_template::color::from_color_string(color);
+            for_each(begin(colors), end(colors), [&output, input_text, compiled_template](const auto &color) {
+                auto compiled_style = compiled_template != nullptr ? compiled_template->FindColor(color) : nullopt;
+                auto text_style = compiled_style ? *compiled_style :
+                                                   mmotd::output_template::color::from_color_string(color);
                 output += format(text_style, FMT_STRING("{}"), input_text);
             });
         }
@@ -245,16 +334,23 @@ auto ReplaceColorSpecifications(const ColorSpecifications &color_specs, bool tes
 
 auto FindAndReplaceColorSpecifications(string_view input, bool test) -> string {
     auto color_specs = FindColorSpecifications(input);
-    return ReplaceColorSpecifications(color_specs, test);
+    const auto color_output = ConfigOptions::Instance().GetBoolean("core.output_color"sv, true);
+    return ReplaceColorSpecifications(color_specs, test, color_output);
 }
 
-auto ReplaceEmbeddedColorCodes(TemplateColumnItems items) -> TemplateColumnItems {
+// The colors of a compiled template were parsed when it was compiled, they are looked up rather than parsed again
+auto ReplaceEmbeddedColorCodes(TemplateColumnItems items,
+                               bool color_output,
+                               const CompiledTemplate *compiled_template = nullptr) -> TemplateColumnItems {
+    auto replace_color_specifications = [color_output, compiled_template](const string &str) {
+        return ReplaceColorSpecifications(FindColorSpecifications(str), false, color_output, compiled_template);
+    };
     for (auto &item : items) {
         for (auto &name_str : item.name) {
-            name_str = FindAndReplaceColorSpecifications(name_str);
+            name_str = replace_color_specifications(name_str);
         }
         for (auto &value_str : item.value) {
-            value_str = FindAndReplaceColorSpecifications(value_str);
+            value_str = replace_color_specifications(value_str);
         }
     }
     return items;
@@ -498,7 +594,7 @@ class OutputRows {
     friend ostream &operator<<(ostream &os, const OutputRows &rows);
 
 public:
-    OutputRows(vector<int> indexes) : column_indexes(move(indexes)) {}
+    OutputRows(vector<int> indexes, bool color_output) : column_indexes(move(indexes)), color_output_(color_output) {}
 
     bool AddItem(const TemplateColumnItem &item);
     void SetColumnWidths();
@@ -524,6 +620,7 @@ private:
 
     vector<OutputRow> rows;
     vector<int> column_indexes;
+    bool color_output_ = true;
 };
 
 size_t OutputRows::GetColumnIndex(int column) const {
@@ -666,7 +763,11 @@ inline bool OutputRows::HasUnresolvedInformationIds(const vector<string> &strs)
 }
 
 inline bool OutputRows::HasUnresolvedInformationId(const string &str) {
-    const auto pattern = regex(R"(%(ID_[_A-Z]+)%)");
+    // nearly every string has been resolved, only search the ones which could still hold an id
+    if (str.find("%ID_"sv) == string::npos) {
+        return false;
+    }
+    static const auto pattern = regex(R"(%(ID_[_A-Z]+)%)");
     return regex_search(str, pattern);
 }
 
@@ -724,8 +825,7 @@ void OutputRows::SetColumnWidths() {
 }
 
 bool OutputRows::IsColorOutputEnabled() const noexcept {
-    static const auto color_output_enabled = ConfigOptions::Instance().GetBoolean("core.output_color"sv, true);
-    return color_output_enabled;
+    return color_output_;
 }
 
 ostream &operator<<(ostream &os, const OutputRows &rows) {
@@ -735,15 +835,24 @@ ostream &operator<<(ostream &os, const OutputRows &rows) {
 
 OutputTemplateWriter::OutputTemplateWriter(vector<int> column_indexes,
                                            TemplateColumnItems items,
-                                           Informations informations) :
+                                           InformationsView informations) :
     column_indexes_{std::move(column_indexes)},
     items_{std::move(items)},
-    informations_{std::move(informations)} {}
+    informations_{informations},
+    color_output_{ConfigOptions::Instance().GetBoolean("core.output_color"sv, true)} {}
+
+OutputTemplateWriter::OutputTemplateWriter(const CompiledTemplate &compiled_template, InformationsView informations) :
+    column_indexes_{compiled_template.GetColumns()},
+    compiled_template_{&compiled_template},
+    informations_{informations},
+    color_output_{ConfigOptions::Instance().GetBoolean("core.output_color"sv, true)} {}
 
 ostream &operator<<(ostream &os, const OutputTemplateWriter &output) {
-    auto items = ReplaceInformationIds(output.items_, output.informations_);
-    items = ReplaceEmbeddedColorCodes(items);
-    auto rows = OutputRows{output.column_indexes_};
+    auto items = output.compiled_template_ != nullptr ?
+                     ReplaceInformationIds(*output.compiled_template_, output.informations_) :
+                     ReplaceInformationIds(output.items_, output.informations_);
+    items = ReplaceEmbeddedColorCodes(items, output.color_output_, output.compiled_template_);
+    auto rows = OutputRows{output.column_indexes_, output.color_output_};
 
     for (auto i = begin(items); i != end(items); ++i) {
         auto &item = *i;
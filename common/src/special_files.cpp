@@ -5,9 +5,13 @@
 #include "common/include/logging.h"
 #include "common/include/user_information.h"
 
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
 #include <filesystem>
 #include <iomanip>
 #include <iterator>
+#include <optional>
 #include <regex>
 #include <string>
 #include <string_view>
@@ -17,6 +21,7 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <sys/ioctl.h>
 #include <unistd.h>
 
 using fmt::format;
@@ -106,6 +111,31 @@ vector<fs::path> GetDefaultLocationsImpl() {
     return default_locations;
 }
 
+fs::path GetCacheDirectoryImpl() {
+    auto cache_home = mmotd::core::special_files::GetEnvironmentValue("XDG_CACHE_HOME");
+    auto cache_dir = fs::path{};
+    if (!empty(cache_home)) {
+        cache_dir = fs::path{cache_home} / "mmotd";
+    } else {
+        auto user_info = mmotd::core::GetUserInformation();
+        if (empty(user_info.home_directory)) {
+            LOG_VERBOSE("home directory not found, unable to determine the cache directory");
+            return fs::path{};
+        }
+        cache_dir = fs::path{user_info.home_directory} / ".cache" / "mmotd";
+    }
+    auto ec = error_code{};
+    if (!fs::exists(cache_dir, ec) && !fs::create_directories(cache_dir, ec)) {
+        LOG_WARNING("unable to create cache directory {}, {}", quoted(cache_dir.string()), ec.message());
+        return fs::path{};
+    }
+    if (!fs::is_directory(cache_dir, ec) || ec) {
+        LOG_WARNING("cache location {} is not a directory", quoted(cache_dir.string()));
+        return fs::path{};
+    }
+    return cache_dir;
+}
+
 auto IsStdoutTtyImpl() -> bool {
     auto is_stdout_tty = isatty(STDOUT_FILENO) != 0;
     LOG_VERBOSE("stdout is{} a TTY", is_stdout_tty ? "" : " not");
@@ -184,6 +214,26 @@ auto IsStdoutTty() -> bool {
     return is_stdout_tty;
 }
 
+optional<size_t> GetTerminalWidth() {
+    auto window_size = winsize{};
+    if (isatty(STDOUT_FILENO) && ioctl(STDOUT_FILENO, TIOCGWINSZ, &window_size) == 0 && window_size.ws_col != 0) {
+        return make_optional(size_t{window_size.ws_col});
+    }
+    if (const auto *columns = getenv("COLUMNS"); columns != nullptr) {
+        auto width = size_t{0};
+        auto columns_str = string_view{columns};
+        auto [ptr, ec] = from_chars(data(columns_str), data(columns_str) + size(columns_str), width);
+        if (ec == errc{} && ptr == data(columns_str) + size(columns_str) && width != 0) {
+            return make_optional(width);
+        }
+    }
+    return nullopt;
+}
+
+fs::path GetCacheDirectory() {
+    return GetCacheDirectoryImpl();
+}
+
 vector<fs::path> GetDefaultLocations() {
     return GetDefaultLocationsImpl();
 }
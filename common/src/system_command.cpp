@@ -2,14 +2,37 @@
 #include "common/include/logging.h"
 #include "common/include/system_command.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <filesystem>
-#include <iomanip>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
 #include <system_error>
+#include <vector>
 
-#include <boost/asio.hpp>
-#include <boost/process.hpp>
 #include <fmt/format.h>
 
+#if !defined(_WIN32)
+#include <cerrno>
+#include <csignal>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+extern char **environ;
+#endif
+
 using fmt::format;
 namespace fs = std::filesystem;
 using namespace std;
@@ -17,33 +40,306 @@ using namespace std::string_literals;
 
 namespace {
 
+using mmotd::system::command::Command;
+using mmotd::system::command::CommandResult;
+
 string CreateCommand(const fs::path &exe_path, const vector<string> &args) {
     return format(FMT_STRING("{} {}"), exe_path.string(), fmt::join(args, " "));
 }
 
-string CreateErrorStr(int result, string command, string std_out, string std_err) {
-    auto output = format(FMT_STRING("command: {} returned "), quoted(command));
-    output += format(FMT_STRING("[{}] {}, "), result == 0 ? "SUCCESS"s : "ERROR"s, result);
-    if (empty(std_out)) {
+string CreateErrorStr(string command, const CommandResult &result) {
+    auto output = format(FMT_STRING("command: \"{}\" "), command);
+    if (result.timed_out) {
+        output += string{"timed out, "};
+    } else if (!result.exit_code) {
+        output += string{"did not exit, "};
+    } else {
+        auto status = result.succeeded() ? "SUCCESS"s : "ERROR"s;
+        output += format(FMT_STRING("returned [{}] {}, "), status, *result.exit_code);
+    }
+    if (empty(result.output)) {
         output += string{"stdout: \"\", "};
     } else {
-        output += format(FMT_STRING("stdout:\n{}\n"), std_out);
+        output += format(FMT_STRING("stdout:\n{}\n"), result.output);
     }
-    if (empty(std_err)) {
+    if (empty(result.error)) {
         output += string{"stderr: \"\""};
     } else {
-        output += format(FMT_STRING("stderr:\n{}"), std_err);
+        output += format(FMT_STRING("stderr:\n{}"), result.error);
     }
     return output;
 }
 
+#if !defined(_WIN32)
+using Clock = chrono::steady_clock;
+
+// How long a command has to exit after SIGTERM before it is sent SIGKILL
+constexpr auto KILL_GRACE_PERIOD = chrono::milliseconds{250};
+// How often a command which has closed its output, but not yet exited, is checked on when there is no pidfd
+constexpr auto EXIT_POLL_INTERVAL = chrono::milliseconds{1};
+constexpr auto READ_BUFFER_SIZE = size_t{16 * 1024};
+
+struct RunningCommand {
+    const Command *command = nullptr;
+    CommandResult result;
+    pid_t pid = -1;
+    // the read ends of the stdout and stderr pipes, -1 once closed
+    array<int, 2> pipes = {-1, -1};
+    // readable once the command exits (linux 5.3 and later), -1 when there is none
+    int pid_fd = -1;
+    Clock::time_point deadline;
+    bool terminated = false;
+    bool exited = false;
+
+    bool IsOutputClosed() const noexcept { return pipes[0] == -1 && pipes[1] == -1; }
+};
+
+void CloseFd(int &fd) {
+    if (fd != -1) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+// A pipe whose ends are closed on exec, the child only keeps the ends which are duplicated onto stdout and stderr
+bool MakePipe(array<int, 2> &fds) {
+#if defined(__linux__)
+    return pipe2(data(fds), O_CLOEXEC) == 0;
+#else
+    if (pipe(data(fds)) != 0) {
+        return false;
+    }
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return true;
+#endif
+}
+
+// A pidfd lets poll wake up as soon as the command exits, rather than checking on it every EXIT_POLL_INTERVAL
+int OpenPidFd(pid_t pid) {
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#else
+    return -1;
+#endif
+}
+
+void SetExitStatus(RunningCommand &running, int status) {
+    running.exited = true;
+    CloseFd(running.pid_fd);
+    if (WIFEXITED(status)) {
+        running.result.exit_code = WEXITSTATUS(status);
+    }
+}
+
+bool Spawn(RunningCommand &running) {
+    const auto &command = *running.command;
+    auto out_pipe = array<int, 2>{-1, -1};
+    auto err_pipe = array<int, 2>{-1, -1};
+    if (!MakePipe(out_pipe) || !MakePipe(err_pipe)) {
+        running.result.error =
+            format(FMT_STRING("unable to create a pipe, {}"), error_code{errno, generic_category()}.message());
+        for (auto &fd : {&out_pipe[0], &out_pipe[1], &err_pipe[0], &err_pipe[1]}) {
+            CloseFd(*fd);
+        }
+        return false;
+    }
+
+    auto actions = posix_spawn_file_actions_t{};
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, out_pipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, err_pipe[1], STDERR_FILENO);
+
+    // the child starts with no blocked signals and the default SIGPIPE, whatever this process has set up
+    auto attributes = posix_spawnattr_t{};
+    posix_spawnattr_init(&attributes);
+    auto signal_mask = sigset_t{};
+    sigemptyset(&signal_mask);
+    posix_spawnattr_setsigmask(&attributes, &signal_mask);
+    auto default_signals = sigset_t{};
+    sigemptyset(&default_signals);
+    sigaddset(&default_signals, SIGPIPE);
+    posix_spawnattr_setsigdefault(&attributes, &default_signals);
+    // the child leads a process group of its own so the deadline reaches the processes it started as well
+    posix_spawnattr_setpgroup(&attributes, 0);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETPGROUP);
+
+    auto exe_path = command.exe_path.string();
+    auto argv = vector<char *>{};
+    argv.push_back(data(exe_path));
+    for (const auto &arg : command.args) {
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    auto spawn_result = posix_spawn(&running.pid, exe_path.c_str(), &actions, &attributes, data(argv), environ);
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&actions);
+    CloseFd(out_pipe[1]);
+    CloseFd(err_pipe[1]);
+    if (spawn_result != 0) {
+        running.result.error = format(FMT_STRING("unable to spawn {}, {}"),
+                                      exe_path,
+                                      error_code{spawn_result, generic_category()}.message());
+        CloseFd(out_pipe[0]);
+        CloseFd(err_pipe[0]);
+        return false;
+    }
+    running.pipes = {out_pipe[0], err_pipe[0]};
+    running.pid_fd = OpenPidFd(running.pid);
+    for (auto fd : running.pipes) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+    running.deadline = Clock::now() + command.timeout;
+    return true;
+}
+
+// Reads whatever is ready on the pipe, returns false once the pipe is closed (or broken)
+bool ReadPipe(int fd, string &output, size_t output_limit, bool &truncated) {
+    auto buffer = array<char, READ_BUFFER_SIZE>{};
+    for (;;) {
+        auto count = read(fd, data(buffer), size(buffer));
+        if (count > 0) {
+            auto kept = min(static_cast<size_t>(count), output_limit - min(output_limit, size(output)));
+            output.append(data(buffer), kept);
+            truncated = truncated || kept != static_cast<size_t>(count);
+        } else if (count == 0) {
+            return false;
+        } else if (errno == EINTR) {
+            continue;
+        } else {
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+    }
+}
+
+// SIGTERM at the deadline and SIGKILL once the grace period has passed as well, a killed command is reaped at once
+void EnforceDeadline(RunningCommand &running, Clock::time_point now) {
+    if (running.terminated && now >= running.deadline + KILL_GRACE_PERIOD) {
+        LOG_WARNING("killing {} (pid {}), it did not exit after SIGTERM",
+                    running.command->exe_path.string(),
+                    running.pid);
+        kill(-running.pid, SIGKILL);
+        // a grandchild which left the process group may still hold the pipes open, they are not drained any further
+        CloseFd(running.pipes[0]);
+        CloseFd(running.pipes[1]);
+        auto status = 0;
+        while (waitpid(running.pid, &status, 0) == -1 && errno == EINTR) {
+        }
+        SetExitStatus(running, status);
+    } else if (!running.terminated && now >= running.deadline) {
+        LOG_WARNING("{} (pid {}) timed out after {}ms",
+                    running.command->exe_path.string(),
+                    running.pid,
+                    running.command->timeout.count());
+        kill(-running.pid, SIGTERM);
+        running.terminated = true;
+        running.result.timed_out = true;
+    }
+}
+
+void TryReap(RunningCommand &running) {
+    auto status = 0;
+    if (waitpid(running.pid, &status, WNOHANG) == running.pid) {
+        SetExitStatus(running, status);
+    }
+}
+
+vector<CommandResult> ExecuteCommands(span<const Command> commands) {
+    auto running_commands = vector<RunningCommand>(size(commands));
+    for (auto i = size_t{0}; i != size(commands); ++i) {
+        running_commands[i].command = &commands[i];
+        running_commands[i].exited = !Spawn(running_commands[i]);
+    }
+
+    auto poll_fds = vector<pollfd>{};
+    auto poll_owners = vector<pair<RunningCommand *, size_t>>{};
+    for (;;) {
+        auto now = Clock::now();
+        auto next_wakeup = Clock::time_point::max();
+        poll_fds.clear();
+        poll_owners.clear();
+        for (auto &running : running_commands) {
+            if (running.exited) {
+                continue;
+            }
+            EnforceDeadline(running, now);
+            if (!running.exited && running.IsOutputClosed()) {
+                TryReap(running);
+            }
+            if (running.exited) {
+                continue;
+            }
+            auto signal_time = running.terminated ? running.deadline + KILL_GRACE_PERIOD : running.deadline;
+            next_wakeup = min(next_wakeup, signal_time);
+            if (running.IsOutputClosed() && running.pid_fd != -1) {
+                poll_fds.push_back(pollfd{running.pid_fd, POLLIN, 0});
+                poll_owners.emplace_back(&running, size(running.pipes));
+            } else if (running.IsOutputClosed()) {
+                next_wakeup = min(next_wakeup, now + EXIT_POLL_INTERVAL);
+            }
+            for (auto index = size_t{0}; index != size(running.pipes); ++index) {
+                if (running.pipes[index] != -1) {
+                    poll_fds.push_back(pollfd{running.pipes[index], POLLIN, 0});
+                    poll_owners.emplace_back(&running, index);
+                }
+            }
+        }
+        if (next_wakeup == Clock::time_point::max()) {
+            break;
+        }
+
+        auto timeout = clamp(chrono::ceil<chrono::milliseconds>(next_wakeup - now).count(),
+                             chrono::milliseconds::rep{0},
+                             chrono::milliseconds::rep{numeric_limits<int>::max()});
+        auto ready = poll(data(poll_fds), static_cast<nfds_t>(size(poll_fds)), static_cast<int>(timeout));
+        if (ready <= 0) {
+            continue;
+        }
+        for (auto i = size_t{0}; i != size(poll_fds); ++i) {
+            if (poll_fds[i].revents == 0) {
+                continue;
+            }
+            auto &[running, index] = poll_owners[i];
+            if (index == size(running->pipes)) {
+                TryReap(*running);
+                continue;
+            }
+            auto &output = index == 0 ? running->result.output : running->result.error;
+            if (!ReadPipe(running->pipes[index], output, running->command->output_limit, running->result.truncated)) {
+                CloseFd(running->pipes[index]);
+            }
+        }
+    }
+
+    auto results = vector<CommandResult>{};
+    results.reserve(size(running_commands));
+    for (auto &running : running_commands) {
+        results.push_back(std::move(running.result));
+    }
+    return results;
+}
+#else
+vector<CommandResult> ExecuteCommands(span<const Command> commands) {
+    LOG_ERROR("running commands is not supported on this platform");
+    return vector<CommandResult>(size(commands));
+}
+#endif
+
 } // namespace
 
 namespace mmotd::system::command {
 
+CommandResult Execute(const Command &command) {
+    return ExecuteCommands(span<const Command>{&command, 1}).front();
+}
+
+vector<CommandResult> ExecuteAll(const vector<Command> &commands) {
+    return ExecuteCommands(span<const Command>{commands});
+}
+
 optional<string> Run(const fs::path &exe_path, const vector<string> &args) {
-    namespace bp = boost::process;
-    namespace io = boost::asio;
     if (empty(exe_path)) {
         return nullopt;
     }
@@ -52,28 +348,13 @@ optional<string> Run(const fs::path &exe_path, const vector<string> &args) {
         LOG_ERROR("unable to execute '{}' since it does not exist", exe_path.string());
         return nullopt;
     }
-    auto command = CreateCommand(exe_path, args);
-    auto exit_code = std::future<int>{};
-    auto data = std::future<std::string>{};
-    auto error = std::future<std::string>{};
-    auto io_service = io::io_service{};
-    auto child_process = bp::child(command,
-                                   bp::std_in.close(),
-                                   bp::std_out > data,
-                                   bp::std_err > error,
-                                   bp::on_exit = exit_code,
-                                   io_service);
-    io_service.run();
-    auto result = exit_code.get();
-    auto std_output = data.get();
-    auto std_error = error.get();
-
-    if (result != 0 || empty(std_output)) {
-        auto error_str = CreateErrorStr(result, command, std_output, std_error);
+    auto result = Execute(Command{exe_path, args});
+    if (!result.succeeded() || empty(result.output)) {
+        auto error_str = CreateErrorStr(CreateCommand(exe_path, args), result);
         LOG_ERROR("{}", error_str);
         return nullopt;
     } else {
-        return {std_output};
+        return {std::move(result.output)};
     }
 }
 
@@ -0,0 +1,147 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/compiled_template.h"
+#include "common/include/information_definitions.h"
+#include "common/include/informations.h"
+#include "common/include/output_template.h"
+#include "common/include/output_template_writer.h"
+#include "common/include/special_files.h"
+#include "common/include/template_column_items.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <nlohmann/json.hpp>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using namespace std;
+
+namespace {
+
+mmotd::information::Information MakeInformation(mmotd::information::InformationId id, const char *value) {
+    using mmotd::information::InformationDefinitions;
+    auto information = InformationDefinitions::Instance().GetInformationDefinition(id);
+    information.SetValue(value);
+    return information;
+}
+
+// The items as the json they are written as, which holds the names of their colors.  An item parsed from json can
+//  have more colors than names or values, only the colors which are used are kept.
+nlohmann::json ToJson(mmotd::output_template::TemplateColumnItems items) {
+    auto root = nlohmann::json::array();
+    for (auto &item : items) {
+        item.name_color.resize(std::min(size(item.name_color), std::max(size(item.name), size_t{1})));
+        item.value_color.resize(std::min(size(item.value_color), std::max(size(item.value), size_t{1})));
+        auto item_root = nlohmann::json();
+        item.to_json(item_root, mmotd::output_template::TemplateItemSettings{});
+        root.push_back(std::move(item_root));
+    }
+    return root;
+}
+
+fs::path MakeTestDirectory(string_view name) {
+    auto directory = fs::temp_directory_path() / (string{name} + "_" + std::to_string(getpid()));
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    return directory;
+}
+
+} // namespace
+
+namespace mmotd::output_template::test {
+
+CATCH_TEST_CASE("builtin compiled template matches mmotd_template.json", "[CompiledTemplate]") {
+    auto project_root = mmotd::core::special_files::FindProjectRootDirectory();
+    CATCH_REQUIRE(!empty(project_root));
+    auto template_path = project_root / "config" / "mmotd_template.json";
+    auto output_template = OutputTemplate::ParseOutputTemplate(template_path.string());
+    CATCH_REQUIRE(output_template);
+
+    auto compiled_template = CompiledTemplate::Compile(*output_template);
+    auto default_template = CompiledTemplate::GetDefault();
+    CATCH_CHECK(default_template.GetColumns() == compiled_template.GetColumns());
+    CATCH_CHECK(default_template.GetView().collapse_column_rows == compiled_template.GetView().collapse_column_rows);
+    CATCH_CHECK(default_template.GetView().table_type == compiled_template.GetView().table_type);
+    CATCH_CHECK(ToJson(default_template.GetColumnItems()) == ToJson(compiled_template.GetColumnItems()));
+    CATCH_CHECK(default_template.GetReferencedInformationIds() == output_template->GetReferencedInformationIds());
+
+    // the embedded colors of the builtin template are the ones their names are parsed to
+    CATCH_CHECK(size(default_template.GetView().colors) == size(compiled_template.GetView().colors));
+    for (const auto &color : compiled_template.GetView().colors) {
+        auto style = default_template.FindColor(color.name);
+        CATCH_REQUIRE(style);
+        CATCH_CHECK(color::to_string(*style) == color::to_string(color::from_color_string(color.name)));
+    }
+}
+
+CATCH_TEST_CASE("compiled template writes the same output as its items", "[CompiledTemplate]") {
+    using mmotd::information::InformationId;
+    using mmotd::output_template_writer::OutputTemplateWriter;
+    auto informations = mmotd::information::Informations{};
+    informations.push_back(MakeInformation(InformationId::ID_GENERAL_USER_NAME, "jdoe"));
+    informations.push_back(MakeInformation(InformationId::ID_BOOT_TIME_UP_TIME, "3 days"));
+    informations.push_back(MakeInformation(InformationId::ID_WEATHER_LOCATION, "Berlin"));
+    informations.push_back(MakeInformation(InformationId::ID_WEATHER_WEATHER, "sunny"));
+    informations.push_back(MakeInformation(InformationId::ID_NETWORK_INFO_INTERFACE_NAME, "eth0"));
+    informations.push_back(MakeInformation(InformationId::ID_NETWORK_INFO_IP, "10.0.0.2"));
+    informations.push_back(MakeInformation(InformationId::ID_NETWORK_INFO_MAC, "00:11:22:33:44:55"));
+    informations.push_back(MakeInformation(InformationId::ID_NETWORK_INFO_INTERFACE_NAME, "wlan0"));
+    informations.push_back(MakeInformation(InformationId::ID_NETWORK_INFO_IP, "192.168.1.7"));
+    informations.push_back(MakeInformation(InformationId::ID_NETWORK_INFO_MAC, "66:77:88:99:aa:bb"));
+    informations.push_back(MakeInformation(InformationId::ID_PACKAGE_MANAGEMENT_REBOOT_REQUIRED, "reboot required"));
+
+    auto compiled_template = CompiledTemplate::GetDefault();
+    auto output = to_string(OutputTemplateWriter(compiled_template, informations));
+    auto writer = OutputTemplateWriter(compiled_template.GetColumns(), compiled_template.GetColumnItems(), informations);
+    auto expected = to_string(writer);
+    CATCH_CHECK(output == expected);
+    // each interface is a row, the optional fortune without an information is left out
+    CATCH_CHECK(output.find("10.0.0.2") != string::npos);
+    CATCH_CHECK(output.find("192.168.1.7") != string::npos);
+    CATCH_CHECK(output.find("reboot required") != string::npos);
+    CATCH_CHECK(output.find("%ID_") == string::npos);
+}
+
+CATCH_TEST_CASE("compiled template is cached by the size and modification time of the file", "[CompiledTemplate]") {
+    auto directory = MakeTestDirectory("mmotd_test_compiled_template");
+    auto template_path = directory / "template.json";
+    auto cache_path = directory / "template.bin";
+    CATCH_REQUIRE(WriteDefaultOutputTemplate(template_path));
+    auto output_template = OutputTemplate::ParseOutputTemplate(template_path.string());
+    CATCH_REQUIRE(output_template);
+
+    auto compiled_template = CompiledTemplate::Compile(*output_template);
+    CATCH_REQUIRE(compiled_template.Write(cache_path, template_path));
+    auto cached_template = CompiledTemplate::Read(cache_path, template_path);
+    CATCH_REQUIRE(cached_template);
+    CATCH_CHECK(cached_template->GetColumns() == compiled_template.GetColumns());
+    CATCH_CHECK(cached_template->GetView().table_type == compiled_template.GetView().table_type);
+    CATCH_CHECK(ToJson(cached_template->GetColumnItems()) == ToJson(compiled_template.GetColumnItems()));
+    CATCH_CHECK(cached_template->GetReferencedInformationIds() == compiled_template.GetReferencedInformationIds());
+    CATCH_CHECK(size(cached_template->GetView().colors) == size(compiled_template.GetView().colors));
+
+    // the views point into the storage of the template which moves along with it
+    auto moved_template = std::move(*cached_template);
+    CATCH_CHECK(ToJson(moved_template.GetColumnItems()) == ToJson(compiled_template.GetColumnItems()));
+
+    // a changed template file is compiled again
+    fs::last_write_time(template_path, fs::last_write_time(template_path) + chrono::seconds{1});
+    CATCH_CHECK_FALSE(CompiledTemplate::Read(cache_path, template_path));
+
+    // a truncated cache is not read
+    CATCH_REQUIRE(compiled_template.Write(cache_path, template_path));
+    fs::resize_file(cache_path, fs::file_size(cache_path) - 1);
+    CATCH_CHECK_FALSE(CompiledTemplate::Read(cache_path, template_path));
+
+    auto ec = error_code{};
+    fs::remove_all(directory, ec);
+}
+
+} // namespace mmotd::output_template::test
@@ -129,6 +129,35 @@ output_color=true
 #  specified on the command line or with the following variable:
 # template_path="$HOME/.config/mmotd/mmotd_template.json"
 
+# The number of milliseconds the providers have to look up their information.  When the budget
+#  expires the output is written with the information which is ready and the late providers are
+#  cancelled.  A value of 0 waits for every provider.
+latency_budget_ms=1500
+
+[cache]
+# The informations found by each provider are saved in a snapshot, $XDG_CACHE_HOME/mmotd/snapshot.bin,
+#  (or $HOME/.cache/mmotd/snapshot.bin) so that only the providers which have expired are looked up again.
+enabled=true
+
+[cache.ttl]
+# The number of seconds each provider's snapshot is valid:
+#  0 means the provider is looked up every time and -1 means the snapshot is valid until the next reboot.
+#  Providers which are not listed are never cached.
+hardware=-1
+system_information=-1
+external_network=3600
+package_management=3600
+weather=1800
+load_average=0
+
+[daemon]
+# `mmotd --daemon` keeps the informations and the template resident, refreshes them every
+#  'daemon.refresh_interval' seconds and serves the rendered output to mmotd over a unix domain socket.
+#  When the daemon is not running mmotd renders the output itself.
+# The default location of the socket is:
+# socket_path="$XDG_RUNTIME_DIR/mmotd.sock"
+refresh_interval=60
+
 [fortune]
 # fortune: the facility to print a random, hopefully interesting, adage
 #  the 'fortune.db_directory' can specify a directory which contains the
@@ -0,0 +1,147 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/information_definitions.h"
+#include "common/include/informations.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using namespace std;
+
+namespace {
+
+mmotd::information::Information MakeInformation(mmotd::information::InformationId id, const char *value) {
+    using mmotd::information::InformationDefinitions;
+    auto information = InformationDefinitions::Instance().GetInformationDefinition(id);
+    information.SetValue(value);
+    return information;
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("every information id has a dense index", "[Informations]") {
+    using namespace mmotd::information;
+    for (auto index = size_t{0}; index != INFORMATION_COUNT; ++index) {
+        auto information_index = ToInformationIndex(INFORMATION_IDS[index]);
+        CATCH_REQUIRE(information_index);
+        CATCH_CHECK(*information_index == index);
+    }
+    CATCH_CHECK(!ToInformationIndex(InformationId::ID_INVALID_INVALID_INFORMATION));
+}
+
+CATCH_TEST_CASE("every plain id string finds its id", "[Informations]") {
+    using namespace mmotd::information;
+    for (const auto &definition : INFORMATION_DEFINITIONS) {
+        CATCH_CHECK(FindInformationId(definition.plain_id_str) == definition.id);
+        CATCH_CHECK(FindInformationDefinition(definition.id) == &definition);
+        CATCH_CHECK(to_string(definition.id) == definition.plain_id_str);
+    }
+    CATCH_CHECK(!FindInformationId("ID_WEATHER_WEATHERS"));
+    CATCH_CHECK(!FindInformationId(""));
+    CATCH_CHECK(from_information_id_string("ID_NOT_AN_INFORMATION") == InformationId::ID_INVALID_INVALID_INFORMATION);
+    CATCH_CHECK(FindInformationDefinition(InformationId::ID_INVALID_INVALID_INFORMATION) == nullptr);
+}
+
+CATCH_TEST_CASE("an information reads its metadata from the definition table", "[Informations]") {
+    using namespace mmotd::information;
+    for (auto index = size_t{0}; index != INFORMATION_COUNT; ++index) {
+        CATCH_CHECK(INFORMATION_DEFINITIONS[index].id == INFORMATION_IDS[index]);
+    }
+    auto timezone = MakeInformation(InformationId::ID_LOCATION_INFO_TIMEZONE, "America/Denver");
+    CATCH_CHECK(timezone.GetIdStr() == "InformationId::ID_LOCATION_INFO_TIMEZONE");
+    CATCH_CHECK(timezone.GetPlainIdStr() == "ID_LOCATION_INFO_TIMEZONE");
+    CATCH_CHECK(timezone.GetName() == "timezone");
+    CATCH_CHECK(timezone.GetFormat() == "{}");
+    CATCH_CHECK(timezone.GetValue() == "America/Denver");
+
+    auto invalid = Information{};
+    CATCH_CHECK(invalid.GetId() == InformationId::ID_INVALID_INVALID_INFORMATION);
+    CATCH_CHECK(empty(invalid.GetValue()));
+}
+
+CATCH_TEST_CASE("an information keeps its raw value until it is formatted", "[Informations]") {
+    using namespace mmotd::information;
+    const auto &definitions = InformationDefinitions::Instance();
+    auto load_average = definitions.GetInformationDefinition(InformationId::ID_LOAD_AVERAGE_LOAD_AVERAGE);
+    load_average.SetValue(1.23456);
+    CATCH_CHECK(std::holds_alternative<double>(load_average.GetRawValue()));
+    CATCH_CHECK(load_average.GetValue() == "1.23");
+    // the "{:.02f}" format is only for floating point, any other number falls back to "{}"
+    load_average.SetValue(size_t{2});
+    CATCH_CHECK(load_average.GetValue() == "2");
+
+    auto process_count = definitions.GetInformationDefinition(InformationId::ID_PROCESSES_PROCESS_COUNT);
+    process_count.SetValue(-42);
+    CATCH_CHECK(std::holds_alternative<std::int64_t>(process_count.GetRawValue()));
+    CATCH_CHECK(process_count.GetValue() == "-42");
+    process_count.SetValue(std::string_view{"[unknown]"});
+    CATCH_CHECK(process_count.GetValue() == "[unknown]");
+}
+
+CATCH_TEST_CASE("Informations groups the informations by id", "[Informations]") {
+    using namespace mmotd::information;
+    auto informations = Informations{};
+    CATCH_CHECK(informations.empty());
+    CATCH_CHECK(empty(informations.at(InformationId::ID_NETWORK_INFO_IP)));
+
+    informations.push_back(MakeInformation(InformationId::ID_NETWORK_INFO_IP, "10.0.0.2"));
+    informations.push_back(MakeInformation(InformationId::ID_NETWORK_INFO_IP, "192.168.1.2"));
+    informations.push_back(MakeInformation(InformationId::ID_GENERAL_USER_NAME, "jasonivey"));
+    CATCH_CHECK(size(informations) == 2);
+    CATCH_CHECK(informations.contains(InformationId::ID_NETWORK_INFO_IP));
+    CATCH_CHECK(!informations.contains(InformationId::ID_NETWORK_INFO_MAC));
+
+    const auto &addresses = informations.at(InformationId::ID_NETWORK_INFO_IP);
+    CATCH_REQUIRE(size(addresses) == 2);
+    CATCH_CHECK(addresses.front().GetValue() == "10.0.0.2");
+    CATCH_CHECK(addresses.back().GetValue() == "192.168.1.2");
+
+    // iterated in the order of information_defs.h
+    auto ids = vector<InformationId>{};
+    for (const auto &[id, entries] : informations) {
+        ids.push_back(id);
+    }
+    CATCH_CHECK(ids == vector<InformationId>{InformationId::ID_GENERAL_USER_NAME, InformationId::ID_NETWORK_INFO_IP});
+
+    auto copied = informations;
+    informations.clear();
+    CATCH_CHECK(informations.empty());
+    CATCH_CHECK(size(copied.at(InformationId::ID_NETWORK_INFO_IP)) == 2);
+
+    // the moved from store is empty
+    auto moved = std::move(copied);
+    CATCH_CHECK(size(moved) == 2);
+    CATCH_CHECK(copied.empty()); // NOLINT(bugprone-use-after-move)
+    CATCH_CHECK(begin(copied) == end(copied));
+    copied = std::move(moved);
+    CATCH_CHECK(size(copied) == 2);
+    CATCH_CHECK(moved.empty()); // NOLINT(bugprone-use-after-move)
+}
+
+CATCH_TEST_CASE("InformationsView merges informations without copying them", "[Informations]") {
+    using namespace mmotd::information;
+    auto general = Informations{};
+    general.push_back(MakeInformation(InformationId::ID_GENERAL_USER_NAME, "jasonivey"));
+    auto weather = Informations{};
+    weather.push_back(MakeInformation(InformationId::ID_WEATHER_WEATHER, "+54°F ☀️ Clear"));
+
+    auto view = InformationsView{general};
+    view.Merge(weather);
+    CATCH_CHECK(size(view) == 2);
+    CATCH_CHECK(&view.at(InformationId::ID_GENERAL_USER_NAME) == &general.at(InformationId::ID_GENERAL_USER_NAME));
+    CATCH_CHECK(&view.at(InformationId::ID_WEATHER_WEATHER) == &weather.at(InformationId::ID_WEATHER_WEATHER));
+    CATCH_CHECK(!view.contains(InformationId::ID_WEATHER_SUNSET));
+
+    view.clear();
+    CATCH_CHECK(view.empty());
+    CATCH_CHECK(begin(view) == end(view));
+}
+
+} // namespace mmotd::test
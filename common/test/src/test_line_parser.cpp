@@ -0,0 +1,61 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/line_parser.h"
+
+#include <array>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using namespace std;
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("ForEachLine visits every line without its newline", "[line_parser]") {
+    using mmotd::core::ForEachLine;
+    auto lines = vector<string_view>{};
+    ForEachLine("first\nsecond\r\n\nlast", [&lines](string_view line) { lines.push_back(line); });
+    CATCH_REQUIRE(size(lines) == 4);
+    CATCH_CHECK(lines[0] == "first");
+    CATCH_CHECK(lines[1] == "second\r");
+    CATCH_CHECK(lines[2].empty());
+    CATCH_CHECK(lines[3] == "last");
+
+    auto line_count = 0;
+    ForEachLine("first\nsecond\nthird\n", [&line_count](string_view) { return ++line_count != 2; });
+    CATCH_CHECK(line_count == 2);
+}
+
+CATCH_TEST_CASE("SplitNameValue trims the name and the value", "[line_parser]") {
+    using mmotd::core::SplitNameValue;
+    auto name_value = SplitNameValue("model name\t: Intel(R) Core(TM) i7-8700 CPU @ 3.20GHz  \r");
+    CATCH_REQUIRE(name_value);
+    CATCH_CHECK(name_value->first == "model name");
+    CATCH_CHECK(name_value->second == "Intel(R) Core(TM) i7-8700 CPU @ 3.20GHz");
+
+    // only the first separator splits the line
+    name_value = SplitNameValue("time: 12:30");
+    CATCH_REQUIRE(name_value);
+    CATCH_CHECK(name_value->second == "12:30");
+
+    CATCH_CHECK(!SplitNameValue("no separator"));
+    CATCH_CHECK(mmotd::core::TrimBlanks(" \t\n ").empty());
+}
+
+#if defined(__linux__)
+CATCH_TEST_CASE("ReadVirtualFile reads files which report no size", "[line_parser]") {
+    using mmotd::core::ReadVirtualFile;
+    auto contents = ReadVirtualFile("/proc/self/status");
+    CATCH_REQUIRE(contents);
+    CATCH_CHECK(contents->starts_with("Name:"));
+
+    auto buffer = array<char, 8>{};
+    auto first_bytes = ReadVirtualFile("/proc/self/status", buffer);
+    CATCH_REQUIRE(first_bytes);
+    CATCH_CHECK(*first_bytes == string_view{*contents}.substr(0, size(buffer)));
+
+    CATCH_CHECK(!ReadVirtualFile("/proc/self/does_not_exist"));
+}
+#endif
+
+} // namespace mmotd::test
@@ -0,0 +1,107 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/mapped_file.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <unistd.h>
+
+using namespace std;
+using namespace std::literals;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct TestRecord {
+    uint32_t first;
+    uint32_t second;
+};
+
+fs::path GetTestDirectory() {
+    auto directory = fs::temp_directory_path() / ("mmotd_test_mapped_file_" + to_string(getpid()));
+    auto ec = error_code{};
+    fs::remove_all(directory, ec);
+    fs::create_directories(directory);
+    return directory;
+}
+
+} // namespace
+
+namespace mmotd::core::test {
+
+CATCH_TEST_CASE("WriteFileAtomically writes the parts which MappedFile maps back", "[MappedFile]") {
+    auto directory = GetTestDirectory();
+    auto file_path = directory / "records.bin";
+    auto header = TestRecord{1, 2};
+    auto records = vector<TestRecord>{{3, 4}, {5, 6}};
+    auto parts = array{AsBytes(header), AsBytes(records), "pool"sv};
+    CATCH_REQUIRE(WriteFileAtomically(file_path, parts));
+
+    auto mapped_file = MappedFile::Open(file_path);
+    CATCH_REQUIRE(mapped_file);
+    CATCH_REQUIRE(mapped_file->size() == 3 * sizeof(TestRecord) + size("pool"sv));
+    auto last_record = TestRecord{};
+    memcpy(&last_record, mapped_file->data() + 2 * sizeof(TestRecord), sizeof(TestRecord));
+    CATCH_CHECK(last_record.first == 5);
+    CATCH_CHECK(last_record.second == 6);
+    CATCH_CHECK(mapped_file->view().substr(3 * sizeof(TestRecord)) == "pool"sv);
+
+    // a file which is replaced does not change under a mapping of the previous one
+    auto replacement = array{"replaced"sv};
+    CATCH_REQUIRE(WriteFileAtomically(file_path, replacement));
+    CATCH_CHECK(mapped_file->view().substr(3 * sizeof(TestRecord)) == "pool"sv);
+    CATCH_CHECK(MappedFile::Open(file_path)->view() == "replaced"sv);
+    // and no temporary file is left behind
+    CATCH_CHECK(distance(fs::directory_iterator{directory}, fs::directory_iterator{}) == 1);
+
+    auto ec = error_code{};
+    fs::remove_all(directory, ec);
+}
+
+CATCH_TEST_CASE("WriteFileAtomically fails without a directory to write into", "[MappedFile]") {
+    auto directory = GetTestDirectory();
+    auto parts = array{"contents"sv};
+    CATCH_CHECK(!WriteFileAtomically(directory / "missing" / "file.bin", parts));
+    CATCH_CHECK(fs::is_empty(directory));
+
+    auto ec = error_code{};
+    fs::remove_all(directory, ec);
+}
+
+CATCH_TEST_CASE("HashCacheKey is FNV-1a", "[MappedFile]") {
+    CATCH_CHECK(HashCacheKey(""sv) == uint64_t{0xcbf29ce484222325ull});
+    CATCH_CHECK(HashCacheKey("a"sv) == uint64_t{0xaf63dc4c8601ec8cull});
+    CATCH_CHECK(HashCacheKey("/usr/share/games/fortunes"sv) != HashCacheKey("/usr/share/games/fortunes/"sv));
+}
+
+CATCH_TEST_CASE("GetSizeAndModificationTime notices a file which changed", "[MappedFile]") {
+    auto directory = GetTestDirectory();
+    auto file_path = directory / "source.txt";
+    CATCH_CHECK(!GetModificationTime(file_path));
+    CATCH_CHECK(!GetSizeAndModificationTime(file_path));
+
+    auto parts = array{"contents"sv};
+    CATCH_REQUIRE(WriteFileAtomically(file_path, parts));
+    auto size_and_mtime = GetSizeAndModificationTime(file_path);
+    CATCH_REQUIRE(size_and_mtime);
+    CATCH_CHECK(size_and_mtime->first == size("contents"sv));
+    CATCH_CHECK(size_and_mtime->second == GetModificationTime(file_path));
+
+    fs::last_write_time(file_path, fs::last_write_time(file_path) + chrono::seconds{1});
+    CATCH_CHECK(GetModificationTime(file_path) != size_and_mtime->second);
+
+    auto ec = error_code{};
+    fs::remove_all(directory, ec);
+}
+
+} // namespace mmotd::core::test
@@ -53,4 +53,21 @@ CATCH_TEST_CASE("default output template matches mmotd_template.json", "[OutputT
     CATCH_CHECK(default_template_json == default_output_template_json);
 }
 
+CATCH_TEST_CASE("default output template references information ids", "[OutputTemplate]") {
+    using mmotd::information::InformationId;
+    auto output_template = OutputTemplate{};
+    auto information_ids = output_template.GetReferencedInformationIds();
+
+    CATCH_CHECK(size(information_ids) == 43);
+    // more than one id in a single value and an id which follows a color specification
+    CATCH_CHECK(information_ids.contains(InformationId::ID_GENERAL_GREETING));
+    CATCH_CHECK(information_ids.contains(InformationId::ID_GENERAL_USER_NAME));
+    CATCH_CHECK(information_ids.contains(InformationId::ID_LAST_LOGIN_LOGOUT_TIME));
+    // ids which appear only in names
+    CATCH_CHECK(information_ids.contains(InformationId::ID_WEATHER_LOCATION));
+    CATCH_CHECK(!information_ids.contains(InformationId::ID_LOCATION_INFO_CITY));
+    CATCH_CHECK(!information_ids.contains(InformationId::ID_MEMORY_USAGE_FREE));
+    CATCH_CHECK(!information_ids.contains(InformationId::ID_INVALID_INVALID_INFORMATION));
+}
+
 } // namespace mmotd::output_template::test
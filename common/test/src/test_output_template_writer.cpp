@@ -1,5 +1,7 @@
 // vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/informations.h"
 #include "common/include/output_template_writer.h"
+#include "common/include/template_column_items.h"
 
 #include <algorithm>
 #include <iterator>
@@ -131,4 +133,23 @@ CATCH_TEST_CASE("ensure double delim is ignored when splitting", "[OutputTemplat
     CATCH_CHECK_THAT(converted_text, Catch::Matchers::Equals(dst_text));
 }
 
+CATCH_TEST_CASE("the writer colors its output as it is told", "[OutputTemplateWriter]") {
+    using mmotd::output_template::TemplateColumnItem;
+    auto item = TemplateColumnItem{};
+    item.name = {"Name:"};
+    item.value = {"the %color:bold_bright_green%value"};
+    auto informations = mmotd::information::Informations{};
+    auto writer = OutputTemplateWriter({mmotd::output_template::ENTIRE_LINE}, {item}, informations);
+
+    writer.SetColorOutput(false);
+    auto plain = to_string(writer);
+    CATCH_CHECK(plain.find("\x1b") == string::npos);
+    CATCH_CHECK(plain.find("the value") != string::npos);
+
+    writer.SetColorOutput(true);
+    auto color = to_string(writer);
+    CATCH_CHECK(color.find("\x1b") != string::npos);
+    CATCH_CHECK(color.find("value") != string::npos);
+}
+
 } // namespace mmotd::output_template_writer::test
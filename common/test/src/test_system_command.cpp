@@ -0,0 +1,105 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#if !defined(_WIN32)
+#include "common/include/system_command.h"
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using namespace std;
+
+namespace {
+
+mmotd::system::command::Command MakeShellCommand(string script) {
+    return mmotd::system::command::Command{"/bin/sh", {"-c", std::move(script)}};
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("Execute captures stdout, stderr and the exit code", "[system_command]") {
+    using mmotd::system::command::Execute;
+    auto result = Execute(MakeShellCommand("echo out; echo err >&2; read line; echo \"[$line]\"; exit 3"));
+    CATCH_REQUIRE(result.exit_code);
+    CATCH_CHECK(*result.exit_code == 3);
+    CATCH_CHECK_FALSE(result.succeeded());
+    // stdin is /dev/null so the read finds nothing
+    CATCH_CHECK(result.output == "out\n[]\n");
+    CATCH_CHECK(result.error == "err\n");
+    CATCH_CHECK_FALSE(result.timed_out);
+    CATCH_CHECK_FALSE(result.truncated);
+
+    result = Execute(mmotd::system::command::Command{"/this/does/not/exist", {}});
+    CATCH_CHECK_FALSE(result.exit_code);
+}
+
+CATCH_TEST_CASE("Execute kills a command which runs past its deadline", "[system_command]") {
+    using mmotd::system::command::Execute;
+    auto command = MakeShellCommand("trap '' TERM; echo started; sleep 10");
+    command.timeout = chrono::milliseconds{100};
+    auto start = chrono::steady_clock::now();
+    auto result = Execute(command);
+    CATCH_CHECK(chrono::steady_clock::now() - start < chrono::seconds{5});
+    CATCH_CHECK(result.timed_out);
+    CATCH_CHECK_FALSE(result.exit_code);
+    CATCH_CHECK(result.output == "started\n");
+}
+
+#if defined(__linux__)
+CATCH_TEST_CASE("Execute kills the processes started by a command which runs past its deadline", "[system_command]") {
+    using mmotd::system::command::Execute;
+    auto command = MakeShellCommand("sleep 10 & echo $!; wait");
+    command.timeout = chrono::milliseconds{100};
+    auto result = Execute(command);
+    CATCH_CHECK(result.timed_out);
+    auto pid = stoi(result.output);
+    CATCH_REQUIRE(pid > 0);
+
+    // the sleep is gone (or a zombie waiting on whoever inherited it) shortly after the deadline
+    auto is_running = [pid]() {
+        auto stat = ifstream{"/proc/" + std::to_string(pid) + "/stat"};
+        auto line = string{};
+        return getline(stat, line) && line.find(") Z ") == string::npos;
+    };
+    auto deadline = chrono::steady_clock::now() + chrono::seconds{2};
+    while (is_running() && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::milliseconds{10});
+    }
+    CATCH_CHECK_FALSE(is_running());
+}
+#endif
+
+CATCH_TEST_CASE("Execute keeps at most the output limit", "[system_command]") {
+    using mmotd::system::command::Execute;
+    auto command = MakeShellCommand("i=0; while [ $i -lt 1000 ]; do echo 0123456789; i=$((i + 1)); done");
+    command.output_limit = 100;
+    auto result = Execute(command);
+    CATCH_CHECK(result.succeeded());
+    CATCH_CHECK(result.truncated);
+    CATCH_CHECK(result.output.size() == 100);
+}
+
+CATCH_TEST_CASE("ExecuteAll runs the commands concurrently", "[system_command]") {
+    using mmotd::system::command::ExecuteAll;
+    auto commands = vector<mmotd::system::command::Command>{};
+    for (auto i = 0; i != 4; ++i) {
+        commands.push_back(MakeShellCommand("sleep 1; echo " + std::to_string(i)));
+    }
+    auto start = chrono::steady_clock::now();
+    auto results = ExecuteAll(commands);
+    CATCH_CHECK(chrono::steady_clock::now() - start < chrono::seconds{3});
+    CATCH_REQUIRE(results.size() == 4);
+    for (auto i = size_t{0}; i != 4; ++i) {
+        CATCH_CHECK(results[i].succeeded());
+        CATCH_CHECK(results[i].output == std::to_string(i) + "\n");
+    }
+}
+
+} // namespace mmotd::test
+#endif
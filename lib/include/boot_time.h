@@ -6,7 +6,9 @@
 
 #include <cstdint>
 #include <optional>
+#include <stop_token>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace mmotd::information {
@@ -15,8 +17,10 @@ class BootTime : public InformationProvider {
 public:
     DEFAULT_CONSTRUCTORS_COPY_MOVE_OPERATORS_VIRTUAL_DESTRUCTOR(BootTime);
 
+    std::string_view GetName() const noexcept override { return "boot_time"; }
+
 protected:
-    void FindInformation() override;
+    void FindInformation(std::stop_token stop_token) override;
 };
 
 } // namespace mmotd::information
@@ -2,49 +2,110 @@
 #pragma once
 #include "common/include/big_five_macros.h"
 #include "common/include/information.h"
+#include "common/include/informations.h"
+#include "lib/include/task_graph.h"
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <optional>
+#include <stop_token>
+#include <string_view>
 #include <vector>
 
+#include <boost/asio/thread_pool.hpp>
+
 namespace mmotd::information {
 
+class InformationCache;
 class InformationProvider;
 using InformationProviderPtr = std::unique_ptr<InformationProvider>;
 using InformationProviderCreator = std::function<InformationProviderPtr()>;
 
-bool RegisterInformationProvider(InformationProviderCreator creator);
+// The name is the one `GetName` returns, so the provider can be depended on without being created.  The ids are
+//  every information the provider produces, they decide whether the provider is needed at all
+bool RegisterInformationProvider(std::string_view name,
+                                 InformationProviderCreator creator,
+                                 InformationIds information_ids);
+
+// The providers producing at least one of `information_ids` (every provider when there are no ids) along with
+//  the providers they depend on
+std::vector<std::shared_ptr<InformationProvider>>
+CreateInformationProviders(const std::optional<InformationIds> &information_ids);
 
 class ComputerInformation {
 public:
-    NO_CONSTRUCTOR_DEFAULT_COPY_MOVE_OPERATORS_DESTRUCTOR(ComputerInformation);
+    // Shared (rather than unique) so a provider which runs past the deadline outlives this object
+    using InformationProviders = std::vector<std::shared_ptr<InformationProvider>>;
+
+    // Looks up `information_providers` instead of the registered providers, i.e. the providers of a test
+    explicit ComputerInformation(InformationProviders information_providers);
+    ~ComputerInformation();
+    ComputerInformation(ComputerInformation const &other) = delete;
+    ComputerInformation &operator=(ComputerInformation const &other) = delete;
+    ComputerInformation(ComputerInformation &&other) = delete;
+    ComputerInformation &operator=(ComputerInformation &&other) = delete;
 
     static ComputerInformation &Instance();
 
+    // Only the providers producing at least one of these ids are created (by default every provider is created)
+    //  This has to be called before the first lookup, i.e. before CacheInformation
+    void SetRequiredInformationIds(InformationIds information_ids);
+
     // Made public for future use -- currently this is called internally by GetAllInformations & GetInformations
+    //  The lookups are bounded by 'core.latency_budget_ms', providers which are still running when the budget
+    //  expires are asked to stop and their informations are left out.  The lookups (and their sub-tasks) are
+    //  scheduled as a task graph so a provider only waits on the providers it depends on.
     void CacheInformation();
 
+    // Looks up every provider whose snapshot has expired again -- used by the resident daemon
+    void RefreshInformation();
+
     // This method does not call the CacheInformation method
     std::optional<Information> FindInformation(InformationId id) const;
 
     // These methods DO call the CacheInformation method
-    Informations &GetAllInformations();
+    //  The view points into the informations of the providers, it is valid until the next RefreshInformation
+    const InformationsView &GetAllInformations();
     std::vector<Information> GetInformations();
 
 private:
     ComputerInformation();
 
-    using InformationProviders = std::vector<InformationProviderPtr>;
-    InformationProviders GetInformationProviders();
+    using Deadline = std::chrono::steady_clock::time_point;
     void SetInformationProviders();
 
+    InformationProviders RestoreInformationProviders(const InformationProviders &providers,
+                                                     const InformationCache &snapshot_cache);
+
     bool IsInformationCached() const;
-    void CacheInformationAsync();
-    void CacheInformationSerial();
+    InformationProviders GetIdleInformationProviders() const;
+
+    using ProviderFinished = std::function<void(const std::shared_ptr<InformationProvider> &)>;
+    // Adds the lookup of every provider, after the providers it depends on, with `finished` called at the end of
+    //  each lookup -- the dependencies are looked for in `idle_providers`
+    TaskGraph CreateLookupGraph(const InformationProviders &providers,
+                                const InformationProviders &idle_providers,
+                                std::stop_token stop_token,
+                                ProviderFinished finished) const;
+
+    // These methods return the providers which finished before the deadline
+    InformationProviders CacheInformationAsync(const InformationProviders &providers,
+                                               const InformationProviders &idle_providers,
+                                               Deadline deadline);
+    InformationProviders CacheInformationSerial(const InformationProviders &providers,
+                                                const InformationProviders &idle_providers,
+                                                Deadline deadline);
+
+    struct LookupState;
 
+    std::optional<InformationIds> required_information_ids_;
     InformationProviders information_providers_;
-    Informations information_cache_;
+    InformationsView information_cache_;
+    std::shared_ptr<LookupState> lookup_state_;
+    // Stops the providers of the lookup in flight, when the deadline expires or when this object is destroyed
+    std::stop_source stop_source_;
+    std::unique_ptr<boost::asio::thread_pool> thread_pool_;
 };
 
 } // namespace mmotd::information
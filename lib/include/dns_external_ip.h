@@ -0,0 +1,41 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+
+#include <boost/asio/ip/address.hpp>
+#include <boost/asio/ip/udp.hpp>
+
+namespace mmotd::networking {
+
+// A resolver which answers a query for a special name with the address the query came from, by default the
+//  'myip.opendns.com' A record of resolver1.opendns.com
+struct DnsExternalIpResolver {
+    boost::asio::ip::udp::endpoint server;
+    std::string name;
+    std::chrono::milliseconds timeout{300};
+    int attempts = 2;
+
+    // Reads 'network.dns_server', 'network.dns_name', 'network.dns_timeout_ms' and 'network.dns_attempts'
+    static std::optional<DnsExternalIpResolver> FromConfig();
+};
+
+// Finds the external ip address with a single udp query, which is sent again (with a new id) after each timeout.
+//  The answer to any of the queries sent is accepted, so an answer which arrives late is not wasted.
+std::optional<boost::asio::ip::address> QueryExternalIpAddress(const DnsExternalIpResolver &resolver,
+                                                               std::stop_token stop_token = std::stop_token{});
+
+// The wire format of a recursive query for the A record of `name`
+std::string BuildDnsQuery(std::uint16_t id, std::string_view name);
+
+// The first A (or AAAA) record in the answer to the query with `id`
+std::optional<boost::asio::ip::address> ParseDnsResponse(std::string_view response, std::uint16_t id);
+
+// "208.67.222.222", "208.67.222.222:53" or "[2620:119:35::35]:53"
+std::optional<boost::asio::ip::udp::endpoint> ParseDnsServer(std::string_view server);
+
+} // namespace mmotd::networking
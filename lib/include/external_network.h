@@ -6,21 +6,29 @@
 
 #include <cstdint>
 #include <optional>
+#include <stop_token>
 #include <string>
+#include <string_view>
 #include <utility>
 
+#include <boost/asio/ip/address.hpp>
+
 namespace mmotd::information {
 
 class ExternalNetwork : public InformationProvider {
 public:
     DEFAULT_CONSTRUCTORS_COPY_MOVE_OPERATORS_VIRTUAL_DESTRUCTOR(ExternalNetwork);
 
+    std::string_view GetName() const noexcept override { return "external_network"; }
+
 protected:
-    void FindInformation() override;
+    void FindInformation(std::stop_token stop_token) override;
 
 private:
     std::pair<std::string, std::string> GetRequestUrl() const;
 
+    void AddGeoIpLocation(const boost::asio::ip::address &ip_address);
+
     void ParseJsonResponse(const std::string &response);
 };
 
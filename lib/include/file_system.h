@@ -7,7 +7,9 @@
 #include <cstdint>
 #include <ctime>
 #include <optional>
+#include <stop_token>
 #include <string>
+#include <string_view>
 
 namespace mmotd::information {
 
@@ -15,8 +17,10 @@ class FileSystem : public InformationProvider {
 public:
     DEFAULT_CONSTRUCTORS_COPY_MOVE_OPERATORS_VIRTUAL_DESTRUCTOR(FileSystem);
 
+    std::string_view GetName() const noexcept override { return "file_system"; }
+
 protected:
-    void FindInformation() override;
+    void FindInformation(std::stop_token stop_token) override;
 };
 
 } // namespace mmotd::information
@@ -0,0 +1,200 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#include "common/include/mapped_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mmotd::fortune {
+
+// $XDG_CACHE_HOME/mmotd/fortune/<hash of the path>.idx, for the index of a directory or of a file which is not writable
+std::filesystem::path GetCacheIndexPath(const std::filesystem::path &path);
+
+//
+// A fortune file and its STRFILE database (the .dat file written by `strfile`), both memory mapped.  A fortune is
+//  read through the offset in the database, nothing but that fortune is touched.
+//
+class StrFile {
+public:
+    // `text_path` is the fortune file, the database is the same path with .dat appended
+    static std::optional<StrFile> Open(const std::filesystem::path &text_path);
+
+    std::size_t GetCount() const noexcept { return count_; }
+
+    std::optional<std::string> GetFortune(std::size_t index) const;
+
+    char GetDelimiter() const noexcept { return delimiter_; }
+    bool IsRotated() const noexcept { return rotated_; }
+
+private:
+    StrFile() = default;
+
+    mmotd::core::MappedFile dat_file_;
+    mmotd::core::MappedFile text_file_;
+    std::size_t count_ = 0;
+    char delimiter_ = '%';
+    bool rotated_ = false;
+};
+
+// The fortune `index` of a FortuneDirectoryIndex, which is fortune `index` of the file at `text_path`
+struct FortuneLocation {
+    std::filesystem::path text_path;
+    std::size_t index = 0;
+    std::size_t count = 0;
+};
+
+//
+// The number of fortunes in each of the STRFILE databases in a directory, so a fortune is drawn uniformly from all of
+//  them (like `fortune -a`) without opening every database.  The index is rebuilt when the modification time of the
+//  directory changes.
+//
+// File layout (native byte order):
+//  FortuneIndexHeader | FortuneIndexRecord of each file, in the order of their names | file name pool
+//
+class FortuneDirectoryIndex {
+public:
+    // Opens the index at `index_path`, (re)writing it first when it is missing or older than `directory`
+    static std::optional<FortuneDirectoryIndex> Open(const std::filesystem::path &directory,
+                                                     const std::filesystem::path &index_path);
+
+    static bool Write(const std::filesystem::path &directory, const std::filesystem::path &index_path);
+
+    std::size_t GetCount() const noexcept { return count_; }
+    std::size_t GetFileCount() const noexcept { return file_count_; }
+
+    // The file which holds fortune `index`, a binary search of the running count of each file
+    std::optional<FortuneLocation> Locate(std::size_t index) const;
+
+    // The fortune file of each record, in the order of their names
+    std::vector<std::filesystem::path> GetTextPaths() const;
+
+private:
+    FortuneDirectoryIndex() = default;
+
+    static std::optional<FortuneDirectoryIndex> Read(const std::filesystem::path &directory,
+                                                     const std::filesystem::path &index_path);
+
+    mmotd::core::MappedFile mapped_file_;
+    std::filesystem::path directory_;
+    std::size_t count_ = 0;
+    std::size_t file_count_ = 0;
+    const char *records_ = nullptr;
+    std::string_view name_pool_;
+};
+
+// The size of a fortune as it is printed, the width is in columns with a tab reaching the next multiple of 8
+struct FortuneMetrics {
+    std::size_t size = 0;
+    std::size_t line_count = 0;
+    std::size_t max_width = 0;
+};
+
+// The limits a drawn fortune has to fit in, zero is no limit
+struct FortuneConstraints {
+    std::size_t max_lines = 0;
+    std::size_t max_width = 0;
+
+    bool empty() const noexcept { return max_lines == 0 && max_width == 0; }
+    bool IsSatisfiedBy(const FortuneMetrics &metrics) const noexcept {
+        return (max_lines == 0 || metrics.line_count <= max_lines) &&
+               (max_width == 0 || metrics.max_width <= max_width);
+    }
+};
+
+//
+// A text file of fortunes separated by lines holding only '%', with or without a STRFILE database.  The offset, size,
+//  line count and width of every fortune are found with a single memchr scan of the file the first time it is used
+//  and saved next to it (or in the cache directory when that is not writable), keyed by the size and modification
+//  time of the file.  A fortune is then read with a single pread.  When there is a STRFILE database its delimiter is
+//  used and its rotated flag is kept in the index.
+//
+// Index layout (native byte order): TextIndexHeader | TextIndexEntry of each fortune
+//
+class TextFortuneFile {
+public:
+    // Opens the index of `text_path`, writing it first when it is missing or does not match the file
+    static std::optional<TextFortuneFile> Open(const std::filesystem::path &text_path);
+
+    // <text_path>.idx, then GetCacheIndexPath(text_path)
+    static std::vector<std::filesystem::path> GetIndexPaths(const std::filesystem::path &text_path);
+
+    static bool Write(const std::filesystem::path &text_path, const std::filesystem::path &index_path);
+
+    std::size_t GetCount() const noexcept { return count_; }
+    const std::filesystem::path &GetTextPath() const noexcept { return text_path_; }
+
+    // Read from the index, the fortune itself is not read
+    FortuneMetrics GetMetrics(std::size_t index) const;
+
+    // Each line with its trailing blanks removed, as the fortune was written
+    std::optional<std::string> GetFortune(std::size_t index) const;
+
+private:
+    TextFortuneFile() = default;
+
+    static std::optional<TextFortuneFile> Read(const std::filesystem::path &text_path,
+                                               const std::filesystem::path &index_path);
+
+    mmotd::core::MappedFile mapped_file_;
+    std::filesystem::path text_path_;
+    std::size_t count_ = 0;
+    const char *entries_ = nullptr;
+    bool rotated_ = false;
+};
+
+//
+// The fortunes of one or more text files which fit a FortuneConstraints.  The table holds the number of eligible
+//  fortunes of every file before and including each file (a prefix sum) and the index of each eligible fortune, so a
+//  fortune is drawn uniformly from all of them by a single lookup, without reading any of the fortunes which do not
+//  fit.  The table is built from the metrics in the index of each file and saved in the cache directory, keyed by the
+//  constraints and the files, with the size and modification time of each file.  Opening it again only checks the
+//  files, the metrics of every fortune are read again when a file or the constraints change.
+//
+// File layout (native byte order):
+//  EligibleIndexHeader | EligibleIndexRecord of each file | uint32_t index of each eligible fortune | path pool
+//
+class EligibleFortunes {
+public:
+    // Opens the table at `index_path`, (re)writing it first when it does not match the files or the constraints.
+    //  The table is only kept in memory when it can not be saved.
+    static std::optional<EligibleFortunes> Open(const std::vector<std::filesystem::path> &text_paths,
+                                                FortuneConstraints constraints,
+                                                const std::filesystem::path &index_path);
+
+    // $XDG_CACHE_HOME/mmotd/fortune/<hash of the constraints and the paths>.elg
+    static std::filesystem::path GetIndexPath(const std::vector<std::filesystem::path> &text_paths,
+                                              FortuneConstraints constraints);
+
+    std::size_t GetCount() const noexcept { return count_; }
+    std::size_t GetFileCount() const noexcept { return file_count_; }
+
+    // Eligible fortune `index`, between zero and GetCount(), only the file which holds it is opened
+    std::optional<std::string> GetFortune(std::size_t index) const;
+
+private:
+    EligibleFortunes() = default;
+
+    static std::string Build(const std::vector<std::filesystem::path> &text_paths, FortuneConstraints constraints);
+    static std::optional<EligibleFortunes> Read(const std::filesystem::path &index_path,
+                                                const std::vector<std::filesystem::path> &text_paths,
+                                                FortuneConstraints constraints);
+    static std::optional<EligibleFortunes> Parse(std::string_view buffer,
+                                                 const std::vector<std::filesystem::path> &text_paths,
+                                                 FortuneConstraints constraints,
+                                                 std::string_view source);
+
+    std::string_view GetBuffer() const noexcept;
+
+    mmotd::core::MappedFile mapped_file_;
+    // the table when there is no index path to save it to
+    std::string buffer_;
+    std::size_t count_ = 0;
+    std::size_t file_count_ = 0;
+};
+
+} // namespace mmotd::fortune
@@ -6,7 +6,9 @@
 
 #include <cstdint>
 #include <optional>
+#include <stop_token>
 #include <string>
+#include <string_view>
 
 namespace mmotd::information {
 
@@ -14,8 +16,10 @@ class General : public InformationProvider {
 public:
     DEFAULT_CONSTRUCTORS_COPY_MOVE_OPERATORS_VIRTUAL_DESTRUCTOR(General);
 
+    std::string_view GetName() const noexcept override { return "general"; }
+
 protected:
-    void FindInformation() override;
+    void FindInformation(std::stop_token stop_token) override;
 };
 
 } // namespace mmotd::information
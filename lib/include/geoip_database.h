@@ -0,0 +1,74 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#include "common/include/mapped_file.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/asio/ip/address.hpp>
+
+namespace mmotd::networking {
+
+// The same values ipinfo.io answers with, the gps location is "latitude,longitude"
+struct GeoIpLocation {
+    std::string city;
+    std::string region;
+    std::string country;
+    std::string postal_code;
+    std::string timezone;
+    std::string gps_location;
+
+    bool operator==(const GeoIpLocation &other) const = default;
+};
+
+struct GeoIpRange {
+    boost::asio::ip::address first;
+    boost::asio::ip::address last;
+    GeoIpLocation location;
+};
+
+// Reads the ranges of a csv file with the columns:
+//  first_ip,last_ip,country,region,city,postal_code,timezone,latitude,longitude
+//  a field may be quoted, blank lines, lines starting with '#' and a header line are skipped
+std::vector<GeoIpRange> ParseGeoIpCsv(std::istream &input);
+
+//
+// A sorted table of ip address ranges, each with the index of a location, which is memory mapped and searched in
+//  place.  IPv4 addresses are stored as IPv4-mapped IPv6 addresses so both share a single table.  The file is built
+//  offline by 'mmotd_geoip' and the location of the external ip address is found without a web service.
+//
+// File layout (native byte order):
+//  GeoIpHeader | first address of each range (16 bytes each) | GeoIpRangeRecord of each range |
+//  GeoIpLocationRecord of each location | string pool
+//
+class GeoIpDatabase {
+public:
+    static std::optional<GeoIpDatabase> Open(const std::filesystem::path &file_path);
+
+    // Overlapping ranges are dropped, the first one (after sorting) is kept
+    static bool Write(const std::filesystem::path &file_path, const std::vector<GeoIpRange> &ranges);
+
+    std::optional<GeoIpLocation> Find(const boost::asio::ip::address &address) const;
+
+    std::size_t GetRangeCount() const noexcept { return range_count_; }
+
+private:
+    GeoIpDatabase() = default;
+
+    std::optional<GeoIpLocation> GetLocation(std::uint32_t index) const;
+
+    mmotd::core::MappedFile mapped_file_;
+    std::size_t range_count_ = 0;
+    std::size_t location_count_ = 0;
+    const char *first_addresses_ = nullptr;
+    const char *ranges_ = nullptr;
+    const char *locations_ = nullptr;
+    std::string_view string_pool_;
+};
+
+} // namespace mmotd::networking
@@ -2,29 +2,33 @@
 #pragma once
 #include "common/include/big_five_macros.h"
 #include "lib/include/information_provider.h"
+#include "lib/include/platform/hardware_information.h"
 
 #include <optional>
+#include <stop_token>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
-namespace mmotd::platform {
-
-struct HardwareDetails;
-
-} // namespace mmotd::platform
-
 namespace mmotd::information {
 
 class HardwareInformation : public InformationProvider {
 public:
     DEFAULT_CONSTRUCTORS_COPY_MOVE_OPERATORS_VIRTUAL_DESTRUCTOR(HardwareInformation);
 
+    std::string_view GetName() const noexcept override { return "hardware"; }
+
 protected:
-    void FindInformation() override;
+    // The machine, cpu, gpu and temperature details are looked up in parallel
+    std::vector<SubTask> GetSubTasks() override;
+
+    void FindInformation(std::stop_token stop_token) override;
 
 private:
     void CreateInformationObjects(const mmotd::platform::HardwareDetails &details);
+
+    mmotd::platform::HardwareDetails details_;
 };
 
 } // namespace mmotd::information
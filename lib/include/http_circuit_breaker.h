@@ -0,0 +1,45 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace mmotd::networking {
+
+struct HostHealth {
+    std::uint32_t consecutive_failures = 0;
+    std::chrono::system_clock::time_point last_failure;
+};
+
+//
+// Remembers, across invocations, which hosts have been failing so that an offline or degraded host costs nothing
+//  instead of a connect timeout at every login.  After a failure the breaker of the host is open for the back-off,
+//  which doubles with each consecutive failure up to the maximum, and the first success closes it again.
+//
+// The health of each host is a small file, `<host>.health`, in $XDG_CACHE_HOME/mmotd/http.
+//
+class HttpCircuitBreaker {
+public:
+    HttpCircuitBreaker() = default;
+    HttpCircuitBreaker(std::filesystem::path directory, std::chrono::seconds backoff, std::chrono::seconds max_backoff);
+
+    HostHealth GetHealth(std::string_view host) const;
+    std::chrono::seconds GetBackOff(std::uint32_t consecutive_failures) const noexcept;
+    bool IsOpen(std::string_view host,
+                std::chrono::system_clock::time_point now = std::chrono::system_clock::now()) const;
+
+    void RecordSuccess(std::string_view host) const;
+    void RecordFailure(std::string_view host,
+                       std::chrono::system_clock::time_point now = std::chrono::system_clock::now()) const;
+
+private:
+    std::filesystem::path GetHealthPath(std::string_view host) const;
+    bool Save(std::string_view host, const HostHealth &health) const;
+
+    std::filesystem::path directory_;
+    std::chrono::seconds backoff_ = std::chrono::seconds{30};
+    std::chrono::seconds max_backoff_ = std::chrono::hours{1};
+};
+
+} // namespace mmotd::networking
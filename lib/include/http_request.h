@@ -1,19 +1,62 @@
 // vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
 #pragma once
+#include <chrono>
+#include <cstdint>
+#include <future>
 #include <optional>
+#include <stop_token>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace mmotd::networking {
 
 enum class HttpProtocol { HTTP, HTTPS };
 
+struct HttpEndpoint {
+    HttpProtocol protocol = HttpProtocol::HTTPS;
+    std::string host; // with the port when it is not the default one
+};
+
+// How long each phase of a request took, every time is measured from the start of the request (as curl reports it)
+struct HttpTiming {
+    std::string url; // without the query, which can hold an api key
+    long status_code = 0;
+    std::chrono::microseconds name_lookup{0};
+    std::chrono::microseconds connect{0};
+    std::chrono::microseconds tls_handshake{0}; // zero for plain http and reused connections
+    std::chrono::microseconds first_byte{0};
+    std::chrono::microseconds total{0};
+    std::int64_t bytes = 0;
+};
+
 class HttpRequest {
 public:
+    // The request is aborted as soon as a stop is requested through the `stop_token`
     static std::optional<std::string> Get(HttpProtocol protocol,
                                           std::string_view host,
                                           std::string_view path = std::string_view{},
-                                          std::string_view query = std::string_view{});
+                                          std::string_view query = std::string_view{},
+                                          std::stop_token stop_token = std::stop_token{});
+
+    // Sends the request at once and returns while it is in flight, every outstanding request runs concurrently.
+    //  A fresh (or stale but revalidating) response in the http cache is returned without waiting on the network.
+    static std::future<std::optional<std::string>> GetAsync(HttpProtocol protocol,
+                                                            std::string_view host,
+                                                            std::string_view path = std::string_view{},
+                                                            std::string_view query = std::string_view{},
+                                                            std::stop_token stop_token = std::stop_token{});
+
+    // A stale response is revalidated in the background, the revalidations still in flight when the process exits
+    //  are waited on until `deadline` so the next run finds the refreshed response (by default they are abandoned)
+    static void SetRevalidationDeadline(std::chrono::steady_clock::time_point deadline);
+
+    // The timings of every request which has been sent over the network by this process
+    static std::vector<HttpTiming> GetTimings();
+
+    // The endpoint, i.e. "https://wttr.in" or "http://127.0.0.1:8080", of a web service as it is configured in
+    //  `config_name`.  A missing scheme is https.
+    static HttpEndpoint GetEndpoint(std::string_view config_name, std::string_view default_endpoint);
 
     static std::string GetUrl(HttpProtocol protocol,
                               std::string_view host,
@@ -0,0 +1,59 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace mmotd::networking {
+
+// The parts of a Cache-Control response header which decide how long a response may be reused
+struct CacheControl {
+    std::optional<std::chrono::seconds> max_age;
+    bool no_store = false;
+    bool no_cache = false;
+    bool must_revalidate = false;
+};
+
+CacheControl ParseCacheControl(std::string_view cache_control);
+
+struct HttpCacheEntry {
+    std::string url;
+    std::string etag;
+    std::string body;
+    std::chrono::system_clock::time_point fresh_until;
+    // a stale body may be served while it is revalidated unless the server asked for 'must-revalidate'
+    bool must_revalidate = false;
+
+    bool IsFresh(std::chrono::system_clock::time_point now = std::chrono::system_clock::now()) const noexcept {
+        return now < fresh_until;
+    }
+};
+
+//
+// The bodies of http responses saved on disk by url, one file for each url in $XDG_CACHE_HOME/mmotd/http.
+//  Entries are written to a temporary file and renamed so a concurrent login never reads a partial entry.
+//
+// File layout (native byte order): HttpCacheHeader | url | etag | body
+//
+class HttpResponseCache {
+public:
+    HttpResponseCache() = default;
+    explicit HttpResponseCache(std::filesystem::path directory);
+
+    // The directory is not created until something is written to it, see CreateDirectory
+    static std::filesystem::path GetDefaultDirectory();
+    // Creates the directory (and its parents) when it is missing, the error is logged
+    static bool CreateDirectory(const std::filesystem::path &directory);
+
+    std::optional<HttpCacheEntry> Find(std::string_view url) const;
+    bool Store(const HttpCacheEntry &entry) const;
+
+private:
+    std::filesystem::path GetEntryPath(std::string_view url) const;
+
+    std::filesystem::path directory_;
+};
+
+} // namespace mmotd::networking
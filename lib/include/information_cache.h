@@ -0,0 +1,65 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#include "common/include/big_five_macros.h"
+#include "common/include/information.h"
+#include "common/include/information_decls.h"
+#include "common/include/informations.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace mmotd::information {
+
+//
+// A persistent snapshot of the informations found by each provider.  The snapshot is stored in
+//  $XDG_CACHE_HOME/mmotd/snapshot.bin and is read back with a single memory mapping.  Each provider
+//  has a time-to-live, `cache.ttl.<provider name>`, where 0 means the provider is never cached and
+//  a negative value means the informations are valid until the system reboots.  A reboot is detected
+//  by the kernel boot id (the boot time where there is none), and an upgrade, which rewrites
+//  /etc/os-release, also expires these boot-scoped facts.
+//
+// File layout (native byte order, the version is bumped whenever the layout or the ids change):
+//  SnapshotHeader | SnapshotProvider[provider_count] | SnapshotEntry[entry_count] | string pool
+//
+class InformationCache {
+public:
+    InformationCache();
+    explicit InformationCache(std::filesystem::path file_path);
+    InformationCache(std::filesystem::path file_path, const std::filesystem::path &os_release_path);
+    NO_CONSTRUCTOR_DELETE_COPY_MOVE_OPERATORS_DEFAULT_DESTRUCTOR(InformationCache);
+
+    static bool IsEnabled();
+    static std::filesystem::path GetDefaultFilePath();
+    static std::chrono::seconds GetTimeToLive(std::string_view provider_name);
+
+    // Returns the snapshot of the provider if it exists and has not yet expired
+    std::optional<Informations> Find(std::string_view provider_name) const;
+
+    void Update(std::string_view provider_name, const Informations &informations);
+
+    bool Save();
+
+private:
+    struct Snapshot {
+        std::chrono::system_clock::time_point timestamp;
+        Informations informations;
+    };
+
+    void Load();
+    bool Parse(std::string_view buffer);
+    void DiscardBootSnapshots();
+
+    std::filesystem::path file_path_;
+    std::optional<std::chrono::system_clock::time_point> boot_time_;
+    std::string boot_id_;
+    std::int64_t os_release_time_ = 0;
+    std::unordered_map<std::string, Snapshot> snapshots_;
+    bool modified_ = false;
+};
+
+} // namespace mmotd::information
@@ -1,29 +1,55 @@
 // vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
 #pragma once
 #include "common/include/big_five_macros.h"
+#include "common/include/informations.h"
+#include "lib/include/task_graph.h"
 
+#include <functional>
+#include <memory>
+#include <stop_token>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 namespace mmotd::information {
 
-enum class InformationId : size_t;
-class Information;
-using Informations = std::unordered_map<InformationId, std::vector<Information>>;
-
 class InformationProvider {
 public:
     InformationProvider();
     virtual ~InformationProvider();
     NO_CONSTRUCTOR_DEFAULT_COPY_MOVE_OPERATORS_NO_DESTRUCTOR(InformationProvider);
 
+    // Short, stable name used as the key for this provider in the configuration and the snapshot cache
+    virtual std::string_view GetName() const noexcept = 0;
+
     const Informations &GetInformations() const;
 
-    void LookupInformation();
+    // Names of the providers whose informations this provider reads, it is looked up after they have finished
+    virtual std::vector<std::string_view> GetDependencyNames() const { return {}; }
+
+    // The providers named by GetDependencyNames which are available for this lookup
+    void SetDependencies(std::vector<std::shared_ptr<const InformationProvider>> dependencies);
+
+    // A stop is requested on the `stop_token` when the lookup runs past the latency budget
+    void LookupInformation(std::stop_token stop_token = std::stop_token{});
+
+    // Adds the sub-tasks followed by the lookup itself to the task graph, all of them after `dependencies`.
+    //  Returns the id of the task which finishes the lookup.
+    TaskGraph::TaskId AddLookupTasks(TaskGraph &task_graph,
+                                     std::stop_token stop_token,
+                                     const TaskGraph::TaskIds &dependencies);
+
+    // Replaces the informations with values restored from the snapshot cache instead of looking them up
+    void RestoreInformations(Informations informations);
 
 protected:
-    virtual void FindInformation() = 0;
+    using SubTask = std::function<void(std::stop_token)>;
+
+    // Independent parts of the lookup (i.e. running an external command) which are run in parallel before
+    //  FindInformation, which then turns their results into informations
+    virtual std::vector<SubTask> GetSubTasks() { return {}; }
+
+    virtual void FindInformation(std::stop_token stop_token) = 0;
 
     void AddInformation(Information information);
 
@@ -31,8 +57,14 @@ protected:
 
     std::string GetUnknownProperty() const;
 
+    // The informations of the named dependency, nullptr when that provider was not created or is still busy
+    const Informations *GetDependencyInformations(std::string_view name) const;
+
 private:
+    void RunSubTask(const SubTask &sub_task, std::stop_token stop_token);
+
     Informations informations_;
+    std::vector<std::shared_ptr<const InformationProvider>> dependencies_;
 };
 
 } // namespace mmotd::information
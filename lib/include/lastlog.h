@@ -7,7 +7,9 @@
 #include <cstdint>
 #include <ctime>
 #include <optional>
+#include <stop_token>
 #include <string>
+#include <string_view>
 
 namespace mmotd::information {
 
@@ -15,8 +17,10 @@ class LastLog : public InformationProvider {
 public:
     DEFAULT_CONSTRUCTORS_COPY_MOVE_OPERATORS_VIRTUAL_DESTRUCTOR(LastLog);
 
+    std::string_view GetName() const noexcept override { return "last_login"; }
+
 protected:
-    void FindInformation() override;
+    void FindInformation(std::stop_token stop_token) override;
 };
 
 } // namespace mmotd::information
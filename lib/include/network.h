@@ -5,7 +5,9 @@
 #include "lib/include/information_provider.h"
 
 #include <optional>
+#include <stop_token>
 #include <string>
+#include <string_view>
 
 namespace mmotd::information {
 
@@ -13,8 +15,10 @@ class NetworkInfo : public InformationProvider {
 public:
     DEFAULT_CONSTRUCTORS_COPY_MOVE_OPERATORS_VIRTUAL_DESTRUCTOR(NetworkInfo);
 
+    std::string_view GetName() const noexcept override { return "network"; }
+
 protected:
-    void FindInformation() override;
+    void FindInformation(std::stop_token stop_token) override;
 };
 
 } // namespace mmotd::information
@@ -0,0 +1,57 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#include "common/include/mapped_file.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace mmotd::platform {
+
+//
+// The vendor and device names of the PCI ID database (pci.ids) as used by lspci.  The database is memory
+//  mapped and looked up through a sorted index of the name offsets.  The index is built the first time the
+//  database is used and saved as pci_ids.idx in the cache directory, it is rebuilt whenever the size or the
+//  modification time of pci.ids changes.
+//
+// Index layout (native byte order): PciIdsIndexHeader | PciIdsIndexEntry[entry_count]
+//
+class PciIds {
+public:
+    PciIds() = default;
+    ~PciIds() = default;
+    PciIds(const PciIds &other) = delete;
+    PciIds &operator=(const PciIds &other) = delete;
+    PciIds(PciIds &&other) noexcept = default;
+    PciIds &operator=(PciIds &&other) noexcept = default;
+
+    // Opens the first pci.ids found in the usual locations, nullopt when there is none.  The index is saved in
+    //  `cache_directory`, an empty `cache_directory` builds it in memory without saving it
+    static std::optional<PciIds> Open(const std::filesystem::path &cache_directory);
+    // An empty `index_path` builds the index in memory without saving it
+    static std::optional<PciIds> Open(const std::filesystem::path &pci_ids_path,
+                                      const std::filesystem::path &index_path);
+
+    std::optional<std::string_view> FindVendorName(std::uint16_t vendor_id) const;
+    std::optional<std::string_view> FindDeviceName(std::uint16_t vendor_id, std::uint16_t device_id) const;
+
+    struct IndexEntry {
+        // vendor id in bits 32-47, either the device id or VENDOR_KEY in the low bits
+        std::uint64_t key;
+        std::uint32_t name_offset;
+        std::uint32_t name_size;
+    };
+
+private:
+    void BuildIndex();
+    bool LoadIndex(const std::filesystem::path &index_path, std::int64_t pci_ids_time);
+    void SaveIndex(const std::filesystem::path &index_path, std::int64_t pci_ids_time) const;
+    std::optional<std::string_view> Find(std::uint64_t key) const;
+
+    mmotd::core::MappedFile pci_ids_;
+    std::vector<IndexEntry> entries_;
+};
+
+} // namespace mmotd::platform
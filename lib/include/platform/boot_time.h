@@ -9,4 +9,8 @@ namespace mmotd::platform {
 
 std::optional<std::chrono::system_clock::time_point> GetBootTime();
 
+// A random id which the kernel picks at every boot (/proc/sys/kernel/random/boot_id on linux), nullopt when the
+//  platform has none
+std::optional<std::string> GetBootId();
+
 } // namespace mmotd::platform
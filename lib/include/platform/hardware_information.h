@@ -5,9 +5,13 @@
 
 #include <bit>
 #include <cstdint>
+#include <filesystem>
 #include <iterator>
-#include <string>
 #include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace mmotd::platform {
 
@@ -17,11 +21,15 @@ std::optional<std::endian> from_endian_string(std::string endian_str);
 struct HardwareDetails {
     std::string machine_type;
     std::string machine_model;
+    // the number of hardware threads, which is what most tools call the cpu count
     std::int32_t cpu_core_count = 0;
+    std::int32_t cpu_physical_core_count = 0;
+    std::int32_t cpu_socket_count = 0;
     std::string cpu_name;
     std::optional<std::endian> byte_order;
     Temperature cpu_temperature;
-    std::string gpu_name;
+    // one name for each display controller, i.e. the integrated and the discrete gpu
+    std::vector<std::string> gpu_names;
     Temperature gpu_temperature;
     std::string monitor_name;
     std::string monitor_resolution;
@@ -29,6 +37,41 @@ struct HardwareDetails {
     bool empty() const noexcept;
 };
 
+// The details are looked up in independent parts so they can run in parallel, each one only sets its own fields
+//  The parts which run more than one lookup skip the ones which are left once a stop is requested
+void GetMachineDetails(HardwareDetails &details);
+void GetCpuDetails(HardwareDetails &details, std::stop_token stop_token = {});
+// The index of the gpu names is kept in `cache_directory`, it is built in memory when there is no directory
+void GetGpuDetails(HardwareDetails &details,
+                   const std::filesystem::path &cache_directory = {},
+                   std::stop_token stop_token = {});
+void GetTemperatureDetails(HardwareDetails &details);
+
 HardwareDetails GetHardwareInformationDetails();
 
+#if defined(__linux__)
+// Sets the cpu details from the contents of /proc/cpuinfo and the online cpus and their topology found in the
+//  sysfs cpu directory (/sys/devices/system/cpu).  Only the path is different in the tests.
+void GetCpuInfoDetails(HardwareDetails &details,
+                       std::string_view cpuinfo,
+                       const std::filesystem::path &sysfs_cpu_directory);
+
+// Sets the cpu details from the output of 'lscpu --json', the fallback when /proc/cpuinfo has no model name
+void GetLscpuCpuDetails(HardwareDetails &details);
+
+class PciIds;
+
+struct PciDeviceId {
+    std::uint16_t vendor_id = 0;
+    std::uint16_t device_id = 0;
+};
+
+// The display controllers (pci class 0x03) among the devices of the sysfs pci directory (/sys/bus/pci/devices),
+//  in the order of their pci address.  Only the path is different in the tests.
+std::vector<PciDeviceId> FindPciDisplayControllers(const std::filesystem::path &sysfs_pci_devices_directory);
+
+// "Vendor Device" from pci.ids, the hex ids stand in for any name which is not known or when `pci_ids` is null
+std::string GetPciDeviceName(const PciIds *pci_ids, PciDeviceId pci_device_id);
+#endif
+
 } // namespace mmotd::platform
@@ -6,4 +6,7 @@ namespace mmotd::platform {
 
 mmotd::networking::NetworkDevices GetNetworkDevices();
 
+// False only when the host is known to have no default route, i.e. no request to the internet can succeed
+bool HasDefaultRoute();
+
 } // namespace mmotd::platform
@@ -0,0 +1,32 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#include <optional>
+#include <string_view>
+
+#include <date/date.h>
+
+namespace mmotd::astronomy {
+
+// A latitude (north is positive) and longitude (east is positive) in degrees
+struct Coordinates {
+    double latitude = 0.0;
+    double longitude = 0.0;
+};
+
+// "35.0844,-106.6504", the "loc" value of ipinfo.io
+std::optional<Coordinates> ParseCoordinates(std::string_view coordinates);
+
+// The times (UTC) the sun crosses the horizon and the start and end of civil twilight (the center of the sun 6° below
+//  the horizon).  An event is missing on a day the sun stays above or below it, i.e. midnight sun and polar night.
+struct SolarEvents {
+    std::optional<date::sys_seconds> civil_dawn;
+    std::optional<date::sys_seconds> sunrise;
+    std::optional<date::sys_seconds> sunset;
+    std::optional<date::sys_seconds> civil_dusk;
+};
+
+// The events of the local day `day` at `coordinates`, from the NOAA solar calculator (Meeus, Astronomical
+//  Algorithms), which is within a minute of the published tables between ±72° latitude
+SolarEvents ComputeSolarEvents(date::year_month_day day, Coordinates coordinates);
+
+} // namespace mmotd::astronomy
@@ -4,7 +4,9 @@
 #include "lib/include/information_provider.h"
 
 #include <optional>
+#include <stop_token>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
@@ -20,8 +22,10 @@ class SystemInformation : public InformationProvider {
 public:
     DEFAULT_CONSTRUCTORS_COPY_MOVE_OPERATORS_VIRTUAL_DESTRUCTOR(SystemInformation);
 
+    std::string_view GetName() const noexcept override { return "system_information"; }
+
 protected:
-    void FindInformation() override;
+    void FindInformation(std::stop_token stop_token) override;
 
 private:
     void CreateInformationObjects(const mmotd::platform::SystemDetails &details);
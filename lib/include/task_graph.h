@@ -0,0 +1,54 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#include "common/include/big_five_macros.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/thread_pool.hpp>
+
+namespace mmotd::information {
+
+// Schedules the information lookups as a graph of small tasks. A task is started as soon as every task it depends
+//  on has finished, so the tasks which do not depend on each other run in parallel.
+class TaskGraph {
+public:
+    using TaskId = std::size_t;
+    using TaskIds = std::vector<TaskId>;
+    using Task = std::function<void()>;
+
+    DEFAULT_CONSTRUCTORS_COPY_MOVE_OPERATORS_DESTRUCTOR(TaskGraph);
+
+    // A task can only depend on tasks which were added before it, which keeps the graph free of cycles
+    TaskId AddTask(std::string name, Task task, const TaskIds &dependencies = TaskIds{});
+
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+
+    // Runs every task on the calling thread in the order they were added
+    void Run() const;
+
+    // Posts every task to the thread pool once its dependencies have finished and returns immediately.
+    //  The tasks are copied so the graph does not need to outlive them.
+    void Post(boost::asio::thread_pool &thread_pool) const;
+
+private:
+    struct Node {
+        std::string name;
+        Task task;
+        TaskIds dependents;
+        std::size_t dependency_count = 0;
+    };
+
+    struct Execution;
+
+    static void RunTask(const Node &node);
+    static void PostTask(std::shared_ptr<Execution> execution, TaskId id);
+
+    std::vector<Node> nodes_;
+};
+
+} // namespace mmotd::information
@@ -4,7 +4,9 @@
 #include "lib/include/information_provider.h"
 
 #include <cstdint>
+#include <stop_token>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
@@ -14,8 +16,10 @@ class UsersLoggedIn : public InformationProvider {
 public:
     DEFAULT_CONSTRUCTORS_COPY_MOVE_OPERATORS_VIRTUAL_DESTRUCTOR(UsersLoggedIn);
 
+    std::string_view GetName() const noexcept override { return "users_logged_in"; }
+
 protected:
-    void FindInformation() override;
+    void FindInformation(std::stop_token stop_token) override;
 
     using Detail = std::tuple<std::string, std::string>;
     using Details = std::vector<Detail>;
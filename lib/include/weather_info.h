@@ -4,9 +4,12 @@
 #include "lib/include/information_provider.h"
 
 #include <cstdint>
+#include <stop_token>
 #include <string>
-#include <tuple>
+#include <string_view>
 #include <optional>
+#include <utility>
+#include <vector>
 
 namespace mmotd::information {
 
@@ -14,12 +17,21 @@ class WeatherInfo : public InformationProvider {
 public:
     DEFAULT_CONSTRUCTORS_COPY_MOVE_OPERATORS_VIRTUAL_DESTRUCTOR(WeatherInfo);
 
+    std::string_view GetName() const noexcept override { return "weather"; }
+
+    // Depends on the location and the coordinates found from the external ip when either is not configured
+    std::vector<std::string_view> GetDependencyNames() const override;
+
 protected:
-    void FindInformation() override;
+    void FindInformation(std::stop_token stop_token) override;
 
 private:
-    using WeatherData = std::tuple<std::string, std::string, std::string, std::string>;
-    std::optional<WeatherData> GetWeatherInfo();
+    // The location and the weather
+    using WeatherData = std::pair<std::string, std::string>;
+    std::optional<WeatherData> GetWeatherInfo(std::stop_token stop_token);
+
+    // Sunrise, sunset and civil twilight, computed from the coordinates without the weather service
+    void AddSolarEvents();
 };
 
 } // namespace mmotd::information
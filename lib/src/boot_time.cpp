@@ -1,6 +1,5 @@
 // vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
 #include "common/assertion/include/assertion.h"
-#include "common/include/chrono_io.h"
 #include "common/include/information.h"
 #include "common/include/information_definitions.h"
 #include "common/include/logging.h"
@@ -28,7 +27,9 @@ bool gLinkBootTime = false;
 namespace mmotd::information {
 
 static const bool boot_time_factory_registered =
-    RegisterInformationProvider([]() { return make_unique<mmotd::information::BootTime>(); });
+    RegisterInformationProvider("boot_time",
+                                []() { return make_unique<mmotd::information::BootTime>(); },
+                                {InformationId::ID_BOOT_TIME_BOOT_TIME, InformationId::ID_BOOT_TIME_UP_TIME});
 
 template<typename T>
 string AddDurationToString(string current, T count, string name) {
@@ -42,7 +43,7 @@ string AddDurationToString(string current, T count, string name) {
     return current + format(FMT_STRING("{} {}{}"), count, name, plural);
 }
 
-void BootTime::FindInformation() {
+void BootTime::FindInformation(std::stop_token) {
     auto boot_time_holder = mmotd::platform::GetBootTime();
     if (!boot_time_holder) {
         LOG_ERROR("unable to find boot time property");
@@ -84,7 +85,7 @@ void BootTime::FindInformation() {
     AddInformation(up_time_info);
 
     auto boot_time_info = GetInfoTemplate(InformationId::ID_BOOT_TIME_BOOT_TIME);
-    boot_time_info.SetValue(chrono::io::to_string(boot_time, "%a, %d-%h-%Y %I:%M%p %Z"));
+    boot_time_info.SetValue(boot_time);
     AddInformation(boot_time_info);
 }
 
@@ -1,12 +1,29 @@
 // vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
 #include "common/assertion/include/assertion.h"
+#include "common/include/algorithm.h"
+#include "common/include/config_options.h"
 #include "common/include/logging.h"
 #include "lib/include/computer_information.h"
+#include "lib/include/http_request.h"
+#include "lib/include/information_cache.h"
 #include "lib/include/information_provider.h"
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <boost/asio.hpp>
 #include <fmt/format.h>
@@ -16,19 +33,74 @@ using fmt::format;
 
 namespace {
 
-using InformationProviderCreators = vector<mmotd::information::InformationProviderCreator>;
+struct InformationProviderRegistration {
+    string name;
+    mmotd::information::InformationProviderCreator creator;
+    mmotd::information::InformationIds information_ids;
+};
 
-InformationProviderCreators &GetInformationProviderCreators() {
-    static InformationProviderCreators computer_information_provider_creators;
-    return computer_information_provider_creators;
+using InformationProviderRegistrations = vector<InformationProviderRegistration>;
+
+InformationProviderRegistrations &GetInformationProviderRegistrations() {
+    static InformationProviderRegistrations computer_information_provider_registrations;
+    return computer_information_provider_registrations;
 }
 
+chrono::steady_clock::time_point GetLookupDeadline() {
+    auto latency_budget = mmotd::core::ConfigOptions::Instance().GetInteger("core.latency_budget_ms"sv, int64_t{0});
+    if (latency_budget <= 0) {
+        return chrono::steady_clock::time_point::max();
+    }
+    LOG_VERBOSE("information lookups have a latency budget of {}ms", latency_budget);
+    return chrono::steady_clock::now() + chrono::milliseconds{latency_budget};
+}
+
+// How long the destructor waits on the providers which were asked to stop before the pool is joined
+constexpr auto SHUTDOWN_TIMEOUT = chrono::milliseconds{250};
+
 } // namespace
 
 namespace mmotd::information {
 
-ComputerInformation::ComputerInformation() : information_providers_(), information_cache_() {
-    SetInformationProviders();
+// Shared with the tasks posted to the thread pool so a provider which finishes after the deadline (or after
+//  this object is destroyed) can still mark itself as finished
+struct ComputerInformation::LookupState {
+    mutex lock;
+    condition_variable finished;
+    unordered_set<const InformationProvider *> running;
+};
+
+ComputerInformation::ComputerInformation() :
+    required_information_ids_(),
+    information_providers_(),
+    information_cache_(),
+    lookup_state_(make_shared<LookupState>()),
+    stop_source_(),
+    thread_pool_() {}
+
+ComputerInformation::ComputerInformation(InformationProviders information_providers) : ComputerInformation() {
+    information_providers_ = std::move(information_providers);
+}
+
+ComputerInformation::~ComputerInformation() {
+    if (!thread_pool_) {
+        return;
+    }
+    stop_source_.request_stop();
+    auto lock = unique_lock<mutex>{lookup_state_->lock};
+    auto stopped = lookup_state_->finished.wait_for(lock, SHUTDOWN_TIMEOUT, [this]() {
+        return empty(lookup_state_->running);
+    });
+    lock.unlock();
+    if (stopped) {
+        thread_pool_->stop();
+        thread_pool_->join();
+    } else {
+        // a provider which does not check its stop token is still running, joining would wait on it for as
+        //  long as it takes -- the process is exiting so let the threads go with it
+        auto *thread_pool = thread_pool_.release();
+        mmotd::algorithms::unused(thread_pool);
+    }
 }
 
 ComputerInformation &ComputerInformation::Instance() {
@@ -36,16 +108,69 @@ ComputerInformation &ComputerInformation::Instance() {
     return computer_information;
 }
 
+void ComputerInformation::SetRequiredInformationIds(InformationIds information_ids) {
+    PRECONDITIONS(information_providers_.empty(), "required information ids must be set before the first lookup");
+    required_information_ids_ = std::move(information_ids);
+}
+
+vector<shared_ptr<InformationProvider>> CreateInformationProviders(const optional<InformationIds> &information_ids) {
+    auto is_required = [&information_ids](const InformationProviderRegistration &registration) {
+        if (!information_ids) {
+            return true;
+        }
+        const auto &registered_ids = registration.information_ids;
+        return any_of(begin(registered_ids), end(registered_ids), [&information_ids](InformationId id) {
+            return information_ids->contains(id);
+        });
+    };
+    const auto &registrations = GetInformationProviderRegistrations();
+    auto providers = vector<shared_ptr<InformationProvider>>{};
+    auto created = vector<bool>(size(registrations), false);
+    auto create = [&registrations, &providers, &created](size_t i) {
+        auto provider = shared_ptr<InformationProvider>{registrations[i].creator()};
+        CHECKS(provider->GetName() == registrations[i].name,
+               "{} provider is registered as {}",
+               provider->GetName(),
+               registrations[i].name);
+        providers.push_back(std::move(provider));
+        created[i] = true;
+    };
+    for (auto i = size_t{0}; i < size(registrations); ++i) {
+        if (is_required(registrations[i])) {
+            create(i);
+        }
+    }
+
+    // the providers which are depended on are created as well, they are found by their registered name
+    for (auto checked = size_t{0}; checked < size(providers); ++checked) {
+        for (auto dependency_name : providers[checked]->GetDependencyNames()) {
+            auto i = find_if(begin(registrations), end(registrations), [dependency_name](const auto &registration) {
+                return registration.name == dependency_name;
+            });
+            if (i == end(registrations)) {
+                LOG_VERBOSE("{} depends on {} which is not registered", providers[checked]->GetName(), dependency_name);
+                continue;
+            }
+            auto index = static_cast<size_t>(distance(begin(registrations), i));
+            if (!created[index]) {
+                LOG_VERBOSE("{} provider is created for {}", dependency_name, providers[checked]->GetName());
+                create(index);
+            }
+        }
+    }
+    return providers;
+}
+
 void ComputerInformation::SetInformationProviders() {
-    auto &creators = GetInformationProviderCreators();
-    information_providers_.resize(creators.size());
-    transform(begin(creators), end(creators), begin(information_providers_), [](auto &creator) { return creator(); });
-    LOG_INFO("created {} information providers", information_providers_.size());
+    information_providers_ = CreateInformationProviders(required_information_ids_);
+    LOG_INFO("created {} of {} information providers",
+             information_providers_.size(),
+             GetInformationProviderRegistrations().size());
 }
 
-bool RegisterInformationProvider(InformationProviderCreator creator) {
-    auto &information_provider_creators = GetInformationProviderCreators();
-    information_provider_creators.emplace_back(creator);
+bool RegisterInformationProvider(string_view name, InformationProviderCreator creator, InformationIds information_ids) {
+    auto &information_provider_registrations = GetInformationProviderRegistrations();
+    information_provider_registrations.push_back({string{name}, std::move(creator), std::move(information_ids)});
     return true;
 }
 
@@ -58,7 +183,7 @@ optional<Information> ComputerInformation::FindInformation(InformationId id) con
     }
 }
 
-Informations &ComputerInformation::GetAllInformations() {
+const InformationsView &ComputerInformation::GetAllInformations() {
     if (!IsInformationCached()) {
         CacheInformation();
     }
@@ -70,7 +195,7 @@ vector<Information> ComputerInformation::GetInformations() {
         CacheInformation();
     }
     auto informations = vector<Information>{};
-    for (auto &[_, infos] : information_cache_) {
+    for (const auto &[_, infos] : information_cache_) {
         copy(begin(infos), end(infos), back_inserter(informations));
     }
     return informations;
@@ -80,39 +205,210 @@ bool ComputerInformation::IsInformationCached() const {
     return !information_cache_.empty();
 }
 
-void ComputerInformation::CacheInformationAsync() {
-    auto thread_pool = boost::asio::thread_pool{std::thread::hardware_concurrency()};
-    for (auto &&provider : information_providers_) {
-        boost::asio::post(thread_pool, [&provider]() { provider->LookupInformation(); });
+ComputerInformation::InformationProviders ComputerInformation::GetIdleInformationProviders() const {
+    auto idle_providers = InformationProviders{};
+    auto lock = lock_guard<mutex>{lookup_state_->lock};
+    // a provider which is still running may yet read the informations of the providers it depends on
+    auto busy_dependencies = unordered_set<string_view>{};
+    for (const auto &provider : information_providers_) {
+        if (lookup_state_->running.contains(provider.get())) {
+            auto dependency_names = provider->GetDependencyNames();
+            busy_dependencies.insert(begin(dependency_names), end(dependency_names));
+        }
+    }
+    for (const auto &provider : information_providers_) {
+        if (lookup_state_->running.contains(provider.get())) {
+            LOG_WARNING("{} provider is still running from a previous lookup", provider->GetName());
+        } else if (busy_dependencies.contains(provider->GetName())) {
+            LOG_WARNING("{} provider is still in use by a provider from a previous lookup", provider->GetName());
+        } else {
+            idle_providers.push_back(provider);
+        }
+    }
+    return idle_providers;
+}
+
+ComputerInformation::InformationProviders
+ComputerInformation::RestoreInformationProviders(const InformationProviders &providers,
+                                                 const InformationCache &snapshot_cache) {
+    auto expired_providers = InformationProviders{};
+    for (const auto &provider : providers) {
+        if (auto informations = snapshot_cache.Find(provider->GetName()); informations) {
+            LOG_VERBOSE("restored {} provider from the snapshot cache", provider->GetName());
+            provider->RestoreInformations(std::move(*informations));
+        } else {
+            expired_providers.push_back(provider);
+        }
     }
-    thread_pool.join();
+    return expired_providers;
 }
 
-void ComputerInformation::CacheInformationSerial() {
-    for (auto &&provider : information_providers_) {
-        provider->LookupInformation();
+TaskGraph ComputerInformation::CreateLookupGraph(const InformationProviders &providers,
+                                                 const InformationProviders &idle_providers,
+                                                 std::stop_token stop_token,
+                                                 ProviderFinished finished) const {
+    auto find_provider = [](const InformationProviders &haystack, string_view name) {
+        auto i = find_if(begin(haystack), end(haystack), [name](const auto &provider) {
+            return provider->GetName() == name;
+        });
+        return i == end(haystack) ? shared_ptr<InformationProvider>{} : *i;
+    };
+
+    // every provider has to be added after the providers it depends on
+    auto remaining = providers;
+    auto lookup_task_ids = unordered_map<string_view, TaskGraph::TaskId>{};
+    auto is_added = [&lookup_task_ids, &find_provider, &remaining](string_view name) {
+        return lookup_task_ids.contains(name) || !find_provider(remaining, name);
+    };
+    auto task_graph = TaskGraph{};
+    while (!empty(remaining)) {
+        auto i = find_if(begin(remaining), end(remaining), [&is_added](const auto &provider) {
+            auto dependency_names = provider->GetDependencyNames();
+            return all_of(begin(dependency_names), end(dependency_names), is_added);
+        });
+        if (i == end(remaining)) {
+            LOG_ERROR("{} provider has a circular dependency, its dependencies are ignored",
+                      remaining.front()->GetName());
+            i = begin(remaining);
+        }
+        auto provider = *i;
+        remaining.erase(i);
+
+        auto dependencies = vector<shared_ptr<const InformationProvider>>{};
+        auto dependency_task_ids = TaskGraph::TaskIds{};
+        for (auto dependency_name : provider->GetDependencyNames()) {
+            if (auto dependency = find_provider(idle_providers, dependency_name); dependency) {
+                dependencies.push_back(dependency);
+            }
+            if (auto j = lookup_task_ids.find(dependency_name); j != end(lookup_task_ids)) {
+                dependency_task_ids.push_back(j->second);
+            }
+        }
+        provider->SetDependencies(std::move(dependencies));
+
+        auto lookup_task_id = provider->AddLookupTasks(task_graph, stop_token, dependency_task_ids);
+        lookup_task_ids.emplace(provider->GetName(), lookup_task_id);
+        // the graph holds on to this task until the end of the run, which keeps the provider alive for its sub-tasks
+        task_graph.AddTask(fmt::format(FMT_STRING("{} finished"), provider->GetName()),
+                           [provider, finished]() { finished(provider); },
+                           {lookup_task_id});
     }
+    return task_graph;
+}
+
+ComputerInformation::InformationProviders
+ComputerInformation::CacheInformationAsync(const InformationProviders &providers,
+                                           const InformationProviders &idle_providers,
+                                           Deadline deadline) {
+    if (!thread_pool_) {
+        thread_pool_ = make_unique<boost::asio::thread_pool>(std::thread::hardware_concurrency());
+    }
+    auto finished = [state = lookup_state_](const shared_ptr<InformationProvider> &provider) {
+        {
+            auto state_lock = lock_guard<mutex>{state->lock};
+            state->running.erase(provider.get());
+        }
+        state->finished.notify_all();
+    };
+    auto task_graph = CreateLookupGraph(providers, idle_providers, stop_source_.get_token(), finished);
+
+    auto lock = unique_lock<mutex>{lookup_state_->lock};
+    for (const auto &provider : providers) {
+        lookup_state_->running.insert(provider.get());
+    }
+    task_graph.Post(*thread_pool_);
+
+    auto is_running = [this](const auto &provider) { return lookup_state_->running.contains(provider.get()); };
+    auto all_finished = [&providers, &is_running]() { return none_of(begin(providers), end(providers), is_running); };
+    auto finished_in_time = true;
+    if (deadline == Deadline::max()) {
+        lookup_state_->finished.wait(lock, all_finished);
+    } else {
+        finished_in_time = lookup_state_->finished.wait_until(lock, deadline, all_finished);
+    }
+    if (!finished_in_time) {
+        // the late providers keep the stopped token, the next lookup starts with a new one
+        stop_source_.request_stop();
+        stop_source_ = std::stop_source{};
+        for_each(begin(providers), end(providers), [&is_running](const auto &provider) {
+            if (is_running(provider)) {
+                LOG_WARNING("{} provider exceeded the latency budget and was cancelled", provider->GetName());
+            }
+        });
+    }
+
+    auto finished_providers = InformationProviders{};
+    remove_copy_if(begin(providers), end(providers), back_inserter(finished_providers), is_running);
+    return finished_providers;
+}
+
+ComputerInformation::InformationProviders
+ComputerInformation::CacheInformationSerial(const InformationProviders &providers,
+                                            const InformationProviders &idle_providers,
+                                            Deadline deadline) {
+    // the graph runs one provider after the other so the budget is checked at the end of each lookup
+    auto stop_source = std::stop_source{};
+    auto finished_providers = InformationProviders{};
+    auto finished = [&stop_source, &finished_providers, deadline](const shared_ptr<InformationProvider> &provider) {
+        if (stop_source.stop_requested()) {
+            LOG_WARNING("{} provider skipped, the latency budget has expired", provider->GetName());
+            return;
+        }
+        finished_providers.push_back(provider);
+        if (chrono::steady_clock::now() >= deadline) {
+            stop_source.request_stop();
+        }
+    };
+    CreateLookupGraph(providers, idle_providers, stop_source.get_token(), finished).Run();
+    return finished_providers;
+}
+
+void ComputerInformation::RefreshInformation() {
+    information_cache_.clear();
+    CacheInformation();
 }
 
 void ComputerInformation::CacheInformation() {
     if (IsInformationCached()) {
         return;
     }
+    if (information_providers_.empty()) {
+        // created on the first lookup so the required information ids are known
+        SetInformationProviders();
+    }
+    auto deadline = GetLookupDeadline();
+    // the background revalidations of stale http responses may use whatever is left of the budget at exit
+    mmotd::networking::HttpRequest::SetRevalidationDeadline(deadline);
+    auto snapshot_cache = InformationCache{};
+    auto idle_providers = GetIdleInformationProviders();
+    auto expired_providers = RestoreInformationProviders(idle_providers, snapshot_cache);
+    LOG_INFO("{} of {} information providers need to be looked up",
+             expired_providers.size(),
+             information_providers_.size());
 #if defined(MMOTD_ASYNC_DISABLED)
-    CacheInformationSerial();
+    auto finished_providers = CacheInformationSerial(expired_providers, idle_providers, deadline);
 #else
-    CacheInformationAsync();
+    auto finished_providers = CacheInformationAsync(expired_providers, idle_providers, deadline);
 #endif
-    for (const auto &provider : information_providers_) {
-        const auto &informations = provider->GetInformations();
-        for (auto [id, infos] : informations) {
-            if (!information_cache_.contains(id)) {
-                information_cache_.emplace(move(id), move(infos));
-            } else {
-                auto &existing_infos = information_cache_.at(id);
-                copy(begin(infos), end(infos), back_inserter(existing_infos));
-            }
+    for (const auto &provider : finished_providers) {
+        snapshot_cache.Update(provider->GetName(), provider->GetInformations());
+    }
+    snapshot_cache.Save();
+
+    // late providers are still writing their informations and are left out
+    auto late_providers = unordered_set<const InformationProvider *>{};
+    for (const auto &provider : expired_providers) {
+        late_providers.insert(provider.get());
+    }
+    for (const auto &provider : finished_providers) {
+        late_providers.erase(provider.get());
+    }
+    for (const auto &provider : idle_providers) {
+        if (late_providers.contains(provider.get())) {
+            continue;
         }
+        // each information id is found by a single provider so the view never has to combine entries
+        information_cache_.Merge(provider->GetInformations());
     }
 }
 
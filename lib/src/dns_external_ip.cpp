@@ -0,0 +1,280 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/config_options.h"
+#include "common/include/logging.h"
+#include "lib/include/dns_external_ip.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <random>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <fmt/format.h>
+
+using boost::asio::ip::address;
+using boost::asio::ip::udp;
+using namespace std;
+
+namespace {
+
+constexpr auto DEFAULT_DNS_SERVER = string_view{"208.67.222.222:53"};
+constexpr auto DEFAULT_DNS_NAME = string_view{"myip.opendns.com"};
+constexpr auto DNS_HEADER_SIZE = size_t{12};
+constexpr auto DNS_MAX_UDP_SIZE = size_t{512};
+constexpr auto DNS_TYPE_A = uint16_t{1};
+constexpr auto DNS_TYPE_AAAA = uint16_t{28};
+constexpr auto DNS_CLASS_IN = uint16_t{1};
+constexpr auto DNS_FLAG_RESPONSE = uint16_t{0x8000};
+constexpr auto DNS_FLAG_TRUNCATED = uint16_t{0x0200};
+constexpr auto DNS_FLAG_RECURSION_DESIRED = uint16_t{0x0100};
+constexpr auto DNS_RCODE_MASK = uint16_t{0x000f};
+
+void AppendUint16(string &buffer, uint16_t value) {
+    buffer.push_back(static_cast<char>(value >> 8));
+    buffer.push_back(static_cast<char>(value & 0xff));
+}
+
+optional<uint16_t> ReadUint16(string_view buffer, size_t offset) {
+    if (offset + 2 > size(buffer)) {
+        return nullopt;
+    }
+    return static_cast<uint16_t>(static_cast<uint8_t>(buffer[offset]) << 8 | static_cast<uint8_t>(buffer[offset + 1]));
+}
+
+// Returns the offset past the (possibly compressed) name at `offset`
+optional<size_t> SkipName(string_view buffer, size_t offset) {
+    while (offset < size(buffer)) {
+        auto length = static_cast<uint8_t>(buffer[offset]);
+        if (length == 0) {
+            return offset + 1;
+        } else if ((length & 0xc0) == 0xc0) {
+            // a pointer ends the name
+            return offset + 2 <= size(buffer) ? make_optional(offset + 2) : nullopt;
+        }
+        offset += size_t{1} + length;
+    }
+    return nullopt;
+}
+
+// The id of the query in `query_ids` which `response` answers, a datagram which answers none of them is ignored
+optional<uint16_t> FindAnsweredQueryId(string_view response, const vector<uint16_t> &query_ids) {
+    auto response_id = ReadUint16(response, 0);
+    auto flags = ReadUint16(response, 2);
+    if (size(response) < DNS_HEADER_SIZE || !response_id || !flags || (*flags & DNS_FLAG_RESPONSE) == 0 ||
+        find(begin(query_ids), end(query_ids), *response_id) == end(query_ids)) {
+        return nullopt;
+    }
+    return response_id;
+}
+
+uint16_t MakeQueryId() {
+    static thread_local auto engine = mt19937{random_device{}()};
+    return static_cast<uint16_t>(uniform_int_distribution<unsigned int>{0, 0xffff}(engine));
+}
+
+} // namespace
+
+namespace mmotd::networking {
+
+optional<udp::endpoint> ParseDnsServer(string_view server) {
+    auto host = server;
+    auto port = uint16_t{53};
+    auto port_str = string_view{};
+    if (server.starts_with('[')) {
+        auto end = server.find(']');
+        if (end == string_view::npos) {
+            return nullopt;
+        }
+        host = server.substr(1, end - 1);
+        if (end + 1 < size(server)) {
+            if (server[end + 1] != ':') {
+                return nullopt;
+            }
+            port_str = server.substr(end + 2);
+        }
+    } else if (count(begin(server), end(server), ':') == 1) {
+        // more than one ':' is an ipv6 address without a port
+        auto colon = server.find(':');
+        host = server.substr(0, colon);
+        port_str = server.substr(colon + 1);
+    }
+    if (!empty(port_str)) {
+        auto [ptr, ec] = from_chars(data(port_str), data(port_str) + size(port_str), port);
+        if (ec != std::errc() || ptr != data(port_str) + size(port_str)) {
+            return nullopt;
+        }
+    }
+    auto ec = boost::system::error_code{};
+    auto server_address = boost::asio::ip::make_address(string{host}, ec);
+    if (ec) {
+        return nullopt;
+    }
+    return udp::endpoint{server_address, port};
+}
+
+optional<DnsExternalIpResolver> DnsExternalIpResolver::FromConfig() {
+    const auto &config_options = mmotd::core::ConfigOptions::Instance();
+    auto server = config_options.GetString("network.dns_server"sv, DEFAULT_DNS_SERVER);
+    auto endpoint = ParseDnsServer(server);
+    if (!endpoint) {
+        LOG_ERROR("'{}' is not a valid dns server, expected an ip address with an optional port", server);
+        return nullopt;
+    }
+    auto resolver = DnsExternalIpResolver{};
+    resolver.server = *endpoint;
+    resolver.name = config_options.GetString("network.dns_name"sv, DEFAULT_DNS_NAME);
+    resolver.timeout = chrono::milliseconds{config_options.GetInteger("network.dns_timeout_ms"sv, 300)};
+    resolver.attempts = static_cast<int>(config_options.GetInteger("network.dns_attempts"sv, 2));
+    return resolver;
+}
+
+string BuildDnsQuery(uint16_t id, string_view name) {
+    auto query = string{};
+    query.reserve(DNS_HEADER_SIZE + size(name) + 6);
+    AppendUint16(query, id);
+    AppendUint16(query, DNS_FLAG_RECURSION_DESIRED);
+    AppendUint16(query, 1); // one question
+    AppendUint16(query, 0); // no answers
+    AppendUint16(query, 0); // no authority records
+    AppendUint16(query, 0); // no additional records
+    while (!empty(name)) {
+        auto label = name.substr(0, name.find('.'));
+        name.remove_prefix(min(size(name), size(label) + 1));
+        query.push_back(static_cast<char>(min(size(label), size_t{63})));
+        query.append(label.substr(0, 63));
+    }
+    query.push_back('\0');
+    AppendUint16(query, DNS_TYPE_A);
+    AppendUint16(query, DNS_CLASS_IN);
+    return query;
+}
+
+optional<address> ParseDnsResponse(string_view response, uint16_t id) {
+    auto response_id = ReadUint16(response, 0);
+    auto flags = ReadUint16(response, 2);
+    auto question_count = ReadUint16(response, 4);
+    auto answer_count = ReadUint16(response, 6);
+    if (!response_id || !flags || !question_count || !answer_count || *response_id != id) {
+        return nullopt;
+    } else if ((*flags & DNS_FLAG_RESPONSE) == 0 || (*flags & DNS_FLAG_TRUNCATED) != 0) {
+        return nullopt;
+    } else if (auto rcode = *flags & DNS_RCODE_MASK; rcode != 0) {
+        LOG_ERROR("dns query failed with response code {}", rcode);
+        return nullopt;
+    }
+    auto offset = optional<size_t>{DNS_HEADER_SIZE};
+    for (auto i = uint16_t{0}; i != *question_count && offset; ++i) {
+        offset = SkipName(response, *offset);
+        offset = offset ? make_optional(*offset + 4) : nullopt; // type and class
+    }
+    for (auto i = uint16_t{0}; i != *answer_count && offset; ++i) {
+        offset = SkipName(response, *offset);
+        if (!offset) {
+            break;
+        }
+        auto type = ReadUint16(response, *offset);
+        auto data_size = ReadUint16(response, *offset + 8); // past the type, class and ttl
+        auto data_offset = *offset + 10;
+        if (!type || !data_size || data_offset + *data_size > size(response)) {
+            break;
+        }
+        if (*type == DNS_TYPE_A && *data_size == 4) {
+            auto bytes = boost::asio::ip::address_v4::bytes_type{};
+            copy_n(data(response) + data_offset, size(bytes), reinterpret_cast<char *>(data(bytes)));
+            return address{boost::asio::ip::address_v4{bytes}};
+        } else if (*type == DNS_TYPE_AAAA && *data_size == 16) {
+            auto bytes = boost::asio::ip::address_v6::bytes_type{};
+            copy_n(data(response) + data_offset, size(bytes), reinterpret_cast<char *>(data(bytes)));
+            return address{boost::asio::ip::address_v6{bytes}};
+        }
+        offset = data_offset + *data_size;
+    }
+    return nullopt;
+}
+
+optional<address> QueryExternalIpAddress(const DnsExternalIpResolver &resolver, std::stop_token stop_token) {
+    auto io_context = boost::asio::io_context{};
+    auto socket = udp::socket{io_context};
+    auto ec = boost::system::error_code{};
+    socket.open(resolver.server.protocol(), ec);
+    if (ec) {
+        LOG_ERROR("unable to open a udp socket, {}", ec.message());
+        return nullopt;
+    }
+    auto timer = boost::asio::steady_timer{io_context};
+    // a stop cancels the pending receive from the thread which requested it
+    auto stop_callback = std::stop_callback(stop_token, [&io_context, &socket]() {
+        boost::asio::post(io_context, [&socket]() {
+            auto cancel_ec = boost::system::error_code{};
+            socket.cancel(cancel_ec);
+        });
+    });
+    auto response = array<char, DNS_MAX_UDP_SIZE>{};
+    auto sender = udp::endpoint{};
+    auto query_ids = vector<uint16_t>{};
+    auto answer = optional<string>{};
+    // receives until one of the queries is answered or the timer expires, the answer to an earlier query which
+    //  arrives after its timeout is as good as the answer to the latest one -- anything else is ignored
+    auto receive = function<void()>{};
+    receive = [&]() {
+        socket.async_receive_from(boost::asio::buffer(response),
+                                  sender,
+                                  [&](const boost::system::error_code &receive_ec, size_t received) {
+                                      if (receive_ec) {
+                                          timer.cancel();
+                                          return;
+                                      }
+                                      auto datagram = string_view{data(response), received};
+                                      if (sender == resolver.server && FindAnsweredQueryId(datagram, query_ids)) {
+                                          answer = string{datagram};
+                                          timer.cancel();
+                                      } else {
+                                          receive();
+                                      }
+                                  });
+    };
+    for (auto attempt = 1; attempt <= resolver.attempts && !stop_token.stop_requested(); ++attempt) {
+        query_ids.push_back(MakeQueryId());
+        auto query = BuildDnsQuery(query_ids.back(), resolver.name);
+        socket.send_to(boost::asio::buffer(query), resolver.server, 0, ec);
+        if (ec) {
+            LOG_ERROR("unable to send the dns query to {}, {}", resolver.server.address().to_string(), ec.message());
+            return nullopt;
+        }
+        receive();
+        timer.expires_after(resolver.timeout);
+        timer.async_wait([&socket](const boost::system::error_code &timer_ec) {
+            if (!timer_ec) {
+                auto cancel_ec = boost::system::error_code{};
+                socket.cancel(cancel_ec);
+            }
+        });
+        io_context.restart();
+        io_context.run();
+        if (!answer) {
+            LOG_WARNING("dns query {} of {} for '{}' timed out", attempt, resolver.attempts, resolver.name);
+            continue;
+        }
+        auto answered_id = FindAnsweredQueryId(*answer, query_ids);
+        if (auto external_ip = ParseDnsResponse(*answer, *answered_id); external_ip) {
+            return external_ip;
+        }
+        LOG_ERROR("dns response for '{}' has no address", resolver.name);
+        return nullopt;
+    }
+    return nullopt;
+}
+
+} // namespace mmotd::networking
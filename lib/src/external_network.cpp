@@ -2,11 +2,15 @@
 #include "lib/include/external_network.h"
 
 #include "common/assertion/include/throw.h"
+#include "common/include/config_options.h"
 #include "common/include/logging.h"
 #include "common/include/special_files.h"
 #include "lib/include/computer_information.h"
+#include "lib/include/dns_external_ip.h"
+#include "lib/include/geoip_database.h"
 #include "lib/include/http_request.h"
 
+#include <optional>
 #include <sstream>
 #include <string_view>
 #include <tuple>
@@ -30,7 +34,7 @@ bool gLinkExternalNetwork = false;
 namespace {
 
 // https://ipinfo.io/json?token=YOUR_TOKEN_HERE
-static constexpr auto EXTERNAL_IP_SERVICE_URL = string_view{"ipinfo.io"};
+static constexpr auto DEFAULT_EXTERNAL_IP_ENDPOINT = string_view{"https://ipinfo.io"};
 
 pair<string, string> CreateQueryString() {
     auto api_key = GetEnvironmentValue("$IPINFO_API_KEY");
@@ -42,26 +46,89 @@ pair<string, string> CreateQueryString() {
     return make_pair(query, log_safe_query);
 }
 
+bool IsDnsResolverConfigured() {
+    auto resolver = mmotd::core::ConfigOptions::Instance().GetString("network.external_ip_resolver"sv, "https"sv);
+    return boost::iequals(resolver, "dns");
+}
+
+optional<mmotd::networking::GeoIpDatabase> OpenGeoIpDatabase() {
+    auto file_name = mmotd::core::ConfigOptions::Instance().GetString("location.geoip_database"sv, ""sv);
+    if (empty(file_name)) {
+        return nullopt;
+    }
+    auto database = mmotd::networking::GeoIpDatabase::Open(file_name);
+    if (!database) {
+        LOG_WARNING("unable to open the geoip database {}", file_name);
+    }
+    return database;
+}
+
 } // namespace
 
 namespace mmotd::information {
 
 static const bool external_network_information_factory_registered =
-    RegisterInformationProvider([]() { return make_unique<mmotd::information::ExternalNetwork>(); });
-
-void ExternalNetwork::FindInformation() {
+    RegisterInformationProvider("external_network",
+                                []() { return make_unique<mmotd::information::ExternalNetwork>(); },
+                                {InformationId::ID_EXTERNAL_NETWORK_INFO_EXTERNAL_IP,
+                                 InformationId::ID_LOCATION_INFO_CITY, InformationId::ID_LOCATION_INFO_COUNTRY,
+                                 InformationId::ID_LOCATION_INFO_GPS_LOCATION, InformationId::ID_LOCATION_INFO_STATE,
+                                 InformationId::ID_LOCATION_INFO_TIMEZONE, InformationId::ID_LOCATION_INFO_ZIP_CODE});
+
+void ExternalNetwork::FindInformation(std::stop_token stop_token) {
     using namespace mmotd::networking;
+    if (IsDnsResolverConfigured()) {
+        // a single udp round trip finds the address, the location is then found in the local geoip database
+        if (auto resolver = DnsExternalIpResolver::FromConfig(); resolver) {
+            if (auto ip_address = QueryExternalIpAddress(*resolver, stop_token); ip_address) {
+                LOG_DEBUG("found ip address: {} with a dns query", ip_address->to_string());
+                auto ip = GetInfoTemplate(InformationId::ID_EXTERNAL_NETWORK_INFO_EXTERNAL_IP);
+                ip.SetValue(ip_address->to_string());
+                AddInformation(ip);
+                AddGeoIpLocation(*ip_address);
+                return;
+            }
+        }
+        LOG_WARNING("unable to find the external ip address with a dns query, using the https service");
+    }
     auto path = "json"sv;
     auto [query, log_safe_query] = CreateQueryString();
-    auto response = HttpRequest::Get(HttpProtocol::HTTPS, EXTERNAL_IP_SERVICE_URL, path, query);
+    auto endpoint = HttpRequest::GetEndpoint("network.external_ip_endpoint"sv, DEFAULT_EXTERNAL_IP_ENDPOINT);
+    auto response = HttpRequest::Get(endpoint.protocol, endpoint.host, path, query, stop_token);
     if (response.has_value()) {
         ParseJsonResponse(*response);
     } else {
-        auto url = HttpRequest::GetUrl(HttpProtocol::HTTPS, EXTERNAL_IP_SERVICE_URL, path, log_safe_query);
+        auto url = HttpRequest::GetUrl(endpoint.protocol, endpoint.host, path, log_safe_query);
         LOG_ERROR("querying '{}' failed", url);
     }
 }
 
+void ExternalNetwork::AddGeoIpLocation(const boost::asio::ip::address &ip_address) {
+    auto database = OpenGeoIpDatabase();
+    if (!database) {
+        return;
+    }
+    auto location = database->Find(ip_address);
+    if (!location) {
+        LOG_INFO("ip address {} is not in the geoip database", ip_address.to_string());
+        return;
+    }
+    LOG_DEBUG("found the location of {} in the geoip database", ip_address.to_string());
+    auto add_value = [this](InformationId id, const string &value) {
+        if (!empty(value)) {
+            auto information = GetInfoTemplate(id);
+            information.SetValue(value);
+            AddInformation(information);
+        }
+    };
+    add_value(InformationId::ID_LOCATION_INFO_CITY, location->city);
+    add_value(InformationId::ID_LOCATION_INFO_COUNTRY, location->country);
+    add_value(InformationId::ID_LOCATION_INFO_GPS_LOCATION, location->gps_location);
+    add_value(InformationId::ID_LOCATION_INFO_ZIP_CODE, location->postal_code);
+    add_value(InformationId::ID_LOCATION_INFO_STATE, location->region);
+    add_value(InformationId::ID_LOCATION_INFO_TIMEZONE, location->timezone);
+}
+
 void ExternalNetwork::ParseJsonResponse(const string &response) {
     namespace pt = boost::property_tree;
     auto input_str_stream = istringstream{response};
@@ -101,43 +168,43 @@ void ExternalNetwork::ParseJsonResponse(const string &response) {
             return;
         }
         auto ip = GetInfoTemplate(InformationId::ID_EXTERNAL_NETWORK_INFO_EXTERNAL_IP);
-        ip.SetValueArgs(ip_address.to_string());
+        ip.SetValue(ip_address.to_string());
         AddInformation(ip);
     }
     if (auto city_value = tree.get_optional<string>("city"); city_value) {
         LOG_DEBUG("found city: {} in json response body", *city_value);
         auto city = GetInfoTemplate(InformationId::ID_LOCATION_INFO_CITY);
-        city.SetValueArgs(*city_value);
+        city.SetValue(*city_value);
         AddInformation(city);
     }
     if (auto country_value = tree.get_optional<string>("country"); country_value) {
         LOG_DEBUG("found country: {} in json response body", *country_value);
         auto country = GetInfoTemplate(InformationId::ID_LOCATION_INFO_COUNTRY);
-        country.SetValueArgs(*country_value);
+        country.SetValue(*country_value);
         AddInformation(country);
     }
     if (auto gps_location_value = tree.get_optional<string>("loc"); gps_location_value) {
         LOG_DEBUG("found gps location: {} in json response body", *gps_location_value);
         auto gps = GetInfoTemplate(InformationId::ID_LOCATION_INFO_GPS_LOCATION);
-        gps.SetValueArgs(*gps_location_value);
+        gps.SetValue(*gps_location_value);
         AddInformation(gps);
     }
     if (auto zip_code_value = tree.get_optional<string>("postal"); zip_code_value) {
         LOG_DEBUG("found zip code: {} in json response body", *zip_code_value);
         auto zipcode = GetInfoTemplate(InformationId::ID_LOCATION_INFO_ZIP_CODE);
-        zipcode.SetValueArgs(*zip_code_value);
+        zipcode.SetValue(*zip_code_value);
         AddInformation(zipcode);
     }
     if (auto state_value = tree.get_optional<string>("region"); state_value) {
         LOG_DEBUG("found state: {} in json response body", *state_value);
         auto state = GetInfoTemplate(InformationId::ID_LOCATION_INFO_STATE);
-        state.SetValueArgs(*state_value);
+        state.SetValue(*state_value);
         AddInformation(state);
     }
     if (auto timezone_value = tree.get_optional<string>("timezone"); timezone_value) {
         LOG_DEBUG("found timezone: {} in json response body", *timezone_value);
         auto tz = GetInfoTemplate(InformationId::ID_LOCATION_INFO_TIMEZONE);
-        tz.SetValueArgs(*timezone_value);
+        tz.SetValue(*timezone_value);
         AddInformation(tz);
     }
 }
@@ -17,9 +17,12 @@ bool gLinkFileSystem = false;
 namespace mmotd::information {
 
 static const bool file_system_factory_registered =
-    RegisterInformationProvider([]() { return make_unique<mmotd::information::FileSystem>(); });
+    RegisterInformationProvider("file_system",
+                                []() { return make_unique<mmotd::information::FileSystem>(); },
+                                {InformationId::ID_FILE_SYSTEM_FREE, InformationId::ID_FILE_SYSTEM_PERCENT_USED,
+                                 InformationId::ID_FILE_SYSTEM_SUMMARY, InformationId::ID_FILE_SYSTEM_TOTAL});
 
-void FileSystem::FindInformation() {
+void FileSystem::FindInformation(std::stop_token) {
     auto ec = error_code{};
     auto root_fs = std::filesystem::space("/", ec);
     if (ec) {
@@ -31,15 +34,15 @@ void FileSystem::FindInformation() {
     // usage.SetName("Usage of /");
     auto percent_used =
         static_cast<double>((root_fs.capacity - root_fs.available) * 100) / static_cast<double>(root_fs.capacity);
-    usage.SetValueArgs(percent_used);
+    usage.SetValue(percent_used);
     AddInformation(usage);
 
     auto capacity = GetInfoTemplate(InformationId::ID_FILE_SYSTEM_TOTAL);
-    capacity.SetValueArgs(to_human_size(root_fs.capacity));
+    capacity.SetValue(to_human_size(root_fs.capacity));
     AddInformation(capacity);
 
     auto free = GetInfoTemplate(InformationId::ID_FILE_SYSTEM_FREE);
-    free.SetValueArgs(root_fs.free);
+    free.SetValue(root_fs.free);
     AddInformation(free);
 
     auto summary = GetInfoTemplate(InformationId::ID_FILE_SYSTEM_SUMMARY);
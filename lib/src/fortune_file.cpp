@@ -0,0 +1,856 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/logging.h"
+#include "common/include/mapped_file.h"
+#include "common/include/posix_error.h"
+#include "common/include/special_files.h"
+#include "lib/include/fortune_file.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+#include <fmt/format.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using fmt::format;
+using namespace std;
+
+namespace {
+
+#if defined(__APPLE__)
+
+static constexpr uint32_t STRFILE_VERSION = 1;
+using StrFileIntType = uint64_t;
+static constexpr size_t STRFILE_HEADER_PADDING = sizeof(StrFileIntType);
+static constexpr bool STRFILE_ENTRY_CONTAINS_NULL_INT = true;
+
+#define FORTUNE_FILE_BYTESWAP(x) ntohll(x)
+
+#elif defined(__linux__)
+
+static constexpr uint32_t STRFILE_VERSION = 2;
+using StrFileIntType = uint32_t;
+static constexpr size_t STRFILE_HEADER_PADDING = 0;
+static constexpr bool STRFILE_ENTRY_CONTAINS_NULL_INT = false;
+
+#define FORTUNE_FILE_BYTESWAP(x) ntohl(x)
+
+#endif
+
+static constexpr size_t STRFILE_ENTRY_SIZE = sizeof(StrFileIntType);
+
+struct StrFileHeader {
+    StrFileHeader() = default;
+
+    enum class Flags : StrFileIntType {
+        None = 0x00,
+        Random = 0x01,  // randomized pointers
+        Ordered = 0x02, // ordered pointers
+        Rotated = 0x04  // rot-13'd text
+    };
+
+    friend constexpr Flags operator&(Flags a, Flags b) {
+        return static_cast<Flags>(static_cast<StrFileIntType>(a) & static_cast<StrFileIntType>(b));
+    }
+
+    StrFileIntType version = 0;      // version number
+    StrFileIntType count = 0;        // count of strings in the fortune file
+    StrFileIntType longest_str = 0;  // length of longest fortune
+    StrFileIntType shortest_str = 0; // length of shortest shortest fortune
+    Flags flags = Flags::None;       // flags
+    union DelimPadding {
+        char delim;                // delimeter between fortunes
+        array<uint8_t, 4> padding; // padding
+    };
+    DelimPadding delim_padding = {.padding = {0, 0, 0, 0}};
+
+    char get_delim() const { return delim_padding.delim; }
+
+    string flags_to_string() const {
+        auto flags_str = vector<string>{};
+        if (flags == Flags::None) {
+            flags_str.emplace_back("none");
+        }
+        if ((flags & Flags::Random) != Flags::None) {
+            flags_str.emplace_back("random");
+        }
+        if ((flags & Flags::Ordered) != Flags::None) {
+            flags_str.emplace_back("ordered");
+        }
+        if ((flags & Flags::Rotated) != Flags::None) {
+            flags_str.emplace_back("rotated");
+        }
+        return format(FMT_STRING("[{}]"), boost::join(flags_str, ", "));
+    }
+
+    string to_string() const {
+        return format(FMT_STRING("version: {}, count: {}, longest: {}, shortest: {}, flags: {}, delim: {}"),
+                      version,
+                      count,
+                      longest_str,
+                      shortest_str,
+                      flags_to_string(),
+                      get_delim());
+    }
+
+    void update() {
+        version = FORTUNE_FILE_BYTESWAP(version);
+        count = FORTUNE_FILE_BYTESWAP(count);
+        longest_str = FORTUNE_FILE_BYTESWAP(longest_str);
+        shortest_str = FORTUNE_FILE_BYTESWAP(shortest_str);
+        flags = static_cast<Flags>(FORTUNE_FILE_BYTESWAP(static_cast<StrFileIntType>(flags)));
+        LOG_VERBOSE("STRFILE: {}", to_string());
+    }
+};
+
+// The offsets follow the STRFILE header
+constexpr size_t STRFILE_OFFSETS_POSITION = sizeof(StrFileHeader) + STRFILE_HEADER_PADDING;
+
+optional<uint32_t> ParseSingleFortuneDbData(const char *entry) {
+    uint32_t network_offset_value = 0;
+    memcpy(&network_offset_value, entry, std::min(sizeof(uint32_t), STRFILE_ENTRY_SIZE));
+    auto host_offset_value = ntohl(network_offset_value);
+
+    if constexpr (STRFILE_ENTRY_CONTAINS_NULL_INT) {
+        uint32_t null_value = 0;
+        memcpy(&null_value, entry + sizeof(uint32_t), sizeof(uint32_t));
+        if (null_value != 0) {
+            LOG_ERROR("STRFILE appears corrupt, uint32_t value {} is not followed by NULL uint32_t (uint32_t={})",
+                      host_offset_value,
+                      null_value);
+            return nullopt;
+        }
+    }
+    return make_optional(host_offset_value);
+}
+
+// The fortune at the start of `text`, up to the line which holds only the delimiter
+string_view FindFortuneText(string_view text, char delimiter) {
+    for (auto i = text.find(delimiter); i != string_view::npos; i = text.find(delimiter, i + 1)) {
+        auto at_line_start = i == 0 || text[i - 1] == '\n';
+        auto at_line_end = i + 1 == size(text) || text[i + 1] == '\n';
+        if (at_line_start && at_line_end) {
+            return text.substr(0, i);
+        }
+    }
+    return text;
+}
+
+char Rot13(char c) {
+    if (c >= 'a' && c <= 'z') {
+        return static_cast<char>('a' + (c - 'a' + 13) % 26);
+    } else if (c >= 'A' && c <= 'Z') {
+        return static_cast<char>('A' + (c - 'A' + 13) % 26);
+    }
+    return c;
+}
+
+constexpr auto FORTUNE_INDEX_DIRECTORY = string_view{"fortune"};
+constexpr auto FORTUNE_INDEX_MAGIC = array<char, 8>{'m', 'm', 'o', 't', 'd', 'f', 'r', 't'};
+constexpr auto FORTUNE_INDEX_VERSION = uint32_t{1};
+
+struct FortuneIndexHeader {
+    array<char, 8> magic;
+    uint32_t version;
+    uint32_t file_count;
+    int64_t directory_mtime;
+    uint64_t count;
+    uint64_t name_pool_size;
+};
+
+struct FortuneIndexRecord {
+    // the number of fortunes in this file and every file before it
+    uint64_t running_count;
+    uint32_t name_offset;
+    uint32_t name_size;
+};
+
+constexpr auto TEXT_INDEX_MAGIC = array<char, 8>{'m', 'm', 'o', 't', 'd', 't', 'x', 't'};
+constexpr auto TEXT_INDEX_VERSION = uint32_t{2};
+constexpr auto TEXT_INDEX_ROTATED = uint32_t{0x01};
+constexpr auto TEXT_FORTUNE_DELIMITER = '%';
+constexpr auto TEXT_FORTUNE_TAB_STOP = size_t{8};
+
+struct TextIndexHeader {
+    array<char, 8> magic;
+    uint32_t version;
+    uint32_t count;
+    uint64_t text_size;
+    int64_t text_mtime;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+struct TextIndexEntry {
+    uint64_t offset;
+    uint32_t size;
+    // saturated, a fortune this long does not fit anywhere
+    uint16_t line_count;
+    uint16_t max_width;
+};
+
+constexpr auto ELIGIBLE_INDEX_MAGIC = array<char, 8>{'m', 'm', 'o', 't', 'd', 'e', 'l', 'g'};
+constexpr auto ELIGIBLE_INDEX_VERSION = uint32_t{1};
+// the size and modification time recorded for a file which could not be checked
+constexpr auto MISSING_SIZE_AND_MTIME = pair{uint64_t{0}, int64_t{0}};
+
+struct EligibleIndexHeader {
+    array<char, 8> magic;
+    uint32_t version;
+    uint32_t file_count;
+    uint64_t max_lines;
+    uint64_t max_width;
+    uint64_t count;
+    uint64_t path_pool_size;
+};
+
+struct EligibleIndexRecord {
+    // the number of eligible fortunes in this file and every file before it
+    uint64_t running_count;
+    uint64_t text_size;
+    int64_t text_mtime;
+    uint32_t path_offset;
+    uint32_t path_size;
+};
+
+bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Each line with its trailing blanks removed and without the trailing empty lines
+string NormalizeFortune(string_view fortune) {
+    auto result = string{};
+    result.reserve(size(fortune));
+    while (!empty(fortune)) {
+        auto newline = fortune.find('\n');
+        auto line = fortune.substr(0, newline);
+        while (!empty(line) && IsBlank(line.back())) {
+            line.remove_suffix(1);
+        }
+        result.append(line);
+        if (newline == string_view::npos) {
+            break;
+        }
+        result.push_back('\n');
+        fortune.remove_prefix(newline + 1);
+    }
+    return boost::trim_right_copy(result);
+}
+
+// The lines and the widest line of the fortune as it is printed, a utf-8 continuation byte takes no column
+mmotd::fortune::FortuneMetrics MeasureFortune(string_view fortune) {
+    auto metrics = mmotd::fortune::FortuneMetrics{};
+    metrics.size = size(fortune);
+    metrics.line_count = empty(fortune) ? 0 : 1;
+    auto width = size_t{0};
+    for (auto c : fortune) {
+        if (c == '\n') {
+            ++metrics.line_count;
+            width = 0;
+        } else if (c == '\t') {
+            width += TEXT_FORTUNE_TAB_STOP - width % TEXT_FORTUNE_TAB_STOP;
+        } else if ((static_cast<uint8_t>(c) & 0xc0) != 0x80) {
+            ++width;
+        }
+        metrics.max_width = max(metrics.max_width, width);
+    }
+    return metrics;
+}
+
+template<typename T>
+T Saturate(size_t value) {
+    return static_cast<T>(min(value, size_t{numeric_limits<T>::max()}));
+}
+
+// The fortunes of a text file, which are separated by lines holding only the delimiter (and blanks).  Blank fortunes
+//  are left out.  memchr only stops at the delimiters, it is vectorized by the c library.
+vector<TextIndexEntry> ScanTextFortunes(string_view text, char delimiter) {
+    auto entries = vector<TextIndexEntry>{};
+    auto add_entry = [&entries, text](size_t first, size_t last) {
+        auto fortune = text.substr(first, last - first);
+        if (none_of(begin(fortune), end(fortune), [](char c) { return !IsBlank(c) && c != '\n'; })) {
+            return;
+        }
+        auto metrics = MeasureFortune(NormalizeFortune(fortune));
+        entries.push_back(TextIndexEntry{first,
+                                         Saturate<uint32_t>(size(fortune)),
+                                         Saturate<uint16_t>(metrics.line_count),
+                                         Saturate<uint16_t>(metrics.max_width)});
+    };
+    auto entry_start = size_t{0};
+    const auto *first = data(text);
+    const auto *last = data(text) + size(text);
+    for (const auto *p = first; p != last;) {
+        p = static_cast<const char *>(memchr(p, delimiter, static_cast<size_t>(last - p)));
+        if (p == nullptr) {
+            break;
+        }
+        auto line_start = static_cast<size_t>(p - first);
+        while (line_start != 0 && IsBlank(text[line_start - 1])) {
+            --line_start;
+        }
+        auto line_end = static_cast<size_t>(p - first) + 1;
+        while (line_end != size(text) && IsBlank(text[line_end])) {
+            ++line_end;
+        }
+        ++p;
+        if ((line_start != 0 && text[line_start - 1] != '\n') || (line_end != size(text) && text[line_end] != '\n')) {
+            continue;
+        }
+        add_entry(entry_start, line_start);
+        entry_start = line_end == size(text) ? line_end : line_end + 1;
+        p = first + entry_start;
+    }
+    add_entry(entry_start, size(text));
+    return entries;
+}
+
+// $XDG_CACHE_HOME/mmotd/fortune/<hash of the key><extension>
+fs::path GetFortuneCachePath(string_view key, string_view extension) {
+    auto cache_dir = mmotd::core::special_files::GetCacheDirectory();
+    if (empty(cache_dir)) {
+        return fs::path{};
+    }
+    auto index_directory = cache_dir / FORTUNE_INDEX_DIRECTORY;
+    auto ec = error_code{};
+    fs::create_directories(index_directory, ec);
+    if (ec) {
+        LOG_ERROR("unable to create fortune index directory {}, {}", index_directory.string(), ec.message());
+        return fs::path{};
+    }
+    return index_directory / format(FMT_STRING("{:016x}{}"), mmotd::core::HashCacheKey(key), extension);
+}
+
+} // namespace
+
+namespace mmotd::fortune {
+
+optional<StrFile> StrFile::Open(const fs::path &text_path) {
+    auto dat_path = text_path;
+    dat_path += ".dat";
+    auto dat_file = mmotd::core::MappedFile::Open(dat_path);
+    if (!dat_file) {
+        LOG_VERBOSE("unable to open STRFILE database {}", dat_path.string());
+        return nullopt;
+    }
+    if (size(*dat_file) < STRFILE_OFFSETS_POSITION) {
+        LOG_ERROR("STRFILE database {} is too small for its header", dat_path.string());
+        return nullopt;
+    }
+    auto header = mmotd::core::ReadRecord<StrFileHeader>(data(*dat_file));
+    header.update();
+    if (header.version != STRFILE_VERSION) {
+        LOG_ERROR("STRFILE database header is version {} not the expected version {}", header.version, STRFILE_VERSION);
+        return nullopt;
+    }
+    if (header.count == 0 || (size(*dat_file) - STRFILE_OFFSETS_POSITION) / STRFILE_ENTRY_SIZE < header.count) {
+        LOG_ERROR("STRFILE database {} does not hold the offsets of its {} fortunes", dat_path.string(), header.count);
+        return nullopt;
+    }
+    auto text_file = mmotd::core::MappedFile::Open(text_path);
+    if (!text_file) {
+        LOG_ERROR("unable to open fortune file {}", text_path.string());
+        return nullopt;
+    }
+    auto strfile = StrFile{};
+    strfile.dat_file_ = std::move(*dat_file);
+    strfile.text_file_ = std::move(*text_file);
+    strfile.count_ = static_cast<size_t>(header.count);
+    strfile.delimiter_ = header.get_delim();
+    strfile.rotated_ = (header.flags & StrFileHeader::Flags::Rotated) != StrFileHeader::Flags::None;
+    return make_optional(std::move(strfile));
+}
+
+optional<string> StrFile::GetFortune(size_t index) const {
+    if (index >= count_) {
+        LOG_ERROR("fortune {} is out of range, there are {} fortunes", index, count_);
+        return nullopt;
+    }
+    auto offset = ParseSingleFortuneDbData(data(dat_file_) + STRFILE_OFFSETS_POSITION + index * STRFILE_ENTRY_SIZE);
+    if (!offset) {
+        return nullopt;
+    }
+    auto text = text_file_.view();
+    if (*offset >= size(text)) {
+        LOG_ERROR("the fortune offset={} is beyond the fortune file size={}", *offset, size(text));
+        return nullopt;
+    }
+    auto fortune = string{FindFortuneText(text.substr(*offset), delimiter_)};
+    if (rotated_) {
+        transform(begin(fortune), end(fortune), begin(fortune), Rot13);
+    }
+    LOG_VERBOSE("fortune:\n{}", fortune);
+    return make_optional(boost::trim_right_copy(fortune));
+}
+
+fs::path GetCacheIndexPath(const fs::path &path) {
+    return GetFortuneCachePath(path.string(), ".idx"sv);
+}
+
+optional<FortuneDirectoryIndex> FortuneDirectoryIndex::Open(const fs::path &directory, const fs::path &index_path) {
+    if (auto index = Read(directory, index_path); index) {
+        return index;
+    }
+    LOG_DEBUG("writing the fortune index of {} to {}", directory.string(), index_path.string());
+    if (!Write(directory, index_path)) {
+        return nullopt;
+    }
+    return Read(directory, index_path);
+}
+
+optional<FortuneDirectoryIndex> FortuneDirectoryIndex::Read(const fs::path &directory, const fs::path &index_path) {
+    auto mapped_file = mmotd::core::MappedFile::Open(index_path);
+    if (!mapped_file) {
+        return nullopt;
+    }
+    auto buffer = mapped_file->view();
+    if (size(buffer) < sizeof(FortuneIndexHeader)) {
+        return nullopt;
+    }
+    auto header = mmotd::core::ReadRecord<FortuneIndexHeader>(data(buffer));
+    buffer.remove_prefix(sizeof(header));
+    if (header.magic != FORTUNE_INDEX_MAGIC || header.version != FORTUNE_INDEX_VERSION ||
+        size_t{header.file_count} * sizeof(FortuneIndexRecord) + header.name_pool_size != size(buffer)) {
+        LOG_WARNING("discarding invalid fortune index {}", index_path.string());
+        return nullopt;
+    }
+    // adding or replacing a fortune file changes the modification time of the directory
+    auto directory_mtime = mmotd::core::GetModificationTime(directory);
+    if (!directory_mtime || *directory_mtime != header.directory_mtime) {
+        LOG_DEBUG("fortune index {} is older than {}", index_path.string(), directory.string());
+        return nullopt;
+    }
+    auto index = FortuneDirectoryIndex{};
+    index.directory_ = directory;
+    index.count_ = static_cast<size_t>(header.count);
+    index.file_count_ = header.file_count;
+    index.records_ = data(buffer);
+    index.name_pool_ = buffer.substr(size_t{header.file_count} * sizeof(FortuneIndexRecord));
+    index.mapped_file_ = std::move(*mapped_file);
+    return make_optional(std::move(index));
+}
+
+optional<FortuneLocation> FortuneDirectoryIndex::Locate(size_t index) const {
+    if (index >= count_) {
+        return nullopt;
+    }
+    auto get_record = [this](size_t i) {
+        return mmotd::core::ReadRecord<FortuneIndexRecord>(records_ + i * sizeof(FortuneIndexRecord));
+    };
+    // the first file whose running count is past the index
+    auto low = size_t{0};
+    auto high = file_count_;
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        if (get_record(middle).running_count <= index) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == file_count_) {
+        return nullopt;
+    }
+    auto record = get_record(low);
+    auto previous_count = low == 0 ? uint64_t{0} : get_record(low - 1).running_count;
+    if (size_t{record.name_offset} + record.name_size > size(name_pool_)) {
+        LOG_ERROR("fortune index record {} is not valid", low);
+        return nullopt;
+    }
+    auto location = FortuneLocation{};
+    location.text_path = directory_ / name_pool_.substr(record.name_offset, record.name_size);
+    location.index = static_cast<size_t>(index - previous_count);
+    location.count = static_cast<size_t>(record.running_count - previous_count);
+    return make_optional(std::move(location));
+}
+
+vector<fs::path> FortuneDirectoryIndex::GetTextPaths() const {
+    auto text_paths = vector<fs::path>{};
+    text_paths.reserve(file_count_);
+    for (auto i = size_t{0}; i != file_count_; ++i) {
+        auto record = mmotd::core::ReadRecord<FortuneIndexRecord>(records_ + i * sizeof(FortuneIndexRecord));
+        if (size_t{record.name_offset} + record.name_size > size(name_pool_)) {
+            LOG_ERROR("fortune index record {} is not valid", i);
+            continue;
+        }
+        text_paths.push_back(directory_ / name_pool_.substr(record.name_offset, record.name_size));
+    }
+    return text_paths;
+}
+
+bool FortuneDirectoryIndex::Write(const fs::path &directory, const fs::path &index_path) {
+    if (empty(index_path)) {
+        return false;
+    }
+    auto directory_mtime = mmotd::core::GetModificationTime(directory);
+    if (!directory_mtime) {
+        return false;
+    }
+    auto names = vector<string>{};
+    auto ec = error_code{};
+    for (const auto &entry : fs::directory_iterator(directory, ec)) {
+        auto entry_ec = error_code{};
+        if (entry.path().extension() == ".dat" && entry.is_regular_file(entry_ec)) {
+            names.push_back(fs::path{entry.path()}.replace_extension().filename().string());
+        }
+    }
+    if (ec) {
+        LOG_ERROR("unable to list the fortune files in {}, {}", directory.string(), ec.message());
+        return false;
+    }
+    sort(begin(names), end(names));
+
+    auto records = vector<FortuneIndexRecord>{};
+    auto name_pool = string{};
+    auto running_count = uint64_t{0};
+    for (const auto &name : names) {
+        auto strfile = StrFile::Open(directory / name);
+        if (!strfile) {
+            LOG_WARNING("skipping fortune file {} in {}", name, directory.string());
+            continue;
+        }
+        running_count += strfile->GetCount();
+        records.push_back(FortuneIndexRecord{running_count,
+                                             static_cast<uint32_t>(size(name_pool)),
+                                             static_cast<uint32_t>(size(name))});
+        name_pool += name;
+    }
+
+    auto header = FortuneIndexHeader{};
+    header.magic = FORTUNE_INDEX_MAGIC;
+    header.version = FORTUNE_INDEX_VERSION;
+    header.file_count = static_cast<uint32_t>(size(records));
+    header.directory_mtime = *directory_mtime;
+    header.count = running_count;
+    header.name_pool_size = size(name_pool);
+
+    auto parts = array{mmotd::core::AsBytes(header), mmotd::core::AsBytes(records), string_view{name_pool}};
+    return mmotd::core::WriteFileAtomically(index_path, parts);
+}
+
+vector<fs::path> TextFortuneFile::GetIndexPaths(const fs::path &text_path) {
+    auto index_path = text_path;
+    index_path += ".idx";
+    auto index_paths = vector<fs::path>{index_path};
+    if (auto cache_index_path = GetCacheIndexPath(text_path); !empty(cache_index_path)) {
+        index_paths.push_back(cache_index_path);
+    }
+    return index_paths;
+}
+
+optional<TextFortuneFile> TextFortuneFile::Open(const fs::path &text_path) {
+    auto index_paths = GetIndexPaths(text_path);
+    for (const auto &index_path : index_paths) {
+        if (auto text_fortune_file = Read(text_path, index_path); text_fortune_file) {
+            return text_fortune_file;
+        }
+    }
+    // the directory of a fortune file which came with a package is not writable, the cache directory is used instead
+    for (const auto &index_path : index_paths) {
+        LOG_DEBUG("writing the fortune index of {} to {}", text_path.string(), index_path.string());
+        if (Write(text_path, index_path)) {
+            return Read(text_path, index_path);
+        }
+    }
+    return nullopt;
+}
+
+optional<TextFortuneFile> TextFortuneFile::Read(const fs::path &text_path, const fs::path &index_path) {
+    auto mapped_file = mmotd::core::MappedFile::Open(index_path);
+    if (!mapped_file) {
+        return nullopt;
+    }
+    auto buffer = mapped_file->view();
+    if (size(buffer) < sizeof(TextIndexHeader)) {
+        return nullopt;
+    }
+    auto header = mmotd::core::ReadRecord<TextIndexHeader>(data(buffer));
+    if (header.magic != TEXT_INDEX_MAGIC || header.version != TEXT_INDEX_VERSION ||
+        sizeof(header) + size_t{header.count} * sizeof(TextIndexEntry) != size(buffer)) {
+        LOG_WARNING("discarding invalid fortune index {}", index_path.string());
+        return nullopt;
+    }
+    auto size_and_mtime = mmotd::core::GetSizeAndModificationTime(text_path);
+    if (!size_and_mtime || size_and_mtime->first != header.text_size || size_and_mtime->second != header.text_mtime) {
+        LOG_DEBUG("fortune index {} does not match {}", index_path.string(), text_path.string());
+        return nullopt;
+    }
+    auto text_fortune_file = TextFortuneFile{};
+    text_fortune_file.text_path_ = text_path;
+    text_fortune_file.count_ = header.count;
+    text_fortune_file.entries_ = data(buffer) + sizeof(header);
+    text_fortune_file.rotated_ = (header.flags & TEXT_INDEX_ROTATED) != 0;
+    text_fortune_file.mapped_file_ = std::move(*mapped_file);
+    return make_optional(std::move(text_fortune_file));
+}
+
+optional<string> TextFortuneFile::GetFortune(size_t index) const {
+    if (index >= count_) {
+        LOG_ERROR("fortune {} is out of range, there are {} fortunes", index, count_);
+        return nullopt;
+    }
+    auto entry = mmotd::core::ReadRecord<TextIndexEntry>(entries_ + index * sizeof(TextIndexEntry));
+    auto fd = open(text_path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        LOG_ERROR("unable to open {} for reading, {}", text_path_.string(), mmotd::error::posix_error::to_string());
+        return nullopt;
+    }
+    auto buffer = string(static_cast<size_t>(entry.size), '\0');
+    auto bytes_read = pread(fd, data(buffer), size(buffer), static_cast<off_t>(entry.offset));
+    auto read_error = bytes_read == -1 ? mmotd::error::posix_error::to_string() : "short read"s;
+    close(fd);
+    if (bytes_read != static_cast<ssize_t>(size(buffer))) {
+        LOG_ERROR("unable to read {} bytes of {} at offset {}, {}",
+                  size(buffer),
+                  text_path_.string(),
+                  entry.offset,
+                  read_error);
+        return nullopt;
+    }
+    auto fortune = NormalizeFortune(buffer);
+    if (rotated_) {
+        transform(begin(fortune), end(fortune), begin(fortune), Rot13);
+    }
+    LOG_VERBOSE("fortune:\n{}", fortune);
+    return make_optional(std::move(fortune));
+}
+
+FortuneMetrics TextFortuneFile::GetMetrics(size_t index) const {
+    if (index >= count_) {
+        return FortuneMetrics{};
+    }
+    auto entry = mmotd::core::ReadRecord<TextIndexEntry>(entries_ + index * sizeof(TextIndexEntry));
+    return FortuneMetrics{entry.size, entry.line_count, entry.max_width};
+}
+
+bool TextFortuneFile::Write(const fs::path &text_path, const fs::path &index_path) {
+    auto size_and_mtime = mmotd::core::GetSizeAndModificationTime(text_path);
+    auto mapped_file = mmotd::core::MappedFile::Open(text_path);
+    if (!size_and_mtime || !mapped_file) {
+        LOG_ERROR("unable to read the fortune file {}", text_path.string());
+        return false;
+    }
+    // a fortune file with a STRFILE database may use another delimiter or be rotated
+    auto delimiter = TEXT_FORTUNE_DELIMITER;
+    auto flags = uint32_t{0};
+    if (auto strfile = StrFile::Open(text_path); strfile) {
+        delimiter = strfile->GetDelimiter();
+        flags |= strfile->IsRotated() ? TEXT_INDEX_ROTATED : uint32_t{0};
+    }
+    auto entries = ScanTextFortunes(mapped_file->view(), delimiter);
+    LOG_DEBUG("found {} fortunes in {}", size(entries), text_path.string());
+
+    auto header = TextIndexHeader{};
+    header.magic = TEXT_INDEX_MAGIC;
+    header.version = TEXT_INDEX_VERSION;
+    header.count = static_cast<uint32_t>(size(entries));
+    header.text_size = size_and_mtime->first;
+    header.text_mtime = size_and_mtime->second;
+    header.flags = flags;
+    header.reserved = 0;
+
+    auto parts = array{mmotd::core::AsBytes(header), mmotd::core::AsBytes(entries)};
+    return mmotd::core::WriteFileAtomically(index_path, parts);
+}
+
+optional<EligibleFortunes> EligibleFortunes::Open(const vector<fs::path> &text_paths,
+                                                  FortuneConstraints constraints,
+                                                  const fs::path &index_path) {
+    if (!empty(index_path)) {
+        if (auto eligible_fortunes = Read(index_path, text_paths, constraints); eligible_fortunes) {
+            return eligible_fortunes;
+        }
+    }
+    auto buffer = Build(text_paths, constraints);
+    if (!empty(index_path)) {
+        LOG_DEBUG("writing the eligible fortunes of {} files to {}", size(text_paths), index_path.string());
+        auto parts = array{string_view{buffer}};
+        if (mmotd::core::WriteFileAtomically(index_path, parts)) {
+            if (auto eligible_fortunes = Read(index_path, text_paths, constraints); eligible_fortunes) {
+                return eligible_fortunes;
+            }
+        }
+    }
+    auto eligible_fortunes = Parse(buffer, text_paths, constraints, "the unsaved table"sv);
+    if (!eligible_fortunes) {
+        return nullopt;
+    }
+    eligible_fortunes->buffer_ = std::move(buffer);
+    return eligible_fortunes;
+}
+
+fs::path EligibleFortunes::GetIndexPath(const vector<fs::path> &text_paths, FortuneConstraints constraints) {
+    auto key = format(FMT_STRING("{} {}"), constraints.max_lines, constraints.max_width);
+    for (const auto &text_path : text_paths) {
+        key += '\n';
+        key += text_path.string();
+    }
+    return GetFortuneCachePath(key, ".elg"sv);
+}
+
+string EligibleFortunes::Build(const vector<fs::path> &text_paths, FortuneConstraints constraints) {
+    auto records = vector<EligibleIndexRecord>{};
+    auto indexes = vector<uint32_t>{};
+    auto path_pool = string{};
+    for (const auto &text_path : text_paths) {
+        // taken before the file is read, a change while the table is built is found the next time it is opened
+        auto size_and_mtime = mmotd::core::GetSizeAndModificationTime(text_path).value_or(MISSING_SIZE_AND_MTIME);
+        if (auto text_fortune_file = TextFortuneFile::Open(text_path); text_fortune_file) {
+            auto previous_count = size(indexes);
+            for (auto i = size_t{0}; i != text_fortune_file->GetCount(); ++i) {
+                if (constraints.IsSatisfiedBy(text_fortune_file->GetMetrics(i))) {
+                    indexes.push_back(static_cast<uint32_t>(i));
+                }
+            }
+            LOG_DEBUG("{} of {} fortunes in {} fit the constraints",
+                      size(indexes) - previous_count,
+                      text_fortune_file->GetCount(),
+                      text_path.string());
+        } else {
+            LOG_ERROR("unable to index the text fortunes in {}", text_path.string());
+        }
+        auto path = text_path.string();
+        records.push_back(EligibleIndexRecord{size(indexes),
+                                              size_and_mtime.first,
+                                              size_and_mtime.second,
+                                              static_cast<uint32_t>(size(path_pool)),
+                                              static_cast<uint32_t>(size(path))});
+        path_pool += path;
+    }
+
+    auto header = EligibleIndexHeader{};
+    header.magic = ELIGIBLE_INDEX_MAGIC;
+    header.version = ELIGIBLE_INDEX_VERSION;
+    header.file_count = static_cast<uint32_t>(size(records));
+    header.max_lines = constraints.max_lines;
+    header.max_width = constraints.max_width;
+    header.count = size(indexes);
+    header.path_pool_size = size(path_pool);
+
+    auto buffer = string{};
+    buffer.reserve(sizeof(header) + size(records) * sizeof(EligibleIndexRecord) + size(indexes) * sizeof(uint32_t) +
+                   size(path_pool));
+    buffer += mmotd::core::AsBytes(header);
+    buffer += mmotd::core::AsBytes(records);
+    buffer += mmotd::core::AsBytes(indexes);
+    buffer += path_pool;
+    return buffer;
+}
+
+optional<EligibleFortunes> EligibleFortunes::Read(const fs::path &index_path,
+                                                  const vector<fs::path> &text_paths,
+                                                  FortuneConstraints constraints) {
+    auto mapped_file = mmotd::core::MappedFile::Open(index_path);
+    if (!mapped_file) {
+        return nullopt;
+    }
+    auto eligible_fortunes = Parse(mapped_file->view(), text_paths, constraints, index_path.string());
+    if (!eligible_fortunes) {
+        return nullopt;
+    }
+    eligible_fortunes->mapped_file_ = std::move(*mapped_file);
+    return eligible_fortunes;
+}
+
+optional<EligibleFortunes> EligibleFortunes::Parse(string_view buffer,
+                                                   const vector<fs::path> &text_paths,
+                                                   FortuneConstraints constraints,
+                                                   string_view source) {
+    if (size(buffer) < sizeof(EligibleIndexHeader)) {
+        return nullopt;
+    }
+    auto header = mmotd::core::ReadRecord<EligibleIndexHeader>(data(buffer));
+    auto tables_size =
+        size_t{header.file_count} * sizeof(EligibleIndexRecord) + static_cast<size_t>(header.count) * sizeof(uint32_t);
+    if (header.magic != ELIGIBLE_INDEX_MAGIC || header.version != ELIGIBLE_INDEX_VERSION ||
+        sizeof(header) + tables_size + header.path_pool_size != size(buffer)) {
+        LOG_WARNING("discarding invalid eligible fortune index {}", source);
+        return nullopt;
+    }
+    if (header.max_lines != constraints.max_lines || header.max_width != constraints.max_width ||
+        header.file_count != size(text_paths)) {
+        LOG_DEBUG("eligible fortune index {} is for other constraints or files", source);
+        return nullopt;
+    }
+    const auto *records = data(buffer) + sizeof(header);
+    auto path_pool = buffer.substr(sizeof(header) + tables_size);
+    auto previous_count = uint64_t{0};
+    for (auto i = size_t{0}; i != size(text_paths); ++i) {
+        auto record = mmotd::core::ReadRecord<EligibleIndexRecord>(records + i * sizeof(EligibleIndexRecord));
+        if (record.running_count < previous_count || record.running_count > header.count ||
+            size_t{record.path_offset} + record.path_size > size(path_pool)) {
+            LOG_WARNING("discarding invalid eligible fortune index {}", source);
+            return nullopt;
+        }
+        previous_count = record.running_count;
+        // only the size and modification time of each file are checked, none of them is opened
+        auto size_and_mtime = mmotd::core::GetSizeAndModificationTime(text_paths[i]).value_or(MISSING_SIZE_AND_MTIME);
+        if (path_pool.substr(record.path_offset, record.path_size) != text_paths[i].string() ||
+            size_and_mtime.first != record.text_size || size_and_mtime.second != record.text_mtime) {
+            LOG_DEBUG("eligible fortune index {} does not match {}", source, text_paths[i].string());
+            return nullopt;
+        }
+    }
+    if (previous_count != header.count) {
+        LOG_WARNING("discarding invalid eligible fortune index {}", source);
+        return nullopt;
+    }
+    auto eligible_fortunes = EligibleFortunes{};
+    eligible_fortunes.count_ = static_cast<size_t>(header.count);
+    eligible_fortunes.file_count_ = header.file_count;
+    return make_optional(std::move(eligible_fortunes));
+}
+
+string_view EligibleFortunes::GetBuffer() const noexcept {
+    return empty(buffer_) ? mapped_file_.view() : string_view{buffer_};
+}
+
+optional<string> EligibleFortunes::GetFortune(size_t index) const {
+    if (index >= count_) {
+        LOG_ERROR("eligible fortune {} is out of range, there are {} eligible fortunes", index, count_);
+        return nullopt;
+    }
+    const auto *records = data(GetBuffer()) + sizeof(EligibleIndexHeader);
+    const auto *indexes = records + file_count_ * sizeof(EligibleIndexRecord);
+    const auto *path_pool = indexes + count_ * sizeof(uint32_t);
+    auto get_record = [records](size_t i) {
+        return mmotd::core::ReadRecord<EligibleIndexRecord>(records + i * sizeof(EligibleIndexRecord));
+    };
+    // the first file whose running count is past the index
+    auto low = size_t{0};
+    auto high = file_count_;
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        if (get_record(middle).running_count <= index) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    auto record = get_record(low);
+    auto previous_count = low == 0 ? uint64_t{0} : get_record(low - 1).running_count;
+    auto text_path = fs::path{string_view{path_pool + record.path_offset, record.path_size}};
+    auto text_fortune_file = TextFortuneFile::Open(text_path);
+    if (!text_fortune_file) {
+        LOG_ERROR("unable to index the text fortunes in {}", text_path.string());
+        return nullopt;
+    }
+    LOG_VERBOSE("eligible fortune {} is fortune {} of {}", index, index - previous_count, text_path.string());
+    return text_fortune_file->GetFortune(mmotd::core::ReadRecord<uint32_t>(indexes + index * sizeof(uint32_t)));
+}
+
+} // namespace mmotd::fortune
@@ -25,7 +25,12 @@ using namespace std;
 bool gLinkGeneralGenerator = false;
 
 static const bool general_factory_registered =
-    mmotd::information::RegisterInformationProvider([]() { return make_unique<mmotd::information::General>(); });
+    mmotd::information::RegisterInformationProvider("general",
+                                                    []() { return make_unique<mmotd::information::General>(); },
+                                                    {mmotd::information::InformationId::ID_GENERAL_GREETING,
+                                                     mmotd::information::InformationId::ID_GENERAL_LOCAL_DATE_TIME,
+                                                     mmotd::information::InformationId::ID_GENERAL_LOCAL_TIME_EMOJI,
+                                                     mmotd::information::InformationId::ID_GENERAL_USER_NAME});
 
 namespace {
 using HourType = std::chrono::hours::rep;
@@ -125,14 +130,14 @@ string Greetings::GetLocalDateTime() const {
 
 namespace mmotd::information {
 
-void General::FindInformation() {
+void General::FindInformation(std::stop_token) {
     auto user_info = mmotd::core::GetUserInformation();
     if (user_info.empty()) {
         return;
     }
 
     auto username = GetInfoTemplate(InformationId::ID_GENERAL_USER_NAME);
-    username.SetValueArgs(user_info.full_name);
+    username.SetValue(user_info.full_name);
     AddInformation(username);
 
     auto greeting_info = GetInfoTemplate(InformationId::ID_GENERAL_GREETING);
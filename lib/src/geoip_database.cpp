@@ -0,0 +1,315 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/line_parser.h"
+#include "common/include/logging.h"
+#include "common/include/mapped_file.h"
+#include "lib/include/geoip_database.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio/ip/address.hpp>
+#include <fmt/format.h>
+
+using namespace std;
+using boost::asio::ip::address;
+using fmt::format;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr auto GEOIP_MAGIC = array<char, 8>{'m', 'm', 'o', 't', 'd', 'g', 'e', 'o'};
+constexpr auto GEOIP_VERSION = uint32_t{1};
+constexpr auto ADDRESS_SIZE = size_t{16};
+constexpr auto GEOIP_CSV_COLUMNS = size_t{9};
+
+using AddressKey = array<unsigned char, ADDRESS_SIZE>;
+
+struct GeoIpHeader {
+    array<char, 8> magic;
+    uint32_t version;
+    uint32_t range_count;
+    uint32_t location_count;
+    uint32_t string_pool_size;
+};
+
+struct GeoIpRangeRecord {
+    AddressKey last;
+    uint32_t location_index;
+};
+
+struct GeoIpString {
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct GeoIpLocationRecord {
+    GeoIpString city;
+    GeoIpString region;
+    GeoIpString country;
+    GeoIpString postal_code;
+    GeoIpString timezone;
+    GeoIpString gps_location;
+};
+
+AddressKey ToKey(const address &ip_address) {
+    using namespace boost::asio::ip;
+    if (ip_address.is_v4()) {
+        return make_address_v6(v4_mapped, ip_address.to_v4()).to_bytes();
+    }
+    return ip_address.to_v6().to_bytes();
+}
+
+// A csv line split into its fields, a quoted field may contain ',' and '""' is an escaped quote
+vector<string> SplitCsvLine(string_view line) {
+    auto fields = vector<string>(1);
+    auto quoted = false;
+    for (auto i = size_t{0}; i != size(line); ++i) {
+        auto c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 != size(line) && line[i + 1] == '"') {
+                fields.back().push_back('"');
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                fields.back().push_back(c);
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.emplace_back();
+        } else {
+            fields.back().push_back(c);
+        }
+    }
+    for (auto &field : fields) {
+        field = string{mmotd::core::TrimBlanks(field)};
+    }
+    return fields;
+}
+
+optional<address> ToAddress(const string &str) {
+    auto ec = boost::system::error_code{};
+    auto ip_address = boost::asio::ip::make_address(str, ec);
+    return ec ? nullopt : make_optional(ip_address);
+}
+
+// The strings of every location share one pool, a country is only written once
+class StringPoolWriter {
+public:
+    GeoIpString Add(const string &str) {
+        if (auto i = offsets_.find(str); i != end(offsets_)) {
+            return i->second;
+        }
+        auto result = GeoIpString{static_cast<uint32_t>(size(pool_)), static_cast<uint32_t>(size(str))};
+        pool_ += str;
+        offsets_.emplace(str, result);
+        return result;
+    }
+
+    const string &GetPool() const noexcept { return pool_; }
+
+private:
+    string pool_;
+    unordered_map<string, GeoIpString> offsets_;
+};
+
+} // namespace
+
+namespace mmotd::networking {
+
+vector<GeoIpRange> ParseGeoIpCsv(istream &input) {
+    auto ranges = vector<GeoIpRange>{};
+    auto line = string{};
+    auto line_number = size_t{0};
+    while (getline(input, line)) {
+        ++line_number;
+        auto trimmed = mmotd::core::TrimBlanks(line);
+        if (empty(trimmed) || trimmed.front() == '#') {
+            continue;
+        }
+        auto fields = SplitCsvLine(trimmed);
+        auto first = ToAddress(fields.front());
+        if (!first && line_number == 1) {
+            continue;
+        }
+        auto last = size(fields) > 1 ? ToAddress(fields[1]) : nullopt;
+        if (size(fields) != GEOIP_CSV_COLUMNS || !first || !last || first->is_v4() != last->is_v4()) {
+            LOG_WARNING("skipping invalid geoip range on line {}: '{}'", line_number, trimmed);
+            continue;
+        }
+        auto range = GeoIpRange{*first, *last, GeoIpLocation{}};
+        range.location.country = std::move(fields[2]);
+        range.location.region = std::move(fields[3]);
+        range.location.city = std::move(fields[4]);
+        range.location.postal_code = std::move(fields[5]);
+        range.location.timezone = std::move(fields[6]);
+        if (!empty(fields[7]) && !empty(fields[8])) {
+            range.location.gps_location = format(FMT_STRING("{},{}"), fields[7], fields[8]);
+        }
+        ranges.push_back(std::move(range));
+    }
+    return ranges;
+}
+
+optional<GeoIpDatabase> GeoIpDatabase::Open(const fs::path &file_path) {
+    auto mapped_file = mmotd::core::MappedFile::Open(file_path);
+    if (!mapped_file) {
+        return nullopt;
+    }
+    auto buffer = mapped_file->view();
+    auto header = GeoIpHeader{};
+    if (size(buffer) < sizeof(header)) {
+        LOG_ERROR("geoip database {} is too small", file_path.string());
+        return nullopt;
+    }
+    header = mmotd::core::ReadRecord<GeoIpHeader>(data(buffer));
+    auto expected_size = sizeof(header) + size_t{header.range_count} * (ADDRESS_SIZE + sizeof(GeoIpRangeRecord)) +
+                         size_t{header.location_count} * sizeof(GeoIpLocationRecord) + header.string_pool_size;
+    if (header.magic != GEOIP_MAGIC || header.version != GEOIP_VERSION || expected_size != size(buffer)) {
+        LOG_ERROR("geoip database {} is not valid", file_path.string());
+        return nullopt;
+    }
+    auto database = GeoIpDatabase{};
+    database.range_count_ = header.range_count;
+    database.location_count_ = header.location_count;
+    database.first_addresses_ = data(buffer) + sizeof(header);
+    database.ranges_ = database.first_addresses_ + database.range_count_ * ADDRESS_SIZE;
+    database.locations_ = database.ranges_ + database.range_count_ * sizeof(GeoIpRangeRecord);
+    database.string_pool_ = buffer.substr(size(buffer) - header.string_pool_size);
+    database.mapped_file_ = std::move(*mapped_file);
+    return make_optional(std::move(database));
+}
+
+optional<GeoIpLocation> GeoIpDatabase::Find(const address &ip_address) const {
+    auto key = ToKey(ip_address);
+    // the number of ranges which start at or before the address, the last of those is the only one it can be in
+    auto low = size_t{0};
+    auto high = range_count_;
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        if (memcmp(first_addresses_ + middle * ADDRESS_SIZE, data(key), ADDRESS_SIZE) <= 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == 0) {
+        return nullopt;
+    }
+    auto range = mmotd::core::ReadRecord<GeoIpRangeRecord>(ranges_ + (low - 1) * sizeof(GeoIpRangeRecord));
+    if (memcmp(data(key), data(range.last), ADDRESS_SIZE) > 0) {
+        return nullopt;
+    }
+    return GetLocation(range.location_index);
+}
+
+optional<GeoIpLocation> GeoIpDatabase::GetLocation(uint32_t index) const {
+    if (index >= location_count_) {
+        LOG_ERROR("geoip location {} is out of range, there are {} locations", index, location_count_);
+        return nullopt;
+    }
+    auto record = mmotd::core::ReadRecord<GeoIpLocationRecord>(locations_ + index * sizeof(GeoIpLocationRecord));
+    auto location = GeoIpLocation{};
+    auto valid = true;
+    auto get_string = [this, &valid](const GeoIpString &str) {
+        if (size_t{str.offset} + str.size > size(string_pool_)) {
+            valid = false;
+            return string{};
+        }
+        return string{string_pool_.substr(str.offset, str.size)};
+    };
+    location.city = get_string(record.city);
+    location.region = get_string(record.region);
+    location.country = get_string(record.country);
+    location.postal_code = get_string(record.postal_code);
+    location.timezone = get_string(record.timezone);
+    location.gps_location = get_string(record.gps_location);
+    if (!valid) {
+        LOG_ERROR("geoip location {} is not valid", index);
+        return nullopt;
+    }
+    return make_optional(std::move(location));
+}
+
+bool GeoIpDatabase::Write(const fs::path &file_path, const vector<GeoIpRange> &ranges) {
+    auto keyed_ranges = vector<pair<AddressKey, const GeoIpRange *>>{};
+    keyed_ranges.reserve(size(ranges));
+    for (const auto &range : ranges) {
+        keyed_ranges.emplace_back(ToKey(range.first), &range);
+    }
+    stable_sort(begin(keyed_ranges), end(keyed_ranges), [](const auto &a, const auto &b) {
+        return a.first < b.first;
+    });
+
+    auto first_addresses = vector<AddressKey>{};
+    auto range_records = vector<GeoIpRangeRecord>{};
+    auto location_records = vector<GeoIpLocationRecord>{};
+    auto location_indexes = unordered_map<string, uint32_t>{};
+    auto string_pool = StringPoolWriter{};
+    for (const auto &[first, range] : keyed_ranges) {
+        auto last = ToKey(range->last);
+        if (last < first) {
+            LOG_WARNING("skipping geoip range {} - {}, it ends before it starts",
+                        range->first.to_string(),
+                        range->last.to_string());
+            continue;
+        }
+        if (!empty(range_records) && first <= range_records.back().last) {
+            LOG_WARNING("skipping geoip range {} - {}, it overlaps the range before it",
+                        range->first.to_string(),
+                        range->last.to_string());
+            continue;
+        }
+        const auto &location = range->location;
+        auto location_key = format(FMT_STRING("{}\n{}\n{}\n{}\n{}\n{}"),
+                                   location.city,
+                                   location.region,
+                                   location.country,
+                                   location.postal_code,
+                                   location.timezone,
+                                   location.gps_location);
+        auto [i, inserted] = location_indexes.emplace(location_key, static_cast<uint32_t>(size(location_records)));
+        if (inserted) {
+            location_records.push_back(GeoIpLocationRecord{string_pool.Add(location.city),
+                                                           string_pool.Add(location.region),
+                                                           string_pool.Add(location.country),
+                                                           string_pool.Add(location.postal_code),
+                                                           string_pool.Add(location.timezone),
+                                                           string_pool.Add(location.gps_location)});
+        }
+        first_addresses.push_back(first);
+        range_records.push_back(GeoIpRangeRecord{last, i->second});
+    }
+    if (size(range_records) > numeric_limits<uint32_t>::max() ||
+        size(string_pool.GetPool()) > numeric_limits<uint32_t>::max()) {
+        LOG_ERROR("too many geoip ranges to write {}", file_path.string());
+        return false;
+    }
+
+    auto header = GeoIpHeader{};
+    header.magic = GEOIP_MAGIC;
+    header.version = GEOIP_VERSION;
+    header.range_count = static_cast<uint32_t>(size(range_records));
+    header.location_count = static_cast<uint32_t>(size(location_records));
+    header.string_pool_size = static_cast<uint32_t>(size(string_pool.GetPool()));
+
+    auto parts = array{mmotd::core::AsBytes(header),
+                       mmotd::core::AsBytes(first_addresses),
+                       mmotd::core::AsBytes(range_records),
+                       mmotd::core::AsBytes(location_records),
+                       string_view{string_pool.GetPool()}};
+    return mmotd::core::WriteFileAtomically(file_path, parts);
+}
+
+} // namespace mmotd::networking
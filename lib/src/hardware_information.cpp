@@ -1,14 +1,18 @@
 // vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/special_files.h"
 #include "lib/include/computer_information.h"
 #include "lib/include/hardware_information.h"
+#include "lib/include/information_cache.h"
 #include "lib/include/platform/hardware_information.h"
 #include "lib/include/platform/hardware_temperature.h"
 
 #include <bit>
+#include <filesystem>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 using namespace std;
@@ -19,12 +23,34 @@ bool gLinkHardwareInformation = false;
 namespace mmotd::information {
 
 static const bool hardware_information_factory_registered =
-    RegisterInformationProvider([]() { return make_unique<mmotd::information::HardwareInformation>(); });
+    RegisterInformationProvider("hardware",
+                                []() { return make_unique<mmotd::information::HardwareInformation>(); },
+                                {InformationId::ID_HARDWARE_CPU_BYTE_ORDER, InformationId::ID_HARDWARE_CPU_CORE_COUNT,
+                                 InformationId::ID_HARDWARE_CPU_NAME, InformationId::ID_HARDWARE_CPU_TEMPERATURE,
+                                 InformationId::ID_HARDWARE_GPU_MODEL_NAME, InformationId::ID_HARDWARE_GPU_TEMPERATURE,
+                                 InformationId::ID_HARDWARE_MACHINE_MODEL, InformationId::ID_HARDWARE_MACHINE_TYPE,
+                                 InformationId::ID_HARDWARE_MONITOR_NAME, InformationId::ID_HARDWARE_MONITOR_RESOLUTION,
+                                 InformationId::ID_HARDWARE_CPU_PHYSICAL_CORE_COUNT,
+                                 InformationId::ID_HARDWARE_CPU_SOCKET_COUNT});
+
+vector<InformationProvider::SubTask> HardwareInformation::GetSubTasks() {
+    using namespace mmotd::platform;
+    // each of the sub-tasks sets its own fields of the details
+    details_ = HardwareDetails{};
+    // the index of the gpu names is cached along with the snapshots
+    auto cache_directory = InformationCache::IsEnabled() ? mmotd::core::special_files::GetCacheDirectory()
+                                                         : std::filesystem::path{};
+    return {[this](std::stop_token) { GetMachineDetails(details_); },
+            [this](std::stop_token stop_token) { GetCpuDetails(details_, std::move(stop_token)); },
+            [this, cache_directory](std::stop_token stop_token) {
+                GetGpuDetails(details_, cache_directory, std::move(stop_token));
+            },
+            [this](std::stop_token) { GetTemperatureDetails(details_); }};
+}
 
-void HardwareInformation::FindInformation() {
-    auto details = mmotd::platform::GetHardwareInformationDetails();
-    if (!details.empty()) {
-        CreateInformationObjects(details);
+void HardwareInformation::FindInformation(std::stop_token) {
+    if (!details_.empty()) {
+        CreateInformationObjects(details_);
     }
 }
 
@@ -32,46 +58,67 @@ void HardwareInformation::CreateInformationObjects(const mmotd::platform::Hardwa
     const auto UNKNOWN_STR = GetUnknownProperty();
 
     auto machine_type = GetInfoTemplate(InformationId::ID_HARDWARE_MACHINE_TYPE);
-    machine_type.SetValueArgs(std::empty(details.machine_type) ? UNKNOWN_STR : details.machine_type);
+    machine_type.SetValue(std::empty(details.machine_type) ? UNKNOWN_STR : details.machine_type);
     AddInformation(machine_type);
 
     auto machine_model = GetInfoTemplate(InformationId::ID_HARDWARE_MACHINE_MODEL);
-    machine_model.SetValueArgs(std::empty(details.machine_model) ? UNKNOWN_STR : details.machine_model);
+    machine_model.SetValue(std::empty(details.machine_model) ? UNKNOWN_STR : details.machine_model);
     AddInformation(machine_model);
 
     auto cpu_core_count = GetInfoTemplate(InformationId::ID_HARDWARE_CPU_CORE_COUNT);
-    cpu_core_count.SetValueArgs(details.cpu_core_count == 0 ? UNKNOWN_STR : std::to_string(details.cpu_core_count));
+    cpu_core_count.SetValue(details.cpu_core_count == 0 ? UNKNOWN_STR : std::to_string(details.cpu_core_count));
     AddInformation(cpu_core_count);
 
+    auto cpu_physical_core_count = GetInfoTemplate(InformationId::ID_HARDWARE_CPU_PHYSICAL_CORE_COUNT);
+    if (details.cpu_physical_core_count == 0) {
+        cpu_physical_core_count.SetValue(UNKNOWN_STR);
+    } else {
+        cpu_physical_core_count.SetValue(details.cpu_physical_core_count);
+    }
+    AddInformation(cpu_physical_core_count);
+
+    auto cpu_socket_count = GetInfoTemplate(InformationId::ID_HARDWARE_CPU_SOCKET_COUNT);
+    if (details.cpu_socket_count == 0) {
+        cpu_socket_count.SetValue(UNKNOWN_STR);
+    } else {
+        cpu_socket_count.SetValue(details.cpu_socket_count);
+    }
+    AddInformation(cpu_socket_count);
+
     auto cpu_name = GetInfoTemplate(InformationId::ID_HARDWARE_CPU_NAME);
-    cpu_name.SetValueArgs(std::empty(details.cpu_name) ? UNKNOWN_STR : details.cpu_name);
+    cpu_name.SetValue(std::empty(details.cpu_name) ? UNKNOWN_STR : details.cpu_name);
     AddInformation(cpu_name);
 
     auto byte_order = GetInfoTemplate(InformationId::ID_HARDWARE_CPU_BYTE_ORDER);
-    byte_order.SetValueArgs(details.byte_order.has_value() ? mmotd::platform::to_string(*details.byte_order) :
-                                                             UNKNOWN_STR);
+    byte_order.SetValue(details.byte_order.has_value() ? mmotd::platform::to_string(*details.byte_order) : UNKNOWN_STR);
     AddInformation(byte_order);
 
-    auto gpu_name = GetInfoTemplate(InformationId::ID_HARDWARE_GPU_MODEL_NAME);
-    gpu_name.SetValueArgs(empty(details.gpu_name) ? UNKNOWN_STR : details.gpu_name);
-    AddInformation(gpu_name);
+    // one information for each gpu, a machine with an integrated and a discrete gpu lists both
+    for (const auto &gpu_model_name : details.gpu_names) {
+        auto gpu_name = GetInfoTemplate(InformationId::ID_HARDWARE_GPU_MODEL_NAME);
+        gpu_name.SetValue(gpu_model_name);
+        AddInformation(gpu_name);
+    }
+    if (empty(details.gpu_names)) {
+        auto gpu_name = GetInfoTemplate(InformationId::ID_HARDWARE_GPU_MODEL_NAME);
+        gpu_name.SetValue(UNKNOWN_STR);
+        AddInformation(gpu_name);
+    }
 
     auto monitor_name = GetInfoTemplate(InformationId::ID_HARDWARE_MONITOR_NAME);
-    monitor_name.SetValueArgs(empty(details.monitor_name) ? UNKNOWN_STR : details.monitor_name);
+    monitor_name.SetValue(empty(details.monitor_name) ? UNKNOWN_STR : details.monitor_name);
     AddInformation(monitor_name);
 
     auto monitor_resolution = GetInfoTemplate(InformationId::ID_HARDWARE_MONITOR_RESOLUTION);
-    monitor_resolution.SetValueArgs(empty(details.monitor_resolution) ? UNKNOWN_STR : details.monitor_resolution);
+    monitor_resolution.SetValue(empty(details.monitor_resolution) ? UNKNOWN_STR : details.monitor_resolution);
     AddInformation(monitor_resolution);
 
     auto cpu_temperature = GetInfoTemplate(InformationId::ID_HARDWARE_CPU_TEMPERATURE);
-    cpu_temperature.SetValueArgs(std::empty(details.cpu_temperature) ? UNKNOWN_STR :
-                                                                       details.cpu_temperature.to_string());
+    cpu_temperature.SetValue(std::empty(details.cpu_temperature) ? UNKNOWN_STR : details.cpu_temperature.to_string());
     AddInformation(cpu_temperature);
 
     auto gpu_temperature = GetInfoTemplate(InformationId::ID_HARDWARE_GPU_TEMPERATURE);
-    gpu_temperature.SetValueArgs(std::empty(details.gpu_temperature) ? UNKNOWN_STR :
-                                                                       details.gpu_temperature.to_string());
+    gpu_temperature.SetValue(std::empty(details.gpu_temperature) ? UNKNOWN_STR : details.gpu_temperature.to_string());
     AddInformation(gpu_temperature);
 }
 
@@ -0,0 +1,137 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/logging.h"
+#include "common/include/mapped_file.h"
+#include "lib/include/http_circuit_breaker.h"
+#include "lib/include/http_response_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr auto HEALTH_MAGIC = array<char, 8>{'m', 'm', 'o', 't', 'd', 'b', 'r', 'k'};
+constexpr auto HEALTH_VERSION = uint32_t{1};
+
+struct HealthRecord {
+    array<char, 8> magic;
+    uint32_t version;
+    uint32_t consecutive_failures;
+    int64_t last_failure;
+};
+
+// host names (with an optional port) are kept to a file name friendly alphabet
+string GetHealthFileName(string_view host) {
+    auto name = string{host};
+    replace_if(
+        begin(name),
+        end(name),
+        [](char c) { return !isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '-'; },
+        '_');
+    return name + ".health";
+}
+
+} // namespace
+
+namespace mmotd::networking {
+
+HttpCircuitBreaker::HttpCircuitBreaker(fs::path directory, chrono::seconds backoff, chrono::seconds max_backoff) :
+    directory_(std::move(directory)), backoff_(backoff), max_backoff_(max(backoff, max_backoff)) {}
+
+fs::path HttpCircuitBreaker::GetHealthPath(string_view host) const {
+    return directory_ / GetHealthFileName(host);
+}
+
+HostHealth HttpCircuitBreaker::GetHealth(string_view host) const {
+    if (empty(directory_)) {
+        return HostHealth{};
+    }
+    auto mapped_file = mmotd::core::MappedFile::Open(GetHealthPath(host));
+    if (!mapped_file) {
+        return HostHealth{};
+    }
+    auto record = HealthRecord{};
+    if (mapped_file->size() != sizeof(record)) {
+        return HostHealth{};
+    }
+    memcpy(&record, mapped_file->data(), sizeof(record));
+    if (record.magic != HEALTH_MAGIC || record.version != HEALTH_VERSION) {
+        return HostHealth{};
+    }
+    auto last_failure = chrono::system_clock::time_point{chrono::seconds{record.last_failure}};
+    return HostHealth{record.consecutive_failures, last_failure};
+}
+
+chrono::seconds HttpCircuitBreaker::GetBackOff(uint32_t consecutive_failures) const noexcept {
+    if (consecutive_failures == 0) {
+        return chrono::seconds::zero();
+    }
+    auto backoff = backoff_;
+    for (auto i = uint32_t{1}; i < consecutive_failures && backoff < max_backoff_; ++i) {
+        backoff *= 2;
+    }
+    return min(backoff, max_backoff_);
+}
+
+bool HttpCircuitBreaker::IsOpen(string_view host, chrono::system_clock::time_point now) const {
+    auto health = GetHealth(host);
+    if (health.consecutive_failures == 0) {
+        return false;
+    }
+    auto retry_time = health.last_failure + GetBackOff(health.consecutive_failures);
+    // a clock which went backwards does not keep the breaker open for longer than one back-off
+    return now >= health.last_failure && now < retry_time;
+}
+
+void HttpCircuitBreaker::RecordSuccess(string_view host) const {
+    if (empty(directory_)) {
+        return;
+    }
+    auto ec = error_code{};
+    if (fs::remove(GetHealthPath(host), ec)) {
+        LOG_INFO("{} is reachable again", host);
+    }
+}
+
+void HttpCircuitBreaker::RecordFailure(string_view host, chrono::system_clock::time_point now) const {
+    if (empty(directory_)) {
+        return;
+    }
+    auto health = GetHealth(host);
+    health.consecutive_failures = health.consecutive_failures + 1;
+    health.last_failure = now;
+    LOG_WARNING("{} failed {} times in a row, skipping it for {}s",
+                host,
+                health.consecutive_failures,
+                GetBackOff(health.consecutive_failures).count());
+    Save(host, health);
+}
+
+bool HttpCircuitBreaker::Save(string_view host, const HostHealth &health) const {
+    if (empty(directory_)) {
+        return false;
+    }
+    auto record = HealthRecord{};
+    record.magic = HEALTH_MAGIC;
+    record.version = HEALTH_VERSION;
+    record.consecutive_failures = health.consecutive_failures;
+    record.last_failure = chrono::duration_cast<chrono::seconds>(health.last_failure.time_since_epoch()).count();
+
+    if (!HttpResponseCache::CreateDirectory(directory_)) {
+        return false;
+    }
+    auto parts = array{mmotd::core::AsBytes(record)};
+    return mmotd::core::WriteFileAtomically(GetHealthPath(host), parts);
+}
+
+} // namespace mmotd::networking
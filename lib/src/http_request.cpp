@@ -3,13 +3,25 @@
 
 #include "common/assertion/include/assertion.h"
 #include "common/include/algorithm.h"
+#include "common/include/config_options.h"
 #include "common/include/logging.h"
+#include "lib/include/http_circuit_breaker.h"
+#include "lib/include/http_response_cache.h"
+#include "lib/include/platform/network.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <stop_token>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -20,13 +32,27 @@
 #include <scope_guard.hpp>
 #include <spdlog/fmt/bin_to_hex.h>
 
+using mmotd::networking::HttpCacheEntry;
+using mmotd::networking::HttpCircuitBreaker;
+using mmotd::networking::HttpEndpoint;
 using mmotd::networking::HttpProtocol;
+using mmotd::networking::HttpResponseCache;
+using mmotd::networking::HttpTiming;
 using namespace std;
 
 namespace {
 
-/* NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables) */
-static std::mutex g_request_mutex;
+struct HttpResponse {
+    CURLcode result = CURLE_OK;
+    long status_code = 0;
+    string body = {};
+    string etag = {};
+    string cache_control = {};
+};
+
+// Minimum time-to-live (in seconds) of the responses of each host when 'http_cache.min_ttl.<host>' is not configured
+constexpr auto DEFAULT_MINIMUM_TIME_TO_LIVE = array<pair<string_view, int64_t>, 2>{pair{"wttr_in", int64_t{1800}},
+                                                                                  pair{"ipinfo_io", int64_t{3600}}};
 
 string GetUserAgent() {
     const char *cversion = curl_version();
@@ -38,29 +64,29 @@ string GetUserAgent() {
 
 #if defined(MMOTD_HTTP_VERBOSE_LOGGING)
 int CurlDebugFunction(CURL *, curl_infotype type, char *data, size_t size, void *) {
-    auto data_buf = vector<uint8_t>(size);
-    memcpy(std::data(data_buf), data, size);
+    const auto *first = reinterpret_cast<const uint8_t *>(data);
+    const auto *last = first + size;
     switch (type) {
         case CURLINFO_TEXT:
-            LOG_VERBOSE("CURL: {}", string(data, data + size));
+            LOG_VERBOSE("CURL: {}", string_view(data, size));
             break;
         case CURLINFO_HEADER_OUT:
-            LOG_VERBOSE("CURL sending header ({} bytes): {:a}", size, spdlog::to_hex(data_buf, size_t{16}));
+            LOG_VERBOSE("CURL sending header ({} bytes): {:a}", size, spdlog::to_hex(first, last, size_t{16}));
             break;
         case CURLINFO_DATA_OUT:
-            LOG_VERBOSE("CURL sending data ({} bytes): {:a}", size, spdlog::to_hex(data_buf, size_t{16}));
+            LOG_VERBOSE("CURL sending data ({} bytes): {:a}", size, spdlog::to_hex(first, last, size_t{16}));
             break;
         case CURLINFO_SSL_DATA_OUT:
-            LOG_VERBOSE("CURL sending SSL data ({} bytes): {:a}", size, spdlog::to_hex(data_buf, size_t{16}));
+            LOG_VERBOSE("CURL sending SSL data ({} bytes): {:a}", size, spdlog::to_hex(first, last, size_t{16}));
             break;
         case CURLINFO_HEADER_IN:
-            LOG_VERBOSE("CURL receiving header ({} bytes): {:a}", size, spdlog::to_hex(data_buf, size_t{16}));
+            LOG_VERBOSE("CURL receiving header ({} bytes): {:a}", size, spdlog::to_hex(first, last, size_t{16}));
             break;
         case CURLINFO_DATA_IN:
-            LOG_VERBOSE("CURL receiving data ({} bytes): {:a}", size, spdlog::to_hex(data_buf, size_t{16}));
+            LOG_VERBOSE("CURL receiving data ({} bytes): {:a}", size, spdlog::to_hex(first, last, size_t{16}));
             break;
         case CURLINFO_SSL_DATA_IN:
-            LOG_VERBOSE("CURL receiving SSL data ({} bytes): {:a}", size, spdlog::to_hex(data_buf, size_t{16}));
+            LOG_VERBOSE("CURL receiving SSL data ({} bytes): {:a}", size, spdlog::to_hex(first, last, size_t{16}));
             break;
         case CURLINFO_END:
         default:
@@ -68,10 +94,6 @@ int CurlDebugFunction(CURL *, curl_infotype type, char *data, size_t size, void
     }
     return 0;
 }
-#else
-inline int CurlDebugFunction(CURL *, curl_infotype, char *, size_t, void *) {
-    return 0;
-}
 #endif
 
 template<typename T>
@@ -84,16 +106,6 @@ bool CurlSetOption(CURL *curl, CURLoption opt, T val) {
     return true;
 }
 
-bool CurlSetOption(CURL *curl, CURLoption opt, string val) {
-    LOG_VERBOSE("setting curl option value: {}", val);
-    /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) */
-    if (auto retval = curl_easy_setopt(curl, opt, data(val)); retval != CURLE_OK) {
-        LOG_ERROR("failed to set curl option '{}', error: {}: {}", opt, retval, curl_easy_strerror(retval));
-        return false;
-    }
-    return true;
-}
-
 size_t CurlWriteFunction(void *ptr, size_t size, size_t nmemb, string *data) {
     if (ptr == nullptr || data == nullptr || size == 0 || nmemb == 0) {
         LOG_ERROR("invalid input, ptr={}, data={}, size={}, nmemb={}", fmt::ptr(ptr), fmt::ptr(data), size, nmemb);
@@ -103,72 +115,480 @@ size_t CurlWriteFunction(void *ptr, size_t size, size_t nmemb, string *data) {
     return size * nmemb;
 }
 
+// Called once for each response header line, the status line of every redirect starts the headers over
+size_t CurlHeaderFunction(char *buffer, size_t item_size, size_t nitems, HttpResponse *response) {
+    auto line = string_view{buffer, item_size * nitems};
+    if (line.starts_with("HTTP/")) {
+        response->etag.clear();
+        response->cache_control.clear();
+        return size(line);
+    }
+    auto colon = line.find(':');
+    if (colon == string_view::npos) {
+        return size(line);
+    }
+    auto name = line.substr(0, colon);
+    auto value = string{line.substr(colon + 1)};
+    boost::trim(value);
+    if (boost::iequals(name, "etag")) {
+        response->etag = std::move(value);
+    } else if (boost::iequals(name, "cache-control")) {
+        response->cache_control = std::move(value);
+    }
+    return size(line);
+}
+
+bool IsHttpCacheEnabled() {
+    return mmotd::core::ConfigOptions::Instance().GetBoolean("http_cache.enabled"sv, true);
+}
+
+// Seconds past its freshness that a response is still served while it is revalidated in the background
+chrono::seconds GetMaximumStaleness() {
+    return chrono::seconds{mmotd::core::ConfigOptions::Instance().GetInteger("http_cache.max_stale"sv, 86400)};
+}
+
+chrono::milliseconds GetConnectTimeout() {
+    const auto &config_options = mmotd::core::ConfigOptions::Instance();
+    return chrono::milliseconds{config_options.GetInteger("network.connect_timeout_ms"sv, 1500)};
+}
+
+chrono::milliseconds GetTimeout() {
+    const auto &config_options = mmotd::core::ConfigOptions::Instance();
+    return chrono::milliseconds{config_options.GetInteger("network.timeout_ms"sv, 5000)};
+}
+
+// The loopback interface is there without a default route, requests to a local service are never skipped for it
+bool IsLoopbackHost(string_view host) {
+    // the host can have a port, i.e. "127.0.0.1:8080" or "[::1]:8080"
+    if (host.starts_with("[::1]")) {
+        return true;
+    }
+    auto name = host.substr(0, host.find(':'));
+    return name == "localhost" || name.starts_with("127.");
+}
+
+HttpCircuitBreaker GetCircuitBreaker() {
+    const auto &config_options = mmotd::core::ConfigOptions::Instance();
+    auto backoff = chrono::seconds{config_options.GetInteger("network.backoff_seconds"sv, 30)};
+    auto max_backoff = chrono::seconds{config_options.GetInteger("network.max_backoff_seconds"sv, 3600)};
+    if (backoff <= chrono::seconds::zero()) {
+        // without a directory the breaker keeps no state and is never open
+        return HttpCircuitBreaker{};
+    }
+    return HttpCircuitBreaker{HttpResponseCache::GetDefaultDirectory(), backoff, max_backoff};
+}
+
+// Cancelled requests say nothing about the host and a client error (4xx) means the host answered
+void RecordHealth(const HttpCircuitBreaker &circuit_breaker, string_view host, const HttpResponse &response) {
+    if (response.result == CURLE_ABORTED_BY_CALLBACK || response.result == CURLE_FAILED_INIT) {
+        return;
+    }
+    auto answered = response.result == CURLE_OK || response.result == CURLE_HTTP_RETURNED_ERROR;
+    if (answered && response.status_code < 500) {
+        circuit_breaker.RecordSuccess(host);
+    } else {
+        circuit_breaker.RecordFailure(host);
+    }
+}
+
+// Config names are split on '.', so a host is looked up with its dots replaced by underscores
+chrono::seconds GetMinimumTimeToLive(string_view host) {
+    auto name = boost::replace_all_copy(string{host}, ".", "_");
+    auto i = find_if(begin(DEFAULT_MINIMUM_TIME_TO_LIVE),
+                     end(DEFAULT_MINIMUM_TIME_TO_LIVE),
+                     [&name](const auto &ttl) { return ttl.first == name; });
+    auto default_ttl = i == end(DEFAULT_MINIMUM_TIME_TO_LIVE) ? int64_t{0} : i->second;
+    const auto &config_options = mmotd::core::ConfigOptions::Instance();
+    auto ttl = config_options.GetInteger(fmt::format(FMT_STRING("http_cache.min_ttl.{}"), name), default_ttl);
+    return chrono::seconds{ttl};
+}
+
+// Saves a successful response (or the refreshed freshness of a 304) and returns the body it stands for
+optional<string> UpdateCache(const HttpResponseCache &cache,
+                             const string &url,
+                             const optional<HttpCacheEntry> &previous,
+                             HttpResponse response,
+                             chrono::seconds min_ttl) {
+    if (response.result != CURLE_OK) {
+        return nullopt;
+    }
+    auto entry = HttpCacheEntry{};
+    entry.url = url;
+    if (response.status_code == 304 && previous) {
+        LOG_VERBOSE("cached response of '{}' is unchanged", url);
+        entry.etag = empty(response.etag) ? previous->etag : std::move(response.etag);
+        entry.body = previous->body;
+    } else if (response.status_code == 200 && !empty(response.body)) {
+        entry.etag = std::move(response.etag);
+        entry.body = std::move(response.body);
+    } else {
+        LOG_ERROR("request for '{}' returned status {} with {} bytes", url, response.status_code, size(response.body));
+        return nullopt;
+    }
+    auto cache_control = mmotd::networking::ParseCacheControl(response.cache_control);
+    if (!cache_control.no_store) {
+        auto max_age = cache_control.max_age.value_or(chrono::seconds::zero());
+        if (cache_control.no_cache) {
+            max_age = chrono::seconds::zero();
+        }
+        entry.fresh_until = chrono::system_clock::now() + max(max_age, min_ttl);
+        entry.must_revalidate = cache_control.must_revalidate;
+        cache.Store(entry);
+    }
+    return make_optional(std::move(entry.body));
+}
+
+class HttpTimings {
+public:
+    static HttpTimings &Instance() {
+        static auto timings = HttpTimings{};
+        return timings;
+    }
+
+    void Add(HttpTiming timing) {
+        auto lock = scoped_lock<mutex>(mutex_);
+        timings_.push_back(std::move(timing));
+    }
+
+    vector<HttpTiming> Get() const {
+        auto lock = scoped_lock<mutex>(mutex_);
+        return timings_;
+    }
+
+private:
+    mutable mutex mutex_;
+    vector<HttpTiming> timings_;
+};
+
+chrono::microseconds GetCurlTime(CURL *curl, CURLINFO info) {
+    auto time = curl_off_t{0};
+    curl_easy_getinfo(curl, info, &time);
+    return chrono::microseconds{time};
+}
+
+HttpTiming GetTiming(CURL *curl, string_view url, long status_code) {
+    auto timing = HttpTiming{};
+    timing.url = string{url.substr(0, url.find('?'))};
+    timing.status_code = status_code;
+    timing.name_lookup = GetCurlTime(curl, CURLINFO_NAMELOOKUP_TIME_T);
+    timing.connect = GetCurlTime(curl, CURLINFO_CONNECT_TIME_T);
+    timing.tls_handshake = GetCurlTime(curl, CURLINFO_APPCONNECT_TIME_T);
+    timing.first_byte = GetCurlTime(curl, CURLINFO_STARTTRANSFER_TIME_T);
+    timing.total = GetCurlTime(curl, CURLINFO_TOTAL_TIME_T);
+    auto bytes = curl_off_t{0};
+    curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &bytes);
+    timing.bytes = bytes;
+    return timing;
+}
+
+// Revalidations in flight at exit are abandoned once this has passed, by default they are abandoned at once.  It is
+//  constant initialized and never destroyed, so the engine can still read it while the process exits.
+atomic<chrono::steady_clock::time_point> revalidation_deadline = chrono::steady_clock::time_point::min();
+
+// An idle event loop sleeps until a request (or a stop) wakes it, this only bounds how long a lost wakeup can last
+constexpr auto POLL_TIMEOUT = chrono::milliseconds{1000};
+
+future<optional<string>> MakeReadyFuture(optional<string> body) {
+    auto promise = std::promise<optional<string>>{};
+    promise.set_value(std::move(body));
+    return promise.get_future();
+}
+
 } // namespace
 
 namespace mmotd::networking {
 
-class HttpClient {
+//
+// Runs every outstanding request concurrently on a single curl multi handle, so the network time of the
+//  providers is the slowest of their requests rather than the sum of them.  The event loop has its own thread,
+//  which is started with the first request, and the DNS cache, TLS sessions and connections are shared by every
+//  request through a curl share handle.
+//
+class HttpEngine {
 public:
-    HttpClient();
-    HttpClient(string url);
-    ~HttpClient();
-    HttpClient(HttpClient &other) = delete;
-    HttpClient(HttpClient &&other) = delete;
-    HttpClient &operator=(HttpClient &other) = delete;
-    HttpClient &operator=(HttpClient &&other) = delete;
+    using Completion = function<void(HttpResponse)>;
+
+    ~HttpEngine();
+    HttpEngine(const HttpEngine &other) = delete;
+    HttpEngine(HttpEngine &&other) = delete;
+    HttpEngine &operator=(const HttpEngine &other) = delete;
+    HttpEngine &operator=(HttpEngine &&other) = delete;
 
-    optional<string> Get();
+    static HttpEngine &Instance();
+
+    // `completion` is called on the event loop thread, a cancelled request completes with CURLE_ABORTED_BY_CALLBACK.
+    //  An `etag` makes the request conditional (If-None-Match) so an unchanged response is a bodiless 304.  A
+    //  `revalidation` has no caller waiting on it and is still finished at exit until the revalidation deadline.
+    void Send(string url, string etag, std::stop_token stop_token, Completion completion, bool revalidation = false);
 
 private:
-    CURL *curl_ = nullptr;
-    string url_;
+    HttpEngine();
+
+    struct WakeUp {
+        CURLM *multi = nullptr;
+        void operator()() const noexcept { curl_multi_wakeup(multi); }
+    };
+
+    struct Transfer {
+        CURL *curl = nullptr;
+        curl_slist *headers = nullptr;
+        string url;
+        string etag;
+        long connect_timeout_ms = 0;
+        long timeout_ms = 0;
+        HttpResponse response;
+        std::stop_token stop_token;
+        Completion completion;
+        bool revalidation = false;
+        // wakes the event loop when a stop is requested so the transfer is cancelled at once
+        optional<std::stop_callback<WakeUp>> stop_callback;
+
+        ~Transfer();
+    };
+
+    void Run(std::stop_token stop_token);
+    void FinishRevalidations();
+    bool HasActiveRevalidations() const;
+    void StartPendingTransfers();
+    void CancelStoppedTransfers();
+    void FinishCompletedTransfers();
+    void Finish(CURL *curl, CURLcode result);
+    bool SetOptions(Transfer &transfer) const;
+
+    CURLM *multi_ = nullptr;
+    CURLSH *share_ = nullptr;
+    string user_agent_;
+    mutex pending_mutex_;
+    vector<unique_ptr<Transfer>> pending_transfers_;
+    // only touched by the event loop thread
+    unordered_map<CURL *, unique_ptr<Transfer>> active_transfers_;
+    std::jthread thread_;
 };
 
-HttpClient::HttpClient() = default;
+HttpEngine::Transfer::~Transfer() {
+    if (curl != nullptr) {
+        curl_easy_cleanup(curl);
+    }
+    if (headers != nullptr) {
+        curl_slist_free_all(headers);
+    }
+}
 
-HttpClient::HttpClient(string url) : curl_(curl_easy_init()), url_(move(url)) {
-    if (curl_ == nullptr) {
-        THROW_RUNTIME_ERROR("curl_easy_init() returned {}", "nullptr");
-        return;
+HttpEngine::HttpEngine() : user_agent_(GetUserAgent()) {
+    // the timings are created first so they are destroyed after the engine, whose destructor still finishes the
+    //  transfers which are in flight
+    HttpTimings::Instance();
+    // reference counted, so the handles below stay valid until this engine is destroyed
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    multi_ = curl_multi_init();
+    share_ = curl_share_init();
+    if (multi_ == nullptr || share_ == nullptr) {
+        THROW_RUNTIME_ERROR("unable to create the curl {} handle", multi_ == nullptr ? "multi" : "share");
+    }
+    // the handles are only used by the event loop thread so the share needs no lock functions
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    thread_ = std::jthread([this](std::stop_token stop_token) { Run(std::move(stop_token)); });
+}
+
+HttpEngine::~HttpEngine() {
+    thread_.request_stop();
+    curl_multi_wakeup(multi_);
+    if (thread_.joinable()) {
+        thread_.join();
     }
+    curl_multi_cleanup(multi_);
+    curl_share_cleanup(share_);
+    curl_global_cleanup();
+}
+
+HttpEngine &HttpEngine::Instance() {
+    static auto engine = HttpEngine{};
+    return engine;
 }
 
-HttpClient::~HttpClient() {
-    if (curl_ != nullptr) {
-        curl_easy_cleanup(curl_);
+void HttpEngine::Send(string url, string etag, std::stop_token stop_token, Completion completion, bool revalidation) {
+    auto transfer = make_unique<Transfer>();
+    transfer->url = std::move(url);
+    transfer->etag = std::move(etag);
+    transfer->connect_timeout_ms = static_cast<long>(GetConnectTimeout().count());
+    transfer->timeout_ms = static_cast<long>(GetTimeout().count());
+    transfer->stop_token = std::move(stop_token);
+    transfer->completion = std::move(completion);
+    transfer->revalidation = revalidation;
+    {
+        auto lock = scoped_lock<mutex>(pending_mutex_);
+        pending_transfers_.push_back(std::move(transfer));
     }
+    curl_multi_wakeup(multi_);
 }
 
-optional<string> HttpClient::Get() {
-    PRECONDITIONS(curl_ != nullptr, "curl handle must be valid");
-    PRECONDITIONS(!empty(url_), "url must be valid");
+bool HttpEngine::SetOptions(Transfer &transfer) const {
+    auto *curl = transfer.curl;
+    if (!empty(transfer.etag)) {
+        auto if_none_match = fmt::format(FMT_STRING("If-None-Match: {}"), transfer.etag);
+        transfer.headers = curl_slist_append(transfer.headers, if_none_match.c_str());
+    }
+    return CurlSetOption(curl, CURLOPT_HTTPGET, 1L) &&                          // ask for an HTTP GET request
+           CurlSetOption(curl, CURLOPT_URL, data(transfer.url)) &&              // URL in CURLU * format
+           CurlSetOption(curl, CURLOPT_FAILONERROR, 1L) &&                      // fail on HTTP response >= 400
+           CurlSetOption(curl, CURLOPT_USERAGENT, data(user_agent_)) &&         // user agent
+           CurlSetOption(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_NONE) && // HTTP protocol version to use
+           CurlSetOption(curl, CURLOPT_TCP_KEEPALIVE, 1L) &&                    // TCP keep-alive probing
+           CurlSetOption(curl, CURLOPT_FOLLOWLOCATION, 1L) &&                   // follow HTTP 3xx redirects
+           CurlSetOption(curl, CURLOPT_MAXREDIRS, 50L) &&                       // maximum number of redirects allowed
+           CurlSetOption(curl, CURLOPT_CONNECTTIMEOUT_MS, transfer.connect_timeout_ms) && // time allowed to connect
+           CurlSetOption(curl, CURLOPT_TIMEOUT_MS, transfer.timeout_ms) &&      // time allowed for the whole request
+           CurlSetOption(curl, CURLOPT_SHARE, share_) &&                        // shared DNS, TLS and connections
+           CurlSetOption(curl, CURLOPT_HTTPHEADER, transfer.headers) &&         // conditional request headers
+#if defined(MMOTD_HTTP_VERBOSE_LOGGING)
+           CurlSetOption(curl, CURLOPT_VERBOSE, 1L) &&                          // verbose mode
+           CurlSetOption(curl, CURLOPT_DEBUGFUNCTION, CurlDebugFunction) &&     // debug callback
+#endif
+           CurlSetOption(curl, CURLOPT_HEADERFUNCTION, CurlHeaderFunction) &&   // callback for each response header
+           CurlSetOption(curl, CURLOPT_HEADERDATA, &transfer.response) &&       // passed to the header callback
+           CurlSetOption(curl, CURLOPT_WRITEFUNCTION, CurlWriteFunction) &&     // callback for writing received data
+           CurlSetOption(curl, CURLOPT_WRITEDATA, &transfer.response.body);     // passed to the write callback
+}
 
-    LOG_VERBOSE("url: {}", url_);
+void HttpEngine::StartPendingTransfers() {
+    auto pending_transfers = vector<unique_ptr<Transfer>>{};
+    {
+        auto lock = scoped_lock<mutex>(pending_mutex_);
+        swap(pending_transfers, pending_transfers_);
+    }
+    for (auto &transfer : pending_transfers) {
+        if (transfer->stop_token.stop_requested()) {
+            LOG_WARNING("request for '{}' cancelled before it was sent", transfer->url);
+            transfer->completion(HttpResponse{CURLE_ABORTED_BY_CALLBACK});
+            continue;
+        }
+        LOG_VERBOSE("url: {}", transfer->url);
+        transfer->curl = curl_easy_init();
+        if (transfer->curl == nullptr || !SetOptions(*transfer)) {
+            LOG_ERROR("unable to create the curl request for '{}'", transfer->url);
+            transfer->completion(HttpResponse{CURLE_FAILED_INIT});
+            continue;
+        }
+        if (auto ret_code = curl_multi_add_handle(multi_, transfer->curl); ret_code != CURLM_OK) {
+            LOG_ERROR("failed when calling curl_multi_add_handle, error {}: {}",
+                      ret_code,
+                      curl_multi_strerror(ret_code));
+            transfer->completion(HttpResponse{CURLE_FAILED_INIT});
+            continue;
+        }
+        transfer->stop_callback.emplace(transfer->stop_token, WakeUp{multi_});
+        auto *curl = transfer->curl;
+        active_transfers_.emplace(curl, std::move(transfer));
+    }
+}
 
-    auto response = string{};
-    if (!CurlSetOption(curl_, CURLOPT_HTTPGET, 1L) ||               // ask for an HTTP GET request
-        !CurlSetOption(curl_, CURLOPT_URL, data(url_)) ||           // URL in CURLU * format
-        !CurlSetOption(curl_, CURLOPT_FAILONERROR, 1L) ||           // request failure on HTTP response >= 400
-        !CurlSetOption(curl_, CURLOPT_USERAGENT, GetUserAgent()) || // user agent
-        !CurlSetOption(curl_, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_NONE) || // HTTP protocol version to use
-        !CurlSetOption(curl_, CURLOPT_TCP_KEEPALIVE, 1L) ||                    // TCP keep-alive probing
-        !CurlSetOption(curl_, CURLOPT_FOLLOWLOCATION, 1L) ||                   // follow HTTP 3xx redirects
-        !CurlSetOption(curl_, CURLOPT_MAXREDIRS, 50L) ||                       // maximum number of redirects allowed
-        !CurlSetOption(curl_, CURLOPT_NOPROGRESS, 1L) ||                       // switch off the progress meter
-        !CurlSetOption(curl_, CURLOPT_VERBOSE, 1L) ||                          // verbose mode
-        !CurlSetOption(curl_, CURLOPT_DEBUGFUNCTION, CurlDebugFunction) ||     // debug callback
-        !CurlSetOption(curl_, CURLOPT_WRITEFUNCTION, CurlWriteFunction) ||     // callback for writing received data
-        !CurlSetOption(curl_, CURLOPT_WRITEDATA, &response)) {                 // pointer passed to the write callback
-        return nullopt;
+void HttpEngine::CancelStoppedTransfers() {
+    auto stopped = vector<CURL *>{};
+    for (const auto &[curl, transfer] : active_transfers_) {
+        if (transfer->stop_token.stop_requested()) {
+            stopped.push_back(curl);
+        }
     }
+    for (auto *curl : stopped) {
+        LOG_WARNING("request for '{}' cancelled", active_transfers_.at(curl)->url);
+        Finish(curl, CURLE_ABORTED_BY_CALLBACK);
+    }
+}
 
-    auto ret_code = curl_easy_perform(curl_);
-    if (ret_code != CURLE_OK) {
-        LOG_ERROR("failed when calling curl_easy_perform, error {}: {}", ret_code, curl_easy_strerror(ret_code));
-        return nullopt;
+void HttpEngine::FinishCompletedTransfers() {
+    auto message_count = 0;
+    while (auto *message = curl_multi_info_read(multi_, &message_count)) {
+        if (message->msg != CURLMSG_DONE) {
+            continue;
+        }
+        auto *curl = message->easy_handle;
+        auto ret_code = message->data.result;
+        auto i = active_transfers_.find(curl);
+        if (i == end(active_transfers_)) {
+            continue;
+        }
+        if (ret_code != CURLE_OK) {
+            LOG_ERROR("request for '{}' failed, error {}: {}", i->second->url, ret_code, curl_easy_strerror(ret_code));
+        }
+        Finish(curl, ret_code);
     }
+}
+
+void HttpEngine::Finish(CURL *curl, CURLcode result) {
+    auto i = active_transfers_.find(curl);
+    auto &response = i->second->response;
+    response.result = result;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response.status_code);
+    auto timing = GetTiming(curl, i->second->url, response.status_code);
+    LOG_INFO("request for '{}', status {}: dns {}us, connect {}us, tls {}us, first byte {}us, total {}us, {} bytes",
+             timing.url,
+             timing.status_code,
+             timing.name_lookup.count(),
+             timing.connect.count(),
+             timing.tls_handshake.count(),
+             timing.first_byte.count(),
+             timing.total.count(),
+             timing.bytes);
+    HttpTimings::Instance().Add(std::move(timing));
+    curl_multi_remove_handle(multi_, curl);
+    // the stop callback is released first, it must not wake the loop once the transfer is gone
+    i->second->stop_callback.reset();
+    i->second->completion(std::move(response));
+    active_transfers_.erase(i);
+}
+
+void HttpEngine::Run(std::stop_token stop_token) {
+    while (!stop_token.stop_requested()) {
+        StartPendingTransfers();
+        CancelStoppedTransfers();
+        auto running_count = 0;
+        if (auto ret_code = curl_multi_perform(multi_, &running_count); ret_code != CURLM_OK) {
+            LOG_ERROR("failed when calling curl_multi_perform, error {}: {}", ret_code, curl_multi_strerror(ret_code));
+        }
+        FinishCompletedTransfers();
+        curl_multi_poll(multi_, nullptr, 0, static_cast<int>(POLL_TIMEOUT.count()), nullptr);
+    }
+    FinishRevalidations();
+    // whatever is still in flight is abandoned, a stale response which was not refreshed is revalidated again by
+    //  the next run
+    while (!empty(active_transfers_)) {
+        Finish(begin(active_transfers_)->first, CURLE_ABORTED_BY_CALLBACK);
+    }
+    auto lock = scoped_lock<mutex>(pending_mutex_);
+    for (auto &transfer : pending_transfers_) {
+        transfer->completion(HttpResponse{CURLE_ABORTED_BY_CALLBACK});
+    }
+    pending_transfers_.clear();
+}
 
-    return std::empty(response) ? nullopt : make_optional(response);
+bool HttpEngine::HasActiveRevalidations() const {
+    return any_of(begin(active_transfers_), end(active_transfers_), [](const auto &active_transfer) {
+        return active_transfer.second->revalidation;
+    });
+}
+
+// The process is exiting, a one-shot run is usually done long before its background revalidations are.  They are
+//  given what is left of the latency budget so the refreshed responses are there for the next run, otherwise the
+//  stale response would be served (and saved in the snapshot cache) again and again until it is too old to use.
+void HttpEngine::FinishRevalidations() {
+    auto deadline = revalidation_deadline.load();
+    StartPendingTransfers();
+    while (HasActiveRevalidations() && chrono::steady_clock::now() < deadline) {
+        auto running_count = 0;
+        if (auto ret_code = curl_multi_perform(multi_, &running_count); ret_code != CURLM_OK) {
+            LOG_ERROR("failed when calling curl_multi_perform, error {}: {}", ret_code, curl_multi_strerror(ret_code));
+            break;
+        }
+        FinishCompletedTransfers();
+        auto remaining = chrono::ceil<chrono::milliseconds>(deadline - chrono::steady_clock::now());
+        auto timeout = clamp(remaining, chrono::milliseconds::zero(), POLL_TIMEOUT);
+        curl_multi_poll(multi_, nullptr, 0, static_cast<int>(timeout.count()), nullptr);
+    }
+    if (HasActiveRevalidations()) {
+        LOG_WARNING("abandoning the revalidations which are still in flight at exit");
+    }
 }
 
 string to_string(HttpProtocol protocol) {
@@ -182,10 +602,90 @@ string to_string(HttpProtocol protocol) {
     }
 }
 
-optional<string> HttpRequest::Get(HttpProtocol protocol, string_view host, string_view path, string_view query) {
+optional<string> HttpRequest::Get(HttpProtocol protocol,
+                                  string_view host,
+                                  string_view path,
+                                  string_view query,
+                                  std::stop_token stop_token) {
+    return GetAsync(protocol, host, path, query, std::move(stop_token)).get();
+}
+
+future<optional<string>> HttpRequest::GetAsync(HttpProtocol protocol,
+                                               string_view host,
+                                               string_view path,
+                                               string_view query,
+                                               std::stop_token stop_token) {
     auto url = HttpRequest::GetUrl(protocol, host, path, query, true);
-    scoped_lock<mutex> lock(g_request_mutex);
-    return HttpClient{url}.Get();
+    auto cache = HttpResponseCache{};
+    if (IsHttpCacheEnabled()) {
+        cache = HttpResponseCache{HttpResponseCache::GetDefaultDirectory()};
+    }
+    auto previous = cache.Find(url);
+    auto now = chrono::system_clock::now();
+    if (previous && previous->IsFresh(now)) {
+        LOG_VERBOSE("using the cached response of '{}'", url);
+        return MakeReadyFuture(make_optional(std::move(previous->body)));
+    }
+    auto stale_body = optional<string>{};
+    if (previous && !previous->must_revalidate && now < previous->fresh_until + GetMaximumStaleness()) {
+        stale_body = previous->body;
+    }
+
+    // without a route, or while the host keeps failing, the request is skipped instead of waiting on a timeout
+    auto circuit_breaker = GetCircuitBreaker();
+    auto routable = IsLoopbackHost(host) || mmotd::platform::HasDefaultRoute();
+    if (!routable || circuit_breaker.IsOpen(host, now)) {
+        LOG_WARNING("skipping the request for '{}', {} is unreachable", url, host);
+        return MakeReadyFuture(std::move(stale_body));
+    }
+
+    auto &engine = HttpEngine::Instance();
+    auto min_ttl = GetMinimumTimeToLive(host);
+    auto etag = previous ? previous->etag : string{};
+    if (stale_body) {
+        // stale-while-revalidate: the stale body is used now and the refreshed response is there for the next run,
+        //  the revalidation is not tied to the caller's stop token because the caller is no longer waiting on it
+        LOG_VERBOSE("using the stale response of '{}' while it is revalidated", url);
+        auto revalidate = [cache, circuit_breaker, host = string{host}, url, previous, min_ttl](auto response) {
+            RecordHealth(circuit_breaker, host, response);
+            UpdateCache(cache, url, previous, std::move(response), min_ttl);
+        };
+        engine.Send(std::move(url), std::move(etag), std::stop_token{}, std::move(revalidate), true);
+        return MakeReadyFuture(std::move(stale_body));
+    }
+    auto promise = make_shared<std::promise<optional<string>>>();
+    auto result = promise->get_future();
+    auto update = [promise, cache, circuit_breaker, host = string{host}, url, previous, min_ttl](auto response) {
+        RecordHealth(circuit_breaker, host, response);
+        promise->set_value(UpdateCache(cache, url, previous, std::move(response), min_ttl));
+    };
+    engine.Send(std::move(url), std::move(etag), std::move(stop_token), std::move(update));
+    return result;
+}
+
+HttpEndpoint HttpRequest::GetEndpoint(string_view config_name, string_view default_endpoint) {
+    auto endpoint_str = mmotd::core::ConfigOptions::Instance().GetString(config_name, default_endpoint);
+    auto endpoint = HttpEndpoint{};
+    auto host = string_view{endpoint_str};
+    if (boost::istarts_with(host, "http://")) {
+        endpoint.protocol = HttpProtocol::HTTP;
+        host.remove_prefix(size("http://"sv));
+    } else if (boost::istarts_with(host, "https://")) {
+        host.remove_prefix(size("https://"sv));
+    }
+    while (host.ends_with('/')) {
+        host.remove_suffix(1);
+    }
+    endpoint.host = string{host};
+    return endpoint;
+}
+
+void HttpRequest::SetRevalidationDeadline(chrono::steady_clock::time_point deadline) {
+    revalidation_deadline = deadline;
+}
+
+vector<HttpTiming> HttpRequest::GetTimings() {
+    return HttpTimings::Instance().Get();
 }
 
 string
@@ -0,0 +1,158 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/line_parser.h"
+#include "common/include/logging.h"
+#include "common/include/mapped_file.h"
+#include "common/include/special_files.h"
+#include "lib/include/http_response_cache.h"
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <fmt/format.h>
+
+using namespace std;
+using fmt::format;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr auto HTTP_CACHE_DIRECTORY = string_view{"http"};
+constexpr auto HTTP_CACHE_MAGIC = array<char, 8>{'m', 'm', 'o', 't', 'd', 'h', 't', 'p'};
+constexpr auto HTTP_CACHE_VERSION = uint32_t{1};
+
+struct HttpCacheHeader {
+    array<char, 8> magic;
+    uint32_t version;
+    uint32_t must_revalidate;
+    int64_t fresh_until;
+    uint64_t url_size;
+    uint64_t etag_size;
+    uint64_t body_size;
+};
+
+int64_t ToSeconds(chrono::system_clock::time_point time_point) {
+    return chrono::duration_cast<chrono::seconds>(time_point.time_since_epoch()).count();
+}
+
+} // namespace
+
+namespace mmotd::networking {
+
+CacheControl ParseCacheControl(string_view cache_control) {
+    auto result = CacheControl{};
+    while (!empty(cache_control)) {
+        auto comma = cache_control.find(',');
+        auto directive = mmotd::core::TrimBlanks(cache_control.substr(0, comma));
+        cache_control.remove_prefix(comma == string_view::npos ? size(cache_control) : comma + 1);
+        auto equals = directive.find('=');
+        auto name = mmotd::core::TrimBlanks(directive.substr(0, equals));
+        auto value = string_view{};
+        if (equals != string_view::npos) {
+            value = mmotd::core::TrimBlanks(directive.substr(equals + 1));
+        }
+        if (boost::iequals(name, "max-age")) {
+            auto seconds = int64_t{0};
+            auto [p, ec] = from_chars(data(value), data(value) + size(value), seconds);
+            if (ec == std::errc() && p == data(value) + size(value) && seconds >= 0) {
+                result.max_age = chrono::seconds{seconds};
+            }
+        } else if (boost::iequals(name, "no-store")) {
+            result.no_store = true;
+        } else if (boost::iequals(name, "no-cache")) {
+            result.no_cache = true;
+        } else if (boost::iequals(name, "must-revalidate")) {
+            result.must_revalidate = true;
+        }
+    }
+    return result;
+}
+
+HttpResponseCache::HttpResponseCache(fs::path directory) : directory_(std::move(directory)) {}
+
+fs::path HttpResponseCache::GetDefaultDirectory() {
+    auto cache_dir = mmotd::core::special_files::GetCacheDirectory();
+    if (empty(cache_dir)) {
+        return fs::path{};
+    }
+    return cache_dir / HTTP_CACHE_DIRECTORY;
+}
+
+bool HttpResponseCache::CreateDirectory(const fs::path &directory) {
+    auto ec = error_code{};
+    if (fs::create_directories(directory, ec); ec) {
+        LOG_ERROR("unable to create http cache directory {}, {}", directory.string(), ec.message());
+        return false;
+    }
+    return true;
+}
+
+fs::path HttpResponseCache::GetEntryPath(string_view url) const {
+    return directory_ / format(FMT_STRING("{:016x}.bin"), mmotd::core::HashCacheKey(url));
+}
+
+optional<HttpCacheEntry> HttpResponseCache::Find(string_view url) const {
+    if (empty(directory_)) {
+        return nullopt;
+    }
+    auto mapped_file = mmotd::core::MappedFile::Open(GetEntryPath(url));
+    if (!mapped_file) {
+        return nullopt;
+    }
+    auto buffer = mapped_file->view();
+    auto header = HttpCacheHeader{};
+    if (size(buffer) < sizeof(header)) {
+        return nullopt;
+    }
+    header = mmotd::core::ReadRecord<HttpCacheHeader>(data(buffer));
+    buffer.remove_prefix(sizeof(header));
+    if (header.magic != HTTP_CACHE_MAGIC || header.version != HTTP_CACHE_VERSION ||
+        header.url_size + header.etag_size + header.body_size != size(buffer)) {
+        LOG_WARNING("discarding invalid http cache entry for '{}'", url);
+        return nullopt;
+    }
+    // two urls with the same hash share the file, the url inside tells them apart
+    if (buffer.substr(0, header.url_size) != url) {
+        return nullopt;
+    }
+    auto entry = HttpCacheEntry{};
+    entry.url = string{url};
+    entry.etag = string{buffer.substr(header.url_size, header.etag_size)};
+    entry.body = string{buffer.substr(header.url_size + header.etag_size)};
+    entry.fresh_until = chrono::system_clock::time_point{chrono::seconds{header.fresh_until}};
+    entry.must_revalidate = header.must_revalidate != 0;
+    return make_optional(std::move(entry));
+}
+
+bool HttpResponseCache::Store(const HttpCacheEntry &entry) const {
+    if (empty(directory_)) {
+        return false;
+    }
+    auto header = HttpCacheHeader{};
+    header.magic = HTTP_CACHE_MAGIC;
+    header.version = HTTP_CACHE_VERSION;
+    header.must_revalidate = entry.must_revalidate ? 1 : 0;
+    header.fresh_until = ToSeconds(entry.fresh_until);
+    header.url_size = size(entry.url);
+    header.etag_size = size(entry.etag);
+    header.body_size = size(entry.body);
+
+    if (!CreateDirectory(directory_)) {
+        return false;
+    }
+    auto entry_path = GetEntryPath(entry.url);
+    auto parts = array{mmotd::core::AsBytes(header),
+                       string_view{entry.url},
+                       string_view{entry.etag},
+                       string_view{entry.body}};
+    return mmotd::core::WriteFileAtomically(entry_path, parts);
+}
+
+} // namespace mmotd::networking
@@ -0,0 +1,332 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/config_options.h"
+#include "common/include/information.h"
+#include "common/include/information_decls.h"
+#include "common/include/logging.h"
+#include "common/include/mapped_file.h"
+#include "common/include/special_files.h"
+#include "lib/include/information_cache.h"
+#include "lib/include/platform/boot_time.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+using namespace std;
+using fmt::format;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr auto SNAPSHOT_FILENAME = string_view{"snapshot.bin"};
+constexpr auto SNAPSHOT_MAGIC = array<char, 8>{'m', 'm', 'o', 't', 'd', 's', 'n', 'p'};
+constexpr auto SNAPSHOT_VERSION = uint32_t{3};
+constexpr auto PROVIDER_NAME_SIZE = size_t{32};
+constexpr auto BOOT_ID_SIZE = size_t{40};
+// /proc/uptime based boot times drift by a second or so between calls
+constexpr auto BOOT_TIME_TOLERANCE = chrono::seconds{5};
+// The platform version is the one fact which can change without a reboot, an upgrade rewrites this file
+constexpr auto OS_RELEASE_PATH = string_view{"/etc/os-release"};
+
+struct SnapshotHeader {
+    array<char, 8> magic;
+    uint32_t version;
+    uint32_t provider_count;
+    int64_t boot_time;
+    // the boot id (nul terminated) is compared when the platform has one, otherwise the boot time is
+    array<char, BOOT_ID_SIZE> boot_id;
+    int64_t os_release_time;
+    uint64_t entry_count;
+    uint64_t string_pool_size;
+};
+
+struct SnapshotProvider {
+    array<char, PROVIDER_NAME_SIZE> name;
+    int64_t timestamp;
+    uint32_t first_entry;
+    uint32_t entry_count;
+};
+
+struct SnapshotEntry {
+    uint64_t id;
+    uint32_t value_offset;
+    uint32_t value_size;
+};
+
+// Default time-to-live (in seconds) of each provider when 'cache.ttl.<name>' is not configured
+constexpr auto DEFAULT_TIME_TO_LIVE = array<pair<string_view, int64_t>, 5>{pair{"hardware", int64_t{-1}},
+                                                                          pair{"system_information", int64_t{-1}},
+                                                                          pair{"external_network", int64_t{3600}},
+                                                                          pair{"package_management", int64_t{3600}},
+                                                                          pair{"weather", int64_t{1800}}};
+
+int64_t GetDefaultTimeToLive(string_view provider_name) {
+    auto i = find_if(begin(DEFAULT_TIME_TO_LIVE), end(DEFAULT_TIME_TO_LIVE), [provider_name](const auto &ttl) {
+        return ttl.first == provider_name;
+    });
+    return i == end(DEFAULT_TIME_TO_LIVE) ? int64_t{0} : i->second;
+}
+
+template<typename T>
+bool ReadRecord(string_view buffer, size_t &offset, T &record) {
+    if (offset > size(buffer) || size(buffer) - offset < sizeof(T)) {
+        return false;
+    }
+    record = mmotd::core::ReadRecord<T>(data(buffer) + offset);
+    offset += sizeof(T);
+    return true;
+}
+
+optional<string_view> GetPoolString(string_view pool, uint32_t offset, uint32_t length) {
+    if (offset > size(pool) || size(pool) - offset < length) {
+        return nullopt;
+    }
+    return pool.substr(offset, length);
+}
+
+int64_t ToSeconds(chrono::system_clock::time_point time_point) {
+    return chrono::duration_cast<chrono::seconds>(time_point.time_since_epoch()).count();
+}
+
+chrono::system_clock::time_point FromSeconds(int64_t seconds) {
+    return chrono::system_clock::time_point{chrono::seconds{seconds}};
+}
+
+} // namespace
+
+namespace mmotd::information {
+
+InformationCache::InformationCache() : InformationCache(IsEnabled() ? GetDefaultFilePath() : fs::path{}) {}
+
+InformationCache::InformationCache(fs::path file_path) : InformationCache(std::move(file_path), OS_RELEASE_PATH) {}
+
+InformationCache::InformationCache(fs::path file_path, const fs::path &os_release_path) :
+    file_path_(std::move(file_path)),
+    boot_time_(mmotd::platform::GetBootTime()),
+    boot_id_(mmotd::platform::GetBootId().value_or(string{})),
+    os_release_time_(mmotd::core::GetModificationTime(os_release_path).value_or(0)) {
+    if (size(boot_id_) >= BOOT_ID_SIZE) {
+        boot_id_.clear();
+    }
+    Load();
+}
+
+bool InformationCache::IsEnabled() {
+    return mmotd::core::ConfigOptions::Instance().GetBoolean("cache.enabled"sv, true);
+}
+
+fs::path InformationCache::GetDefaultFilePath() {
+    auto cache_dir = mmotd::core::special_files::GetCacheDirectory();
+    return empty(cache_dir) ? fs::path{} : cache_dir / SNAPSHOT_FILENAME;
+}
+
+chrono::seconds InformationCache::GetTimeToLive(string_view provider_name) {
+    const auto &config_options = mmotd::core::ConfigOptions::Instance();
+    auto ttl = config_options.GetInteger(format(FMT_STRING("cache.ttl.{}"), provider_name),
+                                         GetDefaultTimeToLive(provider_name));
+    return chrono::seconds{ttl};
+}
+
+optional<Informations> InformationCache::Find(string_view provider_name) const {
+    auto i = snapshots_.find(string{provider_name});
+    if (i == end(snapshots_)) {
+        return nullopt;
+    }
+    auto ttl = GetTimeToLive(provider_name);
+    if (ttl == chrono::seconds::zero()) {
+        return nullopt;
+    }
+    const auto &[timestamp, informations] = i->second;
+    // a negative time-to-live is valid until reboot and snapshots from a previous boot are never loaded
+    if (ttl > chrono::seconds::zero() && chrono::system_clock::now() - timestamp >= ttl) {
+        LOG_VERBOSE("snapshot of {} provider expired", provider_name);
+        return nullopt;
+    }
+    return make_optional(informations);
+}
+
+void InformationCache::Update(string_view provider_name, const Informations &informations) {
+    if (empty(file_path_) || size(provider_name) > PROVIDER_NAME_SIZE) {
+        return;
+    }
+    auto name = string{provider_name};
+    if (GetTimeToLive(provider_name) == chrono::seconds::zero() || empty(informations)) {
+        modified_ = snapshots_.erase(name) != 0 || modified_;
+        return;
+    }
+    snapshots_[name] = Snapshot{chrono::system_clock::now(), informations};
+    modified_ = true;
+}
+
+void InformationCache::Load() {
+    if (empty(file_path_) || !boot_time_) {
+        return;
+    }
+    auto mapped_file = mmotd::core::MappedFile::Open(file_path_);
+    if (!mapped_file) {
+        return;
+    }
+    if (!Parse(mapped_file->view())) {
+        LOG_WARNING("discarding snapshot cache {}", file_path_.string());
+        snapshots_.clear();
+        // force the stale/corrupt snapshot to be rewritten
+        modified_ = true;
+    }
+}
+
+bool InformationCache::Parse(string_view buffer) {
+    auto offset = size_t{0};
+    auto header = SnapshotHeader{};
+    if (!ReadRecord(buffer, offset, header) || header.magic != SNAPSHOT_MAGIC) {
+        LOG_ERROR("snapshot cache {} is not a valid snapshot", file_path_.string());
+        return false;
+    } else if (header.version != SNAPSHOT_VERSION) {
+        LOG_INFO("snapshot cache version {} does not match version {}", header.version, SNAPSHOT_VERSION);
+        return false;
+    }
+    auto snapshot_boot_id = string_view{data(header.boot_id), strnlen(data(header.boot_id), size(header.boot_id))};
+    auto rebooted = !empty(boot_id_) && !empty(snapshot_boot_id)
+                        ? snapshot_boot_id != boot_id_
+                        : chrono::abs(FromSeconds(header.boot_time) - *boot_time_) > BOOT_TIME_TOLERANCE;
+    if (rebooted) {
+        LOG_INFO("system has rebooted since the snapshot cache was written");
+        return false;
+    }
+
+    if (header.provider_count > (size(buffer) - offset) / sizeof(SnapshotProvider)) {
+        LOG_ERROR("snapshot cache {} is truncated", file_path_.string());
+        return false;
+    }
+    auto providers = vector<SnapshotProvider>(header.provider_count);
+    for (auto &provider : providers) {
+        if (!ReadRecord(buffer, offset, provider)) {
+            LOG_ERROR("snapshot cache {} is truncated", file_path_.string());
+            return false;
+        }
+    }
+    auto entries_offset = offset;
+    if (header.entry_count > (size(buffer) - entries_offset) / sizeof(SnapshotEntry)) {
+        LOG_ERROR("snapshot cache {} is truncated", file_path_.string());
+        return false;
+    }
+    auto pool_offset = entries_offset + header.entry_count * sizeof(SnapshotEntry);
+    if (size(buffer) - pool_offset != header.string_pool_size) {
+        LOG_ERROR("snapshot cache {} has an invalid string pool", file_path_.string());
+        return false;
+    }
+    auto pool = buffer.substr(pool_offset);
+
+    for (const auto &provider : providers) {
+        if (uint64_t{provider.first_entry} + provider.entry_count > header.entry_count) {
+            LOG_ERROR("snapshot cache {} has an invalid provider", file_path_.string());
+            return false;
+        }
+        auto name = string{data(provider.name), strnlen(data(provider.name), size(provider.name))};
+        auto informations = Informations{};
+        offset = entries_offset + provider.first_entry * sizeof(SnapshotEntry);
+        for (auto index = uint32_t{0}; index != provider.entry_count; ++index) {
+            auto entry = SnapshotEntry{};
+            ReadRecord(buffer, offset, entry);
+            auto entry_value = GetPoolString(pool, entry.value_offset, entry.value_size);
+            if (!entry_value) {
+                LOG_ERROR("snapshot cache {} has an invalid string offset", file_path_.string());
+                return false;
+            }
+            const auto *definition = FindInformationDefinition(static_cast<InformationId>(entry.id));
+            if (definition == nullptr) {
+                LOG_ERROR("snapshot cache {} has an unknown information id {}", file_path_.string(), entry.id);
+                return false;
+            }
+            auto information = Information{*definition};
+            information.SetValue(string{*entry_value});
+            informations.push_back(std::move(information));
+        }
+        snapshots_[name] = Snapshot{FromSeconds(provider.timestamp), std::move(informations)};
+    }
+    if (header.os_release_time != os_release_time_) {
+        DiscardBootSnapshots();
+    }
+    LOG_VERBOSE("loaded {} provider snapshots from {}", size(snapshots_), file_path_.string());
+    return true;
+}
+
+void InformationCache::DiscardBootSnapshots() {
+    LOG_INFO("platform version has changed since the snapshot cache was written");
+    for (auto i = begin(snapshots_); i != end(snapshots_);) {
+        if (GetTimeToLive(i->first) < chrono::seconds::zero()) {
+            i = snapshots_.erase(i);
+            modified_ = true;
+        } else {
+            ++i;
+        }
+    }
+}
+
+bool InformationCache::Save() {
+    if (empty(file_path_) || !modified_ || !boot_time_) {
+        return true;
+    }
+
+    auto providers = vector<SnapshotProvider>{};
+    auto entries = vector<SnapshotEntry>{};
+    auto pool = string{};
+    auto add_string = [&pool](const string &str) {
+        auto str_offset = static_cast<uint32_t>(size(pool));
+        pool += str;
+        return pair{str_offset, static_cast<uint32_t>(size(str))};
+    };
+    for (const auto &[name, snapshot] : snapshots_) {
+        auto provider = SnapshotProvider{};
+        copy_n(begin(name), min(size(name), PROVIDER_NAME_SIZE), begin(provider.name));
+        provider.timestamp = ToSeconds(snapshot.timestamp);
+        provider.first_entry = static_cast<uint32_t>(size(entries));
+        for (const auto &[id, infos] : snapshot.informations) {
+            for (const auto &info : infos) {
+                auto entry = SnapshotEntry{};
+                entry.id = static_cast<uint64_t>(id);
+                tie(entry.value_offset, entry.value_size) = add_string(info.GetValue());
+                entries.push_back(entry);
+            }
+        }
+        provider.entry_count = static_cast<uint32_t>(size(entries)) - provider.first_entry;
+        providers.push_back(provider);
+    }
+    if (size(pool) > numeric_limits<uint32_t>::max()) {
+        LOG_ERROR("snapshot cache string pool is too large, {} bytes", size(pool));
+        return false;
+    }
+
+    auto header = SnapshotHeader{};
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.provider_count = static_cast<uint32_t>(size(providers));
+    header.boot_time = ToSeconds(*boot_time_);
+    copy(begin(boot_id_), end(boot_id_), begin(header.boot_id));
+    header.os_release_time = os_release_time_;
+    header.entry_count = size(entries);
+    header.string_pool_size = size(pool);
+
+    auto parts = array{mmotd::core::AsBytes(header),
+                       mmotd::core::AsBytes(providers),
+                       mmotd::core::AsBytes(entries),
+                       string_view{pool}};
+    if (!mmotd::core::WriteFileAtomically(file_path_, parts)) {
+        return false;
+    }
+    modified_ = false;
+    LOG_VERBOSE("saved {} provider snapshots to {}", size(providers), file_path_.string());
+    return true;
+}
+
+} // namespace mmotd::information
@@ -8,9 +8,12 @@
 
 #include <algorithm>
 #include <iterator>
+#include <memory>
 #include <optional>
+#include <stop_token>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include <boost/exception/diagnostic_information.hpp>
@@ -30,11 +33,47 @@ const Informations &InformationProvider::GetInformations() const {
     return informations_;
 }
 
-void InformationProvider::LookupInformation() {
-    auto exception_message = string{};
+void InformationProvider::SetDependencies(vector<shared_ptr<const InformationProvider>> dependencies) {
+    dependencies_ = std::move(dependencies);
+}
+
+void InformationProvider::LookupInformation(std::stop_token stop_token) {
+    for (const auto &sub_task : GetSubTasks()) {
+        RunSubTask(sub_task, stop_token);
+    }
+    // a provider can be looked up more than once when the daemon refreshes the informations
+    informations_.clear();
+    RunSubTask([this](std::stop_token token) { FindInformation(std::move(token)); }, stop_token);
+}
+
+TaskGraph::TaskId InformationProvider::AddLookupTasks(TaskGraph &task_graph,
+                                                      std::stop_token stop_token,
+                                                      const TaskGraph::TaskIds &dependencies) {
+    // the tasks are skipped once the lookup is over budget, there is no point in starting anything new
+    auto name = string{GetName()};
+    auto sub_tasks = GetSubTasks();
+    auto sub_task_ids = TaskGraph::TaskIds{};
+    for (auto i = size_t{0}; i != size(sub_tasks); ++i) {
+        auto task = [this, sub_task = std::move(sub_tasks[i]), stop_token]() {
+            if (!stop_token.stop_requested()) {
+                RunSubTask(sub_task, stop_token);
+            }
+        };
+        sub_task_ids.push_back(task_graph.AddTask(fmt::format(FMT_STRING("{}[{}]"), name, i), task, dependencies));
+    }
+    auto lookup = [this, stop_token]() {
+        if (!stop_token.stop_requested()) {
+            informations_.clear();
+            RunSubTask([this](std::stop_token token) { FindInformation(std::move(token)); }, stop_token);
+        }
+    };
+    return task_graph.AddTask(name, lookup, empty(sub_task_ids) ? dependencies : sub_task_ids);
+}
 
+void InformationProvider::RunSubTask(const SubTask &sub_task, std::stop_token stop_token) {
+    auto exception_message = string{};
     try {
-        FindInformation();
+        sub_task(std::move(stop_token));
     } catch (boost::exception &ex) {
         exception_message = mmotd::assertion::GetBoostExceptionMessage(ex);
     } catch (const std::exception &ex) {
@@ -46,18 +85,25 @@ void InformationProvider::LookupInformation() {
     }
 }
 
+void InformationProvider::RestoreInformations(Informations informations) {
+    informations_ = std::move(informations);
+}
+
 void InformationProvider::AddInformation(Information information) {
-    if (informations_.contains(information.GetId())) {
-        informations_[information.GetId()].push_back(move(information));
-    } else {
-        informations_.emplace(information.GetId(), vector<Information>{information});
-    }
+    informations_.push_back(std::move(information));
 }
 
 Information InformationProvider::GetInfoTemplate(InformationId id) const {
     return InformationDefinitions::Instance().GetInformationDefinition(id);
 }
 
+const Informations *InformationProvider::GetDependencyInformations(string_view name) const {
+    auto i = find_if(begin(dependencies_), end(dependencies_), [name](const auto &dependency) {
+        return dependency->GetName() == name;
+    });
+    return i == end(dependencies_) ? nullptr : &(*i)->GetInformations();
+}
+
 std::string InformationProvider::GetUnknownProperty() const {
     static constexpr auto style = fmt::text_style(fmt::emphasis::bold) | fmt::fg(fmt::terminal_color::bright_yellow);
     static const auto UNKNOWN_STR = fmt::format(style, FMT_STRING("[unknown]"));
@@ -10,15 +10,17 @@ bool gLinkLoadAverage = false;
 namespace mmotd::information {
 
 static const bool load_average_information_factory_registered =
-    RegisterInformationProvider([]() { return make_unique<mmotd::information::LoadAverage>(); });
+    RegisterInformationProvider("load_average",
+                                []() { return make_unique<mmotd::information::LoadAverage>(); },
+                                {InformationId::ID_LOAD_AVERAGE_LOAD_AVERAGE});
 
-void LoadAverage::FindInformation() {
+void LoadAverage::FindInformation(std::stop_token) {
     auto load_average_holder = mmotd::platform::GetLoadAverageDetails();
     if (!load_average_holder.has_value()) {
         return;
     }
     auto load_average = GetInfoTemplate(InformationId::ID_LOAD_AVERAGE_LOAD_AVERAGE);
-    load_average.SetValueArgs(*load_average_holder);
+    load_average.SetValue(*load_average_holder);
     AddInformation(load_average);
 }
 
@@ -17,21 +17,24 @@ bool gLinkMemoryUsage = false;
 namespace mmotd::information {
 
 static const bool memory_information_factory_registered =
-    RegisterInformationProvider([]() { return make_unique<mmotd::information::Memory>(); });
+    RegisterInformationProvider("memory",
+                                []() { return make_unique<mmotd::information::Memory>(); },
+                                {InformationId::ID_MEMORY_USAGE_FREE, InformationId::ID_MEMORY_USAGE_PERCENT_USED,
+                                 InformationId::ID_MEMORY_USAGE_SUMMARY, InformationId::ID_MEMORY_USAGE_TOTAL});
 
-void Memory::FindInformation() {
+void Memory::FindInformation(std::stop_token) {
     auto details = mmotd::platform::GetMemoryDetails();
 
     auto total = GetInfoTemplate(InformationId::ID_MEMORY_USAGE_TOTAL);
-    total.SetValueArgs(to_human_size(details.total));
+    total.SetValue(to_human_size(details.total));
     AddInformation(total);
 
     auto free = GetInfoTemplate(InformationId::ID_MEMORY_USAGE_FREE);
-    free.SetValueArgs(details.free);
+    free.SetValue(details.free);
     AddInformation(free);
 
     auto percent_used = GetInfoTemplate(InformationId::ID_MEMORY_USAGE_PERCENT_USED);
-    percent_used.SetValueArgs(details.percent_used);
+    percent_used.SetValue(details.percent_used);
     AddInformation(percent_used);
 
     auto summary = GetInfoTemplate(InformationId::ID_MEMORY_USAGE_SUMMARY);
@@ -17,20 +17,23 @@ bool gLinkPackageManagementInfo = false;
 namespace mmotd::information {
 
 static const bool package_management_information_factory_registered =
-    RegisterInformationProvider([]() { return make_unique<mmotd::information::PackageManagement>(); });
+    RegisterInformationProvider("package_management",
+                                []() { return make_unique<mmotd::information::PackageManagement>(); },
+                                {InformationId::ID_PACKAGE_MANAGEMENT_REBOOT_REQUIRED,
+                                 InformationId::ID_PACKAGE_MANAGEMENT_UPDATE_DETAILS});
 
-void PackageManagement::FindInformation() {
+void PackageManagement::FindInformation(std::stop_token) {
     auto update_details = platform::package_management::GetUpdateDetails();
     if (!empty(update_details)) {
         auto update_details_info = GetInfoTemplate(InformationId::ID_PACKAGE_MANAGEMENT_UPDATE_DETAILS);
-        update_details_info.SetValueArgs(update_details);
+        update_details_info.SetValue(update_details);
         LOG_VERBOSE("set the value of package management update details: {}", update_details);
         AddInformation(update_details_info);
     }
     auto reboot_required = platform::package_management::GetRebootRequired();
     if (!empty(reboot_required)) {
         auto reboot_required_info = GetInfoTemplate(InformationId::ID_PACKAGE_MANAGEMENT_REBOOT_REQUIRED);
-        reboot_required_info.SetValueArgs(reboot_required);
+        reboot_required_info.SetValue(reboot_required);
         LOG_VERBOSE("set the value of package management reboot required: {}", reboot_required);
         AddInformation(reboot_required_info);
     }
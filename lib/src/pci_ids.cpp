@@ -0,0 +1,192 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/line_parser.h"
+#include "common/include/logging.h"
+#include "common/include/mapped_file.h"
+#include "lib/include/pci_ids.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+using mmotd::platform::PciIds;
+
+constexpr auto PCI_IDS_INDEX_FILENAME = string_view{"pci_ids.idx"};
+constexpr auto PCI_IDS_INDEX_MAGIC = array<char, 8>{'m', 'm', 'o', 't', 'd', 'p', 'c', 'i'};
+constexpr auto PCI_IDS_INDEX_VERSION = uint32_t{1};
+// Above any 16 bit device id, so the vendor sorts after all of its devices
+constexpr auto VENDOR_KEY = uint64_t{0x10000};
+// Where the distributions install the database, the first one found is used
+constexpr auto PCI_IDS_LOCATIONS =
+    array<string_view, 3>{"/usr/share/hwdata/pci.ids", "/usr/share/misc/pci.ids", "/usr/share/pci.ids"};
+
+struct PciIdsIndexHeader {
+    array<char, 8> magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint64_t pci_ids_size;
+    int64_t pci_ids_time;
+};
+
+constexpr uint64_t MakeKey(uint16_t vendor_id, uint64_t device_id) {
+    return (uint64_t{vendor_id} << 32) | device_id;
+}
+
+optional<uint16_t> ParseHexId(string_view str) {
+    auto id = uint16_t{0};
+    auto [p, ec] = from_chars(data(str), data(str) + size(str), id, 16);
+    return ec == std::errc() && p == data(str) + size(str) && size(str) == 4 ? make_optional(id) : nullopt;
+}
+
+// Splits "10de  NVIDIA Corporation" into the id and the name
+optional<pair<uint16_t, string_view>> ParseIdLine(string_view line) {
+    auto separator = line.find("  ");
+    if (separator == string_view::npos) {
+        return nullopt;
+    }
+    auto id = ParseHexId(line.substr(0, separator));
+    auto name = mmotd::core::TrimBlanks(line.substr(separator));
+    return id ? make_optional(pair{*id, name}) : nullopt;
+}
+
+} // namespace
+
+namespace mmotd::platform {
+
+optional<PciIds> PciIds::Open(const fs::path &cache_directory) {
+    auto ec = error_code{};
+    auto i = find_if(begin(PCI_IDS_LOCATIONS), end(PCI_IDS_LOCATIONS), [&ec](auto location) {
+        return fs::exists(location, ec);
+    });
+    if (i == end(PCI_IDS_LOCATIONS)) {
+        LOG_VERBOSE("unable to find the pci.ids database");
+        return nullopt;
+    }
+    auto index_path = empty(cache_directory) ? fs::path{} : cache_directory / PCI_IDS_INDEX_FILENAME;
+    return Open(fs::path{*i}, index_path);
+}
+
+optional<PciIds> PciIds::Open(const fs::path &pci_ids_path, const fs::path &index_path) {
+    auto pci_ids_file = mmotd::core::MappedFile::Open(pci_ids_path);
+    if (!pci_ids_file) {
+        return nullopt;
+    }
+    auto pci_ids = PciIds{};
+    pci_ids.pci_ids_ = std::move(*pci_ids_file);
+    auto pci_ids_time = mmotd::core::GetModificationTime(pci_ids_path).value_or(0);
+    if (empty(index_path) || !pci_ids.LoadIndex(index_path, pci_ids_time)) {
+        pci_ids.BuildIndex();
+        if (!empty(index_path)) {
+            pci_ids.SaveIndex(index_path, pci_ids_time);
+        }
+    }
+    return make_optional(std::move(pci_ids));
+}
+
+optional<string_view> PciIds::FindVendorName(uint16_t vendor_id) const {
+    return Find(MakeKey(vendor_id, VENDOR_KEY));
+}
+
+optional<string_view> PciIds::FindDeviceName(uint16_t vendor_id, uint16_t device_id) const {
+    return Find(MakeKey(vendor_id, device_id));
+}
+
+optional<string_view> PciIds::Find(uint64_t key) const {
+    auto i = lower_bound(begin(entries_), end(entries_), key, [](const auto &entry, uint64_t entry_key) {
+        return entry.key < entry_key;
+    });
+    if (i == end(entries_) || i->key != key) {
+        return nullopt;
+    }
+    return pci_ids_.view().substr(i->name_offset, i->name_size);
+}
+
+void PciIds::BuildIndex() {
+    auto pci_ids = pci_ids_.view();
+    auto vendor_id = optional<uint16_t>{};
+    auto entries = vector<IndexEntry>{};
+    auto add_entry = [&pci_ids, &entries](uint64_t key, string_view name) {
+        auto name_offset = static_cast<uint32_t>(data(name) - data(pci_ids));
+        entries.push_back(IndexEntry{key, name_offset, static_cast<uint32_t>(size(name))});
+    };
+    mmotd::core::ForEachLine(pci_ids, [&vendor_id, &add_entry](string_view line) {
+        if (empty(line) || line.front() == '#') {
+            return true;
+        } else if (line.starts_with("C ")) {
+            // the device classes follow the vendors, there are no more names to index
+            return false;
+        } else if (line.starts_with("\t\t")) {
+            // the subsystems of a device are not needed
+            return true;
+        } else if (line.front() == '\t') {
+            if (auto device = ParseIdLine(line.substr(1)); device && vendor_id) {
+                add_entry(MakeKey(*vendor_id, device->first), device->second);
+            }
+        } else if (auto vendor = ParseIdLine(line); vendor) {
+            vendor_id = vendor->first;
+            add_entry(MakeKey(*vendor_id, VENDOR_KEY), vendor->second);
+        } else {
+            vendor_id = nullopt;
+        }
+        return true;
+    });
+    sort(begin(entries), end(entries), [](const auto &a, const auto &b) { return a.key < b.key; });
+    LOG_VERBOSE("indexed {} pci.ids names", size(entries));
+    entries_ = std::move(entries);
+}
+
+bool PciIds::LoadIndex(const fs::path &index_path, int64_t pci_ids_time) {
+    auto index_file = mmotd::core::MappedFile::Open(index_path);
+    if (!index_file || size(*index_file) < sizeof(PciIdsIndexHeader)) {
+        return false;
+    }
+    auto header = mmotd::core::ReadRecord<PciIdsIndexHeader>(index_file->data());
+    if (header.magic != PCI_IDS_INDEX_MAGIC || header.version != PCI_IDS_INDEX_VERSION ||
+        header.pci_ids_size != size(pci_ids_) || header.pci_ids_time != pci_ids_time) {
+        LOG_VERBOSE("pci.ids index {} is out of date", index_path.string());
+        return false;
+    }
+    if (size(*index_file) != sizeof(PciIdsIndexHeader) + header.entry_count * sizeof(IndexEntry)) {
+        LOG_ERROR("pci.ids index {} is truncated", index_path.string());
+        return false;
+    }
+    auto entries = vector<IndexEntry>(header.entry_count);
+    for (auto i = size_t{0}; i < size(entries); ++i) {
+        entries[i] = mmotd::core::ReadRecord<IndexEntry>(index_file->data() + sizeof(header) + i * sizeof(IndexEntry));
+    }
+    auto name_out_of_range = any_of(begin(entries), end(entries), [this](const auto &entry) {
+        return uint64_t{entry.name_offset} + entry.name_size > size(pci_ids_);
+    });
+    if (name_out_of_range) {
+        LOG_ERROR("pci.ids index {} has an invalid name offset", index_path.string());
+        return false;
+    }
+    entries_ = std::move(entries);
+    return true;
+}
+
+void PciIds::SaveIndex(const fs::path &index_path, int64_t pci_ids_time) const {
+    auto header = PciIdsIndexHeader{};
+    header.magic = PCI_IDS_INDEX_MAGIC;
+    header.version = PCI_IDS_INDEX_VERSION;
+    header.entry_count = static_cast<uint32_t>(size(entries_));
+    header.pci_ids_size = size(pci_ids_);
+    header.pci_ids_time = pci_ids_time;
+
+    auto parts = array{mmotd::core::AsBytes(header), mmotd::core::AsBytes(entries_)};
+    mmotd::core::WriteFileAtomically(index_path, parts);
+}
+
+} // namespace mmotd::platform
@@ -40,5 +40,19 @@ optional<std::chrono::system_clock::time_point> GetBootTime() {
     return {boot_time_point};
 }
 
+optional<string> GetBootId() {
+    auto boot_session_uuid = array<char, 64>{};
+    auto boot_session_uuid_len = size(boot_session_uuid);
+    if (sysctlbyname("kern.bootsessionuuid", data(boot_session_uuid), &boot_session_uuid_len, nullptr, 0) == -1) {
+        auto error_str = string{};
+        if (auto posix_errno = mmotd::error::posix_error::to_string(); !posix_errno.empty()) {
+            error_str += format(FMT_STRING(", details: {}"), posix_errno);
+        }
+        LOG_ERROR("sysctl(kern.bootsessionuuid) syscall failed{}", error_str);
+        return nullopt;
+    }
+    return make_optional(string{data(boot_session_uuid)});
+}
+
 } // namespace mmotd::platform
 #endif
@@ -10,6 +10,7 @@
 #include <array>
 #include <bit>
 #include <cstddef>
+#include <filesystem>
 #include <iterator>
 #include <string_view>
 #include <vector>
@@ -275,34 +276,33 @@ string GetCpuName() {
 
 namespace mmotd::platform {
 
-HardwareDetails GetHardwareInformationDetails() {
-    auto details = HardwareDetails{};
+void GetMachineDetails(HardwareDetails &details) {
+    auto machine_information_holder = MachineInformation::QueryMachineInformation();
+    if (!machine_information_holder || machine_information_holder.value().empty()) {
+        LOG_WARNING("machine information was either null or empty");
+    } else {
+        const auto &machine_info = *machine_information_holder;
+        details.machine_type = machine_info.machine_type;
+        details.machine_model = machine_info.machine_model;
+    }
+}
+
+void GetCpuDetails(HardwareDetails &details, std::stop_token) {
     details.cpu_core_count = GetCpuCount().value_or(0);
     details.cpu_name = GetCpuName();
     details.byte_order = GetByteOrder();
-    details.cpu_temperature = GetCpuTemperature();
-    details.gpu_temperature = GetGpuTemperature();
+}
 
+void GetGpuDetails(HardwareDetails &details, const std::filesystem::path &, std::stop_token) {
     auto gpu_information_holder = GpuInformation::QueryGpuInformation();
     if (!gpu_information_holder || gpu_information_holder.value().empty()) {
         LOG_WARNING("gpu information was either null or empty");
     } else {
         const auto &gpu_info = *gpu_information_holder;
-        details.gpu_name = gpu_info.GetGraphicsModelName();
+        details.gpu_names.push_back(gpu_info.GetGraphicsModelName());
         details.monitor_name = gpu_info.GetDisplayName();
         details.monitor_resolution = gpu_info.GetResolution();
     }
-
-    auto machine_information_holder = MachineInformation::QueryMachineInformation();
-    if (!machine_information_holder || machine_information_holder.value().empty()) {
-        LOG_WARNING("machine information was either null or empty");
-    } else {
-        const auto &machine_info = *machine_information_holder;
-        details.machine_type = machine_info.machine_type;
-        details.machine_model = machine_info.machine_model;
-    }
-
-    return details;
 }
 
 } // namespace mmotd::platform
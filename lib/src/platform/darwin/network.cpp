@@ -23,9 +23,11 @@
 #include <ifaddrs.h>
 #include <net/if_dl.h>
 #include <net/if_media.h>
+#include <net/route.h>
 #include <netinet/in.h>
 #include <netinet6/in6_var.h>
 #include <sys/socket.h>
+#include <sys/sysctl.h>
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -208,6 +210,15 @@ void AddIpAddress(NetworkDevices &network_devices, const struct ifaddrs *ifaddrs
     SetActiveDevice(network_devices, interface_name, address_family, family_name);
 }
 
+bool IsUnspecifiedAddress(const struct sockaddr *address) {
+    if (address->sa_family == AF_INET) {
+        return reinterpret_cast<const struct sockaddr_in *>(address)->sin_addr.s_addr == INADDR_ANY;
+    } else if (address->sa_family == AF_INET6) {
+        return IN6_IS_ADDR_UNSPECIFIED(&reinterpret_cast<const struct sockaddr_in6 *>(address)->sin6_addr);
+    }
+    return false;
+}
+
 } // namespace
 
 namespace mmotd::platform {
@@ -242,5 +253,35 @@ NetworkDevices GetNetworkDevices() {
     return network_devices;
 }
 
+bool HasDefaultRoute() {
+    // the gateway routes of the routing table, a default route has an unspecified destination
+    for (auto family : {AF_INET, AF_INET6}) {
+        int mib[6] = {CTL_NET, PF_ROUTE, 0, family, NET_RT_FLAGS, RTF_GATEWAY};
+        auto length = size_t{0};
+        if (sysctl(mib, 6, nullptr, &length, nullptr, 0) == -1) {
+            LOG_ERROR("sysctl(NET_RT_FLAGS) failed, {}", mmotd::error::posix_error::to_string());
+            return true;
+        }
+        auto buffer = vector<char>(length);
+        if (sysctl(mib, 6, data(buffer), &length, nullptr, 0) == -1) {
+            LOG_ERROR("sysctl(NET_RT_FLAGS) failed, {}", mmotd::error::posix_error::to_string());
+            return true;
+        }
+        for (auto offset = size_t{0}; offset + sizeof(struct rt_msghdr) <= length;) {
+            const auto *header = reinterpret_cast<const struct rt_msghdr *>(data(buffer) + offset);
+            if (header->rtm_msglen == 0) {
+                break;
+            }
+            const auto *destination = reinterpret_cast<const struct sockaddr *>(header + 1);
+            if ((header->rtm_addrs & RTA_DST) != 0 && IsUnspecifiedAddress(destination)) {
+                return true;
+            }
+            offset += header->rtm_msglen;
+        }
+    }
+    LOG_VERBOSE("no default route found");
+    return false;
+}
+
 } // namespace mmotd::platform
 #endif
@@ -37,7 +37,21 @@ optional<endian> from_endian_string(string endian_str) {
 
 bool HardwareDetails::empty() const noexcept {
     return std::empty(machine_type) && std::empty(machine_model) && cpu_core_count == 0 && std::empty(cpu_name) &&
-           !byte_order && std::empty(gpu_name) && std::empty(monitor_name) && std::empty(monitor_resolution);
+           !byte_order && std::empty(gpu_names) && std::empty(monitor_name) && std::empty(monitor_resolution);
+}
+
+void GetTemperatureDetails(HardwareDetails &details) {
+    details.cpu_temperature = GetCpuTemperature();
+    details.gpu_temperature = GetGpuTemperature();
+}
+
+HardwareDetails GetHardwareInformationDetails() {
+    auto details = HardwareDetails{};
+    GetMachineDetails(details);
+    GetCpuDetails(details);
+    GetGpuDetails(details);
+    GetTemperatureDetails(details);
+    return details;
 }
 
 } // namespace mmotd::platform
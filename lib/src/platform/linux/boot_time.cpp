@@ -2,8 +2,10 @@
 #if defined(__linux__)
 #include "common/include/chrono_io.h"
 #include "common/include/iostream_error.h"
+#include "common/include/line_parser.h"
 #include "common/include/logging.h"
 
+#include <array>
 #include <chrono>
 #include <fstream>
 #include <optional>
@@ -16,6 +18,9 @@ using namespace std;
 using fmt::format;
 
 static constexpr string_view UPTIME_FILENAME = "/proc/uptime";
+static constexpr string_view BOOT_ID_FILENAME = "/proc/sys/kernel/random/boot_id";
+// A uuid with its dashes and newline is 37 characters
+static constexpr size_t BOOT_ID_BUFFER_SIZE = 64;
 
 namespace mmotd::platform {
 
@@ -39,5 +44,15 @@ optional<std::chrono::system_clock::time_point> GetBootTime() {
     return make_optional(boot_time_point);
 }
 
+optional<string> GetBootId() {
+    auto buffer = array<char, BOOT_ID_BUFFER_SIZE>{};
+    auto boot_id = mmotd::core::ReadVirtualFile(BOOT_ID_FILENAME, buffer);
+    if (!boot_id || empty(mmotd::core::TrimBlanks(*boot_id))) {
+        LOG_ERROR("unable to read the boot id from {}", BOOT_ID_FILENAME);
+        return nullopt;
+    }
+    return make_optional(string{mmotd::core::TrimBlanks(*boot_id)});
+}
+
 } // namespace mmotd::platform
 #endif
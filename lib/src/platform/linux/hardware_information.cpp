@@ -3,20 +3,24 @@
 #include "lib/include/hardware_information.h"
 
 #include "common/include/iostream_error.h"
+#include "common/include/line_parser.h"
 #include "common/include/logging.h"
 #include "common/include/posix_error.h"
 #include "common/include/system_command.h"
+#include "lib/include/pci_ids.h"
 #include "lib/include/platform/hardware_information.h"
 
+#include <algorithm>
+#include <array>
 #include <bit>
 #include <charconv>
 #include <filesystem>
 #include <fstream>
 #include <optional>
-#include <regex>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <boost/algorithm/string.hpp>
@@ -112,7 +116,84 @@ CpuInfo ParseLscpuOutput(optional<string> output_holder) {
     return make_tuple(cpu_name, cpu_count, byte_order);
 }
 
-CpuInfo GetCpuInformation() {
+constexpr auto PROC_CPUINFO_PATH = string_view{"/proc/cpuinfo"};
+constexpr auto SYSFS_CPU_DIRECTORY = string_view{"/sys/devices/system/cpu"};
+// The fields of /proc/cpuinfo which name the cpu model (x86, mips and powerpc), the first one in this list wins
+constexpr auto CPU_NAME_FIELDS = array<string_view, 3>{"model name", "cpu model", "cpu"};
+constexpr auto SYSFS_PCI_DEVICES_DIRECTORY = string_view{"/sys/bus/pci/devices"};
+// A sysfs cpu list, "0-3,8-11", or a topology id is always well within this
+constexpr auto SYSFS_VALUE_BUFFER_SIZE = size_t{256};
+
+// The physical id (socket) and core id of a hardware thread
+using CpuTopology = pair<int32_t, int32_t>;
+
+optional<int32_t> ParseInteger(string_view str) {
+    str = mmotd::core::TrimBlanks(str);
+    auto value = int32_t{0};
+    auto [p, ec] = from_chars(data(str), data(str) + size(str), value);
+    return ec == std::errc() && p == data(str) + size(str) && !empty(str) ? make_optional(value) : nullopt;
+}
+
+// Calls `function` with every cpu of a sysfs cpu list such as "0-3,8,10-11", returns false when it is malformed
+template<typename Function>
+bool ForEachCpu(string_view cpu_list, Function function) {
+    cpu_list = mmotd::core::TrimBlanks(cpu_list);
+    while (!empty(cpu_list)) {
+        auto comma = cpu_list.find(',');
+        auto range = cpu_list.substr(0, comma);
+        cpu_list.remove_prefix(comma == string_view::npos ? size(cpu_list) : comma + 1);
+        auto dash = range.find('-');
+        auto first = ParseInteger(range.substr(0, dash));
+        auto last = dash == string_view::npos ? first : ParseInteger(range.substr(dash + 1));
+        if (!first || !last || *last < *first) {
+            return false;
+        }
+        for (auto cpu = *first; cpu <= *last; ++cpu) {
+            function(cpu);
+        }
+    }
+    return true;
+}
+
+optional<int32_t> ReadSysfsInteger(const fs::path &file_path) {
+    auto buffer = array<char, SYSFS_VALUE_BUFFER_SIZE>{};
+    auto value = mmotd::core::ReadVirtualFile(file_path, buffer);
+    return value ? ParseInteger(*value) : nullopt;
+}
+
+// The number of hardware threads in the first of 'online' or 'present' which can be read
+int32_t GetSysfsCpuCount(const fs::path &sysfs_cpu_directory) {
+    for (auto file_name : {"online", "present"}) {
+        auto buffer = array<char, SYSFS_VALUE_BUFFER_SIZE>{};
+        auto cpu_list = mmotd::core::ReadVirtualFile(sysfs_cpu_directory / file_name, buffer);
+        auto cpu_count = int32_t{0};
+        if (cpu_list && ForEachCpu(*cpu_list, [&cpu_count](int32_t) { ++cpu_count; }) && cpu_count != 0) {
+            return cpu_count;
+        }
+    }
+    return int32_t{0};
+}
+
+// Used when /proc/cpuinfo does not list the 'physical id' and 'core id' of each processor (i.e. arm)
+vector<CpuTopology> GetSysfsCpuTopology(const fs::path &sysfs_cpu_directory) {
+    auto buffer = array<char, SYSFS_VALUE_BUFFER_SIZE>{};
+    auto cpu_list = mmotd::core::ReadVirtualFile(sysfs_cpu_directory / "online", buffer);
+    auto topology = vector<CpuTopology>{};
+    if (!cpu_list) {
+        return topology;
+    }
+    auto valid = ForEachCpu(*cpu_list, [&sysfs_cpu_directory, &topology](int32_t cpu) {
+        auto topology_directory = sysfs_cpu_directory / format(FMT_STRING("cpu{}"), cpu) / "topology";
+        auto package_id = ReadSysfsInteger(topology_directory / "physical_package_id");
+        auto core_id = ReadSysfsInteger(topology_directory / "core_id");
+        if (package_id && core_id) {
+            topology.emplace_back(*package_id, *core_id);
+        }
+    });
+    return valid ? topology : vector<CpuTopology>{};
+}
+
+CpuInfo GetLscpuInformation() {
     using mmotd::system::command::Run;
     return Run("/usr/bin/lscpu", {"--json"}, ParseLscpuOutput);
 }
@@ -145,66 +226,22 @@ string GetMachineModel() {
     return GetLineFromFile(product_name_path);
 }
 
-optional<string> ParseLspciOutput(optional<string> output_holder) {
-    // ensure input is valid
-    if (!output_holder) {
-        return nullopt;
-    }
-
-    // split the chunk of input into discrete lines
-    auto output = *output_holder;
-    auto output_lines = vector<string>{};
-    boost::split(output_lines, output, boost::is_any_of("\n"));
-
-    constexpr auto regex_flags = std::regex::ECMAScript | std::regex::icase;
-    const auto vga_regex = regex(R"(vga|[23]d)", regex_flags);
-
-    // find which line refers to 'VGA', '3D' or '2D'
-    auto i = find_if(begin(output_lines), end(output_lines), [&vga_regex](const auto &output_line) {
-        return std::regex_search(output_line, vga_regex, std::regex_constants::match_any);
-    });
-    if (i == end(output_lines)) {
-        LOG_ERROR("unable to find 'VGA', '2D' or '3D' in output of 'lspci', output: '{}'", output);
-        return nullopt;
-    }
-
-    // split the line on the ":" character
-    const auto &vga_line = *i;
-    auto vga_line_parts = vector<string>{};
-    boost::split(vga_line_parts, vga_line, boost::is_any_of(":"));
+// The pci class of a display controller (vga, xga, 3d or other) is 0x03 in the top byte of the 24 bit class
+constexpr auto PCI_DISPLAY_CONTROLLER_CLASS = uint32_t{0x03};
 
-    if (size(vga_line_parts) == 1) {
-        LOG_ERROR("found 'vga' in 'lspci output but there is no ':' character: '{}'", vga_line);
+optional<uint32_t> ReadSysfsHexInteger(const fs::path &file_path) {
+    auto buffer = array<char, SYSFS_VALUE_BUFFER_SIZE>{};
+    auto value_holder = mmotd::core::ReadVirtualFile(file_path, buffer);
+    if (!value_holder) {
         return nullopt;
     }
-
-    // trim any whitespace off of the right hand side of the ":" character
-    auto gpu_name = boost::trim_copy(vga_line_parts.back());
-    LOG_INFO("found gpu model name from 'lspci' output: '{}'", gpu_name);
-    return make_optional(gpu_name);
-}
-
-fs::path FindLspciBinary() {
-    auto ec = error_code{};
-    if (auto lspci_path = fs::path{"/usr/bin/lspci"}; fs::exists(lspci_path, ec) && !ec) {
-        return lspci_path;
-    }
-    if (auto lspci_path = fs::path{"/usr/sbin/lspci"}; fs::exists(lspci_path, ec) && !ec) {
-        return lspci_path;
+    auto str = mmotd::core::TrimBlanks(*value_holder);
+    if (str.starts_with("0x")) {
+        str.remove_prefix(2);
     }
-    return fs::path{};
-}
-
-string GetGraphicsModelName() {
-    using mmotd::system::command::Run;
-    auto gpu_model_name = Run(FindLspciBinary(), {}, ParseLspciOutput);
-    if (!gpu_model_name) {
-        LOG_ERROR("lspci did not return the gpu model name");
-        return string{};
-    }
-
-    LOG_INFO("gpu model name: {}", *gpu_model_name);
-    return *gpu_model_name;
+    auto value = uint32_t{0};
+    auto [p, ec] = from_chars(data(str), data(str) + size(str), value, 16);
+    return ec == std::errc() && p == data(str) + size(str) && !empty(str) ? make_optional(value) : nullopt;
 }
 
 string GetMonitorName() {
@@ -221,22 +258,158 @@ string GetMonitorResolution() {
 
 namespace mmotd::platform {
 
-HardwareDetails GetHardwareInformationDetails() {
-    auto [cpu_name, cpu_count, byte_order] = GetCpuInformation();
-
-    auto details = HardwareDetails{};
+void GetMachineDetails(HardwareDetails &details) {
     details.machine_type = GetMachineType();
     details.machine_model = GetMachineModel();
+}
+
+void GetCpuInfoDetails(HardwareDetails &details, string_view cpuinfo, const fs::path &sysfs_cpu_directory) {
+    auto processor_count = int32_t{0};
+    auto physical_id = optional<int32_t>{};
+    auto topology = vector<CpuTopology>{};
+    auto cpu_name = string_view{};
+    auto cpu_name_rank = size(CPU_NAME_FIELDS);
+    mmotd::core::ForEachLine(cpuinfo, [&](string_view line) {
+        auto name_value = mmotd::core::SplitNameValue(line);
+        if (!name_value) {
+            return;
+        }
+        auto [name, value] = *name_value;
+        if (name == "processor") {
+            ++processor_count;
+            physical_id = nullopt;
+        } else if (name == "physical id") {
+            physical_id = ParseInteger(value);
+        } else if (name == "core id") {
+            if (auto core_id = ParseInteger(value); physical_id && core_id) {
+                topology.emplace_back(*physical_id, *core_id);
+            }
+        } else if (auto i = find(begin(CPU_NAME_FIELDS), end(CPU_NAME_FIELDS), name); i != end(CPU_NAME_FIELDS)) {
+            auto rank = static_cast<size_t>(distance(begin(CPU_NAME_FIELDS), i));
+            if (rank < cpu_name_rank && !empty(value)) {
+                cpu_name = value;
+                cpu_name_rank = rank;
+            }
+        }
+    });
+
+    auto thread_count = GetSysfsCpuCount(sysfs_cpu_directory);
+    if (thread_count == 0) {
+        thread_count = processor_count;
+    }
+    if (processor_count == 0 || size(topology) != static_cast<size_t>(processor_count)) {
+        topology = GetSysfsCpuTopology(sysfs_cpu_directory);
+    }
+    sort(begin(topology), end(topology));
+    topology.erase(unique(begin(topology), end(topology)), end(topology));
+    auto socket_count = empty(topology) ? size_t{0} : size_t{1};
+    for (auto i = size_t{1}; i < size(topology); ++i) {
+        socket_count += topology[i].first != topology[i - 1].first;
+    }
+
+    details.cpu_name = string{cpu_name};
+    details.cpu_core_count = thread_count;
+    details.cpu_physical_core_count = static_cast<int32_t>(size(topology));
+    details.cpu_socket_count = static_cast<int32_t>(socket_count);
+    // the probe runs on the cpu it describes, so the byte order it was built for is the byte order of the cpu
+    if constexpr (endian::native == endian::little || endian::native == endian::big) {
+        details.byte_order = endian::native;
+    }
+    LOG_VERBOSE("cpu '{}' has {} threads, {} cores and {} sockets",
+                cpu_name,
+                thread_count,
+                size(topology),
+                socket_count);
+}
+
+void GetLscpuCpuDetails(HardwareDetails &details) {
+    auto [cpu_name, cpu_count, byte_order] = GetLscpuInformation();
     details.cpu_core_count = cpu_count;
     details.cpu_name = cpu_name;
-    details.cpu_temperature = GetCpuTemperature();
     details.byte_order = byte_order;
-    details.gpu_name = GetGraphicsModelName();
-    details.gpu_temperature = GetGpuTemperature();
+}
+
+void GetCpuDetails(HardwareDetails &details, std::stop_token stop_token) {
+    if (auto cpuinfo = mmotd::core::ReadVirtualFile(PROC_CPUINFO_PATH); cpuinfo) {
+        GetCpuInfoDetails(details, *cpuinfo, SYSFS_CPU_DIRECTORY);
+    }
+    if (stop_token.stop_requested()) {
+        return;
+    }
+    // arm only lists the part number in /proc/cpuinfo, lscpu has the table which turns it into a model name
+    if (std::empty(details.cpu_name) || details.cpu_core_count == 0) {
+        LOG_VERBOSE("falling back to lscpu for the cpu details");
+        auto lscpu_details = HardwareDetails{};
+        GetLscpuCpuDetails(lscpu_details);
+        if (std::empty(details.cpu_name)) {
+            details.cpu_name = lscpu_details.cpu_name;
+        }
+        if (details.cpu_core_count == 0) {
+            details.cpu_core_count = lscpu_details.cpu_core_count;
+        }
+    }
+}
+
+vector<PciDeviceId> FindPciDisplayControllers(const fs::path &sysfs_pci_devices_directory) {
+    // sorted by pci address so the gpus are always listed in the same order
+    auto device_directories = vector<fs::path>{};
+    auto ec = error_code{};
+    for (const auto &entry : fs::directory_iterator(sysfs_pci_devices_directory, ec)) {
+        device_directories.push_back(entry.path());
+    }
+    if (ec) {
+        LOG_ERROR("unable to list pci devices in {}, {}", sysfs_pci_devices_directory.string(), ec.message());
+        return vector<PciDeviceId>{};
+    }
+    sort(begin(device_directories), end(device_directories));
+
+    auto display_controllers = vector<PciDeviceId>{};
+    for (const auto &device_directory : device_directories) {
+        auto device_class = ReadSysfsHexInteger(device_directory / "class");
+        if (!device_class || (*device_class >> 16) != PCI_DISPLAY_CONTROLLER_CLASS) {
+            continue;
+        }
+        auto vendor_id = ReadSysfsHexInteger(device_directory / "vendor");
+        auto device_id = ReadSysfsHexInteger(device_directory / "device");
+        if (!vendor_id || !device_id) {
+            LOG_ERROR("unable to read the vendor and device ids of {}", device_directory.string());
+            continue;
+        }
+        LOG_VERBOSE("found display controller {:04x}:{:04x} at {}",
+                    *vendor_id,
+                    *device_id,
+                    device_directory.filename().string());
+        display_controllers.push_back(
+            PciDeviceId{static_cast<uint16_t>(*vendor_id), static_cast<uint16_t>(*device_id)});
+    }
+    return display_controllers;
+}
+
+string GetPciDeviceName(const PciIds *pci_ids, PciDeviceId pci_device_id) {
+    auto [vendor_id, device_id] = pci_device_id;
+    auto vendor_name = pci_ids != nullptr ? pci_ids->FindVendorName(vendor_id) : nullopt;
+    auto device_name = pci_ids != nullptr ? pci_ids->FindDeviceName(vendor_id, device_id) : nullopt;
+    if (vendor_name && device_name) {
+        return format(FMT_STRING("{} {}"), *vendor_name, *device_name);
+    } else if (vendor_name) {
+        return format(FMT_STRING("{} {:04x}"), *vendor_name, device_id);
+    }
+    return format(FMT_STRING("{:04x}:{:04x}"), vendor_id, device_id);
+}
+
+void GetGpuDetails(HardwareDetails &details, const fs::path &cache_directory, std::stop_token stop_token) {
+    auto display_controllers = FindPciDisplayControllers(SYSFS_PCI_DEVICES_DIRECTORY);
+    if (stop_token.stop_requested()) {
+        return;
+    }
+    // pci.ids is only opened (and its index built) once there is a gpu to name
+    auto pci_ids = empty(display_controllers) ? optional<PciIds>{} : PciIds::Open(cache_directory);
+    details.gpu_names.clear();
+    for (auto display_controller : display_controllers) {
+        details.gpu_names.push_back(GetPciDeviceName(pci_ids ? &*pci_ids : nullptr, display_controller));
+    }
     details.monitor_name = GetMonitorName();
     details.monitor_resolution = GetMonitorResolution();
-
-    return details;
 }
 
 } // namespace mmotd::platform
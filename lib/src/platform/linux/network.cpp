@@ -6,6 +6,7 @@
 #include "common/include/posix_error.h"
 #include "lib/include/platform/network.h"
 
+#include <array>
 #include <cstring>
 #include <optional>
 #include <regex>
@@ -22,9 +23,12 @@
 #include <net/if.h>
 #include <netinet/in.h>
 #include <sys/ioctl.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
 #include <linux/if_packet.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
 
 using boost::asio::ip::address;
 using boost::asio::ip::make_address;
@@ -151,6 +155,12 @@ void AddIpAddress(NetworkDevices &network_devices, const struct ifaddrs *ifaddrs
     }
 }
 
+// A unicast route with a zero length destination prefix, in any routing table, is a default route
+bool IsDefaultRoute(const nlmsghdr *message) {
+    const auto *route = static_cast<const rtmsg *>(NLMSG_DATA(message));
+    return message->nlmsg_type == RTM_NEWROUTE && route->rtm_dst_len == 0 && route->rtm_type == RTN_UNICAST;
+}
+
 } // namespace
 
 namespace mmotd::platform {
@@ -186,5 +196,51 @@ NetworkDevices GetNetworkDevices() {
     return network_devices;
 }
 
+bool HasDefaultRoute() {
+    // dumps the ipv4 and ipv6 routes over rtnetlink, any error means the routes are unknown and assumes a route
+    int sock = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (sock == -1) {
+        LOG_ERROR("opening netlink socket failed, details: {}", mmotd::error::posix_error::to_string());
+        return true;
+    }
+    auto socket_closer = sg::make_scope_guard([sock]() noexcept { close(sock); });
+
+    struct {
+        nlmsghdr header;
+        rtmsg route;
+    } request{};
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(rtmsg));
+    request.header.nlmsg_type = RTM_GETROUTE;
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.header.nlmsg_seq = 1;
+    request.route.rtm_family = AF_UNSPEC;
+    if (send(sock, &request, request.header.nlmsg_len, 0) == -1) {
+        LOG_ERROR("sending netlink route request failed, details: {}", mmotd::error::posix_error::to_string());
+        return true;
+    }
+
+    alignas(nlmsghdr) auto buffer = array<char, 16384>{};
+    for (;;) {
+        auto received = recv(sock, data(buffer), size(buffer), 0);
+        if (received <= 0) {
+            LOG_ERROR("receiving netlink routes failed, details: {}", mmotd::error::posix_error::to_string());
+            return true;
+        }
+        auto length = static_cast<unsigned int>(received);
+        for (auto *message = reinterpret_cast<const nlmsghdr *>(data(buffer)); NLMSG_OK(message, length);
+             message = NLMSG_NEXT(message, length)) {
+            if (message->nlmsg_type == NLMSG_DONE) {
+                LOG_VERBOSE("no default route found");
+                return false;
+            } else if (message->nlmsg_type == NLMSG_ERROR) {
+                LOG_ERROR("netlink route request returned an error");
+                return true;
+            } else if (IsDefaultRoute(message)) {
+                return true;
+            }
+        }
+    }
+}
+
 } // namespace mmotd::platform
 #endif
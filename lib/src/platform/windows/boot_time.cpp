@@ -39,5 +39,9 @@ optional<string> GetBootTime() {
     return nullopt;
 }
 
+optional<string> GetBootId() {
+    return nullopt;
+}
+
 } // namespace mmotd::platform
 #endif
@@ -1,7 +1,9 @@
 // vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
 #if defined(_WIN32)
-#include "lib/include/platform/system_information.h"
+#include "lib/include/platform/hardware_information.h"
 
+#include <filesystem>
+#include <stop_token>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -10,9 +12,11 @@ using namespace std;
 
 namespace mmotd::platform {
 
-HardwareDetails GetHardwareInformationDetails() {
-    return HardwareDetails{};
-}
+void GetMachineDetails(HardwareDetails &) {}
+
+void GetCpuDetails(HardwareDetails &, std::stop_token) {}
+
+void GetGpuDetails(HardwareDetails &, const std::filesystem::path &, std::stop_token) {}
 
 } // namespace mmotd::platform
 #endif
@@ -11,5 +11,9 @@ NetworkDetails GetNetworkDetails() {
     return NetworkDetails{};
 }
 
+bool HasDefaultRoute() {
+    return true;
+}
+
 } // namespace mmotd::platform
 #endif
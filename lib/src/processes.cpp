@@ -16,14 +16,16 @@ bool gLinkProcessesInfo = false;
 namespace mmotd::information {
 
 static const bool processes_information_factory_registered =
-    RegisterInformationProvider([]() { return make_unique<mmotd::information::Processes>(); });
+    RegisterInformationProvider("processes",
+                                []() { return make_unique<mmotd::information::Processes>(); },
+                                {InformationId::ID_PROCESSES_PROCESS_COUNT});
 
-void Processes::FindInformation() {
+void Processes::FindInformation(std::stop_token) {
     auto processes_count_holder = mmotd::platform::GetProcessCount();
     auto processes_count = processes_count_holder ? *processes_count_holder : size_t{0};
 
     auto process_count = GetInfoTemplate(InformationId::ID_PROCESSES_PROCESS_COUNT);
-    process_count.SetValueArgs(processes_count);
+    process_count.SetValue(processes_count);
     AddInformation(process_count);
 }
 
@@ -0,0 +1,129 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/line_parser.h"
+#include "lib/include/solar_events.h"
+
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <optional>
+#include <string_view>
+#include <system_error>
+
+#include <date/date.h>
+
+using namespace std;
+
+namespace {
+
+// The zenith of the center of the sun at sunrise includes 34' of refraction and its 16' radius
+constexpr auto SUNRISE_ZENITH = 90.833;
+constexpr auto CIVIL_TWILIGHT_ZENITH = 96.0;
+constexpr auto JULIAN_DAY_OF_UNIX_EPOCH = 2440587.5;
+constexpr auto JULIAN_DAY_OF_J2000 = 2451545.0;
+constexpr auto MINUTES_PER_DAY = 1440.0;
+
+double ToRadians(double degrees) {
+    return degrees * numbers::pi / 180.0;
+}
+
+double ToDegrees(double radians) {
+    return radians * 180.0 / numbers::pi;
+}
+
+struct SolarPosition {
+    double declination;           // radians
+    double equation_of_time;      // minutes
+};
+
+// The position of the sun at `julian_day`, `t` is the number of julian centuries since J2000.0
+SolarPosition GetSolarPosition(double julian_day) {
+    auto t = (julian_day - JULIAN_DAY_OF_J2000) / 36525.0;
+    auto mean_longitude = ToRadians(fmod(280.46646 + t * (36000.76983 + t * 0.0003032), 360.0));
+    auto mean_anomaly = ToRadians(357.52911 + t * (35999.05029 - 0.0001537 * t));
+    auto eccentricity = 0.016708634 - t * (0.000042037 + 0.0000001267 * t);
+    auto equation_of_center = sin(mean_anomaly) * (1.914602 - t * (0.004817 + 0.000014 * t)) +
+                              sin(2.0 * mean_anomaly) * (0.019993 - 0.000101 * t) +
+                              sin(3.0 * mean_anomaly) * 0.000289;
+    auto omega = ToRadians(125.04 - 1934.136 * t);
+    auto apparent_longitude = ToRadians(ToDegrees(mean_longitude) + equation_of_center - 0.00569 -
+                                        0.00478 * sin(omega));
+    auto mean_obliquity_seconds = 21.448 - t * (46.8150 + t * (0.00059 - t * 0.001813));
+    auto mean_obliquity = 23.0 + (26.0 + mean_obliquity_seconds / 60.0) / 60.0;
+    auto obliquity = ToRadians(mean_obliquity + 0.00256 * cos(omega));
+
+    auto y = pow(tan(obliquity / 2.0), 2.0);
+    auto equation_of_time = y * sin(2.0 * mean_longitude) - 2.0 * eccentricity * sin(mean_anomaly) +
+                            4.0 * eccentricity * y * sin(mean_anomaly) * cos(2.0 * mean_longitude) -
+                            0.5 * y * y * sin(4.0 * mean_longitude) -
+                            1.25 * eccentricity * eccentricity * sin(2.0 * mean_anomaly);
+    return SolarPosition{asin(sin(obliquity) * sin(apparent_longitude)), ToDegrees(equation_of_time) * 4.0};
+}
+
+// The minutes after midnight UTC of `midnight` the sun reaches `zenith`, rising in the morning or setting in the
+//  evening, or nothing when it never does
+optional<double> GetMinutesOfEvent(double midnight, mmotd::astronomy::Coordinates coordinates, double zenith,
+                                   bool rising) {
+    auto latitude = ToRadians(coordinates.latitude);
+    // the position at noon gives the first estimate, which is refined once with the position at that estimate
+    auto minutes = MINUTES_PER_DAY / 2.0 - 4.0 * coordinates.longitude;
+    for (auto i = 0; i != 2; ++i) {
+        auto position = GetSolarPosition(midnight + minutes / MINUTES_PER_DAY);
+        auto cos_hour_angle = cos(ToRadians(zenith)) / (cos(latitude) * cos(position.declination)) -
+                              tan(latitude) * tan(position.declination);
+        if (cos_hour_angle < -1.0 || cos_hour_angle > 1.0) {
+            return nullopt;
+        }
+        auto hour_angle = ToDegrees(acos(cos_hour_angle));
+        if (!rising) {
+            hour_angle = -hour_angle;
+        }
+        minutes = MINUTES_PER_DAY / 2.0 - 4.0 * (coordinates.longitude + hour_angle) - position.equation_of_time;
+    }
+    return minutes;
+}
+
+} // namespace
+
+namespace mmotd::astronomy {
+
+optional<Coordinates> ParseCoordinates(string_view coordinates) {
+    auto comma = coordinates.find(',');
+    if (comma == string_view::npos) {
+        return nullopt;
+    }
+    auto to_degrees = [](string_view str) -> optional<double> {
+        str = mmotd::core::TrimBlanks(str);
+        auto value = 0.0;
+        auto [p, ec] = from_chars(data(str), data(str) + size(str), value);
+        if (ec != std::errc() || p != data(str) + size(str)) {
+            return nullopt;
+        }
+        return value;
+    };
+    auto latitude = to_degrees(coordinates.substr(0, comma));
+    auto longitude = to_degrees(coordinates.substr(comma + 1));
+    if (!latitude || !longitude || fabs(*latitude) > 90.0 || fabs(*longitude) > 180.0) {
+        return nullopt;
+    }
+    return Coordinates{*latitude, *longitude};
+}
+
+SolarEvents ComputeSolarEvents(date::year_month_day day, Coordinates coordinates) {
+    auto midnight = date::sys_days{day};
+    auto julian_midnight = static_cast<double>(midnight.time_since_epoch().count()) + JULIAN_DAY_OF_UNIX_EPOCH;
+    auto to_time_point = [midnight](optional<double> minutes) -> optional<date::sys_seconds> {
+        if (!minutes) {
+            return nullopt;
+        }
+        return midnight + chrono::seconds{lround(*minutes * 60.0)};
+    };
+    auto events = SolarEvents{};
+    events.civil_dawn = to_time_point(GetMinutesOfEvent(julian_midnight, coordinates, CIVIL_TWILIGHT_ZENITH, true));
+    events.sunrise = to_time_point(GetMinutesOfEvent(julian_midnight, coordinates, SUNRISE_ZENITH, true));
+    events.sunset = to_time_point(GetMinutesOfEvent(julian_midnight, coordinates, SUNRISE_ZENITH, false));
+    events.civil_dusk = to_time_point(GetMinutesOfEvent(julian_midnight, coordinates, CIVIL_TWILIGHT_ZENITH, false));
+    return events;
+}
+
+} // namespace mmotd::astronomy
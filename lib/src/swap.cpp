@@ -15,25 +15,29 @@ bool gLinkSwapUsage = false;
 namespace mmotd::information {
 
 static const bool swap_usage_factory_registered =
-    RegisterInformationProvider([]() { return make_unique<mmotd::information::Swap>(); });
+    RegisterInformationProvider("swap",
+                                []() { return make_unique<mmotd::information::Swap>(); },
+                                {InformationId::ID_SWAP_USAGE_ENCRYPTED, InformationId::ID_SWAP_USAGE_FREE,
+                                 InformationId::ID_SWAP_USAGE_PERCENT_USED, InformationId::ID_SWAP_USAGE_SUMMARY,
+                                 InformationId::ID_SWAP_USAGE_TOTAL});
 
-void Swap::FindInformation() {
+void Swap::FindInformation(std::stop_token) {
     auto details = mmotd::platform::GetSwapDetails();
 
     auto total = GetInfoTemplate(InformationId::ID_SWAP_USAGE_TOTAL);
-    total.SetValueArgs(to_human_size(details.total));
+    total.SetValue(to_human_size(details.total));
     AddInformation(total);
 
     auto free = GetInfoTemplate(InformationId::ID_SWAP_USAGE_FREE);
-    free.SetValueArgs(details.free);
+    free.SetValue(details.free);
     AddInformation(free);
 
     auto percent_used = GetInfoTemplate(InformationId::ID_SWAP_USAGE_PERCENT_USED);
-    percent_used.SetValueArgs(details.percent_used);
+    percent_used.SetValue(details.percent_used);
     AddInformation(percent_used);
 
     auto encrypted = GetInfoTemplate(InformationId::ID_SWAP_USAGE_ENCRYPTED);
-    encrypted.SetValueArgs(details.encrypted ? "[encrypted]" : "[un-encrypted]");
+    encrypted.SetValue(details.encrypted ? "[encrypted]" : "[un-encrypted]");
     AddInformation(encrypted);
 
     auto summary = GetInfoTemplate(InformationId::ID_SWAP_USAGE_SUMMARY);
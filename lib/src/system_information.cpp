@@ -14,9 +14,18 @@ bool gLinkSystemInformation = false;
 namespace mmotd::information {
 
 static const bool system_information_factory_registered =
-    RegisterInformationProvider([]() { return make_unique<mmotd::information::SystemInformation>(); });
+    RegisterInformationProvider("system_information",
+                                []() { return make_unique<mmotd::information::SystemInformation>(); },
+                                {InformationId::ID_SYSTEM_INFORMATION_ARCHITECTURE,
+                                 InformationId::ID_SYSTEM_INFORMATION_COMPUTER_NAME,
+                                 InformationId::ID_SYSTEM_INFORMATION_HOST_NAME,
+                                 InformationId::ID_SYSTEM_INFORMATION_KERNEL_RELEASE,
+                                 InformationId::ID_SYSTEM_INFORMATION_KERNEL_TYPE,
+                                 InformationId::ID_SYSTEM_INFORMATION_KERNEL_VERSION,
+                                 InformationId::ID_SYSTEM_INFORMATION_PLATFORM_NAME,
+                                 InformationId::ID_SYSTEM_INFORMATION_PLATFORM_VERSION});
 
-void SystemInformation::FindInformation() {
+void SystemInformation::FindInformation(std::stop_token) {
     auto details = mmotd::platform::GetSystemInformationDetails();
     if (!details.empty()) {
         CreateInformationObjects(details);
@@ -25,35 +34,35 @@ void SystemInformation::FindInformation() {
 
 void SystemInformation::CreateInformationObjects(const mmotd::platform::SystemDetails &details) {
     auto host_name = GetInfoTemplate(InformationId::ID_SYSTEM_INFORMATION_HOST_NAME);
-    host_name.SetValueArgs(details.host_name);
+    host_name.SetValue(details.host_name);
     AddInformation(host_name);
 
     auto computer_name = GetInfoTemplate(InformationId::ID_SYSTEM_INFORMATION_COMPUTER_NAME);
-    computer_name.SetValueArgs(details.computer_name);
+    computer_name.SetValue(details.computer_name);
     AddInformation(computer_name);
 
     auto kernel_version = GetInfoTemplate(InformationId::ID_SYSTEM_INFORMATION_KERNEL_VERSION);
-    kernel_version.SetValueArgs(details.kernel_version);
+    kernel_version.SetValue(details.kernel_version);
     AddInformation(kernel_version);
 
     auto kernel_release = GetInfoTemplate(InformationId::ID_SYSTEM_INFORMATION_KERNEL_RELEASE);
-    kernel_release.SetValueArgs(details.kernel_release);
+    kernel_release.SetValue(details.kernel_release);
     AddInformation(kernel_release);
 
     auto kernel_type = GetInfoTemplate(InformationId::ID_SYSTEM_INFORMATION_KERNEL_TYPE);
-    kernel_type.SetValueArgs(details.kernel_type);
+    kernel_type.SetValue(details.kernel_type);
     AddInformation(kernel_type);
 
     auto architecture_type = GetInfoTemplate(InformationId::ID_SYSTEM_INFORMATION_ARCHITECTURE);
-    architecture_type.SetValueArgs(details.architecture_type);
+    architecture_type.SetValue(details.architecture_type);
     AddInformation(architecture_type);
 
     auto platform_version = GetInfoTemplate(InformationId::ID_SYSTEM_INFORMATION_PLATFORM_VERSION);
-    platform_version.SetValueArgs(details.platform_version);
+    platform_version.SetValue(details.platform_version);
     AddInformation(platform_version);
 
     auto platform_name = GetInfoTemplate(InformationId::ID_SYSTEM_INFORMATION_PLATFORM_NAME);
-    platform_name.SetValueArgs(details.platform_name);
+    platform_name.SetValue(details.platform_name);
     AddInformation(platform_name);
 }
 
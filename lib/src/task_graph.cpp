@@ -0,0 +1,109 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/assertion/include/assertion.h"
+#include "common/assertion/include/throw.h"
+#include "common/include/logging.h"
+#include "lib/include/task_graph.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/exception/diagnostic_information.hpp>
+#include <fmt/format.h>
+
+using namespace std;
+
+namespace mmotd::information {
+
+// The state of a single posted run of the graph, shared by its tasks so it lives until the last one finishes
+struct TaskGraph::Execution {
+    Execution(boost::asio::thread_pool &pool, vector<Node> task_nodes) :
+        thread_pool(pool), nodes(std::move(task_nodes)), remaining(std::size(nodes)) {
+        for (auto id = TaskId{0}; id != std::size(nodes); ++id) {
+            remaining[id] = nodes[id].dependency_count;
+        }
+    }
+
+    boost::asio::thread_pool &thread_pool;
+    const vector<Node> nodes;
+    mutex lock;
+    // the number of dependencies of each task which have not finished yet
+    vector<size_t> remaining;
+};
+
+TaskGraph::TaskId TaskGraph::AddTask(string name, Task task, const TaskIds &dependencies) {
+    auto id = std::size(nodes_);
+    for (auto dependency : dependencies) {
+        PRECONDITIONS(dependency < id, "task '{}' depends on task {} which has not been added", name, dependency);
+        nodes_[dependency].dependents.push_back(id);
+    }
+    nodes_.push_back(Node{std::move(name), std::move(task), TaskIds{}, std::size(dependencies)});
+    return id;
+}
+
+size_t TaskGraph::size() const noexcept {
+    return std::size(nodes_);
+}
+
+bool TaskGraph::empty() const noexcept {
+    return std::empty(nodes_);
+}
+
+void TaskGraph::Run() const {
+    // a task only depends on the tasks added before it so the insertion order is already a valid order
+    for (const auto &node : nodes_) {
+        RunTask(node);
+    }
+}
+
+void TaskGraph::Post(boost::asio::thread_pool &thread_pool) const {
+    auto execution = make_shared<Execution>(thread_pool, nodes_);
+    for (auto id = TaskId{0}; id != std::size(nodes_); ++id) {
+        if (nodes_[id].dependency_count == 0) {
+            PostTask(execution, id);
+        }
+    }
+}
+
+void TaskGraph::PostTask(shared_ptr<Execution> execution, TaskId id) {
+    auto &thread_pool = execution->thread_pool;
+    boost::asio::post(thread_pool, [execution = std::move(execution), id]() {
+        const auto &node = execution->nodes[id];
+        RunTask(node);
+
+        auto ready = TaskIds{};
+        {
+            auto lock = lock_guard<mutex>{execution->lock};
+            for (auto dependent : node.dependents) {
+                if (--execution->remaining[dependent] == 0) {
+                    ready.push_back(dependent);
+                }
+            }
+        }
+        for (auto dependent : ready) {
+            PostTask(execution, dependent);
+        }
+    });
+}
+
+void TaskGraph::RunTask(const Node &node) {
+    LOG_DEBUG("running task '{}'", node.name);
+    auto exception_message = string{};
+    // the dependents still run when a task fails, they are left to cope with the missing results
+    try {
+        node.task();
+    } catch (boost::exception &ex) {
+        exception_message = mmotd::assertion::GetBoostExceptionMessage(ex);
+    } catch (const std::exception &ex) {
+        exception_message = mmotd::assertion::GetStdExceptionMessage(ex);
+    } catch (...) { exception_message = mmotd::assertion::GetUnknownExceptionMessage(); }
+
+    if (!std::empty(exception_message)) {
+        LOG_ERROR("task '{}' failed: {}", node.name, exception_message);
+    }
+}
+
+} // namespace mmotd::information
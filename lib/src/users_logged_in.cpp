@@ -19,12 +19,14 @@ bool gLinkUsersLoggedIn = false;
 namespace mmotd::information {
 
 static const bool users_logged_in_factory_registered =
-    RegisterInformationProvider([]() { return make_unique<mmotd::information::UsersLoggedIn>(); });
+    RegisterInformationProvider("users_logged_in",
+                                []() { return make_unique<mmotd::information::UsersLoggedIn>(); },
+                                {InformationId::ID_LOGGED_IN_USER_LOGGED_IN});
 
-void UsersLoggedIn::FindInformation() {
+void UsersLoggedIn::FindInformation(std::stop_token) {
     if (auto logged_in = GetUsersLoggedIn(); !logged_in.empty()) {
         auto logged = GetInfoTemplate(InformationId::ID_LOGGED_IN_USER_LOGGED_IN);
-        logged.SetValueArgs(logged_in);
+        logged.SetValue(logged_in);
         AddInformation(logged);
     }
 }
@@ -7,41 +7,93 @@
 #include "common/include/logging.h"
 #include "lib/include/computer_information.h"
 #include "lib/include/http_request.h"
+#include "lib/include/solar_events.h"
 
+#include <chrono>
 #include <iterator>
-#include <regex>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include <boost/algorithm/string.hpp>
+#include <date/date.h>
+#include <date/tz.h>
 #include <fmt/format.h>
 
 using namespace std;
 using namespace std::string_literals;
+using namespace std::string_view_literals;
 
 bool gLinkWeatherInfo = false;
 
 namespace {
 
-static constexpr auto WEATHER_SERVICE_URL = string_view{"wttr.in"};
-static constexpr auto WEATHER_QUERY = string_view{"u&format=%l:+%t+%c+%C+%w+%m+%S+%s&lang=en"};
+static constexpr auto DEFAULT_WEATHER_ENDPOINT = string_view{"https://wttr.in"};
+// sunrise and sunset are computed locally, the weather service is only asked for the weather
+static constexpr auto WEATHER_QUERY = string_view{"u&format=%l:+%t+%c+%C+%w+%m&lang=en"};
+static constexpr auto SOLAR_EVENT_FORMAT = "%I:%M:%S%p";
 
-// parse input as : "[00-23]h[00-59]m[00-59]s"
-// print output as: "[01-12]h[00-59]m[00-59]s[am|pm]"
-optional<string> ParseTodPrintTod(string input) {
-    using namespace mmotd::chrono::io;
-    if (auto time_of_day_holder = time_from_string(input, "%H:%M:%S"); time_of_day_holder.has_value()) {
-        return to_string(*time_of_day_holder, "%I:%M:%S%p");
+bool IsLocationConfigured() {
+    using namespace mmotd::core;
+    return !empty(ConfigOptions::Instance().GetString("location.city"s, std::string{})) ||
+           !empty(ConfigOptions::Instance().GetString("location.state"s, std::string{})) ||
+           !empty(ConfigOptions::Instance().GetString("location.country"s, std::string{}));
+}
+
+// A latitude or longitude in the config file, "35" is read as well as "35.0"
+optional<double> GetConfigDegrees(string_view name) {
+    using namespace mmotd::core;
+    if (auto degrees = ConfigOptions::Instance().GetDouble(name); degrees) {
+        return degrees;
+    } else if (auto integer_degrees = ConfigOptions::Instance().GetInteger(name); integer_degrees) {
+        return static_cast<double>(*integer_degrees);
     }
     return nullopt;
 }
 
-string GetLocation(string seperator) {
+bool AreCoordinatesConfigured() {
+    return GetConfigDegrees("location.latitude"sv).has_value() && GetConfigDegrees("location.longitude"sv).has_value();
+}
+
+// The configured coordinates, or the gps location the external network provider found
+optional<mmotd::astronomy::Coordinates> GetCoordinates(const mmotd::information::Informations *external_network) {
+    using mmotd::information::InformationId;
+    auto latitude = GetConfigDegrees("location.latitude"sv);
+    auto longitude = GetConfigDegrees("location.longitude"sv);
+    if (latitude && longitude) {
+        return mmotd::astronomy::Coordinates{*latitude, *longitude};
+    } else if (external_network != nullptr) {
+        const auto &entries = external_network->at(InformationId::ID_LOCATION_INFO_GPS_LOCATION);
+        if (!empty(entries)) {
+            return mmotd::astronomy::ParseCoordinates(entries.front().GetValue());
+        }
+    }
+    return nullopt;
+}
+
+// Today in the configured time zone ('location.timezone') or else the time zone of the computer
+date::year_month_day GetLocalDay() {
+    auto now = date::make_zoned(mmotd::chrono::io::GetTimeZone(), chrono::system_clock::now());
+    return date::year_month_day{date::floor<date::days>(now.get_local_time())};
+}
+
+string GetLocation(string seperator, const mmotd::information::Informations *external_network) {
     using namespace mmotd::core;
+    using mmotd::information::InformationId;
     auto city = ConfigOptions::Instance().GetString("location.city"s, std::string{});
     auto state = ConfigOptions::Instance().GetString("location.state"s, std::string{});
     auto country = ConfigOptions::Instance().GetString("location.country"s, std::string{});
+    if (empty(city) && empty(state) && empty(country) && external_network != nullptr) {
+        // reuse the location the external network provider found instead of having the weather service find it
+        auto get_value = [external_network](InformationId id) {
+            const auto &entries = external_network->at(id);
+            return empty(entries) ? string{} : entries.front().GetValue();
+        };
+        city = get_value(InformationId::ID_LOCATION_INFO_CITY);
+        state = get_value(InformationId::ID_LOCATION_INFO_STATE);
+        country = get_value(InformationId::ID_LOCATION_INFO_COUNTRY);
+    }
     // return fmt::format(FMT_STRING("{} {} {}"), city, state, country);
     return boost::join_if(vector{city, state, country}, seperator, [](const auto &str) { return !empty(str); });
 }
@@ -54,14 +106,14 @@ bool IsWeatherResponseInvalid(const string &response) {
 // "http://wttr.in/?u&format=%l:+%t+%c+%C+%w+%m+%S+%s&lang=en"
 // "http://wttr.in/Albuquerque%20NM%20USA?u&format=%l:+%t+%c+%C+%w+%m+%S+%s&lang=en"
 // return format(FMT_STRING("/{}?u&format=%l:+%t+%c+%C+%w+%m+%S+%s&lang=en"), location);
-optional<string> RequestWeatherData() {
+optional<string> RequestWeatherData(const string &location_path, std::stop_token stop_token) {
     using namespace mmotd::networking;
-    auto location_path = GetLocation(" "s);
     CHECKS(size(location_path) < size_t{256},
            "location city, state, country length ({}) is larger than maximum size",
            size(location_path));
-    auto response = HttpRequest::Get(HttpProtocol::HTTPS, WEATHER_SERVICE_URL, location_path, WEATHER_QUERY);
-    auto url = HttpRequest::GetUrl(HttpProtocol::HTTPS, WEATHER_SERVICE_URL, location_path, WEATHER_QUERY);
+    auto endpoint = HttpRequest::GetEndpoint("network.weather_endpoint"sv, DEFAULT_WEATHER_ENDPOINT);
+    auto response = HttpRequest::Get(endpoint.protocol, endpoint.host, location_path, WEATHER_QUERY, stop_token);
+    auto url = HttpRequest::GetUrl(endpoint.protocol, endpoint.host, location_path, WEATHER_QUERY);
     if (!response) {
         LOG_ERROR("weather response '{}': nullptr", url);
         return nullopt;
@@ -77,47 +129,69 @@ optional<string> RequestWeatherData() {
 namespace mmotd::information {
 
 static const bool users_logged_in_factory_registered =
-    RegisterInformationProvider([]() { return make_unique<mmotd::information::WeatherInfo>(); });
+    RegisterInformationProvider("weather",
+                                []() { return make_unique<mmotd::information::WeatherInfo>(); },
+                                {InformationId::ID_WEATHER_LOCATION, InformationId::ID_WEATHER_SUNRISE,
+                                 InformationId::ID_WEATHER_SUNSET, InformationId::ID_WEATHER_CIVIL_DAWN,
+                                 InformationId::ID_WEATHER_CIVIL_DUSK, InformationId::ID_WEATHER_WEATHER});
+
+vector<string_view> WeatherInfo::GetDependencyNames() const {
+    // waiting on the external network lookup is only worth it when it supplies the location or the coordinates
+    if (IsLocationConfigured() && AreCoordinatesConfigured()) {
+        return {};
+    }
+    return {"external_network"sv};
+}
 
-void WeatherInfo::FindInformation() {
-    auto weather_data = GetWeatherInfo();
+void WeatherInfo::FindInformation(std::stop_token stop_token) {
+    AddSolarEvents();
+
+    auto weather_data = GetWeatherInfo(stop_token);
     if (!weather_data) {
         return;
     }
 
-    auto [location_str, weather_str, sunrise_str, sunset_str] = weather_data.value();
+    auto [location_str, weather_str] = weather_data.value();
     auto weather = GetInfoTemplate(InformationId::ID_WEATHER_WEATHER);
-    weather.SetValueArgs(weather_str);
+    weather.SetValue(weather_str);
     AddInformation(weather);
 
-    if (!empty(sunrise_str)) {
-        auto sunrise = GetInfoTemplate(InformationId::ID_WEATHER_SUNRISE);
-        sunrise.SetValueArgs(sunrise_str);
-        AddInformation(sunrise);
-    }
-
-    if (!empty(sunset_str)) {
-        auto sunset = GetInfoTemplate(InformationId::ID_WEATHER_SUNSET);
-        sunset.SetValueArgs(sunset_str);
-        AddInformation(sunset);
-    }
-
     if (empty(location_str)) {
         return;
     }
 
     auto location = GetInfoTemplate(InformationId::ID_WEATHER_LOCATION);
-    location.SetValueArgs(location_str);
+    location.SetValue(location_str);
     AddInformation(location);
 }
 
-optional<WeatherInfo::WeatherData> WeatherInfo::GetWeatherInfo() {
-    auto weather_response = RequestWeatherData();
+void WeatherInfo::AddSolarEvents() {
+    auto coordinates = GetCoordinates(GetDependencyInformations("external_network"sv));
+    if (!coordinates) {
+        LOG_WARNING("sunrise and sunset need 'location.latitude' and 'location.longitude' or the external location");
+        return;
+    }
+    auto events = mmotd::astronomy::ComputeSolarEvents(GetLocalDay(), *coordinates);
+    auto add_event = [this](InformationId id, const optional<date::sys_seconds> &event) {
+        if (event) {
+            auto information = GetInfoTemplate(id);
+            information.SetValue(mmotd::chrono::io::to_string(*event, SOLAR_EVENT_FORMAT));
+            AddInformation(information);
+        }
+    };
+    add_event(InformationId::ID_WEATHER_CIVIL_DAWN, events.civil_dawn);
+    add_event(InformationId::ID_WEATHER_SUNRISE, events.sunrise);
+    add_event(InformationId::ID_WEATHER_SUNSET, events.sunset);
+    add_event(InformationId::ID_WEATHER_CIVIL_DUSK, events.civil_dusk);
+}
+
+optional<WeatherInfo::WeatherData> WeatherInfo::GetWeatherInfo(std::stop_token stop_token) {
+    auto location_str = GetLocation(" "s, GetDependencyInformations("external_network"sv));
+    auto weather_response = RequestWeatherData(location_str, stop_token);
     if (!weather_response) {
         return nullopt;
     }
 
-    auto location_str = GetLocation(" "s);
     auto weather_str = *weather_response;
     if (auto i = weather_str.find_first_of(':'); i != string::npos) {
         location_str = boost::trim_copy(weather_str.substr(0, i));
@@ -126,30 +200,12 @@ optional<WeatherInfo::WeatherData> WeatherInfo::GetWeatherInfo() {
         LOG_ERROR("weather response appears to be malformed");
         return nullopt;
     }
-
-    const auto sunrise_sunset_regex = regex(R"((\d{2}:\d{2}:\d{2}) (\d{2}:\d{2}:\d{2}))", std::regex::ECMAScript);
-    auto match = smatch{};
-    if (!regex_search(weather_str, match, sunrise_sunset_regex)) {
-        LOG_ERROR("weather information does not seem to include sunrise and sunset");
+    if (empty(weather_str)) {
+        LOG_ERROR("weather data appears to be malformed (weather empty)");
         return nullopt;
     }
-
-    auto weather = boost::trim_copy(weather_str.substr(0, static_cast<size_t>(match.position(0))));
-    LOG_VERBOSE("weather: '{}'", weather);
-    auto sunrise_str = weather_str.substr(static_cast<size_t>(match.position(1)), static_cast<size_t>(match.length(1)));
-    LOG_VERBOSE("sunrise: '{}'", sunrise_str);
-    auto sunset_str = weather_str.substr(static_cast<size_t>(match.position(2)), static_cast<size_t>(match.length(2)));
-    LOG_VERBOSE("sunset: '{}'", sunset_str);
-    if (empty(weather) || empty(sunrise_str) || empty(sunset_str)) {
-        LOG_ERROR("weather data appears to be malformed (weather, sunrise or sunset empty)");
-        return nullopt;
-    }
-
-    auto sunrise_parsed = ParseTodPrintTod(sunrise_str);
-    auto sunset_parsed = ParseTodPrintTod(sunset_str);
-
-    LOG_VERBOSE("weather: '{}, Sunrise (parsed): {}, Sunset (parsed): {}'", weather, *sunrise_parsed, *sunset_parsed);
-    return make_tuple(location_str, weather, *sunrise_parsed, *sunset_parsed);
+    LOG_VERBOSE("weather: '{}'", weather_str);
+    return make_pair(location_str, weather_str);
 }
 
 } // namespace mmotd::information
@@ -0,0 +1,217 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#if !defined(_WIN32)
+#include "common/assertion/include/assertion.h"
+#include "common/include/config_options.h"
+#include "lib/test/src/local_http_server.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+constexpr auto POLL_INTERVAL_MS = 50;
+constexpr auto MAX_REQUEST_SIZE = size_t{65536};
+
+string_view GetReasonPhrase(int status_code) {
+    switch (status_code) {
+        case 200:
+            return "OK";
+        case 304:
+            return "Not Modified";
+        case 404:
+            return "Not Found";
+        case 429:
+            return "Too Many Requests";
+        case 500:
+            return "Internal Server Error";
+        case 503:
+            return "Service Unavailable";
+        default:
+            return "Unknown";
+    }
+}
+
+bool SendAll(int connection, string_view buffer) {
+    while (!empty(buffer)) {
+        auto sent = send(connection, data(buffer), size(buffer), MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return false;
+        }
+        buffer.remove_prefix(static_cast<size_t>(sent));
+    }
+    return true;
+}
+
+// Sleeps in short steps so the server can be stopped in the middle of an injected delay
+bool SleepFor(chrono::milliseconds duration, const std::stop_token &stop_token) {
+    auto deadline = chrono::steady_clock::now() + duration;
+    while (!stop_token.stop_requested() && chrono::steady_clock::now() < deadline) {
+        auto remaining = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now());
+        this_thread::sleep_for(min(remaining, chrono::milliseconds{POLL_INTERVAL_MS}));
+    }
+    return !stop_token.stop_requested();
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+LocalHttpServer::LocalHttpServer(Handler handler) : handler_(std::move(handler)) {
+    listener_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listener_ == -1) {
+        THROW_RUNTIME_ERROR("unable to create the listening socket, {}", strerror(errno));
+    }
+    auto address = sockaddr_in{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    auto address_size = socklen_t{sizeof(address)};
+    if (bind(listener_, reinterpret_cast<const sockaddr *>(&address), address_size) == -1 ||
+        listen(listener_, SOMAXCONN) == -1 ||
+        getsockname(listener_, reinterpret_cast<sockaddr *>(&address), &address_size) == -1) {
+        auto error = string{strerror(errno)};
+        close(listener_);
+        THROW_RUNTIME_ERROR("unable to listen on the loopback interface, {}", error);
+    }
+    port_ = ntohs(address.sin_port);
+    thread_ = std::jthread([this](std::stop_token stop_token) { Run(std::move(stop_token)); });
+}
+
+LocalHttpServer::~LocalHttpServer() {
+    thread_.request_stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    close(listener_);
+}
+
+string LocalHttpServer::GetEndpoint() const {
+    return fmt::format(FMT_STRING("http://127.0.0.1:{}"), port_);
+}
+
+string LocalHttpServer::GetLastRequest() const {
+    auto lock = scoped_lock<mutex>(last_request_mutex_);
+    return last_request_;
+}
+
+void LocalHttpServer::Run(std::stop_token stop_token) {
+    // the connections see the stop of the server, they are joined before this returns
+    auto connections = vector<Connection>{};
+    while (!stop_token.stop_requested()) {
+        auto listener = pollfd{listener_, POLLIN, 0};
+        if (poll(&listener, 1, POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        auto connection = accept4(listener_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection == -1) {
+            continue;
+        }
+        // the threads which have served their connection are joined as the new ones are started
+        erase_if(connections, [](const Connection &served_connection) { return served_connection.served->load(); });
+        auto served = make_shared<atomic<bool>>(false);
+        auto thread = std::jthread([this, connection, served, stop_token]() {
+            Serve(connection, stop_token);
+            close(connection);
+            *served = true;
+        });
+        connections.push_back(Connection{std::move(thread), std::move(served)});
+    }
+}
+
+void LocalHttpServer::Serve(int connection, const std::stop_token &stop_token) {
+    auto request = string{};
+    auto buffer = array<char, 4096>{};
+    while (request.find("\r\n\r\n") == string::npos) {
+        auto client = pollfd{connection, POLLIN, 0};
+        if (stop_token.stop_requested() || size(request) > MAX_REQUEST_SIZE) {
+            return;
+        } else if (poll(&client, 1, POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        auto received = recv(connection, data(buffer), size(buffer), 0);
+        if (received <= 0) {
+            return;
+        }
+        request.append(data(buffer), static_cast<size_t>(received));
+    }
+    {
+        auto lock = scoped_lock<mutex>(last_request_mutex_);
+        last_request_ = request.substr(0, request.find("\r\n\r\n"));
+    }
+    ++request_count_;
+
+    // "GET /json?token=abc HTTP/1.1"
+    auto request_line = string_view{request}.substr(0, request.find("\r\n"));
+    auto target_begin = request_line.find(' ');
+    auto target_end = request_line.rfind(' ');
+    auto target = string_view{};
+    if (target_begin != string_view::npos && target_end > target_begin) {
+        target = request_line.substr(target_begin + 1, target_end - target_begin - 1);
+    }
+
+    auto response = handler_(target);
+    if (!SleepFor(response.latency, stop_token)) {
+        return;
+    }
+    auto header = fmt::format(FMT_STRING("HTTP/1.1 {} {}\r\n"
+                                         "Content-Type: {}\r\n"
+                                         "Content-Length: {}\r\n"
+                                         "Connection: close\r\n"
+                                         "{}"
+                                         "\r\n"),
+                              response.status_code,
+                              GetReasonPhrase(response.status_code),
+                              response.content_type,
+                              size(response.body),
+                              response.headers);
+    if (!SendAll(connection, header)) {
+        return;
+    }
+    auto body = string_view{response.body};
+    auto chunk_size = response.chunk_size == 0 ? size(body) : response.chunk_size;
+    while (!empty(body)) {
+        if (!SleepFor(response.chunk_delay, stop_token)) {
+            return;
+        }
+        auto chunk = body.substr(0, chunk_size);
+        if (!SendAll(connection, chunk)) {
+            return;
+        }
+        body.remove_prefix(size(chunk));
+    }
+}
+
+void UseLocalEndpoint(const LocalHttpServer &server) {
+    using mmotd::core::ConfigOptions;
+    auto &config_options = ConfigOptions::Instance(true);
+    config_options.Override("external_ip_endpoint"s, server.GetEndpoint(), "network"s);
+    config_options.Override("weather_endpoint"s, server.GetEndpoint(), "network"s);
+    config_options.Override("backoff_seconds"s, int64_t{0}, "network"s);
+    config_options.Override("enabled"s, false, "http_cache"s);
+    config_options.Override("latitude"s, 35.0844, "location"s);
+    config_options.Override("longitude"s, -106.6504, "location"s);
+}
+
+} // namespace mmotd::test
+#endif
@@ -0,0 +1,87 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#pragma once
+#if !defined(_WIN32)
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace mmotd::test {
+
+// The responses of the web services as the providers expect them, and the error page of a misconfigured proxy
+inline constexpr auto IPINFO_RESPONSE = std::string_view{R"({"ip": "198.51.100.7", "city": "Albuquerque",
+"region": "New Mexico", "country": "US", "loc": "35.0844,-106.6504", "postal": "87102",
+"timezone": "America/Denver"})"};
+inline constexpr auto WTTR_RESPONSE = std::string_view{"Albuquerque, NM: +54°F ☀️ Clear ↑4mph 🌔"};
+inline constexpr auto HTML_ERROR_PAGE = std::string_view{"<html><head><title>Unknown location</title></head></html>"};
+
+// What the stand-in server answers, with the latency and the slow body of a struggling web service
+struct LocalHttpResponse {
+    int status_code = 200;
+    std::string content_type = "text/plain; charset=utf-8";
+    // more header lines, each one ends with "\r\n", i.e. "ETag: \"v1\"\r\nCache-Control: max-age=60\r\n"
+    std::string headers;
+    std::string body;
+    // before the status line is sent
+    std::chrono::milliseconds latency{0};
+    // the body is sent `chunk_size` bytes at a time with this pause before each chunk (0 sends it at once)
+    std::chrono::milliseconds chunk_delay{0};
+    std::size_t chunk_size = 0;
+};
+
+//
+// A loopback http server on an ephemeral port which answers every request through `handler`, so the web service
+//  providers can be tested and benchmarked against injected latencies, errors, html error pages and slow bodies.
+//  Each connection is served on a thread of its own, so concurrent requests wait on their latencies together, and
+//  it is closed after the response.
+//
+class LocalHttpServer {
+public:
+    // `handler` is called with the request target, i.e. "/json?token=abc"
+    using Handler = std::function<LocalHttpResponse(std::string_view target)>;
+
+    explicit LocalHttpServer(Handler handler);
+    ~LocalHttpServer();
+    LocalHttpServer(const LocalHttpServer &other) = delete;
+    LocalHttpServer(LocalHttpServer &&other) = delete;
+    LocalHttpServer &operator=(const LocalHttpServer &other) = delete;
+    LocalHttpServer &operator=(LocalHttpServer &&other) = delete;
+
+    // "http://127.0.0.1:<port>", to configure in place of a web service
+    std::string GetEndpoint() const;
+    std::size_t GetRequestCount() const noexcept { return request_count_; }
+    // The request line and the headers of the latest request
+    std::string GetLastRequest() const;
+
+private:
+    void Run(std::stop_token stop_token);
+    void Serve(int connection, const std::stop_token &stop_token);
+
+    struct Connection {
+        std::jthread thread;
+        std::shared_ptr<std::atomic<bool>> served;
+    };
+
+    Handler handler_;
+    int listener_ = -1;
+    std::uint16_t port_ = 0;
+    std::atomic<std::size_t> request_count_ = 0;
+    mutable std::mutex last_request_mutex_;
+    std::string last_request_;
+    std::jthread thread_;
+};
+
+// Points both web service providers at the stand-in server, without the http cache or the circuit breaker.  The
+//  configuration is reset first and the coordinates are configured so the weather does not wait on a location.
+void UseLocalEndpoint(const LocalHttpServer &server);
+
+} // namespace mmotd::test
+#endif
@@ -0,0 +1,133 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/config_options.h"
+#include "common/include/information_decls.h"
+#include "lib/include/computer_information.h"
+#include "lib/include/information_provider.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+using namespace std;
+
+namespace {
+
+// Finds its information at once
+class QuickProvider : public mmotd::information::InformationProvider {
+public:
+    string_view GetName() const noexcept override { return "quick"; }
+
+protected:
+    void FindInformation(std::stop_token) override {
+        using mmotd::information::InformationId;
+        auto load_average = GetInfoTemplate(InformationId::ID_LOAD_AVERAGE_LOAD_AVERAGE);
+        load_average.SetValue("0.42");
+        AddInformation(load_average);
+    }
+};
+
+// Has its information but does not finish until it is asked to stop (or for much longer than any budget)
+class BlockingProvider : public mmotd::information::InformationProvider {
+public:
+    string_view GetName() const noexcept override { return "blocking"; }
+
+protected:
+    void FindInformation(std::stop_token stop_token) override {
+        using mmotd::information::InformationId;
+        auto fortune = GetInfoTemplate(InformationId::ID_FORTUNE_FORTUNE);
+        fortune.SetValue("You will be cancelled.");
+        AddInformation(fortune);
+        auto lock = unique_lock<mutex>{mutex_};
+        condition_.wait_for(lock, stop_token, chrono::seconds{5}, []() { return false; });
+    }
+
+private:
+    mutex mutex_;
+    condition_variable_any condition_;
+};
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("CreateInformationProviders creates the providers which are depended on", "[ComputerInformation]") {
+    using namespace mmotd::information;
+    // without a configured location the weather provider depends on the external network provider
+    mmotd::core::ConfigOptions::Instance(true);
+    auto providers = CreateInformationProviders(InformationIds{InformationId::ID_WEATHER_WEATHER});
+    auto is_created = [&providers](string_view name) {
+        return any_of(begin(providers), end(providers), [name](const auto &provider) {
+            return provider->GetName() == name;
+        });
+    };
+    CATCH_CHECK(is_created("weather"sv));
+    CATCH_CHECK(is_created("external_network"sv));
+    CATCH_CHECK(size(providers) == 2);
+}
+
+CATCH_TEST_CASE("CreateInformationProviders only creates the providers which are needed", "[ComputerInformation]") {
+    using namespace mmotd::information;
+    // with the location and the coordinates configured the weather provider does not depend on any provider
+    auto &config_options = mmotd::core::ConfigOptions::Instance(true);
+    config_options.Override("city"s, "Albuquerque"s, "location"s);
+    config_options.Override("latitude"s, 35.0844, "location"s);
+    config_options.Override("longitude"s, -106.6504, "location"s);
+    auto providers = CreateInformationProviders(InformationIds{InformationId::ID_WEATHER_WEATHER});
+    CATCH_REQUIRE(size(providers) == 1);
+    CATCH_CHECK(providers.front()->GetName() == "weather"sv);
+    mmotd::core::ConfigOptions::Instance(true);
+}
+
+CATCH_TEST_CASE("CreateInformationProviders creates every provider under the name it is registered with",
+                "[ComputerInformation]") {
+    using namespace mmotd::information;
+    mmotd::core::ConfigOptions::Instance(true);
+    // a provider whose name differs from its registration could never be found as a dependency
+    auto providers = vector<shared_ptr<InformationProvider>>{};
+    CATCH_REQUIRE_NOTHROW(providers = CreateInformationProviders(nullopt));
+    auto names = vector<string_view>{};
+    transform(begin(providers), end(providers), back_inserter(names), [](const auto &provider) {
+        return provider->GetName();
+    });
+    sort(begin(names), end(names));
+    CATCH_CHECK(adjacent_find(begin(names), end(names)) == end(names));
+    CATCH_CHECK(binary_search(begin(names), end(names), "external_network"sv));
+}
+
+#if !defined(MMOTD_ASYNC_DISABLED)
+CATCH_TEST_CASE("ComputerInformation leaves out the providers which run past the latency budget",
+                "[ComputerInformation]") {
+    using namespace mmotd::information;
+    constexpr auto LATENCY_BUDGET = chrono::milliseconds{200};
+    auto &config_options = mmotd::core::ConfigOptions::Instance(true);
+    config_options.Override("latency_budget_ms"s, int64_t{LATENCY_BUDGET.count()}, "core"s);
+    config_options.Override("enabled"s, false, "cache"s);
+    {
+        auto computer_information =
+            ComputerInformation{{make_shared<QuickProvider>(), make_shared<BlockingProvider>()}};
+        auto start = chrono::steady_clock::now();
+        computer_information.CacheInformation();
+        auto elapsed = chrono::steady_clock::now() - start;
+
+        CATCH_CHECK(elapsed >= LATENCY_BUDGET);
+        // the blocking provider is stopped when the budget expires rather than waited on
+        CATCH_CHECK(elapsed < LATENCY_BUDGET + chrono::milliseconds{250});
+        const auto &informations = computer_information.GetAllInformations();
+        CATCH_CHECK(informations.contains(InformationId::ID_LOAD_AVERAGE_LOAD_AVERAGE));
+        CATCH_CHECK(!informations.contains(InformationId::ID_FORTUNE_FORTUNE));
+    }
+    mmotd::core::ConfigOptions::Instance(true);
+}
+#endif
+
+} // namespace mmotd::test
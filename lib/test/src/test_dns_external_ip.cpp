@@ -0,0 +1,270 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#if !defined(_WIN32)
+#include "common/include/config_options.h"
+#include "common/include/information_definitions.h"
+#include "common/include/informations.h"
+#include "lib/include/dns_external_ip.h"
+#include "lib/include/external_network.h"
+#include "lib/test/src/local_http_server.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+int OpenLoopbackSocket(uint16_t *port = nullptr) {
+    auto loopback_socket = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    auto address = sockaddr_in{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    auto address_size = socklen_t{sizeof(address)};
+    bind(loopback_socket, reinterpret_cast<const sockaddr *>(&address), address_size);
+    getsockname(loopback_socket, reinterpret_cast<sockaddr *>(&address), &address_size);
+    if (port != nullptr) {
+        *port = ntohs(address.sin_port);
+    }
+    return loopback_socket;
+}
+
+// How the stand-in dns server misbehaves
+struct LocalDnsBehavior {
+    // before each answer is sent, i.e. longer than the timeout of the resolver
+    chrono::milliseconds latency{0};
+    // ahead of each answer, the answer from another address and an answer to a query which was never sent
+    bool stray_datagrams = false;
+};
+
+// A stand-in dns server on the loopback interface, which answers every query with `answer` (or ignores it)
+class LocalDnsServer {
+public:
+    explicit LocalDnsServer(optional<array<uint8_t, 4>> answer, LocalDnsBehavior behavior = {}) :
+        answer_(answer), behavior_(behavior) {
+        socket_ = OpenLoopbackSocket(&port_);
+        stray_socket_ = OpenLoopbackSocket();
+        thread_ = std::jthread([this](std::stop_token stop_token) { Run(stop_token); });
+    }
+
+    ~LocalDnsServer() {
+        thread_.request_stop();
+        thread_.join();
+        close(socket_);
+        close(stray_socket_);
+    }
+
+    string GetServer() const { return "127.0.0.1:" + std::to_string(port_); }
+    size_t GetQueryCount() const noexcept { return query_count_; }
+
+private:
+    struct PendingAnswer {
+        chrono::steady_clock::time_point due;
+        sockaddr_in client;
+        string response;
+    };
+
+    void Run(const std::stop_token &stop_token) {
+        auto buffer = array<char, 512>{};
+        auto pending_answers = vector<PendingAnswer>{};
+        while (!stop_token.stop_requested()) {
+            SendDueAnswers(pending_answers);
+            auto server = pollfd{socket_, POLLIN, 0};
+            if (poll(&server, 1, 10) <= 0) {
+                continue;
+            }
+            auto client = sockaddr_in{};
+            auto client_size = socklen_t{sizeof(client)};
+            auto received = recvfrom(socket_,
+                                     data(buffer),
+                                     size(buffer),
+                                     0,
+                                     reinterpret_cast<sockaddr *>(&client),
+                                     &client_size);
+            if (received <= 0) {
+                continue;
+            }
+            ++query_count_;
+            if (!answer_) {
+                continue;
+            }
+            // the query with the response flags, one answer which points back at the question's name
+            auto response = string{data(buffer), static_cast<size_t>(received)};
+            response[2] = static_cast<char>(0x81);
+            response[3] = static_cast<char>(0x80);
+            response[7] = 1;
+            response += string{"\xc0\x0c\x00\x01\x00\x01\x00\x00\x00\x00\x00\x04", 12};
+            response.append(reinterpret_cast<const char *>(data(*answer_)), size(*answer_));
+            pending_answers.push_back(PendingAnswer{chrono::steady_clock::now() + behavior_.latency, client, response});
+        }
+    }
+
+    void SendDueAnswers(vector<PendingAnswer> &pending_answers) {
+        auto now = chrono::steady_clock::now();
+        auto send = [](int from, const string &datagram, const sockaddr_in &client) {
+            auto client_size = socklen_t{sizeof(client)};
+            sendto(from, data(datagram), size(datagram), 0, reinterpret_cast<const sockaddr *>(&client), client_size);
+        };
+        for (auto i = begin(pending_answers); i != end(pending_answers);) {
+            if (i->due > now) {
+                ++i;
+                continue;
+            }
+            if (behavior_.stray_datagrams) {
+                send(stray_socket_, i->response, i->client);
+                auto unknown_id = i->response;
+                unknown_id[0] = static_cast<char>(~unknown_id[0]);
+                send(socket_, unknown_id, i->client);
+            }
+            send(socket_, i->response, i->client);
+            i = pending_answers.erase(i);
+        }
+    }
+
+    optional<array<uint8_t, 4>> answer_;
+    LocalDnsBehavior behavior_;
+    int socket_ = -1;
+    int stray_socket_ = -1;
+    uint16_t port_ = 0;
+    atomic<size_t> query_count_ = 0;
+    std::jthread thread_;
+};
+
+mmotd::networking::DnsExternalIpResolver MakeResolver(const LocalDnsServer &server) {
+    auto resolver = mmotd::networking::DnsExternalIpResolver{};
+    resolver.server = *mmotd::networking::ParseDnsServer(server.GetServer());
+    resolver.name = "myip.opendns.com";
+    resolver.timeout = chrono::milliseconds{100};
+    resolver.attempts = 2;
+    return resolver;
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("BuildDnsQuery writes a recursive A query", "[dns_external_ip]") {
+    using mmotd::networking::BuildDnsQuery;
+    auto query = BuildDnsQuery(0x1234, "myip.opendns.com");
+    auto expected = string{"\x12\x34\x01\x00\x00\x01\x00\x00\x00\x00\x00\x00"
+                           "\x04myip\x07opendns\x03"
+                           "com\x00\x00\x01\x00\x01",
+                           34};
+    CATCH_CHECK(query == expected);
+}
+
+CATCH_TEST_CASE("ParseDnsResponse finds the address in the answer", "[dns_external_ip]") {
+    using mmotd::networking::ParseDnsResponse;
+    auto response = string{"\x12\x34\x81\x80\x00\x01\x00\x01\x00\x00\x00\x00"
+                           "\x04myip\x07opendns\x03"
+                           "com\x00\x00\x01\x00\x01"
+                           "\xc0\x0c\x00\x01\x00\x01\x00\x00\x00\x00\x00\x04\xc6\x33\x64\x07",
+                           50};
+    auto external_ip = ParseDnsResponse(response, 0x1234);
+    CATCH_REQUIRE(external_ip);
+    CATCH_CHECK(external_ip->to_string() == "198.51.100.7");
+    CATCH_CHECK_FALSE(ParseDnsResponse(response, 0x4321));
+    CATCH_CHECK_FALSE(ParseDnsResponse(response.substr(0, 40), 0x1234));
+    // NXDOMAIN
+    response[3] = '\x83';
+    CATCH_CHECK_FALSE(ParseDnsResponse(response, 0x1234));
+}
+
+CATCH_TEST_CASE("ParseDnsServer reads an address with an optional port", "[dns_external_ip]") {
+    using mmotd::networking::ParseDnsServer;
+    auto server = ParseDnsServer("208.67.222.222");
+    CATCH_REQUIRE(server);
+    CATCH_CHECK(server->port() == 53);
+    server = ParseDnsServer("127.0.0.1:5353");
+    CATCH_REQUIRE(server);
+    CATCH_CHECK(server->port() == 5353);
+    server = ParseDnsServer("[2620:119:35::35]:54");
+    CATCH_REQUIRE(server);
+    CATCH_CHECK(server->address().is_v6());
+    CATCH_CHECK(server->port() == 54);
+    CATCH_CHECK(ParseDnsServer("2620:119:35::35"));
+    CATCH_CHECK_FALSE(ParseDnsServer("resolver1.opendns.com"));
+    CATCH_CHECK_FALSE(ParseDnsServer("127.0.0.1:port"));
+}
+
+CATCH_TEST_CASE("QueryExternalIpAddress asks the dns server", "[dns_external_ip]") {
+    using mmotd::networking::QueryExternalIpAddress;
+    auto server = LocalDnsServer{array<uint8_t, 4>{198, 51, 100, 7}};
+    auto external_ip = QueryExternalIpAddress(MakeResolver(server));
+    CATCH_REQUIRE(external_ip);
+    CATCH_CHECK(external_ip->to_string() == "198.51.100.7");
+    CATCH_CHECK(server.GetQueryCount() == 1);
+}
+
+CATCH_TEST_CASE("QueryExternalIpAddress retries a server which does not answer", "[dns_external_ip]") {
+    using mmotd::networking::QueryExternalIpAddress;
+    auto server = LocalDnsServer{nullopt};
+    auto start = chrono::steady_clock::now();
+    CATCH_CHECK_FALSE(QueryExternalIpAddress(MakeResolver(server)));
+    CATCH_CHECK(chrono::steady_clock::now() - start < chrono::seconds{1});
+    CATCH_CHECK(server.GetQueryCount() == 2);
+}
+
+CATCH_TEST_CASE("QueryExternalIpAddress takes the late answer to an earlier query", "[dns_external_ip]") {
+    using mmotd::networking::QueryExternalIpAddress;
+    // each query is answered after 150ms, the first one during the second attempt and the second one too late
+    auto behavior = LocalDnsBehavior{};
+    behavior.latency = chrono::milliseconds{150};
+    auto server = LocalDnsServer{array<uint8_t, 4>{198, 51, 100, 7}, behavior};
+    auto external_ip = QueryExternalIpAddress(MakeResolver(server));
+    CATCH_REQUIRE(external_ip);
+    CATCH_CHECK(external_ip->to_string() == "198.51.100.7");
+    CATCH_CHECK(server.GetQueryCount() == 2);
+}
+
+CATCH_TEST_CASE("QueryExternalIpAddress ignores the datagrams which do not answer a query", "[dns_external_ip]") {
+    using mmotd::networking::QueryExternalIpAddress;
+    auto behavior = LocalDnsBehavior{};
+    behavior.stray_datagrams = true;
+    auto server = LocalDnsServer{array<uint8_t, 4>{198, 51, 100, 7}, behavior};
+    auto external_ip = QueryExternalIpAddress(MakeResolver(server));
+    CATCH_REQUIRE(external_ip);
+    CATCH_CHECK(external_ip->to_string() == "198.51.100.7");
+    // the stray datagrams did not cost an attempt
+    CATCH_CHECK(server.GetQueryCount() == 1);
+}
+
+CATCH_TEST_CASE("ExternalNetwork falls back to https when the dns query fails", "[dns_external_ip]") {
+    using namespace mmotd::information;
+    auto dns_server = LocalDnsServer{nullopt};
+    auto http_server = LocalHttpServer{[](string_view) {
+        auto response = LocalHttpResponse{};
+        response.body = R"({"ip": "203.0.113.9", "city": "Albuquerque"})";
+        return response;
+    }};
+    UseLocalEndpoint(http_server);
+    auto &config_options = mmotd::core::ConfigOptions::Instance();
+    config_options.Override("external_ip_resolver"s, "dns"s, "network"s);
+    config_options.Override("dns_server"s, dns_server.GetServer(), "network"s);
+    config_options.Override("dns_timeout_ms"s, int64_t{50}, "network"s);
+
+    auto external_network = ExternalNetwork{};
+    external_network.LookupInformation();
+    const auto &informations = external_network.GetInformations();
+    CATCH_CHECK(dns_server.GetQueryCount() == 2);
+    CATCH_CHECK(http_server.GetRequestCount() == 1);
+    CATCH_REQUIRE(informations.contains(InformationId::ID_EXTERNAL_NETWORK_INFO_EXTERNAL_IP));
+    CATCH_CHECK(informations.at(InformationId::ID_EXTERNAL_NETWORK_INFO_EXTERNAL_IP).front().GetValue() ==
+                "203.0.113.9");
+}
+
+} // namespace mmotd::test
+#endif
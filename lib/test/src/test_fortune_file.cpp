@@ -0,0 +1,314 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#if defined(__linux__)
+#include "lib/include/fortune_file.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <arpa/inet.h>
+#include <unistd.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr auto STRFILE_ROTATED = uint32_t{0x04};
+
+void WriteUint32(ofstream &output, uint32_t value) {
+    auto network_value = htonl(value);
+    output.write(reinterpret_cast<const char *>(&network_value), sizeof(network_value));
+}
+
+// Writes the fortunes and the version 2 STRFILE database `strfile` would write for them
+void WriteFortuneFile(const fs::path &text_path, const vector<string> &fortunes, uint32_t flags = 0) {
+    auto offsets = vector<uint32_t>{};
+    auto longest = uint32_t{0};
+    auto shortest = uint32_t{UINT32_MAX};
+    {
+        auto output = ofstream(text_path, ios_base::out | ios_base::binary | ios_base::trunc);
+        for (const auto &fortune : fortunes) {
+            offsets.push_back(static_cast<uint32_t>(output.tellp()));
+            output << fortune << "\n%\n";
+            longest = max(longest, static_cast<uint32_t>(fortune.size() + 1));
+            shortest = min(shortest, static_cast<uint32_t>(fortune.size() + 1));
+        }
+        offsets.push_back(static_cast<uint32_t>(output.tellp()));
+    }
+    auto dat_path = text_path;
+    dat_path += ".dat";
+    auto output = ofstream(dat_path, ios_base::out | ios_base::binary | ios_base::trunc);
+    WriteUint32(output, 2);
+    WriteUint32(output, static_cast<uint32_t>(fortunes.size()));
+    WriteUint32(output, longest);
+    WriteUint32(output, shortest);
+    WriteUint32(output, flags);
+    output.write("%\0\0\0", 4);
+    for (auto offset : offsets) {
+        WriteUint32(output, offset);
+    }
+}
+
+string Rot13(string text) {
+    for (auto &c : text) {
+        if (c >= 'a' && c <= 'z') {
+            c = static_cast<char>('a' + (c - 'a' + 13) % 26);
+        } else if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>('A' + (c - 'A' + 13) % 26);
+        }
+    }
+    return text;
+}
+
+fs::path MakeTestDirectory(string_view name) {
+    auto directory = fs::temp_directory_path() / (string{name} + "_" + std::to_string(getpid()));
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    return directory;
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("StrFile reads a fortune through its STRFILE offset", "[fortune]") {
+    using mmotd::fortune::StrFile;
+    auto directory = MakeTestDirectory("mmotd_test_strfile");
+    auto fortunes = vector<string>{"The first fortune.",
+                                   "A fortune with\ntwo lines and a 50% chance of a % sign.",
+                                   "  -- the last fortune"};
+    WriteFortuneFile(directory / "test", fortunes);
+
+    auto strfile = StrFile::Open(directory / "test");
+    CATCH_REQUIRE(strfile);
+    CATCH_REQUIRE(strfile->GetCount() == 3);
+    for (auto i = size_t{0}; i != fortunes.size(); ++i) {
+        CATCH_CHECK(strfile->GetFortune(i) == fortunes[i]);
+    }
+    CATCH_CHECK_FALSE(strfile->GetFortune(3));
+
+    WriteFortuneFile(directory / "rotated", {Rot13("Hello, World!")}, STRFILE_ROTATED);
+    strfile = StrFile::Open(directory / "rotated");
+    CATCH_REQUIRE(strfile);
+    CATCH_CHECK(strfile->GetFortune(0) == "Hello, World!");
+
+    CATCH_CHECK_FALSE(StrFile::Open(directory / "missing"));
+    auto ec = error_code{};
+    fs::remove_all(directory, ec);
+}
+
+CATCH_TEST_CASE("FortuneDirectoryIndex locates a fortune among all the files", "[fortune]") {
+    using mmotd::fortune::FortuneDirectoryIndex;
+    auto directory = MakeTestDirectory("mmotd_test_fortune_index");
+    auto index_path = directory.parent_path() / (directory.filename().string() + ".idx");
+    WriteFortuneFile(directory / "b", {"b0", "b1"});
+    WriteFortuneFile(directory / "a", {"a0", "a1", "a2"});
+    // a text file without a database is not part of the index
+    WriteFortuneFile(directory / "c", {"c0"});
+    fs::remove(directory / "c.dat");
+
+    auto index = FortuneDirectoryIndex::Open(directory, index_path);
+    CATCH_REQUIRE(index);
+    CATCH_CHECK(index->GetFileCount() == 2);
+    CATCH_REQUIRE(index->GetCount() == 5);
+    auto expected = vector<pair<string, size_t>>{{"a", 0}, {"a", 1}, {"a", 2}, {"b", 0}, {"b", 1}};
+    for (auto i = size_t{0}; i != expected.size(); ++i) {
+        auto location = index->Locate(i);
+        CATCH_REQUIRE(location);
+        CATCH_CHECK(location->text_path == directory / expected[i].first);
+        CATCH_CHECK(location->index == expected[i].second);
+    }
+    CATCH_CHECK_FALSE(index->Locate(5));
+
+    // a new file changes the directory, the index is written again
+    WriteFortuneFile(directory / "d", {"d0", "d1", "d2", "d3"});
+    index = FortuneDirectoryIndex::Open(directory, index_path);
+    CATCH_REQUIRE(index);
+    CATCH_CHECK(index->GetFileCount() == 3);
+    CATCH_CHECK(index->GetCount() == 9);
+    auto location = index->Locate(8);
+    CATCH_REQUIRE(location);
+    CATCH_CHECK(location->text_path == directory / "d");
+    CATCH_CHECK(location->index == 3);
+    CATCH_CHECK(location->count == 4);
+
+    auto ec = error_code{};
+    fs::remove(index_path, ec);
+    fs::remove_all(directory, ec);
+}
+
+CATCH_TEST_CASE("TextFortuneFile indexes the fortunes of a text file", "[fortune]") {
+    using mmotd::fortune::TextFortuneFile;
+    auto directory = MakeTestDirectory("mmotd_test_text_fortune");
+    auto text_path = directory / "test.txt";
+    {
+        auto output = ofstream(text_path, ios_base::out | ios_base::binary | ios_base::trunc);
+        output << "%\nThe first fortune.   \n%\n\n  \n% \r\nA fortune with\ntwo lines, 50% of them with a %.\n\n"
+               << "  %\nthe last fortune";
+    }
+    auto text_fortune_file = TextFortuneFile::Open(text_path);
+    CATCH_REQUIRE(text_fortune_file);
+    // the blank fortunes are left out
+    CATCH_REQUIRE(text_fortune_file->GetCount() == 3);
+    CATCH_CHECK(text_fortune_file->GetFortune(0) == "The first fortune.");
+    CATCH_CHECK(text_fortune_file->GetFortune(1) == "A fortune with\ntwo lines, 50% of them with a %.");
+    CATCH_CHECK(text_fortune_file->GetFortune(2) == "the last fortune");
+    CATCH_CHECK_FALSE(text_fortune_file->GetFortune(3));
+
+    auto index_path = text_path;
+    index_path += ".idx";
+    CATCH_REQUIRE(fs::exists(index_path));
+    auto index_time = fs::last_write_time(index_path);
+    text_fortune_file = TextFortuneFile::Open(text_path);
+    CATCH_REQUIRE(text_fortune_file);
+    CATCH_CHECK(fs::last_write_time(index_path) == index_time);
+
+    // a changed file is indexed again
+    {
+        auto output = ofstream(text_path, ios_base::out | ios_base::binary | ios_base::app);
+        output << "\n%\none more fortune\n";
+    }
+    text_fortune_file = TextFortuneFile::Open(text_path);
+    CATCH_REQUIRE(text_fortune_file);
+    CATCH_REQUIRE(text_fortune_file->GetCount() == 4);
+    CATCH_CHECK(text_fortune_file->GetFortune(3) == "one more fortune");
+
+    auto ec = error_code{};
+    fs::remove_all(directory, ec);
+}
+
+CATCH_TEST_CASE("TextFortuneFile records the lines and width of each fortune", "[fortune]") {
+    using mmotd::fortune::TextFortuneFile;
+    auto directory = MakeTestDirectory("mmotd_test_fortune_metrics");
+    auto fortunes = vector<string>{"one line", "two\nlines, the second is wider", "\ttab\n\u00e9t\u00e9"};
+    WriteFortuneFile(directory / "test", fortunes);
+
+    auto text_fortune_file = TextFortuneFile::Open(directory / "test");
+    CATCH_REQUIRE(text_fortune_file);
+    CATCH_REQUIRE(text_fortune_file->GetCount() == 3);
+    auto metrics = text_fortune_file->GetMetrics(0);
+    CATCH_CHECK(metrics.line_count == 1);
+    CATCH_CHECK(metrics.max_width == 8);
+    metrics = text_fortune_file->GetMetrics(1);
+    CATCH_CHECK(metrics.line_count == 2);
+    CATCH_CHECK(metrics.max_width == 26);
+    // a tab reaches column 8 and a two byte character is one column
+    metrics = text_fortune_file->GetMetrics(2);
+    CATCH_CHECK(metrics.line_count == 2);
+    CATCH_CHECK(metrics.max_width == 11);
+
+    // the text of a rotated STRFILE database is rotated back
+    WriteFortuneFile(directory / "rotated", {Rot13("Hello, World!")}, STRFILE_ROTATED);
+    text_fortune_file = TextFortuneFile::Open(directory / "rotated");
+    CATCH_REQUIRE(text_fortune_file);
+    CATCH_CHECK(text_fortune_file->GetFortune(0) == "Hello, World!");
+
+    auto ec = error_code{};
+    fs::remove_all(directory, ec);
+}
+
+CATCH_TEST_CASE("EligibleFortunes holds only the fortunes which fit the constraints", "[fortune]") {
+    using mmotd::fortune::EligibleFortunes;
+    using mmotd::fortune::FortuneConstraints;
+    auto directory = MakeTestDirectory("mmotd_test_eligible_fortunes");
+    WriteFortuneFile(directory / "a", {"short", "a much longer fortune", "two\nlines"});
+    WriteFortuneFile(directory / "b", {"three\nshort\nlines", "tiny"});
+    WriteFortuneFile(directory / "c", {"a fortune which is too wide"});
+    auto text_paths = vector<fs::path>{directory / "a", directory / "b", directory / "c"};
+    auto index_path = directory / "eligible.elg";
+
+    auto get_all_fortunes = [](const EligibleFortunes &eligible_fortunes) {
+        auto fortunes = vector<string>{};
+        for (auto i = size_t{0}; i != eligible_fortunes.GetCount(); ++i) {
+            fortunes.push_back(eligible_fortunes.GetFortune(i).value_or(""));
+        }
+        return fortunes;
+    };
+
+    auto eligible_fortunes = EligibleFortunes::Open(text_paths, FortuneConstraints{}, index_path);
+    CATCH_REQUIRE(eligible_fortunes);
+    CATCH_CHECK(eligible_fortunes->GetCount() == 6);
+    CATCH_CHECK(eligible_fortunes->GetFileCount() == 3);
+
+    eligible_fortunes = EligibleFortunes::Open(text_paths, FortuneConstraints{2, 10}, index_path);
+    CATCH_REQUIRE(eligible_fortunes);
+    CATCH_CHECK(get_all_fortunes(*eligible_fortunes) == vector<string>{"short", "two\nlines", "tiny"});
+    CATCH_CHECK_FALSE(eligible_fortunes->GetFortune(3));
+
+    eligible_fortunes = EligibleFortunes::Open(text_paths, FortuneConstraints{1, 0}, index_path);
+    CATCH_REQUIRE(eligible_fortunes);
+    CATCH_CHECK(get_all_fortunes(*eligible_fortunes) ==
+                vector<string>{"short", "a much longer fortune", "tiny", "a fortune which is too wide"});
+
+    eligible_fortunes = EligibleFortunes::Open(text_paths, FortuneConstraints{0, 3}, index_path);
+    CATCH_REQUIRE(eligible_fortunes);
+    CATCH_CHECK(eligible_fortunes->GetCount() == 0);
+
+    // without a path to save it to the table is kept in memory
+    eligible_fortunes = EligibleFortunes::Open(text_paths, FortuneConstraints{2, 10}, fs::path{});
+    CATCH_REQUIRE(eligible_fortunes);
+    CATCH_CHECK(get_all_fortunes(*eligible_fortunes) == vector<string>{"short", "two\nlines", "tiny"});
+
+    auto ec = error_code{};
+    fs::remove_all(directory, ec);
+}
+
+CATCH_TEST_CASE("EligibleFortunes saves its table until a file or the constraints change", "[fortune]") {
+    using mmotd::fortune::EligibleFortunes;
+    using mmotd::fortune::FortuneConstraints;
+    auto directory = MakeTestDirectory("mmotd_test_eligible_index");
+    WriteFortuneFile(directory / "a", {"short", "two\nlines"});
+    WriteFortuneFile(directory / "b", {"tiny", "three\nshort\nlines"});
+    auto text_paths = vector<fs::path>{directory / "a", directory / "b"};
+    auto index_path = directory / "eligible.elg";
+    auto constraints = FortuneConstraints{1, 0};
+
+    CATCH_CHECK(EligibleFortunes::GetIndexPath(text_paths, constraints) !=
+                EligibleFortunes::GetIndexPath(text_paths, FortuneConstraints{2, 0}));
+
+    auto eligible_fortunes = EligibleFortunes::Open(text_paths, constraints, index_path);
+    CATCH_REQUIRE(eligible_fortunes);
+    CATCH_CHECK(eligible_fortunes->GetCount() == 2);
+    CATCH_REQUIRE(fs::exists(index_path));
+    // an older time shows whether the table is written again
+    auto index_time = fs::last_write_time(index_path) - chrono::hours{1};
+    fs::last_write_time(index_path, index_time);
+
+    // the table is read back without reading the metrics again, and without writing it
+    eligible_fortunes = EligibleFortunes::Open(text_paths, constraints, index_path);
+    CATCH_REQUIRE(eligible_fortunes);
+    CATCH_CHECK(eligible_fortunes->GetFortune(1) == "tiny");
+    CATCH_CHECK(fs::last_write_time(index_path) == index_time);
+
+    // other constraints or other files are another table
+    eligible_fortunes = EligibleFortunes::Open(text_paths, FortuneConstraints{2, 0}, index_path);
+    CATCH_REQUIRE(eligible_fortunes);
+    CATCH_CHECK(eligible_fortunes->GetCount() == 3);
+    CATCH_CHECK(fs::last_write_time(index_path) != index_time);
+    eligible_fortunes = EligibleFortunes::Open(vector<fs::path>{directory / "b"}, constraints, index_path);
+    CATCH_REQUIRE(eligible_fortunes);
+    CATCH_CHECK(eligible_fortunes->GetCount() == 1);
+
+    // a changed file is measured again
+    eligible_fortunes = EligibleFortunes::Open(text_paths, constraints, index_path);
+    CATCH_REQUIRE(eligible_fortunes);
+    CATCH_CHECK(eligible_fortunes->GetCount() == 2);
+    WriteFortuneFile(directory / "b", {"tiny", "three\nshort\nlines", "more", "and more"});
+    eligible_fortunes = EligibleFortunes::Open(text_paths, constraints, index_path);
+    CATCH_REQUIRE(eligible_fortunes);
+    CATCH_CHECK(eligible_fortunes->GetCount() == 4);
+    CATCH_CHECK(eligible_fortunes->GetFortune(3) == "and more");
+
+    auto ec = error_code{};
+    fs::remove_all(directory, ec);
+}
+
+} // namespace mmotd::test
+#endif
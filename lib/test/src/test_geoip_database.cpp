@@ -0,0 +1,98 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "lib/include/geoip_database.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+#include <boost/asio/ip/address.hpp>
+#include <catch2/catch.hpp>
+
+#include <unistd.h>
+
+using boost::asio::ip::make_address;
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr auto GEOIP_CSV = R"(first_ip,last_ip,country,region,city,postal_code,timezone,latitude,longitude
+# documentation ranges
+192.0.2.0,192.0.2.255,US,NM,Albuquerque,87101,America/Denver,35.0844,-106.6504
+198.51.100.0,198.51.100.127,US,"New Mexico","Santa Fe, Capital",87501,America/Denver,,
+203.0.113.0,203.0.113.255,AU,NSW,Sydney,2000,Australia/Sydney,-33.8688,151.2093
+203.0.113.128,203.0.113.200,NZ,AUK,Auckland,1010,Pacific/Auckland,-36.8485,174.7633
+2001:db8::,2001:db8::ffff,US,NM,Albuquerque,87101,America/Denver,35.0844,-106.6504
+not an address,192.0.2.1,US,NM,Albuquerque,87101,America/Denver,35.0844,-106.6504
+)";
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("ParseGeoIpCsv reads the ranges of a csv file", "[GeoIpDatabase]") {
+    using mmotd::networking::ParseGeoIpCsv;
+    auto input = istringstream{GEOIP_CSV};
+    auto ranges = ParseGeoIpCsv(input);
+    CATCH_REQUIRE(ranges.size() == 5);
+    CATCH_CHECK(ranges[0].first == make_address("192.0.2.0"));
+    CATCH_CHECK(ranges[0].last == make_address("192.0.2.255"));
+    CATCH_CHECK(ranges[0].location.gps_location == "35.0844,-106.6504");
+    CATCH_CHECK(ranges[1].location.region == "New Mexico");
+    CATCH_CHECK(ranges[1].location.city == "Santa Fe, Capital");
+    CATCH_CHECK(ranges[1].location.gps_location.empty());
+}
+
+CATCH_TEST_CASE("GeoIpDatabase finds the range of an address", "[GeoIpDatabase]") {
+    using mmotd::networking::GeoIpDatabase;
+    using mmotd::networking::ParseGeoIpCsv;
+    auto file_path = fs::temp_directory_path() / ("mmotd_test_geoip_" + std::to_string(getpid()) + ".db");
+    auto input = istringstream{GEOIP_CSV};
+    CATCH_REQUIRE(GeoIpDatabase::Write(file_path, ParseGeoIpCsv(input)));
+
+    auto database = GeoIpDatabase::Open(file_path);
+    CATCH_REQUIRE(database);
+    // the auckland range overlaps the sydney range
+    CATCH_CHECK(database->GetRangeCount() == 4);
+
+    auto location = database->Find(make_address("192.0.2.0"));
+    CATCH_REQUIRE(location);
+    CATCH_CHECK(location->city == "Albuquerque");
+    CATCH_CHECK(location->region == "NM");
+    CATCH_CHECK(location->country == "US");
+    CATCH_CHECK(location->postal_code == "87101");
+    CATCH_CHECK(location->timezone == "America/Denver");
+    CATCH_CHECK(location->gps_location == "35.0844,-106.6504");
+    CATCH_CHECK(database->Find(make_address("192.0.2.255")) == location);
+    CATCH_CHECK(database->Find(make_address("2001:db8::1234")) == location);
+
+    location = database->Find(make_address("203.0.113.150"));
+    CATCH_REQUIRE(location);
+    CATCH_CHECK(location->city == "Sydney");
+
+    CATCH_CHECK_FALSE(database->Find(make_address("0.0.0.0")));
+    CATCH_CHECK_FALSE(database->Find(make_address("192.0.3.0")));
+    CATCH_CHECK_FALSE(database->Find(make_address("198.51.100.128")));
+    CATCH_CHECK_FALSE(database->Find(make_address("::ffff:ffff")));
+    CATCH_CHECK_FALSE(database->Find(make_address("2001:db8::1:0")));
+
+    auto ec = error_code{};
+    fs::remove(file_path, ec);
+}
+
+CATCH_TEST_CASE("GeoIpDatabase does not open an invalid file", "[GeoIpDatabase]") {
+    using mmotd::networking::GeoIpDatabase;
+    auto file_path = fs::temp_directory_path() / ("mmotd_test_geoip_invalid_" + std::to_string(getpid()) + ".db");
+    {
+        auto output = ofstream(file_path, ios_base::out | ios_base::binary | ios_base::trunc);
+        output << "mmotdgeo but not a database";
+    }
+    CATCH_CHECK_FALSE(GeoIpDatabase::Open(file_path));
+    CATCH_CHECK_FALSE(GeoIpDatabase::Open(file_path.string() + ".missing"));
+    auto ec = error_code{};
+    fs::remove(file_path, ec);
+}
+
+} // namespace mmotd::test
@@ -0,0 +1,212 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#if defined(__linux__)
+#include "lib/include/pci_ids.h"
+#include "lib/include/platform/hardware_information.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <catch2/catch.hpp>
+
+#include <unistd.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+// Two hyper-threaded cores in one socket
+constexpr auto X86_CPUINFO = string_view{R"(processor	: 0
+vendor_id	: GenuineIntel
+cpu family	: 6
+model name	: Intel(R) Core(TM) i3-6100U CPU @ 2.30GHz
+physical id	: 0
+core id		: 0
+cpu cores	: 2
+
+processor	: 1
+model name	: Intel(R) Core(TM) i3-6100U CPU @ 2.30GHz
+physical id	: 0
+core id		: 1
+
+processor	: 2
+model name	: Intel(R) Core(TM) i3-6100U CPU @ 2.30GHz
+physical id	: 0
+core id		: 0
+
+processor	: 3
+model name	: Intel(R) Core(TM) i3-6100U CPU @ 2.30GHz
+physical id	: 0
+core id		: 1
+)"};
+
+// No model name and no topology, both come from elsewhere on arm
+constexpr auto ARM_CPUINFO = string_view{R"(processor	: 0
+BogoMIPS	: 48.00
+CPU part	: 0xd08
+
+processor	: 1
+BogoMIPS	: 48.00
+CPU part	: 0xd08
+)"};
+
+// A few vendors of pci.ids with their devices, subsystems and the class section which follows them
+constexpr auto PCI_IDS = string_view{R"(#	List of PCI ID's
+#
+# Syntax:
+# vendor  vendor_name
+#	device  device_name				<-- single tab
+#		subvendor subdevice  subsystem_name	<-- two tabs
+
+8086  Intel Corporation
+	1234  Not A Real Device
+	5917  UHD Graphics 620
+		1028 0810  Latitude 7490
+10de  NVIDIA Corporation
+	1c8d  GP107M [GeForce GTX 1050 Mobile]
+1af4  Red Hat, Inc.
+
+# List of known device classes, subclasses and programming interfaces
+C 03  Display controller
+	00  VGA compatible controller
+)"};
+
+void WriteFile(const fs::path &file_path, string_view contents) {
+    fs::create_directories(file_path.parent_path());
+    auto output = ofstream(file_path);
+    output << contents;
+}
+
+// A sysfs cpu directory with the cpus of `online` spread over two sockets of one core each
+fs::path MakeSysfsCpuDirectory(string_view online) {
+    auto sysfs_cpu_directory = fs::temp_directory_path() / ("mmotd_test_sysfs_cpu_" + to_string(getpid()));
+    WriteFile(sysfs_cpu_directory / "online", online);
+    WriteFile(sysfs_cpu_directory / "present", "0-7\n");
+    for (auto cpu = 0; cpu != 8; ++cpu) {
+        auto topology_directory = sysfs_cpu_directory / ("cpu" + to_string(cpu)) / "topology";
+        WriteFile(topology_directory / "physical_package_id", to_string(cpu % 2) + "\n");
+        WriteFile(topology_directory / "core_id", "0\n");
+    }
+    return sysfs_cpu_directory;
+}
+
+// A sysfs pci directory with an intel and an nvidia gpu, a disk controller and a gpu which pci.ids does not know
+fs::path MakeSysfsPciDirectory() {
+    auto sysfs_pci_directory = fs::temp_directory_path() / ("mmotd_test_sysfs_pci_" + to_string(getpid()));
+    auto write_device = [&sysfs_pci_directory](string_view address, string_view pci_class, string_view vendor,
+                                               string_view device) {
+        WriteFile(sysfs_pci_directory / address / "class", pci_class);
+        WriteFile(sysfs_pci_directory / address / "vendor", vendor);
+        WriteFile(sysfs_pci_directory / address / "device", device);
+    };
+    write_device("0000:01:00.0", "0x030200\n", "0x10de\n", "0x1c8d\n");
+    write_device("0000:00:02.0", "0x030000\n", "0x8086\n", "0x5917\n");
+    write_device("0000:00:17.0", "0x010601\n", "0x8086\n", "0x9d03\n");
+    write_device("0000:02:00.0", "0x038000\n", "0x1b36\n", "0x0100\n");
+    return sysfs_pci_directory;
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("cpu details are read from /proc/cpuinfo", "[HardwareInformation]") {
+    using mmotd::platform::GetCpuInfoDetails;
+    using mmotd::platform::HardwareDetails;
+    auto sysfs_cpu_directory = MakeSysfsCpuDirectory("0-3\n");
+
+    auto details = HardwareDetails{};
+    GetCpuInfoDetails(details, X86_CPUINFO, sysfs_cpu_directory);
+    CATCH_CHECK(details.cpu_name == "Intel(R) Core(TM) i3-6100U CPU @ 2.30GHz");
+    CATCH_CHECK(details.cpu_core_count == 4);
+    CATCH_CHECK(details.cpu_physical_core_count == 2);
+    CATCH_CHECK(details.cpu_socket_count == 1);
+    CATCH_CHECK(details.byte_order.has_value());
+
+    auto ec = error_code{};
+    fs::remove_all(sysfs_cpu_directory, ec);
+}
+
+CATCH_TEST_CASE("cpu topology falls back to sysfs", "[HardwareInformation]") {
+    using mmotd::platform::GetCpuInfoDetails;
+    using mmotd::platform::HardwareDetails;
+    auto sysfs_cpu_directory = MakeSysfsCpuDirectory("0-1,3\n");
+
+    auto details = HardwareDetails{};
+    GetCpuInfoDetails(details, ARM_CPUINFO, sysfs_cpu_directory);
+    CATCH_CHECK(details.cpu_name.empty());
+    CATCH_CHECK(details.cpu_core_count == 3);
+    CATCH_CHECK(details.cpu_physical_core_count == 2);
+    CATCH_CHECK(details.cpu_socket_count == 2);
+
+    // a malformed online list falls back to the cpus which are present
+    WriteFile(sysfs_cpu_directory / "online", "0-");
+    details = HardwareDetails{};
+    GetCpuInfoDetails(details, ARM_CPUINFO, sysfs_cpu_directory);
+    CATCH_CHECK(details.cpu_core_count == 8);
+
+    auto ec = error_code{};
+    fs::remove_all(sysfs_cpu_directory, ec);
+}
+
+CATCH_TEST_CASE("pci.ids names are found through the saved index", "[HardwareInformation]") {
+    using mmotd::platform::PciIds;
+    auto test_directory = fs::temp_directory_path() / ("mmotd_test_pci_ids_" + to_string(getpid()));
+    WriteFile(test_directory / "pci.ids", PCI_IDS);
+    auto index_path = test_directory / "pci_ids.idx";
+
+    // the first open builds and saves the index, the second maps the saved one
+    for (auto i = 0; i != 2; ++i) {
+        auto pci_ids = PciIds::Open(test_directory / "pci.ids", index_path);
+        CATCH_REQUIRE(pci_ids.has_value());
+        CATCH_CHECK(fs::exists(index_path));
+        CATCH_CHECK(pci_ids->FindVendorName(0x8086) == "Intel Corporation");
+        CATCH_CHECK(pci_ids->FindVendorName(0x1af4) == "Red Hat, Inc.");
+        CATCH_CHECK(pci_ids->FindDeviceName(0x8086, 0x5917) == "UHD Graphics 620");
+        CATCH_CHECK(pci_ids->FindDeviceName(0x10de, 0x1c8d) == "GP107M [GeForce GTX 1050 Mobile]");
+        CATCH_CHECK_FALSE(pci_ids->FindDeviceName(0x10de, 0x5917).has_value());
+        CATCH_CHECK_FALSE(pci_ids->FindVendorName(0x1028).has_value());
+        CATCH_CHECK_FALSE(pci_ids->FindVendorName(0x0300).has_value());
+    }
+
+    // a changed pci.ids is indexed again
+    auto pci_ids_contents = string{PCI_IDS};
+    pci_ids_contents.insert(pci_ids_contents.find("# List of known"), "1b36  Red Hat, Inc.\n");
+    WriteFile(test_directory / "pci.ids", pci_ids_contents);
+    auto pci_ids = PciIds::Open(test_directory / "pci.ids", index_path);
+    CATCH_REQUIRE(pci_ids.has_value());
+    CATCH_CHECK(pci_ids->FindVendorName(0x1b36) == "Red Hat, Inc.");
+    pci_ids = PciIds::Open(test_directory / "pci.ids", fs::path{});
+    CATCH_REQUIRE(pci_ids.has_value());
+    CATCH_CHECK(pci_ids->FindVendorName(0x8086) == "Intel Corporation");
+
+    auto ec = error_code{};
+    fs::remove_all(test_directory, ec);
+}
+
+CATCH_TEST_CASE("gpus are the display controllers in sysfs", "[HardwareInformation]") {
+    using mmotd::platform::FindPciDisplayControllers;
+    using mmotd::platform::GetPciDeviceName;
+    using mmotd::platform::PciIds;
+    auto sysfs_pci_directory = MakeSysfsPciDirectory();
+    WriteFile(sysfs_pci_directory / "pci.ids", PCI_IDS);
+    auto pci_ids = PciIds::Open(sysfs_pci_directory / "pci.ids", fs::path{});
+    CATCH_REQUIRE(pci_ids.has_value());
+
+    auto display_controllers = FindPciDisplayControllers(sysfs_pci_directory);
+    CATCH_REQUIRE(display_controllers.size() == 3);
+    CATCH_CHECK(GetPciDeviceName(&*pci_ids, display_controllers[0]) == "Intel Corporation UHD Graphics 620");
+    CATCH_CHECK(GetPciDeviceName(&*pci_ids, display_controllers[1]) ==
+                "NVIDIA Corporation GP107M [GeForce GTX 1050 Mobile]");
+    CATCH_CHECK(GetPciDeviceName(&*pci_ids, display_controllers[2]) == "1b36:0100");
+    CATCH_CHECK(GetPciDeviceName(nullptr, display_controllers[0]) == "8086:5917");
+
+    auto ec = error_code{};
+    fs::remove_all(sysfs_pci_directory, ec);
+}
+
+} // namespace mmotd::test
+#endif
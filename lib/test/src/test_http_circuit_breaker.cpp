@@ -0,0 +1,54 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "lib/include/http_circuit_breaker.h"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+#include <catch2/catch.hpp>
+
+#include <unistd.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("HttpCircuitBreaker backs off exponentially", "[HttpCircuitBreaker]") {
+    using mmotd::networking::HttpCircuitBreaker;
+    auto circuit_breaker = HttpCircuitBreaker{fs::path{}, chrono::seconds{30}, chrono::seconds{100}};
+    CATCH_CHECK(circuit_breaker.GetBackOff(0) == chrono::seconds{0});
+    CATCH_CHECK(circuit_breaker.GetBackOff(1) == chrono::seconds{30});
+    CATCH_CHECK(circuit_breaker.GetBackOff(2) == chrono::seconds{60});
+    CATCH_CHECK(circuit_breaker.GetBackOff(3) == chrono::seconds{100});
+    CATCH_CHECK(circuit_breaker.GetBackOff(1000) == chrono::seconds{100});
+}
+
+CATCH_TEST_CASE("HttpCircuitBreaker keeps the health of a host across instances", "[HttpCircuitBreaker]") {
+    using mmotd::networking::HttpCircuitBreaker;
+    auto directory = fs::temp_directory_path() / ("mmotd_test_circuit_breaker_" + std::to_string(getpid()));
+    fs::create_directories(directory);
+    auto now = chrono::system_clock::now();
+    {
+        auto circuit_breaker = HttpCircuitBreaker{directory, chrono::seconds{30}, chrono::seconds{3600}};
+        CATCH_CHECK_FALSE(circuit_breaker.IsOpen("wttr.in", now));
+        circuit_breaker.RecordFailure("wttr.in", now);
+        circuit_breaker.RecordFailure("wttr.in", now);
+    }
+    {
+        auto circuit_breaker = HttpCircuitBreaker{directory, chrono::seconds{30}, chrono::seconds{3600}};
+        CATCH_CHECK(circuit_breaker.GetHealth("wttr.in").consecutive_failures == 2);
+        CATCH_CHECK(circuit_breaker.IsOpen("wttr.in", now + chrono::seconds{59}));
+        CATCH_CHECK_FALSE(circuit_breaker.IsOpen("wttr.in", now + chrono::seconds{61}));
+        CATCH_CHECK_FALSE(circuit_breaker.IsOpen("ipinfo.io", now));
+
+        circuit_breaker.RecordSuccess("wttr.in");
+        CATCH_CHECK(circuit_breaker.GetHealth("wttr.in").consecutive_failures == 0);
+        CATCH_CHECK_FALSE(circuit_breaker.IsOpen("wttr.in", now));
+    }
+    auto ec = error_code{};
+    fs::remove_all(directory, ec);
+}
+
+} // namespace mmotd::test
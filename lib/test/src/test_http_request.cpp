@@ -0,0 +1,282 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#if !defined(_WIN32)
+#include "common/include/config_options.h"
+#include "common/include/system_command.h"
+#include "lib/include/computer_information.h"
+#include "lib/include/http_request.h"
+#include "lib/test/src/local_http_server.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+
+#include <unistd.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+// "127.0.0.1:<port>", the endpoint of the server without its scheme
+string GetHost(const mmotd::test::LocalHttpServer &server) {
+    auto endpoint = server.GetEndpoint();
+    return endpoint.substr(endpoint.find("://") + 3);
+}
+
+// Turns the http cache on in a cache directory ($XDG_CACHE_HOME) of its own, which is removed at the end
+class TestHttpCache {
+public:
+    TestHttpCache() : directory_(fs::temp_directory_path() / ("mmotd_test_http_request_" + std::to_string(getpid()))) {
+        if (const auto *cache_home = getenv("XDG_CACHE_HOME"); cache_home != nullptr) {
+            cache_home_ = string{cache_home};
+        }
+        auto ec = error_code{};
+        fs::remove_all(directory_, ec);
+        setenv("XDG_CACHE_HOME", directory_.c_str(), 1);
+        mmotd::core::ConfigOptions::Instance().Override("enabled"s, true, "http_cache"s);
+    }
+
+    ~TestHttpCache() {
+        if (cache_home_) {
+            setenv("XDG_CACHE_HOME", cache_home_->c_str(), 1);
+        } else {
+            unsetenv("XDG_CACHE_HOME");
+        }
+        auto ec = error_code{};
+        fs::remove_all(directory_, ec);
+    }
+
+    TestHttpCache(const TestHttpCache &other) = delete;
+    TestHttpCache(TestHttpCache &&other) = delete;
+    TestHttpCache &operator=(const TestHttpCache &other) = delete;
+    TestHttpCache &operator=(TestHttpCache &&other) = delete;
+
+private:
+    fs::path directory_;
+    optional<string> cache_home_;
+};
+
+// A response without a body is a 304 (Not Modified)
+mmotd::test::LocalHttpResponse MakeResponse(string body, string headers) {
+    auto response = mmotd::test::LocalHttpResponse{};
+    response.status_code = empty(body) ? 304 : 200;
+    response.body = std::move(body);
+    response.headers = std::move(headers);
+    return response;
+}
+
+#if defined(__linux__)
+// Names the stand-in weather service for the one-shot process, which is this test executable run again
+constexpr auto ONE_SHOT_ENDPOINT_VARIABLE = "MMOTD_TEST_WEATHER_ENDPOINT";
+constexpr auto ONE_SHOT_TEST_CASE = "a one-shot process looks up the weather";
+constexpr auto ONE_SHOT_WEATHER_PREFIX = string_view{"weather: "};
+
+// Runs the one-shot process and returns the weather it printed
+string LookUpWeatherInOneShotProcess() {
+    using namespace mmotd::system::command;
+    auto command = Command{"/proc/self/exe", {ONE_SHOT_TEST_CASE}, chrono::seconds{10}};
+    auto result = Execute(command);
+    CATCH_REQUIRE(result.succeeded());
+    auto output = string_view{result.output};
+    auto i = output.find(ONE_SHOT_WEATHER_PREFIX);
+    if (i == string_view::npos) {
+        return string{};
+    }
+    output.remove_prefix(i + size(ONE_SHOT_WEATHER_PREFIX));
+    return string{output.substr(0, output.find('\n'))};
+}
+#endif
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("HttpRequest runs the outstanding requests concurrently", "[HttpRequest]") {
+    using namespace mmotd::networking;
+    constexpr auto LATENCY = chrono::milliseconds{500};
+    auto server = LocalHttpServer{[LATENCY](string_view target) {
+        auto response = LocalHttpResponse{};
+        response.body = string{target};
+        response.latency = LATENCY;
+        return response;
+    }};
+    UseLocalEndpoint(server);
+    auto host = GetHost(server);
+
+    auto start = chrono::steady_clock::now();
+    auto first = HttpRequest::GetAsync(HttpProtocol::HTTP, host, "first");
+    auto second = HttpRequest::GetAsync(HttpProtocol::HTTP, host, "second");
+    auto first_body = first.get();
+    auto second_body = second.get();
+    auto elapsed = chrono::steady_clock::now() - start;
+
+    CATCH_CHECK(first_body == "/first");
+    CATCH_CHECK(second_body == "/second");
+    CATCH_CHECK(server.GetRequestCount() == 2);
+    // both requests wait on their latency at the same time
+    CATCH_CHECK(elapsed < LATENCY * 2);
+}
+
+CATCH_TEST_CASE("HttpRequest records the timing of each request", "[HttpRequest]") {
+    using namespace mmotd::networking;
+    constexpr auto LATENCY = chrono::milliseconds{100};
+    auto server = LocalHttpServer{[LATENCY](string_view) {
+        auto response = LocalHttpResponse{};
+        response.status_code = 200;
+        response.body = "sunny";
+        response.latency = LATENCY;
+        return response;
+    }};
+    UseLocalEndpoint(server);
+    auto host = GetHost(server);
+    auto timing_count = size(HttpRequest::GetTimings());
+    CATCH_CHECK(HttpRequest::Get(HttpProtocol::HTTP, host, "weather", "token=secret") == "sunny");
+
+    auto timings = HttpRequest::GetTimings();
+    CATCH_REQUIRE(size(timings) == timing_count + 1);
+    const auto &timing = timings.back();
+    // the query, which can hold an api key, is left out
+    CATCH_CHECK(timing.url == "http://" + host + "/weather");
+    CATCH_CHECK(timing.status_code == 200);
+    CATCH_CHECK(timing.bytes == 5);
+    CATCH_CHECK(timing.tls_handshake == chrono::microseconds::zero());
+    CATCH_CHECK(timing.name_lookup <= timing.connect);
+    CATCH_CHECK(timing.connect <= timing.first_byte);
+    CATCH_CHECK(timing.first_byte <= timing.total);
+    CATCH_CHECK(timing.first_byte >= LATENCY);
+}
+
+CATCH_TEST_CASE("HttpRequest revalidates a cached response with its etag", "[HttpRequest]") {
+    using namespace mmotd::networking;
+    // the response is only changed while no request is in flight
+    auto response = MakeResponse("sunny", "ETag: \"v1\"\r\nCache-Control: max-age=0, must-revalidate\r\n");
+    auto server = LocalHttpServer{[&response](string_view) { return response; }};
+    UseLocalEndpoint(server);
+    auto http_cache = TestHttpCache{};
+    auto host = GetHost(server);
+    CATCH_CHECK(HttpRequest::Get(HttpProtocol::HTTP, host, "weather") == "sunny");
+
+    // the stale response must be revalidated before it is used, the server finds it unchanged
+    response = MakeResponse(string{}, "ETag: \"v1\"\r\nCache-Control: max-age=3600\r\n");
+    CATCH_CHECK(HttpRequest::Get(HttpProtocol::HTTP, host, "weather") == "sunny");
+    CATCH_CHECK(server.GetRequestCount() == 2);
+    CATCH_CHECK(server.GetLastRequest().find("If-None-Match: \"v1\"") != string::npos);
+
+    // the 304 made the cached response fresh again, so it is used without a request
+    CATCH_CHECK(HttpRequest::Get(HttpProtocol::HTTP, host, "weather") == "sunny");
+    CATCH_CHECK(server.GetRequestCount() == 2);
+}
+
+CATCH_TEST_CASE("HttpRequest uses a stale response while it is revalidated", "[HttpRequest]") {
+    using namespace mmotd::networking;
+    constexpr auto LATENCY = chrono::milliseconds{300};
+    auto response = MakeResponse("sunny", "ETag: \"v1\"\r\nCache-Control: max-age=0\r\n");
+    auto server = LocalHttpServer{[&response](string_view) { return response; }};
+    UseLocalEndpoint(server);
+    auto http_cache = TestHttpCache{};
+    auto host = GetHost(server);
+    CATCH_CHECK(HttpRequest::Get(HttpProtocol::HTTP, host, "weather") == "sunny");
+
+    // the stale body is returned at once, the slow revalidation stores the new body for the next request
+    response = MakeResponse("cloudy", "ETag: \"v2\"\r\nCache-Control: max-age=3600\r\n");
+    response.latency = LATENCY;
+    auto start = chrono::steady_clock::now();
+    CATCH_CHECK(HttpRequest::Get(HttpProtocol::HTTP, host, "weather") == "sunny");
+    CATCH_CHECK(chrono::steady_clock::now() - start < LATENCY);
+
+    auto deadline = chrono::steady_clock::now() + chrono::seconds{5};
+    while (server.GetRequestCount() < 2 && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::milliseconds{10});
+    }
+    CATCH_REQUIRE(server.GetRequestCount() == 2);
+    auto body = HttpRequest::Get(HttpProtocol::HTTP, host, "weather");
+    while (body == "sunny" && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::milliseconds{10});
+        body = HttpRequest::Get(HttpProtocol::HTTP, host, "weather");
+    }
+    CATCH_CHECK(body == "cloudy");
+}
+
+CATCH_TEST_CASE("HttpRequest keeps the stale response when its revalidation fails", "[HttpRequest]") {
+    using namespace mmotd::networking;
+    auto response = MakeResponse("sunny", "Cache-Control: max-age=0\r\n");
+    auto server = LocalHttpServer{[&response](string_view) { return response; }};
+    UseLocalEndpoint(server);
+    auto http_cache = TestHttpCache{};
+    auto host = GetHost(server);
+    CATCH_CHECK(HttpRequest::Get(HttpProtocol::HTTP, host, "weather") == "sunny");
+
+    // the error is not stored, the stale response is used again
+    response.status_code = 503;
+    response.body = "down for maintenance";
+    CATCH_CHECK(HttpRequest::Get(HttpProtocol::HTTP, host, "weather") == "sunny");
+    auto deadline = chrono::steady_clock::now() + chrono::seconds{5};
+    while (server.GetRequestCount() < 3 && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::milliseconds{10});
+    }
+    CATCH_CHECK(HttpRequest::Get(HttpProtocol::HTTP, host, "weather") == "sunny");
+}
+
+#if defined(__linux__)
+// Only does something when it is run by the test below, as a login would run mmotd once and exit (the name is
+//  ONE_SHOT_TEST_CASE)
+CATCH_TEST_CASE("a one-shot process looks up the weather", "[.][HttpRequest]") {
+    using namespace mmotd::information;
+    const auto *endpoint = getenv(ONE_SHOT_ENDPOINT_VARIABLE);
+    if (endpoint == nullptr) {
+        return;
+    }
+    auto &config_options = mmotd::core::ConfigOptions::Instance(true);
+    config_options.Override("weather_endpoint"s, string{endpoint}, "network"s);
+    config_options.Override("backoff_seconds"s, int64_t{0}, "network"s);
+    config_options.Override("latency_budget_ms"s, int64_t{3000}, "core"s);
+    // the weather is looked up through the http cache every time rather than restored from a snapshot
+    config_options.Override("enabled"s, false, "cache"s);
+    config_options.Override("enabled"s, true, "http_cache"s);
+    config_options.Override("city"s, "Albuquerque"s, "location"s);
+    config_options.Override("latitude"s, 35.0844, "location"s);
+    config_options.Override("longitude"s, -106.6504, "location"s);
+
+    auto &computer_information = ComputerInformation::Instance();
+    computer_information.SetRequiredInformationIds({InformationId::ID_WEATHER_WEATHER});
+    computer_information.GetAllInformations();
+    auto weather = computer_information.FindInformation(InformationId::ID_WEATHER_WEATHER);
+    CATCH_REQUIRE(weather);
+    fmt::print(FMT_STRING("{}{}\n"), ONE_SHOT_WEATHER_PREFIX, weather->GetValue());
+    fflush(stdout);
+}
+
+CATCH_TEST_CASE("HttpRequest refreshes a stale response before a one-shot process exits", "[HttpRequest]") {
+    constexpr auto LATENCY = chrono::milliseconds{300};
+    auto response = MakeResponse("Albuquerque: +54°F Clear", "ETag: \"v1\"\r\nCache-Control: max-age=0\r\n");
+    auto server = LocalHttpServer{[&response](string_view) { return response; }};
+    UseLocalEndpoint(server);
+    auto http_cache = TestHttpCache{};
+    setenv(ONE_SHOT_ENDPOINT_VARIABLE, server.GetEndpoint().c_str(), 1);
+    CATCH_CHECK(LookUpWeatherInOneShotProcess() == "+54°F Clear");
+    CATCH_CHECK(server.GetRequestCount() == 1);
+
+    // the stale response is printed at once and the process waits on its slow revalidation before it exits
+    response = MakeResponse("Albuquerque: +48°F Cloudy", "ETag: \"v2\"\r\nCache-Control: max-age=3600\r\n");
+    response.latency = LATENCY;
+    CATCH_CHECK(LookUpWeatherInOneShotProcess() == "+54°F Clear");
+    CATCH_CHECK(server.GetRequestCount() == 2);
+
+    // the refreshed response is fresh, so the next run uses it without a request
+    CATCH_CHECK(LookUpWeatherInOneShotProcess() == "+48°F Cloudy");
+    CATCH_CHECK(server.GetRequestCount() == 2);
+    unsetenv(ONE_SHOT_ENDPOINT_VARIABLE);
+}
+#endif
+
+} // namespace mmotd::test
+#endif
@@ -0,0 +1,64 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "lib/include/http_response_cache.h"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+#include <catch2/catch.hpp>
+
+#include <unistd.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("ParseCacheControl reads the freshness directives", "[HttpResponseCache]") {
+    using mmotd::networking::ParseCacheControl;
+    auto cache_control = ParseCacheControl("public, Max-Age=300 , must-revalidate");
+    CATCH_REQUIRE(cache_control.max_age);
+    CATCH_CHECK(*cache_control.max_age == chrono::seconds{300});
+    CATCH_CHECK(cache_control.must_revalidate);
+    CATCH_CHECK_FALSE(cache_control.no_store);
+    CATCH_CHECK_FALSE(cache_control.no_cache);
+
+    cache_control = ParseCacheControl("no-cache,no-store,max-age=soon");
+    CATCH_CHECK_FALSE(cache_control.max_age);
+    CATCH_CHECK(cache_control.no_cache);
+    CATCH_CHECK(cache_control.no_store);
+
+    CATCH_CHECK_FALSE(ParseCacheControl("").max_age);
+}
+
+CATCH_TEST_CASE("HttpResponseCache round trips an entry", "[HttpResponseCache]") {
+    using namespace mmotd::networking;
+    auto directory = fs::temp_directory_path() / ("mmotd_test_http_cache_" + std::to_string(getpid()));
+    fs::create_directories(directory);
+    auto cache = HttpResponseCache{directory};
+    auto url = string{"https://wttr.in/Albuquerque?format=%l:+%t+%c+%C+%w"};
+    CATCH_CHECK_FALSE(cache.Find(url));
+
+    auto entry = HttpCacheEntry{};
+    entry.url = url;
+    entry.etag = "\"v1\"";
+    entry.body = "Albuquerque, NM: +54°F ☀️ Clear ↑4mph";
+    entry.fresh_until = chrono::system_clock::now() + chrono::hours{1};
+    entry.must_revalidate = true;
+    CATCH_REQUIRE(cache.Store(entry));
+
+    auto found = cache.Find(url);
+    CATCH_REQUIRE(found);
+    CATCH_CHECK(found->etag == entry.etag);
+    CATCH_CHECK(found->body == entry.body);
+    CATCH_CHECK(found->must_revalidate);
+    CATCH_CHECK(found->IsFresh());
+    CATCH_CHECK_FALSE(found->IsFresh(entry.fresh_until + chrono::seconds{1}));
+    CATCH_CHECK_FALSE(cache.Find("https://wttr.in/Santa Fe"));
+
+    auto ec = error_code{};
+    fs::remove_all(directory, ec);
+}
+
+} // namespace mmotd::test
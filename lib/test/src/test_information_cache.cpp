@@ -0,0 +1,173 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "common/include/config_options.h"
+#include "common/include/information.h"
+#include "common/include/information_definitions.h"
+#include "common/include/informations.h"
+#include "lib/include/information_cache.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <catch2/catch.hpp>
+
+#include <unistd.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+fs::path GetTestSnapshotPath() {
+    return fs::temp_directory_path() / ("mmotd_test_snapshot_" + to_string(getpid()) + ".bin");
+}
+
+mmotd::information::Informations MakeWeatherInformations() {
+    using namespace mmotd::information;
+    auto weather = InformationDefinitions::Instance().GetInformationDefinition(InformationId::ID_WEATHER_WEATHER);
+    weather.SetValue("Albuquerque, NM: +54°F ☀️ Clear ↑4mph");
+    auto informations = Informations{};
+    informations.push_back(weather);
+    return informations;
+}
+
+// Overwrites `size(bytes)` bytes of the snapshot at `offset`
+void PatchSnapshot(const fs::path &snapshot_path, streamoff offset, string_view bytes) {
+    auto output = fstream(snapshot_path, ios_base::in | ios_base::out | ios_base::binary);
+    output.seekp(offset);
+    output.write(data(bytes), static_cast<streamsize>(size(bytes)));
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("InformationCache round trips a snapshot", "[InformationCache]") {
+    using namespace mmotd::information;
+    mmotd::core::ConfigOptions::Instance(true);
+    auto snapshot_path = GetTestSnapshotPath();
+    {
+        auto snapshot_cache = InformationCache{snapshot_path};
+        CATCH_CHECK(!snapshot_cache.Find("weather"));
+        snapshot_cache.Update("weather", MakeWeatherInformations());
+        CATCH_CHECK(snapshot_cache.Save());
+    }
+    {
+        auto snapshot_cache = InformationCache{snapshot_path};
+        auto informations = snapshot_cache.Find("weather");
+        CATCH_REQUIRE(informations);
+        CATCH_REQUIRE(informations->contains(InformationId::ID_WEATHER_WEATHER));
+        const auto &weather = informations->at(InformationId::ID_WEATHER_WEATHER);
+        CATCH_REQUIRE(size(weather) == 1);
+        CATCH_CHECK(weather.front().GetName() == "weather");
+        CATCH_CHECK(weather.front().GetValue() == "Albuquerque, NM: +54°F ☀️ Clear ↑4mph");
+    }
+    auto ec = error_code{};
+    fs::remove(snapshot_path, ec);
+}
+
+CATCH_TEST_CASE("InformationCache does not cache providers without a time-to-live", "[InformationCache]") {
+    using namespace mmotd::information;
+    mmotd::core::ConfigOptions::Instance(true);
+    CATCH_CHECK(InformationCache::GetTimeToLive("load_average") == std::chrono::seconds::zero());
+    CATCH_CHECK(InformationCache::GetTimeToLive("hardware") < std::chrono::seconds::zero());
+    CATCH_CHECK(InformationCache::GetTimeToLive("weather") == std::chrono::minutes{30});
+
+    auto snapshot_path = GetTestSnapshotPath();
+    {
+        auto snapshot_cache = InformationCache{snapshot_path};
+        snapshot_cache.Update("load_average", MakeWeatherInformations());
+        CATCH_CHECK(!snapshot_cache.Find("load_average"));
+    }
+    auto ec = error_code{};
+    fs::remove(snapshot_path, ec);
+}
+
+CATCH_TEST_CASE("InformationCache discards an invalid snapshot", "[InformationCache]") {
+    using namespace mmotd::information;
+    mmotd::core::ConfigOptions::Instance(true);
+    auto snapshot_path = GetTestSnapshotPath();
+    {
+        auto output = ofstream(snapshot_path, ios_base::out | ios_base::binary | ios_base::trunc);
+        output << "this is not a snapshot of anything at all";
+    }
+    auto snapshot_cache = InformationCache{snapshot_path};
+    CATCH_CHECK(!snapshot_cache.Find("weather"));
+    auto ec = error_code{};
+    fs::remove(snapshot_path, ec);
+}
+
+CATCH_TEST_CASE("InformationCache discards a snapshot with a corrupt header or entry", "[InformationCache]") {
+    using namespace mmotd::information;
+    mmotd::core::ConfigOptions::Instance(true);
+    // SnapshotHeader::provider_count is at offset 12 and the id of the first SnapshotEntry follows the
+    //  88 byte header and the 48 byte provider
+    constexpr auto PROVIDER_COUNT_OFFSET = streamoff{12};
+    constexpr auto FIRST_ENTRY_ID_OFFSET = streamoff{88 + 48};
+    auto corruptions = {pair{PROVIDER_COUNT_OFFSET, string{"\xff\xff\xff\xff", 4}},
+                        pair{FIRST_ENTRY_ID_OFFSET, string{"\xff\xff\xff\xff\xff\xff\xff\x7f", 8}}};
+    auto snapshot_path = GetTestSnapshotPath();
+    for (const auto &[offset, bytes] : corruptions) {
+        {
+            auto snapshot_cache = InformationCache{snapshot_path};
+            snapshot_cache.Update("weather", MakeWeatherInformations());
+            CATCH_REQUIRE(snapshot_cache.Save());
+        }
+        PatchSnapshot(snapshot_path, offset, bytes);
+        {
+            auto snapshot_cache = optional<InformationCache>{};
+            CATCH_REQUIRE_NOTHROW(snapshot_cache.emplace(snapshot_path));
+            CATCH_CHECK(!snapshot_cache->Find("weather"));
+            // the corrupt snapshot is replaced so the next login does not trip over it again
+            CATCH_CHECK(snapshot_cache->Save());
+        }
+        {
+            auto snapshot_cache = InformationCache{snapshot_path};
+            CATCH_CHECK(!snapshot_cache.Find("weather"));
+            snapshot_cache.Update("weather", MakeWeatherInformations());
+            CATCH_CHECK(snapshot_cache.Save());
+        }
+    }
+    auto ec = error_code{};
+    fs::remove(snapshot_path, ec);
+}
+
+CATCH_TEST_CASE("InformationCache expires boot-scoped snapshots when the platform changes", "[InformationCache]") {
+    using namespace mmotd::information;
+    mmotd::core::ConfigOptions::Instance(true);
+    auto snapshot_path = GetTestSnapshotPath();
+    auto os_release_path = fs::temp_directory_path() / ("mmotd_test_os_release_" + std::to_string(getpid()));
+    {
+        auto output = ofstream(os_release_path);
+        output << "NAME=\"Ubuntu\"\nVERSION_ID=\"22.04\"\n";
+    }
+    {
+        auto snapshot_cache = InformationCache{snapshot_path, os_release_path};
+        snapshot_cache.Update("hardware", MakeWeatherInformations());
+        snapshot_cache.Update("weather", MakeWeatherInformations());
+        CATCH_CHECK(snapshot_cache.Save());
+    }
+    {
+        auto snapshot_cache = InformationCache{snapshot_path, os_release_path};
+        CATCH_CHECK(snapshot_cache.Find("hardware"));
+        CATCH_CHECK(snapshot_cache.Find("weather"));
+    }
+    // an upgrade rewrites /etc/os-release, only the facts which last until reboot are looked up again
+    fs::last_write_time(os_release_path, fs::last_write_time(os_release_path) + std::chrono::hours{1});
+    {
+        auto snapshot_cache = InformationCache{snapshot_path, os_release_path};
+        CATCH_CHECK(!snapshot_cache.Find("hardware"));
+        CATCH_CHECK(snapshot_cache.Find("weather"));
+    }
+    auto ec = error_code{};
+    fs::remove(snapshot_path, ec);
+    fs::remove(os_release_path, ec);
+}
+
+} // namespace mmotd::test
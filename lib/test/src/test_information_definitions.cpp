@@ -177,6 +177,10 @@ CATCH_TEST_CASE("information ids are correct", "[InformationId]") {
                 static_cast<InformationId>(MakeInformationId(CategoryId::ID_HARDWARE, 17009)));
     CATCH_CHECK(InformationId::ID_HARDWARE_GPU_TEMPERATURE ==
                 static_cast<InformationId>(MakeInformationId(CategoryId::ID_HARDWARE, 17010)));
+    CATCH_CHECK(InformationId::ID_HARDWARE_CPU_PHYSICAL_CORE_COUNT ==
+                static_cast<InformationId>(MakeInformationId(CategoryId::ID_HARDWARE, 17011)));
+    CATCH_CHECK(InformationId::ID_HARDWARE_CPU_SOCKET_COUNT ==
+                static_cast<InformationId>(MakeInformationId(CategoryId::ID_HARDWARE, 17012)));
 }
 
 } // namespace mmotd::test
@@ -0,0 +1,111 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#if !defined(_WIN32)
+#include "common/include/information_definitions.h"
+#include "common/include/informations.h"
+#include "lib/include/external_network.h"
+#include "lib/include/weather_info.h"
+#include "lib/test/src/local_http_server.h"
+
+#include <chrono>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+using namespace std;
+
+namespace {
+
+mmotd::test::LocalHttpResponse MakeResponse(string_view body, int status_code = 200) {
+    auto response = mmotd::test::LocalHttpResponse{};
+    response.status_code = status_code;
+    response.body = string{body};
+    return response;
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("ExternalNetwork parses the response of the ip service", "[network_providers]") {
+    using namespace mmotd::information;
+    auto server = LocalHttpServer{[](string_view) { return MakeResponse(IPINFO_RESPONSE); }};
+    UseLocalEndpoint(server);
+    auto external_network = ExternalNetwork{};
+    external_network.LookupInformation();
+    const auto &informations = external_network.GetInformations();
+    CATCH_CHECK(server.GetRequestCount() == 1);
+    CATCH_REQUIRE(informations.contains(InformationId::ID_EXTERNAL_NETWORK_INFO_EXTERNAL_IP));
+    CATCH_CHECK(informations.at(InformationId::ID_EXTERNAL_NETWORK_INFO_EXTERNAL_IP).front().GetValue() ==
+                "198.51.100.7");
+    CATCH_REQUIRE(informations.contains(InformationId::ID_LOCATION_INFO_ZIP_CODE));
+    CATCH_CHECK(informations.at(InformationId::ID_LOCATION_INFO_ZIP_CODE).front().GetValue() == "87102");
+}
+
+CATCH_TEST_CASE("WeatherInfo parses the response of the weather service", "[network_providers]") {
+    using namespace mmotd::information;
+    auto server = LocalHttpServer{[](string_view) { return MakeResponse(WTTR_RESPONSE); }};
+    UseLocalEndpoint(server);
+    auto weather_info = WeatherInfo{};
+    weather_info.LookupInformation();
+    const auto &informations = weather_info.GetInformations();
+    CATCH_REQUIRE(informations.contains(InformationId::ID_WEATHER_WEATHER));
+    CATCH_CHECK(informations.at(InformationId::ID_WEATHER_WEATHER).front().GetValue() == "+54°F ☀️ Clear ↑4mph 🌔");
+    CATCH_REQUIRE(informations.contains(InformationId::ID_WEATHER_LOCATION));
+    CATCH_CHECK(informations.at(InformationId::ID_WEATHER_LOCATION).front().GetValue() == "Albuquerque, NM");
+    // sunrise and sunset are computed from the coordinates, the response no longer has them
+    CATCH_CHECK(informations.contains(InformationId::ID_WEATHER_SUNRISE));
+    CATCH_CHECK(informations.contains(InformationId::ID_WEATHER_SUNSET));
+}
+
+CATCH_TEST_CASE("the web service providers find nothing in an error response", "[network_providers]") {
+    using namespace mmotd::information;
+    auto status_code = 500;
+    auto body = string{};
+    auto server = LocalHttpServer{[&status_code, &body](string_view) { return MakeResponse(body, status_code); }};
+    UseLocalEndpoint(server);
+
+    auto weather_info = WeatherInfo{};
+    weather_info.LookupInformation();
+    CATCH_CHECK_FALSE(weather_info.GetInformations().contains(InformationId::ID_WEATHER_WEATHER));
+    // sunrise and sunset do not depend on the weather service
+    CATCH_CHECK(weather_info.GetInformations().contains(InformationId::ID_WEATHER_SUNRISE));
+
+    // wttr.in answers an unknown location with an html page
+    status_code = 200;
+    body = HTML_ERROR_PAGE;
+    weather_info.LookupInformation();
+    CATCH_CHECK_FALSE(weather_info.GetInformations().contains(InformationId::ID_WEATHER_WEATHER));
+
+    body = "not json";
+    auto external_network = ExternalNetwork{};
+    external_network.LookupInformation();
+    CATCH_CHECK(empty(external_network.GetInformations()));
+    CATCH_CHECK(server.GetRequestCount() == 3);
+}
+
+CATCH_TEST_CASE("a slow web service is abandoned when the lookup is stopped", "[network_providers]") {
+    using namespace mmotd::information;
+    auto server = LocalHttpServer{[](string_view) {
+        auto response = MakeResponse(WTTR_RESPONSE);
+        response.chunk_size = 8;
+        response.chunk_delay = chrono::milliseconds{500};
+        return response;
+    }};
+    UseLocalEndpoint(server);
+    auto stop_source = std::stop_source{};
+    auto stopper = std::jthread([&stop_source]() {
+        this_thread::sleep_for(chrono::milliseconds{200});
+        stop_source.request_stop();
+    });
+    auto start = chrono::steady_clock::now();
+    auto weather_info = WeatherInfo{};
+    weather_info.LookupInformation(stop_source.get_token());
+    CATCH_CHECK(chrono::steady_clock::now() - start < chrono::seconds{2});
+    CATCH_CHECK_FALSE(weather_info.GetInformations().contains(InformationId::ID_WEATHER_WEATHER));
+}
+
+} // namespace mmotd::test
+#endif
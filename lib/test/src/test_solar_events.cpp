@@ -0,0 +1,102 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "lib/include/solar_events.h"
+
+#include <chrono>
+#include <optional>
+
+#include <catch2/catch.hpp>
+#include <date/date.h>
+
+using namespace std;
+
+namespace {
+
+struct SolarEventsReference {
+    const char *place;
+    date::year_month_day day;
+    mmotd::astronomy::Coordinates coordinates;
+    // UTC, to the minute as in the published tables
+    chrono::minutes sunrise;
+    chrono::minutes sunset;
+};
+
+// A table entry is a minute since the table is rounded, one more allows for the rounding of the computed time
+bool IsNear(const optional<date::sys_seconds> &event, date::sys_seconds expected) {
+    return event && chrono::abs(*event - expected) <= chrono::seconds{90};
+}
+
+} // namespace
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("ComputeSolarEvents matches the published sunrise and sunset tables", "[SolarEvents]") {
+    using namespace date;
+    using namespace std::chrono_literals;
+    using mmotd::astronomy::ComputeSolarEvents;
+    // the sunset in new york and albuquerque is the next day in UTC, the sunrise in sydney and tokyo the day before
+    const auto references = {
+        SolarEventsReference{"london", 2021_y / June / 21, {51.5074, -0.1278}, 3h + 43min, 20h + 21min},
+        SolarEventsReference{"london", 2021_y / December / 21, {51.5074, -0.1278}, 8h + 4min, 15h + 53min},
+        SolarEventsReference{"new york", 2021_y / June / 21, {40.7128, -74.0060}, 9h + 25min, 24h + 31min},
+        SolarEventsReference{"albuquerque", 2021_y / November / 1, {35.0844, -106.6504}, 13h + 28min, 24h + 12min},
+        SolarEventsReference{"sydney", 2021_y / June / 21, {-33.8688, 151.2093}, -3h + 0min, 6h + 54min},
+        SolarEventsReference{"tokyo", 2021_y / January / 1, {35.6762, 139.6503}, -3h + 51min, 7h + 39min},
+        SolarEventsReference{"quito", 2021_y / March / 20, {-0.1807, -78.4678}, 11h + 18min, 23h + 24min},
+    };
+    for (const auto &reference : references) {
+        CATCH_INFO(reference.place << " " << static_cast<int>(reference.day.year()) << "-"
+                                   << static_cast<unsigned>(reference.day.month()));
+        auto midnight = sys_seconds{sys_days{reference.day}};
+        auto events = ComputeSolarEvents(reference.day, reference.coordinates);
+        CATCH_CHECK(IsNear(events.sunrise, midnight + reference.sunrise));
+        CATCH_CHECK(IsNear(events.sunset, midnight + reference.sunset));
+        CATCH_REQUIRE(events.civil_dawn);
+        CATCH_REQUIRE(events.civil_dusk);
+        CATCH_CHECK(*events.civil_dawn < *events.sunrise);
+        CATCH_CHECK(*events.civil_dusk > *events.sunset);
+    }
+}
+
+CATCH_TEST_CASE("ComputeSolarEvents matches the published civil twilight tables", "[SolarEvents]") {
+    using namespace date;
+    using namespace std::chrono_literals;
+    using mmotd::astronomy::ComputeSolarEvents;
+    auto day = 2021_y / June / 21;
+    auto midnight = sys_seconds{sys_days{day}};
+    auto events = ComputeSolarEvents(day, {51.5074, -0.1278});
+    CATCH_CHECK(IsNear(events.civil_dawn, midnight + 2h + 55min));
+    CATCH_CHECK(IsNear(events.civil_dusk, midnight + 21h + 9min));
+}
+
+CATCH_TEST_CASE("ComputeSolarEvents finds no sunrise during the midnight sun and the polar night", "[SolarEvents]") {
+    using namespace date;
+    using mmotd::astronomy::ComputeSolarEvents;
+    auto tromso = mmotd::astronomy::Coordinates{69.6492, 18.9553};
+
+    auto events = ComputeSolarEvents(2021_y / June / 21, tromso);
+    CATCH_CHECK_FALSE(events.sunrise);
+    CATCH_CHECK_FALSE(events.sunset);
+    CATCH_CHECK_FALSE(events.civil_dawn);
+    CATCH_CHECK_FALSE(events.civil_dusk);
+
+    // the sun stays below the horizon but not 6° below it
+    events = ComputeSolarEvents(2021_y / December / 21, tromso);
+    CATCH_CHECK_FALSE(events.sunrise);
+    CATCH_CHECK_FALSE(events.sunset);
+    CATCH_CHECK(events.civil_dawn);
+    CATCH_CHECK(events.civil_dusk);
+}
+
+CATCH_TEST_CASE("ParseCoordinates reads a latitude and longitude", "[SolarEvents]") {
+    using mmotd::astronomy::ParseCoordinates;
+    auto coordinates = ParseCoordinates("35.0844,-106.6504");
+    CATCH_REQUIRE(coordinates);
+    CATCH_CHECK(coordinates->latitude == Approx(35.0844));
+    CATCH_CHECK(coordinates->longitude == Approx(-106.6504));
+    CATCH_CHECK(ParseCoordinates(" -33.8688 , 151.2093 "));
+    CATCH_CHECK_FALSE(ParseCoordinates("35.0844"));
+    CATCH_CHECK_FALSE(ParseCoordinates("north,west"));
+    CATCH_CHECK_FALSE(ParseCoordinates("95.0,10.0"));
+}
+
+} // namespace mmotd::test
@@ -0,0 +1,70 @@
+// vim: awa:sts=4:ts=4:sw=4:et:cin:fdm=manual:tw=120:ft=cpp
+#include "lib/include/task_graph.h"
+
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/asio/thread_pool.hpp>
+#include <catch2/catch.hpp>
+
+using namespace std;
+
+namespace mmotd::test {
+
+CATCH_TEST_CASE("TaskGraph runs the tasks in the order they were added", "[TaskGraph]") {
+    using mmotd::information::TaskGraph;
+    auto order = vector<int>{};
+    auto task_graph = TaskGraph{};
+    auto first = task_graph.AddTask("first", [&order]() { order.push_back(1); });
+    auto second = task_graph.AddTask("second", [&order]() { order.push_back(2); }, {first});
+    task_graph.AddTask("third", [&order]() { order.push_back(3); }, {first, second});
+
+    CATCH_CHECK(task_graph.size() == 3);
+    task_graph.Run();
+    CATCH_CHECK(order == vector<int>{1, 2, 3});
+}
+
+CATCH_TEST_CASE("TaskGraph only depends on tasks which were already added", "[TaskGraph]") {
+    using mmotd::information::TaskGraph;
+    auto task_graph = TaskGraph{};
+    CATCH_CHECK_THROWS(task_graph.AddTask("orphan", []() {}, {0}));
+    CATCH_CHECK(task_graph.empty());
+}
+
+CATCH_TEST_CASE("TaskGraph runs the dependents of a failed task", "[TaskGraph]") {
+    using mmotd::information::TaskGraph;
+    auto dependent_ran = false;
+    auto task_graph = TaskGraph{};
+    auto failing = task_graph.AddTask("failing", []() { throw runtime_error("task failed"); });
+    task_graph.AddTask("dependent", [&dependent_ran]() { dependent_ran = true; }, {failing});
+
+    task_graph.Run();
+    CATCH_CHECK(dependent_ran);
+}
+
+CATCH_TEST_CASE("TaskGraph posts each task after its dependencies", "[TaskGraph]") {
+    using mmotd::information::TaskGraph;
+    auto lock = mutex{};
+    auto order = vector<int>{};
+    auto record = [&lock, &order](int value) {
+        return [&lock, &order, value]() {
+            auto guard = lock_guard<mutex>{lock};
+            order.push_back(value);
+        };
+    };
+    auto task_graph = TaskGraph{};
+    auto leaf1 = task_graph.AddTask("leaf 1", record(1));
+    auto leaf2 = task_graph.AddTask("leaf 2", record(2));
+    auto leaf3 = task_graph.AddTask("leaf 3", record(3));
+    task_graph.AddTask("root", record(4), {leaf1, leaf2, leaf3});
+
+    auto thread_pool = boost::asio::thread_pool{4};
+    task_graph.Post(thread_pool);
+    thread_pool.join();
+
+    CATCH_REQUIRE(size(order) == 4);
+    CATCH_CHECK(order.back() == 4);
+}
+
+} // namespace mmotd::test